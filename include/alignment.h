@@ -21,10 +21,13 @@
 #ifndef PASTE_ALIGNMENTS_ALIGNMENT_H_
 #define PASTE_ALIGNMENTS_ALIGNMENT_H_
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "helpers.h"
+#include "packed_sequence.h"
 #include "paste_parameters.h"
 #include "scoring_system.h"
 
@@ -111,13 +114,18 @@ class Alignment {
   ///  and evalue.
   /// @parameter paste_parameters Additional arguments used for handling
   ///  floating points. Also indicates whether executing in blind mode.
+  /// @parameter row_owner Owner of the characters `fields` refer to, or
+  ///  null.
   ///
   /// @details `fields` values are interpreted in the order:
   ///  qstart qend sstart send nident mismatch gapopen gaps qlen slen length
   ///  qseq sseq. If executing in blind mode, the last two columns are not
   ///  expected. The object is considered to be on the minus strand if it's
   ///  subject end coordinate precedes its subject start coordinate. Fields in
-  ///  excess of 13 (11 if in blind mode) are ignored.
+  ///  excess of 13 (11 if in blind mode) are ignored. If `row_owner` is not
+  ///  null, the object keeps it and refers to the interpreted fields as read
+  ///  until it is pasted onto. In that case, qseq and sseq are not packed if
+  ///  `paste_parameters.sequence_views` is set.
   ///
   /// @exceptions Strong guarantee. Throws `exceptions::ParsingError` if
   ///  * Fewer than 13 fields are provided (or fewer than 11 in blind mode).
@@ -132,10 +140,11 @@ class Alignment {
   ///  * Length of qseq or sseq is not the same as length (unless in blind
   ///    mode).
   ///
-  static Alignment FromStringFields(int id,
-                                    std::vector<std::string_view> fields,
-                                    const ScoringSystem& scoring_system,
-                                    const PasteParameters& paste_parameters);
+  static Alignment FromStringFields(
+      int id, std::vector<std::string_view> fields,
+      const ScoringSystem& scoring_system,
+      const PasteParameters& paste_parameters,
+      std::shared_ptr<const void> row_owner = nullptr);
   /// @}
 
   /// @name Constructors:
@@ -212,6 +221,26 @@ class Alignment {
   ///
   inline bool PlusStrand() const {return plus_strand_;}
 
+  /// @brief Subject starting coordinate on the aligned strand of the subject.
+  ///
+  /// @details Equals `Sstart` for alignments on the plus strand. For
+  ///  alignments on the minus strand, the coordinate is counted on the reverse
+  ///  complement of the subject, i.e. `Slen - Send + 1`. Canonical subject
+  ///  coordinates increase along the query on either strand.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline int CanonicalSstart() const {return canonical_sstart_;}
+
+  /// @brief Subject ending coordinate on the aligned strand of the subject.
+  ///
+  /// @details Equals `Send` for alignments on the plus strand, and
+  ///  `Slen - Sstart + 1` for alignments on the minus strand.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline int CanonicalSend() const {return canonical_send_;}
+
   /// @brief Number of identical matches.
   ///
   /// @exceptions Strong guarantee.
@@ -248,17 +277,40 @@ class Alignment {
   ///
   inline int Slen() const {return slen_;}
 
-  /// @brief Query part of the sequence alignment.
+  /// @brief Query part of the sequence alignment, unpacked.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline std::string Qseq() const {return qseq_.ToString();}
+
+  /// @brief Subject part of the sequence alignment, unpacked.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline std::string Sseq() const {return sseq_.ToString();}
+
+  /// @brief Query part of the sequence alignment as stored.
   ///
   /// @exceptions Strong guarantee.
   ///
-  inline const std::string& Qseq() const {return qseq_;}
+  inline const PackedSequence& PackedQseq() const {return qseq_;}
 
-  /// @brief Subject part of the sequence alignment.
+  /// @brief Subject part of the sequence alignment as stored.
   ///
   /// @exceptions Strong guarantee.
   ///
-  inline const std::string& Sseq() const {return sseq_;}
+  inline const PackedSequence& PackedSseq() const {return sseq_;}
+
+  /// @brief The interpreted fields as read, from qstart through sseq (through
+  ///  length in blind mode), separated by tabs.
+  ///
+  /// @details Empty unless the object was created with a row owner from
+  ///  consecutive tab-separated fields with integers without leading zeros,
+  ///  and was not pasted onto since.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline std::string_view RawFields() const {return raw_fields_;}
 
   /// @brief Length of the alignment.
   ///
@@ -454,6 +506,28 @@ class Alignment {
   ///
   /// @{
 
+  /// @brief Returns the approximate number of bytes occupied by the object,
+  ///  including its sequences and pasted identifiers.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline long MemoryUsage() const {
+    return (static_cast<long>(sizeof(Alignment)
+                              + pasted_identifiers_.capacity() * sizeof(int))
+            + qseq_.MemoryUsage() + sseq_.MemoryUsage());
+  }
+
+  /// @brief Returns a copy of the object without sequences, whose only pasted
+  ///  identifier is the object's identifier.
+  ///
+  /// @details Pasting alignments onto the outline in blind mode yields the
+  ///  same coordinates, counts, similarity measures, and ungapped prefix and
+  ///  suffix as pasting them onto the object itself.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  Alignment Outline() const;
+
   /// @brief Compares the object to `other`.
   ///
   /// @exceptions Strong guarantee.
@@ -478,6 +552,8 @@ class Alignment {
   int sstart_;
   int send_;
   bool plus_strand_;
+  int canonical_sstart_;
+  int canonical_send_;
   int nident_;
   int mismatch_;
   int gapopen_;
@@ -485,8 +561,11 @@ class Alignment {
   int qlen_;
   int slen_;
   int length_;
-  std::string qseq_;
-  std::string sseq_;
+  PackedSequence qseq_;
+  PackedSequence sseq_;
+  std::string_view raw_fields_;
+  std::shared_ptr<const void> row_owner_; // Kept while `raw_fields_` is not
+                                          // empty or qseq_ or sseq_ is a view.
   float pident_;
   float raw_score_;
   float bitscore_;
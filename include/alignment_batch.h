@@ -34,6 +34,29 @@ namespace paste_alignments {
 ///
 /// @{
 
+/// @brief Strategies by which `AlignmentBatch::PasteAlignments` pastes a batch.
+///
+enum class BatchEngine {
+
+  /// @brief Greedy strategy without the index used to skip seeds that cannot
+  ///  reach the final score threshold. Chosen for tiny batches.
+  ///
+  kBruteForce,
+
+  /// @brief Greedy strategy skipping seeds by their score bounds.
+  ///
+  kIndexedGreedy,
+
+  /// @brief Greedy strategy applied in parallel to clusters of alignments no
+  ///  pasting can reach across.
+  ///
+  kClusterParallel,
+
+  /// @brief Colinear chaining.
+  ///
+  kChain
+};
+
 /// @brief Container for alignments between a query and a subject sequence.
 ///
 /// @details Alignments can be accessed directly, or sorted by one of:
@@ -43,9 +66,14 @@ namespace paste_alignments {
 ///  * Query start coordinate ascending.
 ///  * Query end coordinate ascending.
 ///
+///  The latter two orders are also kept separately for the alignments on each
+///  strand of the subject.
+///
 /// @invariant The collections ScoreSorted, QstartSorted, and QendSorted each
 ///  consist precisely of the set of integers `{0, 1, ..., Size() - 1}` (as
-///  second coordinate for QstartSorted and QendSorted).
+///  second coordinate for QstartSorted and QendSorted). For either strand,
+///  `StrandQstartSorted` and `StrandQendSorted` are the subsequences of
+///  `QstartSorted` and `QendSorted` referring to the alignments on that strand.
 ///
 class AlignmentBatch {
  public:
@@ -139,6 +167,44 @@ class AlignmentBatch {
     return qend_sorted_;
   }
 
+  /// @brief Indices of stored alignments on the plus strand if `plus_strand`
+  ///  is set, and on the minus strand otherwise, sorted by query start
+  ///  coordinate.
+  ///
+  /// @details Items are as in `AlignmentBatch::QstartSorted`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline const std::vector<std::pair<int,int>>& StrandQstartSorted(
+      bool plus_strand) const {
+    return (plus_strand ? plus_qstart_sorted_ : minus_qstart_sorted_);
+  }
+
+  /// @brief Indices of stored alignments on the plus strand if `plus_strand`
+  ///  is set, and on the minus strand otherwise, sorted by query end
+  ///  coordinate.
+  ///
+  /// @details Items are as in `AlignmentBatch::QendSorted`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline const std::vector<std::pair<int,int>>& StrandQendSorted(
+      bool plus_strand) const {
+    return (plus_strand ? plus_qend_sorted_ : minus_qend_sorted_);
+  }
+
+  /// @brief Alignments removed as redundant by `ResetAlignments`.
+  ///
+  /// @details Each pair holds the identifier of a removed alignment and that of
+  ///  the alignment it is redundant to. Empty unless the parameters passed to
+  ///  `ResetAlignments` request removal of redundant alignments.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline const std::vector<std::pair<int,int>>& Removed() const {
+    return removed_;
+  }
+
   /// @brief String-identifier of the aligned query sequence.
   ///
   /// @exceptions Strong guarantee.
@@ -150,6 +216,43 @@ class AlignmentBatch {
   /// @exceptions Strong guarantee.
   ///
   inline const std::string& Sseqid() const {return sseqid_;}
+
+  /// @brief Number of alignments processed as seeds by the last call to
+  ///  `PasteAlignments`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline int NumSeeds() const {return num_seeds_;}
+
+  /// @brief Number of seeds skipped by the last call to `PasteAlignments`,
+  ///  because no alignment obtainable from them could satisfy the final score
+  ///  threshold.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline int NumPrunedSeeds() const {return num_pruned_seeds_;}
+
+  /// @brief Strategy used by the last call to `PasteAlignments`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline BatchEngine Engine() const {return engine_;}
+
+  /// @brief Number of pasting candidates scanned by the last call to
+  ///  `PasteAlignments` using a greedy strategy.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline long NumScannedCandidates() const {return num_scanned_candidates_;}
+
+  /// @brief Number of seeds not or not completely extended by the last call to
+  ///  `PasteAlignments`, because the candidate budget was exhausted.
+  ///
+  /// @details Positive if and only if the batch was pasted in degraded form.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline int NumUnextendedSeeds() const {return num_unextended_seeds_;}
   /// @}
 
   /// @name Mutators:
@@ -179,11 +282,36 @@ class AlignmentBatch {
   /// @parameter alignments The new contents of the object.
   /// @parameter parameters Additional arguments to handle floating points.
   ///
+  /// @details If `paste_parameters.remove_redundant` is set, exact duplicates
+  ///  and alignments whose query and subject intervals are contained in those
+  ///  of an alignment with the same start diagonal, strand, and at least the
+  ///  same score are not stored, but recorded in `Removed`. Of several
+  ///  equivalent alignments, the one with the smallest identifier is kept.
+  ///  Each alignment is only compared to the kept alignment with the largest
+  ///  query end coordinate preceding it on its diagonal, so not every
+  ///  contained alignment is necessarily removed.
+  ///
   /// @exception Strong guarantee.
   ///
   void ResetAlignments(std::vector<Alignment> alignments,
                        const PasteParameters& paste_parameters);
 
+  /// @brief Recomputes similarity measures of the stored alignments.
+  ///
+  /// @parameter scoring_system Used to compute raw score, bitscore, and evalue.
+  /// @parameter paste_parameters Additional arguments to handle floating
+  ///  points.
+  ///
+  /// @details Equivalent to resetting the object with alignments created
+  ///  using `scoring_system` and `paste_parameters`. Allows pasting a batch
+  ///  parsed once under different scoring systems. Intended for batches not
+  ///  yet pasted.
+  ///
+  /// @exceptions Basic guarantee.
+  ///
+  void UpdateSimilarityMeasures(const ScoringSystem& scoring_system,
+                                const PasteParameters& paste_parameters);
+
   /// @brief Pastes alignments in pastable configuration together.
   ///
   /// @parameter scoring_system Used to compute raw score, bitscore, and evalue
@@ -195,7 +323,55 @@ class AlignmentBatch {
   ///  pasting. Alignments are processed in `ScoreSorted` order. Alignments
   ///  pasted onto others are not processed/pasted again. Alignments which after
   ///  pasting satisfy final thresholds are marked using the
-  ///  `Alignment::IncludeInOutput` function member.
+  ///  `Alignment::IncludeInOutput` function member. Seeds for which an upper
+  ///  bound on the score obtainable by pasting shows that the final score
+  ///  threshold cannot be reached are skipped without searching for pasting
+  ///  candidates; the result is the same as without skipping.
+  ///
+  ///  If `paste_parameters.engine` is `PastingEngine::kChain`, alignments are
+  ///  instead pasted into colinear chains. For each alignment in `QstartSorted`
+  ///  order, it is pasted onto the pastable chain ending to its left yielding
+  ///  the largest pasted score among the highest-scoring chains ending within
+  ///  gap tolerance of its diagonal, using the same rules for pastability as
+  ///  the greedy strategy. Candidate chains are evaluated in descending order
+  ///  of score using a range-maximum tree over the alignments sorted by strand
+  ///  and end diagonal, and at most a fixed number of them is evaluated per
+  ///  alignment, so a better predecessor may be missed. Chains
+  ///  are then pasted in descending order of score, skipping chains containing
+  ///  alignments already pasted and chains of more than one alignment that do
+  ///  not satisfy the final thresholds.
+  ///
+  ///  If `paste_parameters.engine` is `PastingEngine::kAuto`, the greedy
+  ///  strategy is applied in the variant expected to be cheapest, all of which
+  ///  yield the same alignments: Tiny batches are pasted without the index
+  ///  used to skip seeds. Large batches whose alignments split into several
+  ///  clusters, by strand and by query gaps too wide for any pasting of the
+  ///  clusters' alignments to bridge, are pasted cluster by cluster using
+  ///  `paste_parameters.num_threads` threads if no cluster holds most of the
+  ///  alignments. Other batches are pasted as by `PastingEngine::kGreedy`. The
+  ///  variant used is returned by `Engine`. Clusters are not pasted in
+  ///  parallel if a candidate budget is set.
+  ///
+  ///  If `paste_parameters.candidate_budget` is positive, a greedy strategy
+  ///  stops searching for candidates once that many were scanned. The seed
+  ///  being extended then keeps the pastings made permanent so far, and each
+  ///  remaining alignment is output on its own if it satisfies the final
+  ///  thresholds.
+  ///
+  ///  If `paste_parameters.max_alignments_per_batch` is positive, only that
+  ///  many of the alignments satisfying the final thresholds remain marked,
+  ///  chosen by partial selection in the order of `ScoreSorted` applied to
+  ///  their pasted scores. Once the greedy strategies have marked that many
+  ///  alignments, seeds whose score bound does not reach the smallest of the
+  ///  best marked scores are skipped; alignments such a seed would have
+  ///  absorbed remain available to later seeds. Clusters are not pasted in
+  ///  parallel if the number of alignments is limited.
+  ///
+  ///  Positive `paste_parameters.final_evalue` and
+  ///  `paste_parameters.final_bitscore` are converted once, using the query
+  ///  length of the first alignment, into the smallest raw scores satisfying
+  ///  them. Final alignments must reach the largest of them exactly, i.e.
+  ///  without `paste_parameters.float_epsilon`.
   ///
   /// @exceptions Basic guarantee. Position of pasted alignments in
   ///  `ScoreSorted`, `QstartSorted` and `QendSorted` may not agree with the
@@ -209,6 +385,13 @@ class AlignmentBatch {
   ///
   /// @{
 
+  /// @brief Returns the approximate number of bytes occupied by the object,
+  ///  including its alignments and orders.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  long MemoryUsage() const;
+
   /// @brief Compares the object to `other`.
   ///
   /// @exceptions Strong guarantee.
@@ -222,13 +405,75 @@ class AlignmentBatch {
   std::string DebugString() const;
   /// @}
  private:
+  // Pastes alignments into colinear chains (see `PasteAlignments`).
+  //
+  void ChainAlignments(const ScoringSystem& scoring_system,
+                       const PasteParameters& paste_parameters);
+
+  // Pastes alignments greedily (see `PasteAlignments`). Seeds are only skipped
+  // by their score bounds if `prune_seeds` is set.
+  //
+  void GreedyPaste(const ScoringSystem& scoring_system,
+                   const PasteParameters& paste_parameters, bool prune_seeds);
+
+  // Keeps only the best `paste_parameters.max_alignments_per_batch` alignments
+  // in `ScoreSorted` order marked as final, if positive.
+  //
+  void LimitOutput(const PasteParameters& paste_parameters);
+
+  // Returns the positions of alignments grouped into clusters such that no
+  // alignments of different clusters can be pasted together. Positions are
+  // ascending within each cluster.
+  //
+  std::vector<std::vector<int>> IndependentClusters(
+      const ScoringSystem& scoring_system,
+      const PasteParameters& paste_parameters) const;
+
+  // Pastes the alignments of each of `clusters` as a separate batch using
+  // `paste_parameters.num_threads` threads.
+  //
+  void PasteClusters(const std::vector<std::vector<int>>& clusters,
+                     const ScoringSystem& scoring_system,
+                     const PasteParameters& paste_parameters);
+
+  // Fills the orders of each strand's alignments from `qstart_sorted_` and
+  // `qend_sorted_`.
+  //
+  void SplitStrands();
+
   std::string qseqid_;
   std::string sseqid_;
   std::vector<Alignment> alignments_;
   std::vector<int> score_sorted_;
   std::vector<std::pair<int,int>> qstart_sorted_;
   std::vector<std::pair<int,int>> qend_sorted_;
+  std::vector<std::pair<int,int>> plus_qstart_sorted_;
+  std::vector<std::pair<int,int>> minus_qstart_sorted_;
+  std::vector<std::pair<int,int>> plus_qend_sorted_;
+  std::vector<std::pair<int,int>> minus_qend_sorted_;
+  std::vector<std::pair<int,int>> removed_;
+  int num_seeds_{0};
+  int num_pruned_seeds_{0};
+  long num_scanned_candidates_{0l};
+  int num_unextended_seeds_{0};
+  BatchEngine engine_{BatchEngine::kIndexedGreedy};
 };
+
+/// @brief Returns the largest query distance across which two alignments can
+///  be pasted together while pasting alignments whose positive raw scores sum
+///  to at most `score_sum`.
+///
+/// @details Pasting never increases the sum of the pasted alignments' raw
+///  scores. Hence, if alignments sorted by query start are split into parts at
+///  gaps between a query start and all preceding query ends that exceed this
+///  bound for the part on either side, then no alignments of different parts
+///  are pasted together by `AlignmentBatch::PasteAlignments`.
+///
+/// @exceptions Strong guarantee.
+///
+int PastingDistanceBound(double score_sum,
+                         const ScoringSystem& scoring_system,
+                         const PasteParameters& paste_parameters);
 /// @}
 
 } // namespace paste_alignments
@@ -22,9 +22,14 @@
 #define PASTE_ALIGNMENTS_ALIGNMENT_READER_H_
 
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "alignment.h"
 #include "alignment_batch.h"
+#include "memory_budget.h"
+#include "sharding.h"
 
 namespace paste_alignments {
 
@@ -32,6 +37,50 @@ namespace paste_alignments {
 ///
 /// @{
 
+/// @brief Rows of one batch as read from the input, before they are parsed.
+///
+struct RawBatch {
+
+  /// @brief Query sequence identifier shared by the rows.
+  ///
+  std::string qseqid;
+
+  /// @brief Subject sequence identifier shared by the rows.
+  ///
+  std::string sseqid;
+
+  /// @brief Identifier of the first row.
+  ///
+  long first_row_id{1l};
+
+  /// @brief The rows without their line terminators.
+  ///
+  std::vector<std::string> rows;
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Returns the approximate number of bytes held by the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  long MemoryUsage() const;
+
+  /// @brief Compares the object to `other`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool operator==(const RawBatch& other) const;
+
+  /// @brief Returns a descriptive string of the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string DebugString() const;
+  /// @}
+};
+
 /// @brief Class for reading data in a tab-delimited file into `AlignmentBatch`
 ///  objects.
 ///
@@ -52,18 +101,25 @@ class AlignmentReader {
   /// @parameter is Input stream to be associated with the return object.
   /// @parameter num_fields The number of fields per row expected to be read and
   ///  passed to `Alignment::FromStringFields`.
+  /// @parameter range The part of `is` to be read. `range.begin_offset` must be
+  ///  the beginning of a row and `range.end_offset` must be the beginning of a
+  ///  row or the end of `is`.
+  ///
+  /// @details If `range` is empty, the end of data is reached immediately.
   ///
   /// @exceptions Basic guarantee. Modifies `is`.
   ///  * Throws `exceptions::OutOfRange` if `num_fields` is not positive.
   ///  * Throws `exceptions::ReadError` if
   ///    - `is` compares to `nullptr`.
+  ///    - Seeking `range.begin_offset` in `is` fails.
   ///    - While extracting first line from `is`, `failbit` or `badbit` are set.
   ///    - First line in `is` does not contain at least 2 '\t' characters.
   ///    - One of the first two fields in the first line of `is` is empty.
   ///  * `Alignment::FromStringFields` may throw.
   ///
   static AlignmentReader FromIStream(std::unique_ptr<std::istream> is,
-                                     int num_fields = 13);
+                                     int num_fields = 13,
+                                     const InputRange& range = InputRange());
   /// @}
 
   /// @name Constructors:
@@ -95,12 +151,46 @@ class AlignmentReader {
   /// @brief Indicates whether the end of data in the associated input stream
   ///  was reached.
   ///
-  /// @details End of data is reached when stream operations cause `eofbit`,
+  /// @details End of data is reached once the batch containing the last row of
+  ///  the associated input stream, or of its range, was returned by
+  ///  `ReadBatch`.
   ///
   /// @exceptions Strong guarantee.
   ///
   inline bool EndOfData() const {return end_of_data_;}
 
+  /// @brief Returns the offset of the first row not yet returned as part of a
+  ///  batch.
+  ///
+  /// @details Only meaningful while end of data is not reached. Reading an
+  ///  `InputRange` beginning at this offset continues with the next batch.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline long NextBatchOffset() const {return row_offset_;}
+
+  /// @brief Returns the identifier assigned to the next alignment read.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline long NextAlignmentId() const {return next_alignment_id_;}
+
+  /// @brief Returns the query sequence identifier of the next row.
+  ///
+  /// @details Only meaningful while end of data is not reached.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline std::string_view NextQseqid() const {return next_qseqid_;}
+
+  /// @brief Returns the subject sequence identifier of the next row.
+  ///
+  /// @details Only meaningful while end of data is not reached.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline std::string_view NextSseqid() const {return next_sseqid_;}
+
   /// @brief Returns the next batch of alignments read from the associated input
   ///  stream.
   ///
@@ -115,6 +205,78 @@ class AlignmentReader {
   ///
   AlignmentBatch ReadBatch(const ScoringSystem& scoring_system,
                            const PasteParameters& paste_parameters);
+
+  /// @brief Returns the rows of the next batch read from the associated input
+  ///  stream without parsing them.
+  ///
+  /// @details `ReadBatch` is equivalent to passing the result to `ParseBatch`.
+  ///
+  /// @exceptions Basic guarantee. Throws `exceptions::ReadError` if
+  ///  * Function is called after end of data is was reached.
+  ///  * Extracting a row fails or its first two fields are empty.
+  ///
+  RawBatch ReadRawBatch();
+
+  /// @brief Returns the rows of the next batch like `ReadRawBatch` once their
+  ///  memory was acquired from `budget`.
+  ///
+  /// @parameter budget Budget from which the rows' memory is acquired.
+  /// @parameter acquired Replaced with the number of bytes acquired, which the
+  ///  caller releases once the batch is no longer needed.
+  ///
+  /// @details While other holders have acquired memory from `budget`, rows
+  ///  that no longer fit are moved into a temporary file as they are read.
+  ///  They are read back once the memory of the whole batch was acquired, so
+  ///  that a batch waiting for memory is held on disk.
+  ///
+  /// @exceptions Basic guarantee. Throws `exceptions::ReadError` if
+  ///  * Function is called after end of data is was reached.
+  ///  * Extracting a row fails or its first two fields are empty.
+  ///  * The temporary file cannot be written or read.
+  ///
+  RawBatch ReadRawBatch(MemoryBudget& budget, long& acquired);
+
+  /// @brief Converts the rows of `raw_batch` into a batch of alignments.
+  ///
+  /// @parameter raw_batch Rows of a batch returned by `ReadRawBatch`.
+  /// @parameter scoring_system The scoring system by which to sort alignments.
+  /// @parameter paste_parameters Used by `Alignment::FromStringFields` and
+  ///  `AlignmentBatch::ResetAlignments`.
+  ///
+  /// @details If `paste_parameters.sequence_views` is set or executing in
+  ///  blind mode, the rows are shared by the batch's alignments, which refer
+  ///  to their fields as read (and to their sequences, if
+  ///  `paste_parameters.sequence_views` is set) until they are pasted onto.
+  ///
+  /// @exceptions Strong guarantee. Throws `exceptions::ReadError` if
+  ///  * A row does not contain enough fields.
+  ///  * An extracted field is empty.
+  ///  * `Alignment::FromStringFields` may throw.
+  ///
+  AlignmentBatch ParseBatch(RawBatch raw_batch,
+                            const ScoringSystem& scoring_system,
+                            const PasteParameters& paste_parameters) const;
+
+  /// @brief Returns the next row read from the associated input stream as an
+  ///  alignment.
+  ///
+  /// @parameter scoring_system Used by `Alignment::FromStringFields`.
+  /// @parameter paste_parameters Used by `Alignment::FromStringFields`.
+  ///
+  /// @details Reads a batch one alignment at a time. The alignment belongs to
+  ///  the batch identified by `NextQseqid` and `NextSseqid` before the call,
+  ///  which continues as long as they remain unchanged and end of data is not
+  ///  reached.
+  ///
+  /// @exceptions Basic guarantee. Throws `exceptions::ReadError` if
+  ///  * Function is called after end of data is was reached.
+  ///  * The row does not contain enough fields.
+  ///  * An extracted field is empty.
+  ///  * Extracting the following row fails or its first two fields are empty.
+  ///  * `Alignment::FromStringFields` may throw.
+  ///
+  Alignment ReadAlignment(const ScoringSystem& scoring_system,
+                          const PasteParameters& paste_parameters);
   /// @}
 
   /// @name Other:
@@ -132,9 +294,16 @@ class AlignmentReader {
   ///
   AlignmentReader() = default;
 
+  /// @brief Replaces the current row by the next row, or reaches end of data.
+  ///
+  void AdvanceRow();
+
   int num_fields_; // Number of fields passed to `Alignment::FromStringFields`.
   bool end_of_data_{false};
   long next_alignment_id_{1};
+  long end_offset_{-1}; // Offset where reading stops; -1 if end of stream.
+  long row_offset_{0}; // Offset of `row_`.
+  long next_row_offset_{0}; // Offset of the row following `row_`.
   std::unique_ptr<std::istream> is_;
   std::string row_;
   std::string_view next_qseqid_; // Must be non-empty if end_of_data_ is false.
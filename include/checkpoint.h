@@ -0,0 +1,148 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PASTE_ALIGNMENTS_CHECKPOINT_H_
+#define PASTE_ALIGNMENTS_CHECKPOINT_H_
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include "stats_collector.h"
+
+namespace paste_alignments {
+
+/// @addtogroup PasteAlignments-Reference
+///
+/// @{
+
+/// @brief Progress of a run after its last completely written batch.
+///
+/// @details A run can be resumed from a checkpoint by truncating the output
+///  file to `output_offset` and reading the input beginning at `input_offset`,
+///  assigning `next_row_id` to the row found there. A checkpoint may only be
+///  resumed by a run with the same `settings` and `shard`.
+///
+struct Checkpoint {
+
+  /// @brief Input data file of the run.
+  ///
+  std::string input_filename;
+
+  /// @brief Pasting and output settings of the run as returned by
+  ///  `CacheSettings`.
+  ///
+  std::string settings;
+
+  /// @brief Shard of the input file processed by the run in the form
+  ///  `INDEX/COUNT`, or empty if the whole input file is processed.
+  ///
+  std::string shard;
+
+  /// @brief Offset of the first input row not yet processed.
+  ///
+  long input_offset{0l};
+
+  /// @brief Identifier of the row beginning at `input_offset`.
+  ///
+  long next_row_id{1l};
+
+  /// @brief Size of the output file after the last completely written batch.
+  ///
+  long output_offset{0l};
+
+  /// @brief Statistics of the batches processed so far.
+  ///
+  StatsCollector stats_collector;
+
+  /// @name Factories:
+  ///
+  /// @{
+
+  /// @brief Reads a checkpoint written by `Write`.
+  ///
+  /// @parameter is Stream to read the checkpoint from.
+  ///
+  /// @exceptions Basic guarantee. Modifies `is`. Throws `exceptions::ReadError`
+  ///  if the checkpoint cannot be read or is malformed.
+  ///
+  static Checkpoint FromIStream(std::istream& is);
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Writes the checkpoint into `os`.
+  ///
+  /// @exceptions Basic guarantee. Modifies `os`.
+  ///
+  void Write(std::ostream& os) const;
+
+  /// @brief Compares the object to `other`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool operator==(const Checkpoint& other) const;
+
+  /// @brief Returns a descriptive string of the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string DebugString() const;
+  /// @}
+};
+
+/// @name checkpoint
+///
+/// @{
+
+/// @brief Returns the name of the checkpoint file of a run writing its output
+///  into `output_filename`.
+///
+/// @exceptions Strong guarantee.
+///
+std::string CheckpointFilename(const std::string& output_filename);
+
+/// @brief Writes `checkpoint` into the file `filename`.
+///
+/// @details The checkpoint is written into a temporary file which is synced
+///  to disk and then renamed, so that `filename` always contains a complete
+///  checkpoint.
+///
+/// @exceptions Basic guarantee. Throws `exceptions::ReadError` if the file
+///  cannot be written, synced, or renamed.
+///
+void SaveCheckpoint(const Checkpoint& checkpoint, const std::string& filename);
+
+/// @brief Flushes data of the file `filename` buffered by the operating system
+///  to disk.
+///
+/// @exceptions Strong guarantee. Throws `exceptions::ReadError` if the file
+///  cannot be opened or synced.
+///
+void SyncFile(const std::string& filename);
+/// @}
+
+/// @}
+
+} // namespace paste_alignments
+
+#endif // PASTE_ALIGNMENTS_CHECKPOINT_H_
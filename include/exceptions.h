@@ -72,6 +72,12 @@ struct ReadError final : public BaseException {
   using BaseException::BaseException;
 };
 
+/// @brief Thrown when error occurred while writing output data.
+///
+struct WriteError final : public BaseException {
+  using BaseException::BaseException;
+};
+
 /// @brief Thrown when error occurred while pasting alignments.
 ///
 struct PastingError final : public BaseException {
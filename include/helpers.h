@@ -22,6 +22,7 @@
 #include <charconv>
 #include <cmath>
 #include <cstring>
+#include <functional>
 #include <sstream>
 #include <string>
 #include <system_error>
@@ -274,6 +275,19 @@ inline float MegablastExtendCost(int reward, int penalty) {
   return (reward / 2.0f) + penalty;
 }
 
+/// @brief Calls `task` for each integer in [0, `num_tasks`) using a pool of
+///  `num_threads` worker threads, including the calling thread.
+///
+/// @details Each worker takes the next task until none are left. If a task
+///  fails, no further tasks are started and the first exception is rethrown
+///  once all workers have finished.
+///
+/// @exceptions Basic guarantee. Throws `exceptions::OutOfRange` if
+///  `num_threads` is not positive.
+///
+void RunTasks(int num_tasks, int num_threads,
+              const std::function<void(int)>& task);
+
 } // namespace helpers
 
 } // namespace paste_alignments
@@ -0,0 +1,131 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PASTE_ALIGNMENTS_HIT_SELECTION_H_
+#define PASTE_ALIGNMENTS_HIT_SELECTION_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "alignment_batch.h"
+#include "paste_output.h"
+
+namespace paste_alignments {
+
+/// @addtogroup PasteAlignments-Reference
+///
+/// @{
+
+/// @brief Keeps the best output alignments of each query across consecutive
+///  batches.
+///
+/// @details Alignments are ranked like in `AlignmentBatch::ScoreSorted`: by
+///  raw score, then percent identity, both descending and compared with
+///  `helpers::FuzzyFloatEquals`, and then by the order in which they were
+///  added. The best alignments of the current query are kept in a bounded heap
+///  as formatted output lines together with their subject sequence
+///  identifiers, so memory is proportional to the maximum number of hits.
+///  Once a batch of another query is added, or on `Flush`, the kept lines are
+///  passed on in the order in which they were added, one call per run of lines
+///  of the same subject. Each query is expected to occupy consecutive batches;
+///  a query occurring again later is treated as a new query.
+///
+class QueryHitSelector {
+ public:
+  /// @brief Receives the query and subject sequence identifiers and the
+  ///  output lines of a run of kept alignments.
+  ///
+  using WriteFunction = std::function<void(const std::string&,
+                                           const std::string&,
+                                           const std::string&)>;
+
+  /// @name Constructors:
+  ///
+  /// @{
+
+  /// @brief Keeps at most `max_hits` alignments per query, written with
+  ///  `format` and passed to `write`.
+  ///
+  /// @parameter float_epsilon Tolerance of score and percent identity
+  ///  comparisons (see `PasteParameters::float_epsilon`).
+  ///
+  /// @exceptions Strong guarantee. Throws `exceptions::OutOfRange` if
+  ///  `max_hits` is not positive.
+  ///
+  QueryHitSelector(int max_hits, const OutputFormat& format,
+                   float float_epsilon, WriteFunction write);
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Offers the alignments of `batch` marked as final.
+  ///
+  /// @details Passes on the kept alignments of the previous query first if
+  ///  `batch` belongs to another query.
+  ///
+  /// @exceptions Basic guarantee.
+  ///
+  void Add(const AlignmentBatch& batch);
+
+  /// @brief Passes on the kept alignments of the current query.
+  ///
+  /// @exceptions Basic guarantee.
+  ///
+  void Flush();
+
+  /// @brief Returns the number of alignments kept for the current query.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline int NumHits() const {return static_cast<int>(heap_.size());}
+  /// @}
+
+ private:
+  // A kept alignment.
+  struct Hit {
+    float score{0.0f};
+    float pident{0.0f};
+    long sequence{0l}; // Position among the query's offered alignments.
+    std::shared_ptr<const std::string> sseqid; // Shared by hits of a subject.
+    std::string line;
+  };
+
+  // Returns whether `first` ranks before `second`.
+  //
+  bool Better(const Hit& first, const Hit& second) const;
+
+  int max_hits_;
+  OutputFormat format_;
+  float float_epsilon_;
+  WriteFunction write_;
+  std::string qseqid_;
+  std::shared_ptr<const std::string> sseqid_; // Subject of the last hit added.
+  std::vector<Hit> heap_; // Worst kept alignment first.
+  long next_sequence_{0l};
+};
+/// @}
+
+} // namespace paste_alignments
+
+#endif // PASTE_ALIGNMENTS_HIT_SELECTION_H_
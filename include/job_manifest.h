@@ -0,0 +1,155 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PASTE_ALIGNMENTS_JOB_MANIFEST_H_
+#define PASTE_ALIGNMENTS_JOB_MANIFEST_H_
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace paste_alignments {
+
+/// @addtogroup PasteAlignments-Reference
+///
+/// @{
+
+/// @brief Describes one input file to be processed in manifest mode.
+///
+struct ManifestEntry {
+
+  /// @brief Input data file.
+  ///
+  std::string input_filename;
+
+  /// @brief Output data file.
+  ///
+  std::string output_filename;
+
+  /// @brief Statistics data file. Empty if no statistics are requested.
+  ///
+  std::string stats_filename;
+
+  /// @brief Configuration file used for this entry instead of the one passed
+  ///  on the command line. Empty if no override is requested.
+  ///
+  std::string configuration_filename;
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Compares the object to `other`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool operator==(const ManifestEntry& other) const;
+
+  /// @brief Returns a descriptive string of the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string DebugString() const;
+  /// @}
+};
+
+/// @brief Describes one set of parameters to be used in sweep mode.
+///
+struct SweepEntry {
+
+  /// @brief Configuration file holding the set's parameters. Empty if only
+  ///  the parameters passed on the command line are used.
+  ///
+  std::string configuration_filename;
+
+  /// @brief Output data file.
+  ///
+  std::string output_filename;
+
+  /// @brief Statistics data file. Empty if no statistics are requested.
+  ///
+  std::string stats_filename;
+
+  /// @brief Summary file. Empty if no summary is requested.
+  ///
+  std::string summary_filename;
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Compares the object to `other`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool operator==(const SweepEntry& other) const;
+
+  /// @brief Returns a descriptive string of the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string DebugString() const;
+  /// @}
+};
+
+/// @name job_manifest
+///
+/// @{
+
+/// @brief Reads the list of jobs described by a manifest file.
+///
+/// @parameter is Stream to read the manifest from.
+///
+/// @details Each non-empty line not starting with '#' describes one job by the
+///  tab-separated columns: input file, output file, and optionally statistics
+///  file and configuration file. A column consisting of a single '-' is treated
+///  as absent.
+///
+/// @exceptions Basic guarantee. Modifies `is`. Throws `exceptions::ReadError`
+///  if
+///  * `badbit` of `is` is set while reading.
+///  * A line has fewer than 2 or more than 4 columns.
+///  * The input or output column of a line is empty or '-'.
+///
+std::vector<ManifestEntry> ReadManifest(std::istream& is);
+
+/// @brief Reads the list of parameter sets described by a sweep file.
+///
+/// @parameter is Stream to read the sweep file from.
+///
+/// @details Each non-empty line not starting with '#' describes one parameter
+///  set by the tab-separated columns: configuration file, output file, and
+///  optionally statistics file and summary file. A column consisting of a
+///  single '-' is treated as absent.
+///
+/// @exceptions Basic guarantee. Modifies `is`. Throws `exceptions::ReadError`
+///  if
+///  * `badbit` of `is` is set while reading.
+///  * A line has fewer than 2 or more than 4 columns.
+///  * The output column of a line is empty or '-'.
+///
+std::vector<SweepEntry> ReadSweepFile(std::istream& is);
+/// @}
+
+/// @}
+
+} // namespace paste_alignments
+
+#endif // PASTE_ALIGNMENTS_JOB_MANIFEST_H_
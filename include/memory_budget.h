@@ -0,0 +1,153 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PASTE_ALIGNMENTS_MEMORY_BUDGET_H_
+#define PASTE_ALIGNMENTS_MEMORY_BUDGET_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+namespace paste_alignments {
+
+/// @addtogroup PasteAlignments-Reference
+///
+/// @{
+
+/// @brief Accounts the memory held by batches and statistics against a
+///  maximum shared by all threads of a run.
+///
+/// @details Memory is either acquired for a short time, such as by a batch
+///  while it is pasted, or reserved for a long time, such as by collected
+///  statistics. Acquiring waits while memory acquired by other holders
+///  prevents the total from staying within the maximum, so that holders take
+///  turns instead of exceeding it. A single acquisition larger than the
+///  maximum proceeds once no other memory is acquired. Reserving never waits,
+///  but fails if the total would exceed the maximum, in which case the holder
+///  is expected to free memory, e.g. by spilling it to disk. Memory is
+///  unlimited if the maximum is 0. All operations are synchronized.
+///
+class MemoryBudget {
+ public:
+  /// @name Constructors:
+  ///
+  /// @{
+
+  /// @brief Creates a budget of `max_bytes` bytes.
+  ///
+  /// @parameter max_bytes Maximum total of acquired and reserved memory, or 0
+  ///  if unlimited.
+  ///
+  /// @exceptions Strong guarantee. Throws `exceptions::OutOfRange` if
+  ///  `max_bytes` is negative.
+  ///
+  explicit MemoryBudget(long max_bytes = 0l);
+
+  MemoryBudget(const MemoryBudget& other) = delete;
+  /// @}
+
+  /// @name Assignment:
+  ///
+  /// @{
+
+  MemoryBudget& operator=(const MemoryBudget& other) = delete;
+  /// @}
+
+  /// @name Accessors:
+  ///
+  /// @{
+
+  /// @brief Returns the maximum, or 0 if memory is unlimited.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline long MaxBytes() const {return max_bytes_;}
+
+  /// @brief Returns the total of acquired and reserved memory.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  long Used() const;
+
+  /// @brief Returns the memory currently acquired, excluding reserved memory.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  long Acquired() const;
+  /// @}
+
+  /// @name Accounting:
+  ///
+  /// @{
+
+  /// @brief Indicates whether `bytes` more bytes fit into the budget.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool Fits(long bytes) const;
+
+  /// @brief Accounts `bytes` bytes held for a short time.
+  ///
+  /// @details Waits while the bytes do not fit and other acquired memory may
+  ///  still be released.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  void Acquire(long bytes);
+
+  /// @brief Releases `bytes` bytes previously passed to `Acquire`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  void Release(long bytes);
+
+  /// @brief Accounts `bytes` bytes held for a long time if they fit.
+  ///
+  /// @details Returns whether the bytes were accounted. Negative `bytes`
+  ///  return previously reserved memory and always succeed.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool Reserve(long bytes);
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Returns a descriptive string of the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string DebugString() const;
+  /// @}
+
+ private:
+  long max_bytes_;
+  long acquired_{0l};
+  long reserved_{0l};
+  mutable std::mutex mutex_;
+  std::condition_variable released_;
+};
+/// @}
+
+} // namespace paste_alignments
+
+#endif // PASTE_ALIGNMENTS_MEMORY_BUDGET_H_
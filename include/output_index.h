@@ -0,0 +1,186 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PASTE_ALIGNMENTS_OUTPUT_INDEX_H_
+#define PASTE_ALIGNMENTS_OUTPUT_INDEX_H_
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace paste_alignments {
+
+/// @addtogroup PasteAlignments-Reference
+///
+/// @{
+
+/// @brief Locates the output of one batch within an output file.
+///
+/// @details An index file lists one entry per batch with output alignments as
+///  a line with tab-separated columns: query sequence identifier, subject
+///  sequence identifier, offset of the batch's first byte in the output file,
+///  number of bytes, and number of rows.
+///
+struct OutputIndexEntry {
+
+  /// @brief Query sequence identifier.
+  ///
+  std::string qseqid;
+
+  /// @brief Subject sequence identifier.
+  ///
+  std::string sseqid;
+
+  /// @brief Offset of the batch's first byte in the output file.
+  ///
+  long offset{0l};
+
+  /// @brief Number of bytes of the batch's output.
+  ///
+  long size{0l};
+
+  /// @brief Number of output rows of the batch.
+  ///
+  long num_rows{0l};
+
+  /// @name Factories:
+  ///
+  /// @{
+
+  /// @brief Creates an entry from a line of an index file without its line
+  ///  break.
+  ///
+  /// @exceptions Strong guarantee. Throws `exceptions::ParsingError` if the
+  ///  line does not have five columns, or if one of the numbers is malformed
+  ///  or negative.
+  ///
+  static OutputIndexEntry FromString(std::string_view line);
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Writes the entry into `os` as a line of an index file.
+  ///
+  /// @exceptions Basic guarantee. Modifies `os`.
+  ///
+  void Write(std::ostream& os) const;
+
+  /// @brief Compares the object to `other`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool operator==(const OutputIndexEntry& other) const;
+
+  /// @brief Returns a descriptive string of the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string DebugString() const;
+  /// @}
+};
+
+/// @brief Writes the index entries of the batches written into an output
+///  file.
+///
+/// @details Consecutive output of the same batch, e.g. the parts of a batch
+///  pasted as a stream, is recorded as a single entry. Entries are written
+///  once the next batch begins, or on `Flush`.
+///
+class OutputIndexWriter {
+ public:
+  /// @name Constructors:
+  ///
+  /// @{
+
+  /// @brief Writes the index into `os`, which must outlive the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  explicit OutputIndexWriter(std::ostream& os) : os_{&os} {}
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Records `num_rows` rows of the batch of `qseqid` and `sseqid`
+  ///  written into the `size` bytes of the output file beginning at `offset`.
+  ///
+  /// @details Nothing is recorded if `num_rows` is 0.
+  ///
+  /// @exceptions Basic guarantee.
+  ///
+  void Add(std::string_view qseqid, std::string_view sseqid, long offset,
+           long size, long num_rows);
+
+  /// @brief Writes the pending entry, if any, and flushes the stream.
+  ///
+  /// @exceptions Basic guarantee.
+  ///
+  void Flush();
+  /// @}
+
+ private:
+  std::ostream* os_;
+  OutputIndexEntry pending_;
+  bool has_pending_{false};
+};
+
+/// @name output index
+///
+/// @{
+
+/// @brief Returns the name of the index file of the output file
+///  `output_filename`.
+///
+/// @exceptions Strong guarantee.
+///
+std::string OutputIndexFilename(const std::string& output_filename);
+
+/// @brief Reads all entries of an index file.
+///
+/// @exceptions Basic guarantee. Modifies `is`. Throws
+///  `exceptions::ParsingError` if a line is malformed.
+///
+std::vector<OutputIndexEntry> ReadOutputIndex(std::istream& is);
+
+/// @brief Removes the entries of the index file `filename` that do not lie
+///  within the first `output_size` bytes of its output file.
+///
+/// @details Used when an output file is truncated to resume a run. Reading
+///  stops at the first incomplete or malformed line, as left by an
+///  interrupted run.
+///
+/// @exceptions Basic guarantee.
+///  * Throws `exceptions::ReadError` if the file cannot be read.
+///  * Throws `exceptions::WriteError` if the file cannot be rewritten.
+///
+void TruncateOutputIndex(const std::string& filename, long output_size);
+/// @}
+
+/// @}
+
+} // namespace paste_alignments
+
+#endif // PASTE_ALIGNMENTS_OUTPUT_INDEX_H_
@@ -0,0 +1,256 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PASTE_ALIGNMENTS_OUTPUT_SINK_H_
+#define PASTE_ALIGNMENTS_OUTPUT_SINK_H_
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+struct gzFile_s;
+
+namespace paste_alignments {
+
+/// @addtogroup PasteAlignments-Reference
+///
+/// @{
+
+/// @brief Destination of output data, written in chunks.
+///
+/// @details Implementations count the bytes passed to `Write`, whether or not
+///  they are stored. Data may be buffered until `Flush` is called or the sink
+///  is destroyed.
+///
+class OutputSink {
+ public:
+  /// @name Constructors:
+  ///
+  /// @{
+
+  OutputSink() = default;
+
+  OutputSink(const OutputSink& other) = delete;
+
+  virtual ~OutputSink() = default;
+  /// @}
+
+  /// @name Assignment:
+  ///
+  /// @{
+
+  OutputSink& operator=(const OutputSink& other) = delete;
+  /// @}
+
+  /// @name Accessors:
+  ///
+  /// @{
+
+  /// @brief Number of bytes passed to `Write` so far.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline long BytesWritten() const {return bytes_written_;}
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Writes `data`.
+  ///
+  /// @exceptions Basic guarantee. Throws `exceptions::WriteError` if the
+  ///  data cannot be written.
+  ///
+  void Write(std::string_view data);
+
+  /// @brief Passes buffered data on to the sink's destination.
+  ///
+  /// @exceptions Basic guarantee. Throws `exceptions::WriteError` if the
+  ///  data cannot be written.
+  ///
+  virtual void Flush() {}
+  /// @}
+
+ protected:
+  // Stores or discards `data`.
+  //
+  virtual void DoWrite(std::string_view data) = 0;
+
+ private:
+  long bytes_written_{0};
+};
+
+/// @brief Writes into a file through an `std::ofstream`, or into standard
+///  output.
+///
+class FileSink final : public OutputSink {
+ public:
+  /// @brief Opens file `filename`, or uses standard output if `filename` is
+  ///  empty.
+  ///
+  /// @parameter append Whether to append to an existing file instead of
+  ///  truncating it.
+  ///
+  /// @exceptions Strong guarantee. Throws `exceptions::WriteError` if the file
+  ///  cannot be opened.
+  ///
+  explicit FileSink(const std::string& filename, bool append = false);
+
+  void Flush() override;
+
+ protected:
+  void DoWrite(std::string_view data) override;
+
+ private:
+  std::ofstream ofs_;
+  std::ostream* os_;
+};
+
+/// @brief Writes into a file descriptor with `write` calls of a buffer of
+///  fixed size.
+///
+class FdSink final : public OutputSink {
+ public:
+  /// @brief Opens file `filename`, or uses standard output if `filename` is
+  ///  empty.
+  ///
+  /// @parameter append Whether to append to an existing file instead of
+  ///  truncating it.
+  /// @parameter buffer_size Number of bytes collected per `write` call.
+  ///
+  /// @exceptions Strong guarantee. Throws `exceptions::WriteError` if the file
+  ///  cannot be opened.
+  ///
+  explicit FdSink(const std::string& filename, bool append = false,
+                  long buffer_size = 1l << 20);
+
+  /// @brief Writes remaining buffered data and closes the file.
+  ///
+  /// @details Write errors are ignored; call `Flush` first to detect them.
+  ///
+  ~FdSink() override;
+
+  void Flush() override;
+
+ protected:
+  void DoWrite(std::string_view data) override;
+
+ private:
+  // Writes all of `data` into the file descriptor.
+  //
+  void WriteFully(std::string_view data);
+
+  int fd_;
+  bool owns_fd_;
+  long buffer_size_;
+  std::string buffer_;
+};
+
+/// @brief Keeps the written data in memory.
+///
+class MemorySink final : public OutputSink {
+ public:
+  /// @brief The data written so far.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline const std::string& Data() const {return data_;}
+
+  /// @brief Moves the data written so far out of the sink and clears it.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string Release();
+
+ protected:
+  void DoWrite(std::string_view data) override;
+
+ private:
+  std::string data_;
+};
+
+/// @brief Writes gzip-compressed data into a file, or into standard output.
+///
+class GzipSink final : public OutputSink {
+ public:
+  /// @brief Opens file `filename`, or uses standard output if `filename` is
+  ///  empty.
+  ///
+  /// @exceptions Strong guarantee. Throws `exceptions::WriteError` if the file
+  ///  cannot be opened.
+  ///
+  explicit GzipSink(const std::string& filename);
+
+  /// @brief Completes the compressed stream and closes the file.
+  ///
+  /// @details Write errors are ignored; call `Flush` first to detect them.
+  ///
+  ~GzipSink() override;
+
+  /// @brief Compresses buffered data and writes it to the file.
+  ///
+  /// @details Flushing often degrades compression.
+  ///
+  void Flush() override;
+
+ protected:
+  void DoWrite(std::string_view data) override;
+
+ private:
+  gzFile_s* file_;
+};
+
+/// @brief Discards the written data, counting only its bytes.
+///
+/// @details Used to measure pasting without the cost of output.
+///
+class NullSink final : public OutputSink {
+ protected:
+  inline void DoWrite(std::string_view) override {}
+};
+
+/// @name output_sink
+///
+/// @{
+
+/// @brief Creates the sink named `kind` writing into file `filename`, or into
+///  standard output if `filename` is empty.
+///
+/// @parameter kind One of `file`, `fd`, `gzip`, and `null`.
+/// @parameter append Whether to append to an existing file instead of
+///  truncating it. Not supported by `gzip`.
+///
+/// @exceptions Strong guarantee.
+///  * Throws `exceptions::ParsingError` if `kind` is unknown, or if `append`
+///    is set for `gzip`.
+///  * Throws `exceptions::WriteError` if the file cannot be opened.
+///
+std::unique_ptr<OutputSink> OpenOutputSink(std::string_view kind,
+                                           const std::string& filename,
+                                           bool append = false);
+/// @}
+
+/// @}
+
+} // namespace paste_alignments
+
+#endif // PASTE_ALIGNMENTS_OUTPUT_SINK_H_
@@ -0,0 +1,252 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PASTE_ALIGNMENTS_PACKED_SEQUENCE_H_
+#define PASTE_ALIGNMENTS_PACKED_SEQUENCE_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace paste_alignments {
+
+/// @addtogroup PasteAlignments-Reference
+///
+/// @{
+
+/// @brief Aligned nucleotide sequence stored with two bits per base.
+///
+/// @details The bases `A`, `C`, `G` and `T` are packed 32 to a 64-bit word.
+///  Every other character, such as `N`, the gap character `-`, ambiguity codes
+///  or lowercase bases, is kept in a side table of runs of equal characters,
+///  and its position is packed as `A`. Sequences are unpacked only when they
+///  are written, so that sequences pasted together are never held one byte
+///  per base.
+///
+///  Alternatively, a sequence may be a view of characters held elsewhere,
+///  such as in the rows of a batch read from the input. Views are packed
+///  when first modified, so that sequences written unchanged are never
+///  copied.
+///
+/// @invariant Views hold no words and runs.
+/// @invariant Bits of the last word past the sequence's length are zero.
+/// @invariant Runs are sorted, disjoint, non-empty, and adjacent runs hold
+///  different characters.
+///
+class PackedSequence {
+ public:
+  /// @name Constructors:
+  ///
+  /// @{
+
+  /// @brief Creates an empty sequence.
+  ///
+  PackedSequence() = default;
+
+  /// @brief Packs `sequence`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  static PackedSequence FromString(std::string_view sequence);
+
+  /// @brief Refers to `sequence` without copying it.
+  ///
+  /// @details The characters of `sequence` must outlive the object and its
+  ///  copies, unless they are modified first.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  static PackedSequence View(std::string_view sequence);
+
+  /// @brief Copy constructor.
+  ///
+  PackedSequence(const PackedSequence& other) = default;
+
+  /// @brief Move constructor.
+  ///
+  PackedSequence(PackedSequence&& other) noexcept = default;
+  /// @}
+
+  /// @name Assignment:
+  ///
+  /// @{
+
+  /// @brief Copy assignment.
+  ///
+  /// @details Capacity grows at least geometrically, so that repeatedly
+  ///  assigning a growing sequence takes amortized linear time in allocations.
+  ///
+  PackedSequence& operator=(const PackedSequence& other);
+
+  /// @brief Move assignment.
+  ///
+  PackedSequence& operator=(PackedSequence&& other) noexcept = default;
+  /// @}
+
+  /// @name Accessors:
+  ///
+  /// @{
+
+  /// @brief Number of characters of the sequence.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline int Length() const {return length_;}
+
+  /// @brief Indicates whether the sequence is empty.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline bool Empty() const {return length_ == 0;}
+
+  /// @brief Indicates whether the object is a view of characters held
+  ///  elsewhere.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline bool IsView() const {return view_.data() != nullptr;}
+
+  /// @brief Returns the character at position `pos`.
+  ///
+  /// @exceptions Strong guarantee. Throws `exceptions::OutOfRange` if `pos` is
+  ///  not a position of the sequence.
+  ///
+  char At(int pos) const;
+
+  /// @brief Returns the unpacked sequence.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string ToString() const;
+
+  /// @brief Appends the unpacked sequence to `target`.
+  ///
+  /// @exceptions Basic guarantee.
+  ///
+  void AppendTo(std::string& target) const;
+  /// @}
+
+  /// @name Mutators:
+  ///
+  /// @{
+
+  /// @brief Reserves space for `length` characters.
+  ///
+  /// @details Capacity grows at least geometrically, so that repeatedly
+  ///  reserving space for appended characters takes amortized linear time.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  void Reserve(int length);
+
+  /// @brief Shortens the sequence to its first `length` characters.
+  ///
+  /// @exceptions Strong guarantee. Throws `exceptions::OutOfRange` if `length`
+  ///  is negative or exceeds the sequence's length.
+  ///
+  void Truncate(int length);
+
+  /// @brief Appends `count` copies of `character`.
+  ///
+  /// @exceptions Basic guarantee. Throws `exceptions::OutOfRange` if `count` is
+  ///  negative.
+  ///
+  void AppendRun(char character, int count);
+
+  /// @brief Appends the `length` characters of `other` starting at `begin`.
+  ///
+  /// @details `other` must not be the object itself.
+  ///
+  /// @exceptions Basic guarantee. Throws `exceptions::OutOfRange` if the
+  ///  characters are not all part of `other`.
+  ///
+  void Append(const PackedSequence& other, int begin, int length);
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Returns the number of bytes the sequence occupies on the heap,
+  ///  or the number of characters it refers to if it is a view.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  long MemoryUsage() const;
+
+  /// @brief Compares the sequences character by character.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool operator==(const PackedSequence& other) const;
+
+  /// @brief Compares the sequences character by character.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline bool operator!=(const PackedSequence& other) const {
+    return !(*this == other);
+  }
+  /// @}
+
+ private:
+  // Run of `length` copies of a character which is not packed.
+  //
+  struct Run {
+    int begin;
+    int length;
+    char character;
+
+    inline bool operator==(const Run& other) const {
+      return (begin == other.begin && length == other.length
+              && character == other.character);
+    }
+  };
+
+  // Returns the codes of the `count` bases starting at `pos`, with the first
+  // base in the lowest bits. Assumes 0 < `count` <= 32.
+  //
+  std::uint64_t GetCodes(int pos, int count) const;
+
+  // Appends the `count` bases coded by `codes`. Assumes 0 < `count` <= 32 and
+  // that higher bits of `codes` are zero.
+  //
+  void PutCodes(std::uint64_t codes, int count);
+
+  // Packs the characters of a view.
+  //
+  void Materialize();
+
+  // Marks the `length` characters starting at `begin` as copies of
+  // `character`. Assumes that they are the last characters of the sequence.
+  //
+  void AddRun(int begin, int length, char character);
+
+  std::vector<std::uint64_t> words_;
+  std::vector<Run> runs_;
+  std::string_view view_; // Viewed characters; null unless a view.
+  int length_{0};
+};
+/// @}
+
+} // namespace paste_alignments
+
+#endif // PASTE_ALIGNMENTS_PACKED_SEQUENCE_H_
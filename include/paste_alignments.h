@@ -24,12 +24,21 @@
 #include "alignment.h"
 #include "alignment_batch.h"
 #include "alignment_reader.h"
+#include "checkpoint.h"
 #include "exceptions.h"
 #include "helpers.h"
+#include "hit_selection.h"
+#include "job_manifest.h"
+#include "memory_budget.h"
+#include "output_index.h"
+#include "output_sink.h"
 #include "paste_output.h"
 #include "paste_parameters.h"
+#include "result_cache.h"
 #include "scoring_system.h"
+#include "sharding.h"
 #include "stats_collector.h"
+#include "streaming.h"
 
 /// @defgroup PasteAlignments-Reference
 ///
@@ -21,10 +21,16 @@
 #ifndef PASTE_ALIGNMENTS_PASTE_OUTPUT_H_
 #define PASTE_ALIGNMENTS_PASTE_OUTPUT_H_
 
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "alignment_batch.h"
+#include "output_sink.h"
 #include "paste_parameters.h"
 
 namespace paste_alignments {
@@ -33,20 +39,311 @@ namespace paste_alignments {
 ///
 /// @{
 
+/// @brief Columns written for each output alignment, compiled into one writer
+///  per column.
+///
+/// @details Available columns are: qseqid sseqid qstart qend sstart send
+///  nident mismatch gapopen gaps qlen slen length qseq sseq pident score
+///  bitscore evalue nmatches rows. The default columns are all of them, except
+///  qseq and sseq in blind mode. The rows column is written either as a plain
+///  comma-separated list of row identifiers, or compactly with runs of
+///  consecutive identifiers as ranges (see `AppendRowRanges`).
+///
+class OutputFormat {
+ public:
+  /// @name Factories:
+  ///
+  /// @{
+
+  /// @brief Compiles a comma-separated list of column names.
+  ///
+  /// @parameter columns The column names in output order. The default columns
+  ///  are used if empty.
+  /// @parameter blind_mode Whether executing in blind mode.
+  /// @parameter compact_rows Whether to write the rows column as ranges.
+  ///
+  /// @exceptions Strong guarantee. Throws `exceptions::ParsingError` if
+  ///  * A column name is empty or unknown.
+  ///  * Column qseq or sseq is requested in blind mode.
+  ///
+  static OutputFormat FromString(std::string_view columns, bool blind_mode,
+                                 bool compact_rows);
+  /// @}
+
+  /// @name Accessors:
+  ///
+  /// @{
+
+  /// @brief Number of columns written for each alignment.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline int NumColumns() const {return num_columns_;}
+
+  /// @brief Zero-based position of the last rows column, or -1 if the rows
+  ///  column is not written.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline int RowsColumn() const {return rows_column_;}
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Appends the columns of `alignment` from `batch` as a line to
+  ///  `line`.
+  ///
+  /// @exceptions Basic guarantee.
+  ///
+  void Write(const AlignmentBatch& batch, const Alignment& alignment,
+             std::string& line) const;
+  /// @}
+
+ private:
+  // Writes one or more columns of an alignment.
+  //
+  using FieldWriter = void (*)(const AlignmentBatch& batch,
+                               const Alignment& alignment,
+                               std::string& line);
+
+  std::vector<FieldWriter> writers_;
+  int num_columns_{0};
+  int rows_column_{-1};
+};
+
+/// @brief Location of one batch's block in a binary output file.
+///
+struct BinaryBatchEntry {
+  /// @brief Byte offset of the block from the beginning of the file.
+  ///
+  long offset{0};
+
+  /// @brief Size of the block in bytes.
+  ///
+  long size{0};
+
+  /// @brief Number of alignments in the block.
+  ///
+  long num_rows{0};
+
+  /// @brief Query sequence identifier of the batch.
+  ///
+  std::string qseqid;
+
+  /// @brief Subject sequence identifier of the batch.
+  ///
+  std::string sseqid;
+};
+
+/// @brief Writes output alignments in a binary columnar format.
+///
+/// @details The file starts with a 16 byte header: the magic string
+///  `PASTEBC1`, the 32 bit unsigned integer `0x01020304` in the writer's byte
+///  order, and 32 bit flags, of which bit 0 indicates that sequences are
+///  included. It is followed by one block per batch with output alignments,
+///  a string table, an index, and a 40 byte trailer.
+///
+///  Each block holds one array per column with one value per alignment, in
+///  the order: qstart qend sstart send nident mismatch gapopen gaps qlen slen
+///  length (32 bit signed integers), pident score bitscore (32 bit floats),
+///  evalue (64 bit float), nmatches (32 bit signed integer), and the rows
+///  column. Variable-length columns are given by an array of `n + 1` 32 bit
+///  unsigned offsets followed by the concatenated values, i.e. 32 bit signed
+///  row identifiers for rows, and characters for qseq and sseq, which follow
+///  rows if sequences are included. Subject coordinates are stored in their
+///  output order. Each array is zero-padded to a multiple of 8 bytes, and
+///  blocks start at multiples of 8 bytes, so that a mapped file can be read in
+///  place.
+///
+///  The string table holds the concatenated sequence identifiers. The index
+///  has one entry per block of five 64 bit unsigned integers: block offset,
+///  block size, number of alignments, and offset into the string table of the
+///  qseqid and the sseqid, followed by the two 32 bit unsigned lengths of the
+///  identifiers. The trailer holds the 64 bit unsigned offset and size of the
+///  string table, the offset of the index, and the number of blocks, followed
+///  by the magic string.
+///
+class BinaryWriter {
+ public:
+  /// @name Constructors:
+  ///
+  /// @{
+
+  /// @brief Writes the header into `sink`.
+  ///
+  /// @parameter sink Sink the binary output is written into. Must outlive the
+  ///  object.
+  /// @parameter write_sequences Whether to include columns qseq and sseq.
+  ///
+  /// @exceptions Basic guarantee.
+  ///
+  BinaryWriter(OutputSink& sink, bool write_sequences);
+  /// @}
+
+  /// @name Accessors:
+  ///
+  /// @{
+
+  /// @brief Number of blocks written.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline int NumBatches() const {return static_cast<int>(index_.size());}
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Writes the alignments of `batch` marked as final as one block.
+  ///
+  /// @details Nothing is written if no alignment is marked as final.
+  ///
+  /// @exceptions Basic guarantee.
+  ///
+  void WriteBatch(const AlignmentBatch& batch);
+
+  /// @brief Writes string table, index, and trailer.
+  ///
+  /// @details Must be called once after the last batch is written; the file is
+  ///  incomplete otherwise.
+  ///
+  /// @exceptions Basic guarantee.
+  ///
+  void Finish();
+  /// @}
+
+ private:
+  // Returns the offset of `id` in the string table, adding it if needed.
+  //
+  long StringOffset(const std::string& id);
+
+  OutputSink* sink_;
+  bool write_sequences_;
+  long offset_{0};
+  std::string block_;
+  std::string strings_;
+  std::unordered_map<std::string, long> string_offsets_;
+  std::vector<BinaryBatchEntry> index_;
+};
+
+/// @brief Reads files written by `BinaryWriter`.
+///
+class BinaryReader {
+ public:
+  /// @name Factories:
+  ///
+  /// @{
+
+  /// @brief Reads the trailer, string table, and index from `is`.
+  ///
+  /// @exceptions Basic guarantee. Throws `exceptions::ReadError` if
+  ///  * `is` compares to `nullptr`.
+  ///  * `is` is not a complete binary output file or cannot be read.
+  ///  * The file was written in a different byte order.
+  ///
+  static BinaryReader FromIStream(std::unique_ptr<std::istream> is);
+  /// @}
+
+  /// @name Accessors:
+  ///
+  /// @{
+
+  /// @brief The blocks of the file in the order they were written.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline const std::vector<BinaryBatchEntry>& Batches() const {
+    return index_;
+  }
+
+  /// @brief Whether the file includes columns qseq and sseq.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline bool HasSequences() const {return has_sequences_;}
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Writes the alignments of block `i` into `os` as tab-separated
+  ///  lines with the default columns.
+  ///
+  /// @details The lines are those `WriteBatch` writes with the default
+  ///  `OutputFormat`.
+  ///
+  /// @exceptions Basic guarantee.
+  ///  * Throws `exceptions::OutOfRange` if `i` is not the index of a block.
+  ///  * Throws `exceptions::ReadError` if the block cannot be read.
+  ///
+  void WriteTsv(int i, std::ostream& os);
+  /// @}
+
+ private:
+  std::unique_ptr<std::istream> is_;
+  bool has_sequences_{false};
+  std::vector<BinaryBatchEntry> index_;
+  std::string block_;
+};
+
 /// @name paste_output
 ///
 /// @{
 
+/// @brief Appends `ids` to `result` as a comma-separated list in which each
+///  run of two or more consecutive identifiers is written as a range.
+///
+/// @details A run ascending by one from `a` to `b` is written as `a-b`, and a
+///  run descending by one from `b` to `a` as `b-a`, so that the list keeps
+///  its order, e.g. `1,2,3,4,5,9,7,6` is written as `1-5,9,7-6`. Identifiers
+///  must be non-negative.
+///
+/// @exceptions Basic guarantee.
+///
+void AppendRowRanges(const std::vector<int>& ids, std::string& result);
+
+/// @brief Expands a rows column written by `AppendRowRanges` into the
+///  identifiers it lists, in order.
+///
+/// @details Plain comma-separated lists are returned as they are.
+///
+/// @exceptions Strong guarantee. Throws `exceptions::ParsingError` if `rows`
+///  is not a comma-separated list of non-negative integers and ranges.
+///
+std::vector<long> ExpandRowRanges(std::string_view rows);
+
 /// @brief Writes tab-separated alignment data from batch into data file.
 ///
 /// @parameter batch The alignment batch to write.
-/// @parameter os The stream to write the data into.
+/// @parameter sink The sink to write the data into.
+/// @parameter format The columns to write.
+///
+/// @details Only writes alignments which are marked as final. Fields of
+///  alignments that were not pasted onto are copied from their input rows if
+///  the alignments refer to them (see `Alignment::RawFields`) and the format
+///  contains all of the input columns in input order. The batch's lines are
+///  passed to `sink` in chunks of about a megabyte. Returns the number of
+///  lines written.
+///
+/// @exceptions Basic guarantee. Throws `exceptions::WriteError` if the sink
+///  fails.
+///
+long WriteBatch(const AlignmentBatch& batch, OutputSink& sink,
+                const OutputFormat& format);
+
+/// @brief Writes tab-separated alignment data from batch into data file with
+///  the columns given by `paste_parameters.output_columns` and returns the
+///  number of lines written.
 ///
-/// @details Column order: qseqid, sseqid, qstart, qend, sstart, send, nident,
-///  gapopen, qlen, qseq, pident, score, bitscore, evalue, nmatches,
-///  identifiers. Only writes alignments which are marked as final.
+/// @exceptions Basic guarantee.
+///  * Throws `exceptions::ParsingError` if the columns are invalid.
+///  * Throws `exceptions::WriteError` if the sink fails.
 ///
-void WriteBatch(AlignmentBatch batch, std::ostream& os,
+long WriteBatch(const AlignmentBatch& batch, OutputSink& sink,
                 const PasteParameters& paste_parameters);
 /// @}
 
@@ -54,4 +351,4 @@ void WriteBatch(AlignmentBatch batch, std::ostream& os,
 
 } // namespace paste_alignments
 
-#endif // PASTE_ALIGNMENTS_PASTE_OUTPUT_H_
\ No newline at end of file
+#endif // PASTE_ALIGNMENTS_PASTE_OUTPUT_H_
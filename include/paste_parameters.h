@@ -21,12 +21,34 @@
 #ifndef PASTE_ALIGNMENTS_PASTE_PARAMETERS_H_
 #define PASTE_ALIGNMENTS_PASTE_PARAMETERS_H_
 
+#include <limits>
+
 namespace paste_alignments {
 
 /// @addtogroup PasteAlignments-Reference
 ///
 /// @{
 
+/// @brief Strategies for pasting the alignments of a batch.
+///
+enum class PastingEngine {
+
+  /// @brief Extends alignments in descending order of score with the best
+  ///  pastable candidates to their left and right.
+  ///
+  kGreedy,
+
+  /// @brief Pastes colinear chains of alignments, each extending the best of
+  ///  a bounded number of highest-scoring candidate chains.
+  ///
+  kChain,
+
+  /// @brief Chooses for each batch the cheapest variant of the greedy strategy
+  ///  with the same result.
+  ///
+  kAuto
+};
+
 /// @brief Collects all parameter values relevant for the program.
 ///
 struct PasteParameters {
@@ -55,6 +77,26 @@ struct PasteParameters {
   ///
   float final_score_threshold{0.0f};
 
+  /// @brief Maximum evalue for returned pasted alignments. Not applied if 0.
+  ///
+  /// @details Converted into a raw score threshold for each batch.
+  ///
+  double final_evalue{0.0};
+
+  /// @brief Minimum bitscore for returned pasted alignments. Not applied if 0.
+  ///
+  /// @details Converted into a raw score threshold for each batch.
+  ///
+  float final_bitscore{0.0f};
+
+  /// @brief Exact minimum raw score for returned pasted alignments.
+  ///
+  /// @details Set for each batch to the smallest raw score satisfying
+  ///  `final_evalue` and `final_bitscore`, and compared without
+  ///  `float_epsilon`.
+  ///
+  float final_score_cutoff{-std::numeric_limits<float>::infinity()};
+
   /// @brief Paste alignments only when the pasted score is at least as large as
   ///  the average score of the two alignments.
   ///
@@ -63,6 +105,43 @@ struct PasteParameters {
   /// @brief When executed in blind mode, nucleotide sequences are disregarded.
   ///
   bool blind_mode{false};
+
+  /// @brief Remove exact duplicates and alignments contained in another
+  ///  alignment of at least the same score on the same diagonal before pasting.
+  ///
+  bool remove_redundant{false};
+
+  /// @brief Alignments of whole batches refer to their sequences in the rows
+  ///  read from the input until they are pasted onto, instead of packing them
+  ///  on parsing.
+  ///
+  bool sequence_views{false};
+
+  /// @brief Maximum number of alignments of a batch held at once when pasting
+  ///  batches sorted by query start as a stream. Batches are read and pasted
+  ///  as a whole if not positive.
+  ///
+  int stream_window{0};
+
+  /// @brief Strategy used to paste the alignments of each batch.
+  ///
+  PastingEngine engine{PastingEngine::kGreedy};
+
+  /// @brief Number of threads pasting independent clusters of alignments of a
+  ///  batch in parallel if the strategy is chosen automatically.
+  ///
+  int num_threads{1};
+
+  /// @brief Maximum number of candidates scanned while pasting a batch by the
+  ///  greedy strategy. Once exhausted, the batch's remaining alignments are
+  ///  output without further pasting. Unlimited if not positive.
+  ///
+  long candidate_budget{0l};
+
+  /// @brief Maximum number of output alignments per batch, chosen by score.
+  ///  Unlimited if not positive.
+  ///
+  int max_alignments_per_batch{0};
   /// @}
 
   /// @name Scoring parameters:
@@ -117,6 +196,41 @@ struct PasteParameters {
   ///
   std::string output_filename;
 
+  /// @brief Comma-separated names of the output columns. All columns are
+  ///  written if empty.
+  ///
+  std::string output_columns;
+
+  /// @brief Write runs of consecutive row identifiers in the rows column as
+  ///  ranges.
+  ///
+  bool compact_rows{false};
+
+  /// @brief Kind of `OutputSink` the output file is written with (see
+  ///  `OpenOutputSink`).
+  ///
+  std::string output_sink{"file"};
+
+  /// @brief Write the output file in the binary columnar format of
+  ///  `BinaryWriter` instead of as a tab-separated table.
+  ///
+  bool binary_output{false};
+
+  /// @brief Number of files the output is split into by query (see
+  ///  `OutputShardIndex`). Not split if 1.
+  ///
+  int output_shards{1};
+
+  /// @brief Write an index of the batches in the output file next to it (see
+  ///  `OutputIndexWriter`).
+  ///
+  bool output_index{false};
+
+  /// @brief Maximum number of output alignments per query across its batches
+  ///  (see `QueryHitSelector`). Unlimited if not positive.
+  ///
+  int max_hits_per_query{0};
+
   /// @brief Summary file.
   ///
   std::string summary_filename;
@@ -124,6 +238,19 @@ struct PasteParameters {
   /// @brief Statistics data file.
   ///
   std::string stats_filename;
+
+  /// @brief File listing the batches whose candidate budget was exhausted.
+  ///
+  std::string degraded_filename;
+
+  /// @brief Minimum number of seconds between checkpoints. Checkpoints are
+  ///  disabled if not positive.
+  ///
+  int checkpoint_interval{0};
+
+  /// @brief Continue from the checkpoint of a previous run, if any.
+  ///
+  bool resume{false};
   /// @}
   
   /// @name Other:
@@ -159,7 +286,18 @@ struct PasteParameters {
        << ", i_score_t=" << intermediate_score_threshold
        << ", f_pident_t=" << final_pident_threshold
        << ", f_score_t=" << final_score_threshold
+       << ", f_evalue_t=" << final_evalue
+       << ", f_bitscore_t=" << final_bitscore
+       << ", f_score_c=" << final_score_cutoff
        << ", blind_mode=" << blind_mode
+       << ", remove_redundant=" << remove_redundant
+       << ", stream_window=" << stream_window
+       << ", engine="
+       << (engine == PastingEngine::kChain
+           ? "chain" : (engine == PastingEngine::kAuto ? "auto" : "greedy"))
+       << ", num_threads=" << num_threads
+       << ", candidate_budget=" << candidate_budget
+       << ", max_alignments_per_batch=" << max_alignments_per_batch
        << ", reward=" << reward
        << ", penalty=" << penalty
        << ", open_cost=" << open_cost
@@ -167,8 +305,18 @@ struct PasteParameters {
        << ", db_size=" << db_size
        << ", input_filename=" << input_filename
        << ", output_filename=" << output_filename
+       << ", output_columns=" << output_columns
+       << ", compact_rows=" << compact_rows
+       << ", output_sink=" << output_sink
+       << ", binary_output=" << binary_output
+       << ", output_shards=" << output_shards
+       << ", output_index=" << output_index
+       << ", max_hits_per_query=" << max_hits_per_query
        << ", summary_filename=" << summary_filename
        << ", stats_filename=" << stats_filename
+       << ", degraded_filename=" << degraded_filename
+       << ", checkpoint_interval=" << checkpoint_interval
+       << ", resume=" << resume
        << ", float_epsilon=" << float_epsilon
        << ", double_epsilon=" << double_epsilon
        << '}';
@@ -0,0 +1,246 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PASTE_ALIGNMENTS_RESULT_CACHE_H_
+#define PASTE_ALIGNMENTS_RESULT_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "alignment_reader.h"
+#include "paste_parameters.h"
+#include "stats_collector.h"
+
+namespace paste_alignments {
+
+/// @addtogroup PasteAlignments-Reference
+///
+/// @{
+
+/// @brief Identifies the result of pasting one batch under one set of
+///  parameters.
+///
+/// @details Consists of two independent 64-bit hashes of the batch's raw rows
+///  and the settings affecting its output. The first names the cache entry,
+///  the second is stored in it to detect collisions.
+///
+struct CacheKey {
+
+  /// @brief Hash naming the cache entry.
+  ///
+  std::uint64_t name_hash{0u};
+
+  /// @brief Hash verifying the cache entry.
+  ///
+  std::uint64_t check_hash{0u};
+
+  /// @name Factories:
+  ///
+  /// @{
+
+  /// @brief Computes the key of `raw_batch` pasted under `settings`.
+  ///
+  /// @parameter raw_batch The batch's rows.
+  /// @parameter settings Settings affecting the output as returned by
+  ///  `CacheSettings`.
+  ///
+  /// @details The key does not depend on the identifiers of the batch's rows.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  static CacheKey FromRawBatch(const RawBatch& raw_batch,
+                               std::string_view settings);
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Returns the name of the cache entry's file.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string Filename() const;
+
+  /// @brief Compares the object to `other`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool operator==(const CacheKey& other) const;
+
+  /// @brief Returns a descriptive string of the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string DebugString() const;
+  /// @}
+};
+
+/// @brief On-disk cache of pasted output and statistics of batches.
+///
+/// @details Each entry is a file in the cache directory. Entries are evicted
+///  in least-recently-used order once their total size exceeds the maximum
+///  size. The time of last use is kept as the file's modification time, so the
+///  order persists across runs. Updates of the index are synchronized, so an
+///  object may be shared by several threads, which read and write entry files
+///  concurrently. Concurrent processes may share a directory, since entries
+///  are replaced atomically and missing or corrupt entries are treated as
+///  misses.
+///
+class ResultCache {
+ public:
+  /// @name Constructors:
+  ///
+  /// @{
+
+  /// @brief Creates a cache in `directory` holding at most `max_bytes` bytes.
+  ///
+  /// @parameter directory The cache directory. Created if it doesn't exist.
+  /// @parameter max_bytes Maximum total size of entries.
+  ///
+  /// @details Entries already in the directory are indexed by their times of
+  ///  last use.
+  ///
+  /// @exceptions Basic guarantee.
+  ///  * Throws `exceptions::OutOfRange` if `max_bytes` is negative.
+  ///  * Throws `exceptions::ReadError` if `directory` cannot be created or
+  ///    listed.
+  ///
+  ResultCache(const std::string& directory, long max_bytes);
+
+  ResultCache(const ResultCache& other) = delete;
+  /// @}
+
+  /// @name Assignment:
+  ///
+  /// @{
+
+  ResultCache& operator=(const ResultCache& other) = delete;
+  /// @}
+
+  /// @name Accessors:
+  ///
+  /// @{
+
+  /// @brief Returns the total size of the cached entries.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  long Size() const;
+  /// @}
+
+  /// @name Cache operations:
+  ///
+  /// @{
+
+  /// @brief Looks up the entry of `key`.
+  ///
+  /// @parameter key The entry's key.
+  /// @parameter output Replaced with the cached output, if found.
+  /// @parameter stats Replaced with the cached statistics, if found.
+  ///
+  /// @details Marks the entry as most recently used. Unreadable entries are
+  ///  removed and reported as missing.
+  ///
+  /// @exceptions Basic guarantee. Returns whether the entry was found.
+  ///
+  bool Lookup(const CacheKey& key, std::string& output, StatsCollector& stats);
+
+  /// @brief Stores `output` and `stats` as the entry of `key`.
+  ///
+  /// @details Evicts least recently used entries while the total size exceeds
+  ///  the maximum. Entries larger than the maximum size are not stored.
+  ///
+  /// @exceptions Basic guarantee. Throws `exceptions::ReadError` if the entry
+  ///  cannot be written.
+  ///
+  void Store(const CacheKey& key, std::string_view output,
+             const StatsCollector& stats);
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Returns a descriptive string of the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string DebugString() const;
+  /// @}
+ private:
+  // Entry of the recency list.
+  struct Entry {
+    std::string filename;
+    long size;
+  };
+
+  // Marks the entry `filename` as most recently used and updates its size.
+  void Touch(const std::string& filename, long size);
+
+  // Removes the entry `filename` from the index and the directory.
+  void Remove(const std::string& filename);
+
+  std::string directory_;
+  long max_bytes_;
+  long size_{0};
+  std::list<Entry> recency_; // Most recently used first.
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+  mutable std::mutex mutex_;
+};
+
+/// @name result_cache
+///
+/// @{
+
+/// @brief Returns a description of all settings in `paste_parameters` that
+///  affect the output of a batch, for use as part of a `CacheKey`.
+///
+/// @parameter paste_parameters The parameters used for pasting.
+/// @parameter num_fields The number of fields parsed from each row.
+///
+/// @exceptions Strong guarantee.
+///
+std::string CacheSettings(const PasteParameters& paste_parameters,
+                          int num_fields);
+
+/// @brief Returns `output` with `shift` added to each identifier in the `rows`
+///  column, i.e. the last column, of each line.
+///
+/// @details Both ends of ranges written by `AppendRowRanges` are shifted.
+///
+/// @details Used to store output independent of a batch's position in the
+///  input.
+///
+/// @exceptions Strong guarantee. Throws `exceptions::ParsingError` if a row
+///  identifier cannot be converted.
+///
+std::string ShiftRowIds(std::string_view output, long shift);
+/// @}
+
+/// @}
+
+} // namespace paste_alignments
+
+#endif // PASTE_ALIGNMENTS_RESULT_CACHE_H_
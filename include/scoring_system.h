@@ -348,6 +348,36 @@ class ScoringSystem {
   ///  
   double Evalue(float raw_score, int qlen,
                 const PasteParameters& parameters) const;
+
+  /// @brief Computes the smallest raw score whose evalue does not exceed
+  ///  `evalue`.
+  ///
+  /// @parameter evalue Maximum evalue.
+  /// @parameter qlen Length of query sequence.
+  /// @parameter parameters Additional arguments to deal with floating points.
+  ///
+  /// @details Inverts `Evalue`, including its rounding to the next lower even
+  ///  number, over raw scores, which are multiples of 0.5. Returns the lowest
+  ///  float if every raw score satisfies `evalue`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  float EvalueScoreThreshold(double evalue, int qlen,
+                             const PasteParameters& parameters) const;
+
+  /// @brief Computes the smallest raw score whose bitscore is at least
+  ///  `bitscore`.
+  ///
+  /// @parameter bitscore Minimum bitscore.
+  /// @parameter parameters Additional arguments to deal with floating points.
+  ///
+  /// @details Inverts `Bitscore`, including its rounding to the next lower even
+  ///  number, over raw scores, which are multiples of 0.5.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  float BitscoreScoreThreshold(float bitscore,
+                               const PasteParameters& parameters) const;
   /// @}
 
   /// @name Other:
@@ -0,0 +1,173 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PASTE_ALIGNMENTS_SHARDING_H_
+#define PASTE_ALIGNMENTS_SHARDING_H_
+
+#include <istream>
+#include <string>
+#include <string_view>
+
+namespace paste_alignments {
+
+/// @addtogroup PasteAlignments-Reference
+///
+/// @{
+
+/// @brief Identifies one of several processes sharing an input file.
+///
+struct Shard {
+
+  /// @brief One-based index of the shard.
+  ///
+  int index{1};
+
+  /// @brief Total number of shards.
+  ///
+  int num_shards{1};
+
+  /// @name Factories:
+  ///
+  /// @{
+
+  /// @brief Creates a `Shard` from a specification of the form `INDEX/COUNT`.
+  ///
+  /// @parameter specification The shard specification, e.g. "2/8".
+  ///
+  /// @exceptions Strong guarantee. Throws `exceptions::ParsingError` if
+  ///  `specification` is not of the form `INDEX/COUNT` with integers
+  ///  1 <= `INDEX` <= `COUNT`.
+  ///
+  static Shard FromString(std::string_view specification);
+  /// @}
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Compares the object to `other`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool operator==(const Shard& other) const;
+
+  /// @brief Returns a descriptive string of the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string DebugString() const;
+  /// @}
+};
+
+/// @brief Describes the part of an input stream read by an `AlignmentReader`.
+///
+struct InputRange {
+
+  /// @brief Offset of the first byte of the range.
+  ///
+  long begin_offset{0l};
+
+  /// @brief Offset one past the last byte of the range, or -1 if the range
+  ///  extends to the end of the input stream.
+  ///
+  long end_offset{-1l};
+
+  /// @brief Identifier of the row beginning at `begin_offset`.
+  ///
+  /// @details Row identifiers are the one-based line numbers in the input
+  ///  stream, so the identifiers of a range agree with those assigned when
+  ///  reading the whole stream.
+  ///
+  long first_row_id{1l};
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Compares the object to `other`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool operator==(const InputRange& other) const;
+
+  /// @brief Returns a descriptive string of the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string DebugString() const;
+  /// @}
+};
+
+/// @name sharding
+///
+/// @{
+
+/// @brief Returns the range of the input stream processed by `shard`.
+///
+/// @parameter is Seekable input stream of tab-delimited rows.
+/// @parameter shard The shard whose range is computed.
+///
+/// @details The stream is split into `shard.num_shards` byte ranges of roughly
+///  equal size. The boundaries between ranges are then moved forward to the
+///  beginning of the next batch, i.e. the first row whose first two fields
+///  differ from those of the preceding row, so that no batch is split between
+///  shards. Ranges of all shards are disjoint and cover the stream. A range
+///  may be empty. Determining the first row identifier requires counting the
+///  lines preceding the range. Afterwards, the state of `is` is cleared and
+///  `is` is positioned at the beginning of the range.
+///
+/// @exceptions Basic guarantee. Modifies `is`. Throws `exceptions::ReadError`
+///  if the size of `is` cannot be determined, or if `badbit` of `is` is set
+///  while reading.
+///
+InputRange FindShardRange(std::istream& is, const Shard& shard);
+
+/// @brief Returns the name of the file written by shard `index` in place of
+///  `filename`.
+///
+/// @exceptions Strong guarantee.
+///
+std::string ShardFilename(const std::string& filename, int index);
+
+/// @brief Returns the zero-based index of the output shard receiving the
+///  batches of query `qseqid` when output is split into `num_shards` files.
+///
+/// @details The index is the 64-bit FNV-1a hash of `qseqid` modulo
+///  `num_shards`, so it is the same across runs, platforms, and inputs.
+///
+/// @exceptions Strong guarantee. Throws `exceptions::OutOfRange` if
+///  `num_shards` is not positive.
+///
+int OutputShardIndex(std::string_view qseqid, int num_shards);
+
+/// @brief Concatenates the files written by `num_shards` shards in place of
+///  `filename` into `filename`.
+///
+/// @exceptions Basic guarantee. Throws `exceptions::ReadError` if one of the
+///  shard files cannot be opened or read.
+///
+void ConcatenateShards(const std::string& filename, int num_shards);
+/// @}
+
+/// @}
+
+} // namespace paste_alignments
+
+#endif // PASTE_ALIGNMENTS_SHARDING_H_
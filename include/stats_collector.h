@@ -21,10 +21,14 @@
 #ifndef PASTE_ALIGNMENTS_STATS_COLLECTOR_H_
 #define PASTE_ALIGNMENTS_STATS_COLLECTOR_H_
 
+#include <cstdio>
 #include <fstream>
+#include <functional>
+#include <memory>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "alignment_batch.h"
@@ -80,10 +84,151 @@ struct PasteStats {
   ///
   float average_nmatches{0.0f};
 
+  /// @brief Identifiers of alignments removed as redundant, each paired with
+  ///  the identifier of the alignment it is redundant to.
+  ///
+  std::vector<std::pair<int,int>> removed_rows;
+
+  /// @brief Number of seeds not or not completely extended, because the
+  ///  candidate budget was exhausted. The batch was pasted in degraded form if
+  ///  positive.
+  ///
+  long num_unextended_seeds{0l};
+
+  /// @name Other:
+  ///
+  /// @{
+
+  /// @brief Compares the object to `other`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool operator==(const PasteStats& other) const;
+
+  /// @brief Returns a descriptive string of the object.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  std::string DebugString() const;
+  /// @}
+};
+
+/// @brief Mergeable sums over a set of alignments from which overall statistics
+///  are derived.
+///
+/// @details Unlike averages, the totals of disjoint sets of alignments can be
+///  combined exactly, e.g. when the input is processed in shards.
+///
+struct PasteTotals {
+
+  /// @brief Number of alignments.
+  ///
+  long num_alignments{0l};
+
+  /// @brief Number of times alignments were pasted.
+  ///
+  long num_pastings{0l};
+
+  /// @brief Sum of alignment lengths.
+  ///
+  double total_length{0.0};
+
+  /// @brief Sum of alignment percent identities.
+  ///
+  double total_pident{0.0};
+
+  /// @brief Sum of alignment scores.
+  ///
+  double total_score{0.0};
+
+  /// @brief Sum of alignment bitscores.
+  ///
+  double total_bitscore{0.0};
+
+  /// @brief Sum of alignment evalues.
+  ///
+  double total_evalue{0.0};
+
+  /// @brief Sum of aligned unknown residues counted as mismatches.
+  ///
+  double total_nmatches{0.0};
+
+  /// @brief Number of seeds processed while pasting.
+  ///
+  long num_seeds{0l};
+
+  /// @brief Number of seeds skipped while pasting, because they could not
+  ///  reach the final score threshold.
+  ///
+  long num_pruned_seeds{0l};
+
+  /// @brief Number of alignments removed as redundant before pasting.
+  ///
+  long num_removed_alignments{0l};
+
+  /// @brief Number of window overflows while pasting batches as a stream.
+  ///
+  long num_window_overflows{0l};
+
+  /// @brief Number of batches pasted by the greedy strategy without seed
+  ///  bounds.
+  ///
+  long num_brute_force_batches{0l};
+
+  /// @brief Number of batches pasted by the greedy strategy with seed bounds.
+  ///
+  long num_indexed_greedy_batches{0l};
+
+  /// @brief Number of batches pasted by the greedy strategy cluster by
+  ///  cluster in parallel.
+  ///
+  long num_cluster_parallel_batches{0l};
+
+  /// @brief Number of pasting candidates scanned by the greedy strategies.
+  ///
+  long num_scanned_candidates{0l};
+
+  /// @brief Number of batches pasted in degraded form, because their
+  ///  candidate budget was exhausted.
+  ///
+  long num_degraded_batches{0l};
+
+  /// @name Mutators:
+  ///
+  /// @{
+
+  /// @brief Adds alignment `a` to the totals.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  void Add(const Alignment& a);
+
+  /// @brief Adds the totals of a disjoint set of alignments.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  PasteTotals& operator+=(const PasteTotals& other);
+  /// @}
+
   /// @name Other:
   ///
   /// @{
 
+  /// @brief Returns the overall statistics described by the totals.
+  ///
+  /// @details Identifiers of the result are empty. All averages are 0 if the
+  ///  totals contain no alignments.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  PasteStats Averages() const;
+
+  /// @brief Compares the object to `other`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool operator==(const PasteTotals& other) const;
+
   /// @brief Returns a descriptive string of the object.
   ///
   /// @exceptions Strong guarantee.
@@ -92,8 +237,58 @@ struct PasteStats {
   /// @}
 };
 
+/// @brief Combines descriptive statistics of disjoint sets of alignments.
+///
+/// @parameter stats Statistics of each set of alignments.
+///
+/// @details Counts are summed and averages are weighted by the number of
+///  alignments they describe. Identifiers of the result are empty. All
+///  averages and counts are set to 0 if `stats` contains no alignments.
+///
+/// @exceptions Strong guarantee.
+///
+PasteStats CombineStats(const std::vector<PasteStats>& stats);
+
+/// @brief Writes overall statistics described by `totals` in JSON format.
+///
+/// @parameter totals Totals of the alignments to be summarized.
+/// @parameter os Stream to write the summary into.
+/// @parameter include_totals If set, `totals` are appended to the summary with
+///  full precision so that it can be read back by `ReadSummaryTotals`.
+///
+/// @exceptions Basic guarantee. Modifies `os`.
+///
+void WriteSummary(const PasteTotals& totals, std::ostream& os,
+                  bool include_totals = false);
+
+/// @brief Reads the totals from a summary written by `WriteSummary` with
+///  `include_totals` set.
+///
+/// @parameter is Stream to read the summary from.
+///
+/// @exceptions Basic guarantee. Modifies `is`. Throws `exceptions::ReadError`
+///  if `badbit` of `is` is set while reading, or if one of the totals is
+///  missing or cannot be converted.
+///
+PasteTotals ReadSummaryTotals(std::istream& is);
+
 class StatsCollector {
  public:
+  /// @name Factories:
+  ///
+  /// @{
+
+  /// @brief Restores a `StatsCollector` from the state written by
+  ///  `WriteState`.
+  ///
+  /// @parameter is Stream to read the state from.
+  ///
+  /// @exceptions Basic guarantee. Modifies `is`. Throws `exceptions::ReadError`
+  ///  if the state cannot be read or is malformed.
+  ///
+  static StatsCollector FromIStream(std::istream& is);
+  /// @}
+
 
   /// @name Constructors:
   ///
@@ -129,13 +324,37 @@ class StatsCollector {
   ///
   /// @{
   
-  /// @brief Returns all stored `BatchStats` objects.
+  /// @brief Returns the stored `BatchStats` objects held in memory.
+  ///
+  /// @details Stats moved to disk by `Spill` are not included.
   ///
   /// @exceptions Strong guarantee.
   ///
   inline const std::vector<PasteStats>& BatchStats() const {
     return batch_stats_;
   }
+
+  /// @brief Returns the number of stored `BatchStats` objects moved to disk by
+  ///  `Spill`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline long NumSpilled() const {return num_spilled_;}
+
+  /// @brief Returns the approximate number of bytes occupied by the stats held
+  ///  in memory.
+  ///
+  /// @details Amortized constant time when called after every batch passed.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  long MemoryUsage() const;
+
+  /// @brief Returns the totals of all alignments passed to `CollectStats`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  inline const PasteTotals& Totals() const {return totals_;}
   /// @}
 
   /// @name Stats computation:
@@ -145,12 +364,58 @@ class StatsCollector {
   /// @brief Computes descriptive statistics for the batch of alignments.
   ///
   /// @parameter batch The batch for which statistics are computed.
+  /// @parameter continues_previous If set, `batch` is a further part of the
+  ///  batch passed in the previous call, and both are described by the same
+  ///  stats.
+  ///
+  /// @details Only stores the batch's stats if it's not empty or if
+  ///  alignments were removed from it as redundant. Alignments of the batch
+  ///  included in the output, as well as the batch's numbers of seeds, pruned
+  ///  seeds, removed alignments, and scanned candidates, and the greedy
+  ///  strategy used to paste it, are added to the totals. Batches with
+  ///  unextended seeds are always stored and counted as degraded. Stats of a
+  ///  batch collected in parts equal those of the whole batch, except that the
+  ///  strategy is counted for each part.
+  ///
+  /// @exceptions Basic guarantee.
+  ///
+  void CollectStats(const AlignmentBatch& batch,
+                    bool continues_previous = false);
+
+  /// @brief Adds `num_overflows` window overflows to the totals.
+  ///
+  /// @exceptions Strong guarantee.
   ///
-  /// @details Only stores the batch's stats if it's not empty.
+  void CountWindowOverflows(long num_overflows);
+
+  /// @brief Adds the statistics collected by `other` after those already
+  ///  stored.
   ///
   /// @exceptions Strong guarantee.
   ///
-  void CollectStats(const AlignmentBatch& batch);
+  void Merge(const StatsCollector& other);
+
+  /// @brief Adds `shift` to the identifiers of all removed alignments.
+  ///
+  /// @details Requires that no stats were moved to disk by `Spill`.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  void ShiftRowIds(long shift);
+
+  /// @brief Moves the stored stats to a temporary binary file, except those
+  ///  of the last batch passed, which may still be continued.
+  ///
+  /// @details Spilled stats are read back in order whenever all stats are
+  ///  written or compared, so the object behaves as before apart from
+  ///  `BatchStats` and `MemoryUsage`. Copies share the file until either of
+  ///  them spills again, which then writes its own copy of the file first. The
+  ///  file is removed once no copy refers to it.
+  ///
+  /// @exceptions Basic guarantee. Throws `exceptions::ReadError` if the
+  ///  temporary file cannot be created or written.
+  ///
+  void Spill();
   /// @}
   
   /// @name Write operations:
@@ -161,16 +426,70 @@ class StatsCollector {
   ///  overall statistics.
   ///
   /// @parameter os Stream to write statistics into.
+  /// @parameter include_removed_rows If set, an additional column lists the
+  ///  removed alignments of each batch as comma-separated
+  ///  `removed:kept` identifier pairs, or `-` if there are none.
   ///
   /// @details All averages and counts in return value are set to 0 if no stats
   ///  were computed.
   ///
-  PasteStats WriteData(std::ostream& os);
+  PasteStats WriteData(std::ostream& os, bool include_removed_rows = false);
+
+  /// @brief Writes the statistics of each batch into the stream returned for
+  ///  it by `stream_of` and returns overall statistics.
+  ///
+  /// @parameter stream_of Returns the stream to write a batch's statistics
+  ///  into.
+  /// @parameter include_removed_rows See other overload.
+  ///
+  /// @details Lines have the same format as those written by the other
+  ///  overload. Within each stream, batches keep their order.
+  ///
+  PasteStats WriteData(
+      const std::function<std::ostream&(const PasteStats&)>& stream_of,
+      bool include_removed_rows = false);
+
+  /// @brief Writes the batches pasted in degraded form.
+  ///
+  /// @parameter os Stream to write the batches into.
+  ///
+  /// @details Writes one line per degraded batch with tab-separated columns:
+  ///  query sequence identifier, subject sequence identifier, and number of
+  ///  unextended seeds.
+  ///
+  /// @exceptions Basic guarantee. Modifies `os`.
+  ///
+  void WriteDegraded(std::ostream& os) const;
+
+  /// @brief Writes each batch pasted in degraded form into the stream
+  ///  returned for it by `stream_of`.
+  ///
+  /// @exceptions Basic guarantee.
+  ///
+  void WriteDegraded(
+      const std::function<std::ostream&(const PasteStats&)>& stream_of) const;
+
+  /// @brief Writes the collector's complete state so that it can be restored
+  ///  by `FromIStream`.
+  ///
+  /// @parameter os Stream to write the state into.
+  ///
+  /// @details Floating point values are written with full precision.
+  ///
+  /// @exceptions Basic guarantee. Modifies `os`.
+  ///
+  void WriteState(std::ostream& os) const;
   /// @}
 
   /// @name Other:
   ///
   /// @{
+
+  /// @brief Compares the object to `other`, including spilled stats.
+  ///
+  /// @exceptions Strong guarantee.
+  ///
+  bool operator==(const StatsCollector& other) const;
   
   /// @brief Returns a descriptive string of the object.
   ///
@@ -179,7 +498,22 @@ class StatsCollector {
   std::string DebugString() const;
   /// @}
  private:
+  // Calls `visit` for each stored `PasteStats` object, spilled ones first.
+  //
+  void VisitBatchStats(
+      const std::function<void(const PasteStats&)>& visit) const;
+
   std::vector<PasteStats> batch_stats_;
+  PasteTotals totals_;
+  PasteStats batch_sums_; // Undivided sums of the last batch passed.
+  bool batch_stored_{false}; // Whether the last batch passed has stats stored.
+  std::shared_ptr<std::FILE> spill_file_; // Null if nothing was spilled.
+  long num_spilled_{0l};
+  long spill_size_{0l}; // Number of bytes of `spill_file_` holding stats.
+  // Heap bytes of the first `num_measured_` stored stats, none of which but
+  // the last may still change size. Updated lazily by `MemoryUsage`.
+  mutable long measured_bytes_{0l};
+  mutable std::size_t num_measured_{0u};
 };
 /// @}
 
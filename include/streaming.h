@@ -0,0 +1,80 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PASTE_ALIGNMENTS_STREAMING_H_
+#define PASTE_ALIGNMENTS_STREAMING_H_
+
+#include <functional>
+
+#include "alignment_batch.h"
+#include "alignment_reader.h"
+#include "paste_parameters.h"
+#include "scoring_system.h"
+
+namespace paste_alignments {
+
+/// @addtogroup PasteAlignments-Reference
+///
+/// @{
+
+/// @name streaming
+///
+/// @{
+
+/// @brief Reads and pastes the next batch of `reader` one part at a time,
+///  holding at most `paste_parameters.stream_window` of its alignments at once.
+///
+/// @parameter reader Reader whose next batch is pasted. Alignments of the
+///  batch must be sorted by query start coordinate.
+/// @parameter scoring_system Used to read and paste the alignments.
+/// @parameter paste_parameters Used to read and paste the alignments.
+/// @parameter emit Called with each pasted part of the batch in input order,
+///  and whether it is the first part of the batch.
+///
+/// @details The batch is split into parts where the gap between an
+///  alignment's query start and all preceding query ends exceeds
+///  `PastingDistanceBound` of the parts on both of its sides. Parts are pasted
+///  separately by `AlignmentBatch::PasteAlignments`, which then yields the
+///  same alignments as pasting the whole batch. A part is pasted once the
+///  held alignments exceed the window, or once the batch is read. If a part
+///  exceeds the window by itself, or a later part may reach across the
+///  boundary of a part already pasted, the boundary is an overflow of the
+///  window, across which no pasting takes place.
+///
+/// @returns The number of window overflows in the batch.
+///
+/// @exceptions Basic guarantee.
+///  * Throws `exceptions::OutOfRange` if `paste_parameters.stream_window` is
+///    not positive.
+///  * Throws `exceptions::ReadError` if alignments of the batch are not sorted
+///    by query start.
+///  * `AlignmentReader::ReadAlignment` may throw.
+///
+int PasteStreamedBatch(
+    AlignmentReader& reader, const ScoringSystem& scoring_system,
+    const PasteParameters& paste_parameters,
+    const std::function<void(AlignmentBatch, bool)>& emit);
+/// @}
+
+/// @}
+
+} // namespace paste_alignments
+
+#endif // PASTE_ALIGNMENTS_STREAMING_H_
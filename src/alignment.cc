@@ -30,10 +30,11 @@ namespace paste_alignments {
 
 // Alignment::FromStringFields.
 //
-Alignment Alignment::FromStringFields(int id,
-                                      std::vector<std::string_view> fields,
-                                      const ScoringSystem& scoring_system,
-                                      const PasteParameters& paste_parameters) {
+Alignment Alignment::FromStringFields(
+    int id, std::vector<std::string_view> fields,
+    const ScoringSystem& scoring_system,
+    const PasteParameters& paste_parameters,
+    std::shared_ptr<const void> row_owner) {
   std::stringstream error_message;
   if (fields.size() >= 13
       || (paste_parameters.blind_mode && fields.size() >= 11)) {
@@ -90,22 +91,53 @@ Alignment Alignment::FromStringFields(int id,
 
     // Sequence alignment.
     if (!paste_parameters.blind_mode) {
-      result.qseq_ = fields.at(11);
-      result.sseq_ = fields.at(12);
-      if (result.qseq_.empty() || result.sseq_.empty()) {
+      std::string_view qseq{fields.at(11)}, sseq{fields.at(12)};
+      if (qseq.empty() || sseq.empty()) {
         error_message << "Invalid sequence alignment. Alignment must be"
                       << " non-empty. (id: " << id << ").";
         throw exceptions::ParsingError(error_message.str());
-      } else if (result.qseq_.length() != result.sseq_.length()) {
+      } else if (qseq.length() != sseq.length()) {
         error_message << "Invalid sequence alignment. Both sides of the"
                       << " alignment must have the same length. (id: " << id
                       << ").";
         throw exceptions::ParsingError(error_message.str());
-      } else if (static_cast<int>(result.qseq_.length()) != result.length_) {
+      } else if (static_cast<int>(qseq.length()) != result.length_) {
         error_message << "Alignment length must be the same as the length of"
                       << " either side of the alignment. (id: " << id << ").";
         throw exceptions::ParsingError(error_message.str());
       }
+      if (row_owner != nullptr && paste_parameters.sequence_views) {
+        result.qseq_ = PackedSequence::View(qseq);
+        result.sseq_ = PackedSequence::View(sseq);
+      } else {
+        result.qseq_ = PackedSequence::FromString(qseq);
+        result.sseq_ = PackedSequence::FromString(sseq);
+      }
+    }
+
+    // Fields as read, if they are formatted as they would be written.
+    if (row_owner != nullptr) {
+      int last{paste_parameters.blind_mode ? 10 : 12};
+      bool as_written{true};
+      for (int i = 0; i <= last && as_written; ++i) {
+        as_written = ((i > 10 || fields.at(i).length() == 1
+                       || fields.at(i).front() != '0')
+                      && (i == last
+                          || (fields.at(i).data() + fields.at(i).length() + 1
+                              == fields.at(i + 1).data()
+                              && fields.at(i).data()[fields.at(i).length()]
+                                 == '\t')));
+      }
+      if (as_written) {
+        result.raw_fields_ = std::string_view{
+            fields.at(0).data(),
+            static_cast<std::string_view::size_type>(
+                fields.at(last).data() + fields.at(last).length()
+                - fields.at(0).data())};
+      }
+      if (!result.raw_fields_.empty() || result.qseq_.IsView()) {
+        result.row_owner_ = std::move(row_owner);
+      }
     }
 
     // Derived values.
@@ -115,6 +147,13 @@ Alignment Alignment::FromStringFields(int id,
       std::swap(result.sstart_, result.send_);
       result.plus_strand_ = false;
     }
+    if (result.plus_strand_) {
+      result.canonical_sstart_ = result.sstart_;
+      result.canonical_send_ = result.send_;
+    } else {
+      result.canonical_sstart_ = result.slen_ - result.send_ + 1;
+      result.canonical_send_ = result.slen_ - result.sstart_ + 1;
+    }
     result.UpdateSimilarityMeasures(scoring_system, paste_parameters);
     result.ungapped_prefix_end_ = result.length_;
     result.ungapped_suffix_begin_ = 0;
@@ -192,33 +231,33 @@ PastedPartition GetLeftPartition(const AlignmentConfiguration& config) {
   return result;
 }
 
-// Pastes left and right strings together maximizing ungapped suffix.
+// Pastes right sequence onto left sequence in place maximizing ungapped
+// suffix.
 //
-std::string CombineRight(const std::string& left, const std::string& right,
-                         const PastedPartition& partition, char gap_character) {
-  std::string result;
-  result.reserve(partition.gap_begin + partition.gap_length
-                 + partition.unknown_length + partition.right_length);
-  result.append(left.data(), partition.gap_begin);
-  result.append(partition.gap_length, gap_character);
-  result.append(partition.unknown_length, 'N');
-  result.append(right.data(), right.length());
-  return result;
+void CombineRight(PackedSequence& left, const PackedSequence& right,
+                  const PastedPartition& partition, char gap_character) {
+  left.Truncate(partition.gap_begin);
+  left.Reserve(partition.gap_begin + partition.gap_length
+               + partition.unknown_length + partition.right_length);
+  left.AppendRun(gap_character, partition.gap_length);
+  left.AppendRun('N', partition.unknown_length);
+  left.Append(right, 0, right.Length());
 }
 
-// Pastes left and right strings together maximizing ungapped prefix.
+// Pastes left and right sequences together maximizing ungapped prefix.
 //
-std::string CombineLeft(const std::string& left, const std::string& right,
-                         const PastedPartition& partition, char gap_character) {
-  std::string result;
-  result.reserve(left.length() + partition.unknown_length + partition.gap_length
-                 + partition.right_length);
-  result.append(left.data(), left.length());
-  result.append(partition.unknown_length, 'N');
-  result.append(partition.gap_length, gap_character);
-  result.append(right.data() + right.length() - partition.right_length,
+PackedSequence CombineLeft(const PackedSequence& left,
+                           const PackedSequence& right,
+                           const PastedPartition& partition,
+                           char gap_character) {
+  PackedSequence result;
+  result.Reserve(left.Length() + partition.unknown_length
+                 + partition.gap_length + partition.right_length);
+  result.Append(left, 0, left.Length());
+  result.AppendRun('N', partition.unknown_length);
+  result.AppendRun(gap_character, partition.gap_length);
+  result.Append(right, right.Length() - partition.right_length,
                 partition.right_length);
-
   return result;
 }
 
@@ -366,16 +405,15 @@ void Alignment::PasteRight(const Alignment& other,
                            const ScoringSystem& scoring_system,
                            const PasteParameters& paste_parameters) {
   // Invariant sanity checks.
-  assert(qseq_.length() == sseq_.length());
-  assert(other.Qseq().length() == other.Sseq().length());
+  assert(qseq_.Length() == sseq_.Length());
+  assert(other.PackedQseq().Length() == other.PackedSseq().Length());
 
   // Preconditions.
-  if (qstart_ >= other.Qstart()
+  if (plus_strand_ != other.PlusStrand()
+      || qstart_ >= other.Qstart()
       || qend_ >= other.Qend()
-      || (plus_strand_ && (sstart_ >= other.Sstart()
-                           || send_ >= other.Send()))
-      || ((!plus_strand_) && (sstart_ <= other.Sstart()
-                              || send_ <= other.Send()))) {
+      || canonical_sstart_ >= other.CanonicalSstart()
+      || canonical_send_ >= other.CanonicalSend()) {
     std::stringstream error_message;
     error_message << "Invalid configuration for pasting alignment "
                   << other.DebugString() << " onto the right of alignment "
@@ -395,10 +433,7 @@ void Alignment::PasteRight(const Alignment& other,
 
   // Deploy changes.
   if (!paste_parameters.blind_mode) {
-    std::string new_qseq, new_sseq;
     char query_gap_char, subject_gap_char;
-    new_qseq.reserve(config.pasted_length);
-    new_sseq.reserve(config.pasted_length);
 
     // Add gap characters on one side and unknown on other side of gap.
     if (config.query_offset > config.subject_offset) {
@@ -408,16 +443,19 @@ void Alignment::PasteRight(const Alignment& other,
       query_gap_char = '-';
       subject_gap_char = 'N';
     }
-    new_qseq = CombineRight(qseq_, other.Qseq(), partition, query_gap_char);
-    new_sseq = CombineRight(sseq_, other.Sseq(), partition, subject_gap_char);
-    qseq_ = std::move(new_qseq);
-    sseq_ = std::move(new_sseq);
+    CombineRight(qseq_, other.PackedQseq(), partition, query_gap_char);
+    CombineRight(sseq_, other.PackedSseq(), partition, subject_gap_char);
+  }
+  raw_fields_ = std::string_view{};
+  if (!qseq_.IsView() && !sseq_.IsView()) {
+    row_owner_.reset();
   }
   pasted_identifiers_.insert(pasted_identifiers_.end(),
                              other.PastedIdentifiers().begin(),
                              other.PastedIdentifiers().end());
   length_ = config.pasted_length;
   qend_ = other.Qend();
+  canonical_send_ = other.CanonicalSend();
   if (plus_strand_) {
     send_ = other.Send();
   } else {
@@ -438,17 +476,15 @@ void Alignment::PasteLeft(const Alignment& other,
                           const ScoringSystem& scoring_system,
                           const PasteParameters& paste_parameters) {
   // Invariant sanity checks.
-  assert(qseq_.length() == sseq_.length());
-  assert(other.Qseq().length() == other.Sseq().length());
+  assert(qseq_.Length() == sseq_.Length());
+  assert(other.PackedQseq().Length() == other.PackedSseq().Length());
 
   // Preconditions.
   if (plus_strand_ != other.PlusStrand()
       || qstart_ <= other.Qstart()
       || qend_ <= other.Qend()
-      || (plus_strand_ && (sstart_ <= other.Sstart()
-                           || send_ <= other.Send()))
-      || (!plus_strand_ && (sstart_ >= other.Sstart()
-                            || send_ >= other.Send()))) {
+      || canonical_sstart_ <= other.CanonicalSstart()
+      || canonical_send_ <= other.CanonicalSend()) {
     std::stringstream error_message;
     error_message << "Invalid configuration for pasting alignment "
                   << other.DebugString() << " onto the left of alignment "
@@ -467,10 +503,8 @@ void Alignment::PasteLeft(const Alignment& other,
 
   // Deploy changes.
   if (!paste_parameters.blind_mode) {
-    std::string new_qseq, new_sseq;
+    PackedSequence new_qseq, new_sseq;
     char query_gap_char, subject_gap_char;
-    new_qseq.reserve(config.pasted_length);
-    new_sseq.reserve(config.pasted_length);
 
     // Add gap characters on one side and unknown on other side of gap.
     if (config.query_offset > config.subject_offset) {
@@ -480,16 +514,23 @@ void Alignment::PasteLeft(const Alignment& other,
       query_gap_char = '-';
       subject_gap_char = 'N';
     }
-    new_qseq = CombineLeft(other.Qseq(), qseq_, partition, query_gap_char);
-    new_sseq = CombineLeft(other.Sseq(), sseq_, partition, subject_gap_char);
+    new_qseq = CombineLeft(other.PackedQseq(), qseq_, partition,
+                           query_gap_char);
+    new_sseq = CombineLeft(other.PackedSseq(), sseq_, partition,
+                           subject_gap_char);
     qseq_ = std::move(new_qseq);
     sseq_ = std::move(new_sseq);
   }
+  raw_fields_ = std::string_view{};
+  if (!qseq_.IsView() && !sseq_.IsView()) {
+    row_owner_.reset();
+  }
   pasted_identifiers_.insert(pasted_identifiers_.end(),
                              other.PastedIdentifiers().begin(),
                              other.PastedIdentifiers().end());
   length_ = config.pasted_length;
   qstart_ = other.Qstart();
+  canonical_sstart_ = other.CanonicalSstart();
   if (plus_strand_) {
     sstart_ = other.Sstart();
   } else {
@@ -503,6 +544,35 @@ void Alignment::PasteLeft(const Alignment& other,
   UpdateSimilarityMeasures(scoring_system, paste_parameters);
 }
 
+// Alignment::Outline
+//
+Alignment Alignment::Outline() const {
+  Alignment result{Id()};
+  result.qstart_ = qstart_;
+  result.qend_ = qend_;
+  result.sstart_ = sstart_;
+  result.send_ = send_;
+  result.plus_strand_ = plus_strand_;
+  result.canonical_sstart_ = canonical_sstart_;
+  result.canonical_send_ = canonical_send_;
+  result.nident_ = nident_;
+  result.mismatch_ = mismatch_;
+  result.gapopen_ = gapopen_;
+  result.gaps_ = gaps_;
+  result.qlen_ = qlen_;
+  result.slen_ = slen_;
+  result.length_ = length_;
+  result.pident_ = pident_;
+  result.raw_score_ = raw_score_;
+  result.bitscore_ = bitscore_;
+  result.evalue_ = evalue_;
+  result.include_in_output_ = include_in_output_;
+  result.ungapped_prefix_end_ = ungapped_prefix_end_;
+  result.ungapped_suffix_begin_ = ungapped_suffix_begin_;
+  result.nmatches_ = nmatches_;
+  return result;
+}
+
 // Alignment::operator==
 //
 bool Alignment::operator==(const Alignment& other) const {
@@ -569,8 +639,8 @@ std::string Alignment::DebugString() const {
      << ", qlen=" << qlen_
      << ", slen=" << slen_
      << ", length=" << length_
-     << ", qseq='" << qseq_
-     << "', sseq='" << sseq_
+     << ", qseq='" << qseq_.ToString()
+     << "', sseq='" << sseq_.ToString()
      << "', pident=" << pident_
      << ", raw_score=" << raw_score_
      << ", bitscore=" << bitscore_
@@ -22,16 +22,139 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <tuple>
 #include <unordered_set>
 #include <utility>
 
 namespace paste_alignments {
 
+// AlignmentBatch::ResetAlignments helpers.
+//
+namespace {
+
+// Indicates whether `first` at position `first_pos` precedes `second` at
+// position `second_pos` in `ScoreSorted` order, i.e. by lexicographic key
+// (raw score, pident, position), the first two descending and compared with
+// `helpers::FuzzyFloatEquals`.
+//
+inline bool ScoreOrderBefore(const Alignment& first, int first_pos,
+                             const Alignment& second, int second_pos,
+                             float epsilon) {
+  if (helpers::FuzzyFloatEquals(first.RawScore(), second.RawScore(),
+                                epsilon)) {
+    if (helpers::FuzzyFloatEquals(first.Pident(), second.Pident(), epsilon)) {
+      return first_pos < second_pos;
+    }
+    return first.Pident() > second.Pident();
+  }
+  return first.RawScore() > second.RawScore();
+}
+
+// Diagonal on which `alignment` starts in canonical subject coordinates.
+//
+inline int StartDiagonal(const Alignment& alignment) {
+  return alignment.Qstart() - alignment.CanonicalSstart();
+}
+
+// Indicates whether `other` is redundant to `kept`, i.e. whether both its
+// query and subject intervals are contained in those of `kept` and its score is
+// not larger.
+//
+inline bool Redundant(const Alignment& other, const Alignment& kept) {
+  return (kept.Qstart() <= other.Qstart() && other.Qend() <= kept.Qend()
+          && kept.Sstart() <= other.Sstart() && other.Send() <= kept.Send()
+          && other.RawScore() <= kept.RawScore());
+}
+
+// Removes alignments from `alignments` which are redundant to another
+// alignment starting on the same diagonal and returns the identifiers of the
+// removed alignments paired with those of the alignments they are redundant to.
+// The order of the remaining alignments is preserved.
+//
+std::vector<std::pair<int,int>> RemoveRedundant(
+    std::vector<Alignment>& alignments) {
+  // Sort by strand, diagonal, query start ascending, query end descending,
+  // score descending, and identifier ascending, so that an alignment can only
+  // be redundant to alignments preceding it.
+  std::vector<int> order(alignments.size());
+  std::vector<int> diagonals;
+  diagonals.reserve(alignments.size());
+  for (int i = 0; i < static_cast<int>(alignments.size()); ++i) {
+    order.at(i) = i;
+    diagonals.push_back(StartDiagonal(alignments.at(i)));
+  }
+  std::sort(order.begin(), order.end(),
+            [&alignments, &diagonals](int first, int second) {
+              const Alignment& a{alignments.at(first)};
+              const Alignment& b{alignments.at(second)};
+              if (a.PlusStrand() != b.PlusStrand()) {
+                return a.PlusStrand();
+              } else if (diagonals.at(first) != diagonals.at(second)) {
+                return diagonals.at(first) < diagonals.at(second);
+              } else if (a.Qstart() != b.Qstart()) {
+                return a.Qstart() < b.Qstart();
+              } else if (a.Qend() != b.Qend()) {
+                return a.Qend() > b.Qend();
+              } else if (a.RawScore() != b.RawScore()) {
+                return a.RawScore() > b.RawScore();
+              }
+              return a.Id() < b.Id();
+            });
+
+  // Compare each alignment with the kept alignment of its diagonal reaching
+  // furthest in query.
+  std::vector<std::pair<int,int>> result;
+  std::vector<bool> removed(alignments.size(), false);
+  int reaching{-1};
+  for (int i : order) {
+    const Alignment& alignment{alignments.at(i)};
+    if (reaching != -1
+        && alignments.at(reaching).PlusStrand() == alignment.PlusStrand()
+        && diagonals.at(reaching) == diagonals.at(i)) {
+      if (Redundant(alignment, alignments.at(reaching))) {
+        removed.at(i) = true;
+        result.emplace_back(alignment.Id(), alignments.at(reaching).Id());
+        continue;
+      } else if (alignment.Qend() <= alignments.at(reaching).Qend()) {
+        continue;
+      }
+    }
+    reaching = i;
+  }
+  if (result.empty()) {
+    return result;
+  }
+
+  int num_kept{0};
+  for (int i = 0; i < static_cast<int>(alignments.size()); ++i) {
+    if (!removed.at(i)) {
+      if (num_kept != i) {
+        alignments.at(num_kept) = std::move(alignments.at(i));
+      }
+      ++num_kept;
+    }
+  }
+  alignments.erase(alignments.begin() + num_kept, alignments.end());
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace
+
 // AlignmentBatch::ResetAlignments
 //
 void AlignmentBatch::ResetAlignments(std::vector<Alignment> alignments,
                                      const PasteParameters& paste_parameters) {
+  std::vector<std::pair<int,int>> removed;
+  if (paste_parameters.remove_redundant) {
+    removed = RemoveRedundant(alignments);
+  }
   std::vector<int> score_sorted;
   std::vector<std::pair<int, int>> qstart_sorted, qend_sorted;
   score_sorted.reserve(alignments.size());
@@ -45,29 +168,11 @@ void AlignmentBatch::ResetAlignments(std::vector<Alignment> alignments,
   }
 
   std::sort(score_sorted.begin(), score_sorted.end(),
-            // Sort by lexicographic key (raw score, pident, id), both
-            // descending. Consider two floats equal according to
-            // helpers::FuzzyFloatEquals.
             [&alignments = std::as_const(alignments),
              &epsilon = std::as_const(paste_parameters.float_epsilon)](
                 int first, int second) {
-              float first_score, second_score, first_pident, second_pident;
-              first_score = alignments.at(first).RawScore();
-              second_score = alignments.at(second).RawScore();
-              first_pident = alignments.at(first).Pident();
-              second_pident = alignments.at(second).Pident();
-              if (helpers::FuzzyFloatEquals(
-                      first_score, second_score, epsilon)) {
-                if (helpers::FuzzyFloatEquals(
-                        first_pident, second_pident, epsilon)) {
-                  return first < second;
-                } else if (first_pident > second_pident) {
-                  return true;
-                }
-              } else if (first_score > second_score) {
-                return true;
-              }
-              return false;
+              return ScoreOrderBefore(alignments.at(first), first,
+                                      alignments.at(second), second, epsilon);
             });
   std::sort(qstart_sorted.begin(), qstart_sorted.end());
   std::sort(qend_sorted.begin(), qend_sorted.end());
@@ -76,6 +181,40 @@ void AlignmentBatch::ResetAlignments(std::vector<Alignment> alignments,
   score_sorted_ = std::move(score_sorted);
   qstart_sorted_ = std::move(qstart_sorted);
   qend_sorted_ = std::move(qend_sorted);
+  removed_ = std::move(removed);
+  SplitStrands();
+}
+
+// AlignmentBatch::SplitStrands
+//
+void AlignmentBatch::SplitStrands() {
+  plus_qstart_sorted_.clear();
+  minus_qstart_sorted_.clear();
+  plus_qend_sorted_.clear();
+  minus_qend_sorted_.clear();
+  for (const std::pair<int,int>& qstart_pos : qstart_sorted_) {
+    (alignments_.at(qstart_pos.second).PlusStrand()
+     ? plus_qstart_sorted_ : minus_qstart_sorted_).push_back(qstart_pos);
+  }
+  for (const std::pair<int,int>& qend_pos : qend_sorted_) {
+    (alignments_.at(qend_pos.second).PlusStrand()
+     ? plus_qend_sorted_ : minus_qend_sorted_).push_back(qend_pos);
+  }
+}
+
+// AlignmentBatch::UpdateSimilarityMeasures
+//
+void AlignmentBatch::UpdateSimilarityMeasures(
+    const ScoringSystem& scoring_system,
+    const PasteParameters& paste_parameters) {
+  for (Alignment& alignment : alignments_) {
+    alignment.UpdateSimilarityMeasures(scoring_system, paste_parameters);
+  }
+  std::vector<std::pair<int,int>> removed{std::move(removed_)};
+  ResetAlignments(std::move(alignments_), paste_parameters);
+  removed.insert(removed.end(), removed_.begin(), removed_.end());
+  std::sort(removed.begin(), removed.end());
+  removed_ = std::move(removed);
 }
 
 // Helper functions for AlignmentBatch::PasteAlignments
@@ -191,18 +330,250 @@ int FindFirstGreaterQstart(
   }
 }
 
+// When an alignment with raw score `score` is further than this bound in query
+// or subject to another alignment, then the two cannot be pasted together. The
+// bound does not decrease as `score` increases.
+//
+int GetDistanceBound(float score,
+                     const ScoringSystem& scoring_system,
+                     const PasteParameters& paste_parameters) {
+  return (((2.0f * score - paste_parameters.intermediate_score_threshold)
+           / scoring_system.Penalty())
+          + static_cast<float>(paste_parameters.gap_tolerance));
+}
+
 // When an alignment is further than this bound in query or subject to
 // `alignment`, then the two cannot be pasted together.
 //
 int GetDistanceBound(const Alignment& alignment,
                      const ScoringSystem& scoring_system,
                      const PasteParameters& paste_parameters) {
-  return (((2.0f * alignment.RawScore()
-            - paste_parameters.intermediate_score_threshold)
-           / scoring_system.Penalty())
-          + static_cast<float>(paste_parameters.gap_tolerance));
+  return GetDistanceBound(alignment.RawScore(), scoring_system,
+                          paste_parameters);
+}
+
+// Indicates whether `score` reaches the exact raw score cutoff converted from
+// the evalue and bitscore thresholds.
+//
+inline bool ReachesScoreCutoff(double score,
+                               const PasteParameters& paste_parameters) {
+  return score >= paste_parameters.final_score_cutoff;
+}
+
+// Indicates whether `alignment` satisfies the final thresholds.
+//
+inline bool SatisfiesFinalThresholds(const Alignment& alignment,
+                                     const PasteParameters& paste_parameters) {
+  return (alignment.SatisfiesThresholds(paste_parameters.final_pident_threshold,
+                                        paste_parameters.final_score_threshold,
+                                        paste_parameters)
+          && ReachesScoreCutoff(alignment.RawScore(), paste_parameters));
 }
 
+// Maximum number of refinements of a seed's score bound.
+//
+constexpr int kMaxBoundRefinements{4};
+
+// Computes upper bounds on the raw score of any alignment obtainable by
+// pasting unused alignments onto a seed.
+//
+// Pasting never increases the sum of the pasted alignments' raw scores, so the
+// score of a pasted alignment is at most the seed's score plus the positive
+// scores of the unused alignments on the seed's strand it could reach. If the
+// score stays below `U`, no two consecutively pasted alignments are more than
+// `GetDistanceBound(U)` apart in query, so every reachable alignment lies in
+// the seed's cluster of alignments whose query intervals, sorted by query
+// start, are separated by gaps of at most that distance. Starting from the sum
+// over the whole batch, the bound is refined by summing over the cluster of the
+// previous bound's distance.
+//
+// Positive scores of unused alignments are kept in a Fenwick tree over the
+// `QstartSorted` order for each strand, and cluster boundaries are found by
+// descending a max-segment tree over the gaps between consecutive positions.
+//
+class SeedBounds {
+ public:
+  // Prepares bounds for `alignments` of which those in `used` are used.
+  //
+  SeedBounds(const std::vector<Alignment>& alignments,
+             const std::vector<std::pair<int,int>>& qstart_sorted,
+             const std::unordered_set<int>& used)
+      : size_{static_cast<int>(qstart_sorted.size())},
+        sorted_pos_(qstart_sorted.size()),
+        plus_scores_(qstart_sorted.size() + 1, 0.0),
+        minus_scores_(qstart_sorted.size() + 1, 0.0) {
+    num_leaves_ = 1;
+    while (num_leaves_ < size_) {
+      num_leaves_ *= 2;
+    }
+    gaps_.assign(2 * num_leaves_, std::numeric_limits<int>::min());
+    int max_qend{std::numeric_limits<int>::min()};
+    for (int k = 0; k < size_; ++k) {
+      const Alignment& alignment{alignments.at(qstart_sorted.at(k).second)};
+      sorted_pos_.at(qstart_sorted.at(k).second) = k;
+      if (alignment.RawScore() > 0.0f
+          && !used.count(qstart_sorted.at(k).second)) {
+        AddScore(k, alignment.PlusStrand(),
+                 static_cast<double>(alignment.RawScore()));
+      }
+      max_qend = std::max(max_qend, alignment.Qend());
+      if (k + 1 < size_) {
+        gaps_.at(num_leaves_ + k) = qstart_sorted.at(k + 1).first - max_qend
+                                    - 1;
+      }
+    }
+    for (int node = num_leaves_ - 1; node > 0; --node) {
+      gaps_.at(node) = std::max(gaps_.at(2 * node), gaps_.at(2 * node + 1));
+    }
+  }
+
+  // Marks unused alignment `alignment` at position `alignment_pos` as used.
+  //
+  void Remove(int alignment_pos, const Alignment& alignment) {
+    if (alignment.RawScore() > 0.0f) {
+      AddScore(sorted_pos_.at(alignment_pos), alignment.PlusStrand(),
+               -static_cast<double>(alignment.RawScore()));
+    }
+  }
+
+  // Indicates whether pasting unused alignments onto the seed `seed` at
+  // position `seed_pos` can yield an alignment satisfying the final score
+  // threshold. Assumes that the seed is marked as used.
+  //
+  bool CanReachFinalScore(int seed_pos, const Alignment& seed,
+                          const ScoringSystem& scoring_system,
+                          const PasteParameters& paste_parameters) const {
+    return CanReachScore(seed_pos, seed,
+                         paste_parameters.final_score_threshold,
+                         paste_parameters.final_score_cutoff,
+                         scoring_system, paste_parameters);
+  }
+
+  // Indicates whether pasting unused alignments onto the seed `seed` at
+  // position `seed_pos` can yield an alignment whose score is not fuzzily
+  // less than `score` and not less than `score_cutoff`. Assumes that the seed
+  // is marked as used.
+  //
+  bool CanReachScore(int seed_pos, const Alignment& seed, float score,
+                     float score_cutoff,
+                     const ScoringSystem& scoring_system,
+                     const PasteParameters& paste_parameters) const {
+    int k{sorted_pos_.at(seed_pos)};
+    double bound{static_cast<double>(seed.RawScore())
+                 + SumScores(0, size_ - 1, seed.PlusStrand())};
+    for (int i = 0; i < kMaxBoundRefinements; ++i) {
+      if (!Reaches(bound, score, score_cutoff, paste_parameters)) {
+        return false;
+      }
+      int distance_bound{GetDistanceBound(static_cast<float>(bound),
+                                          scoring_system, paste_parameters)};
+      int first{LastGapAbove(k - 1, distance_bound) + 1};
+      int last{FirstGapAbove(k, distance_bound)};
+      double refined{static_cast<double>(seed.RawScore())
+                     + SumScores(first, last, seed.PlusStrand())};
+      if (refined >= bound) {
+        break;
+      }
+      bound = refined;
+    }
+    return Reaches(bound, score, score_cutoff, paste_parameters);
+  }
+
+ private:
+  // Indicates whether `bound` is not fuzzily less than `score` and not less
+  // than `score_cutoff`.
+  //
+  static bool Reaches(double bound, float score, float score_cutoff,
+                      const PasteParameters& paste_parameters) {
+    return (helpers::SatisfiesThresholds(
+                100.0f, static_cast<float>(bound), 0.0f, score,
+                paste_parameters.float_epsilon)
+            && bound >= score_cutoff);
+  }
+
+  // Adds `delta` to the score at position `k` of the strand's Fenwick tree.
+  //
+  void AddScore(int k, bool plus_strand, double delta) {
+    std::vector<double>& tree{plus_strand ? plus_scores_ : minus_scores_};
+    for (int i = k + 1; i <= size_; i += (i & -i)) {
+      tree.at(i) += delta;
+    }
+  }
+
+  // Returns the sum of scores at positions [`first`, `last`] of the strand.
+  //
+  double SumScores(int first, int last, bool plus_strand) const {
+    const std::vector<double>& tree{plus_strand ? plus_scores_
+                                                : minus_scores_};
+    double result{0.0};
+    for (int i = last + 1; i > 0; i -= (i & -i)) {
+      result += tree.at(i);
+    }
+    for (int i = first; i > 0; i -= (i & -i)) {
+      result -= tree.at(i);
+    }
+    return std::max(0.0, result);
+  }
+
+  // Returns the first position `k >= from` whose following gap exceeds
+  // `distance`, or the last position if there is none.
+  //
+  int FirstGapAbove(int from, int distance) const {
+    int result{FirstGapAbove(1, 0, num_leaves_, from, distance)};
+    return (result == -1 ? size_ - 1 : std::min(result, size_ - 1));
+  }
+
+  int FirstGapAbove(int node, int node_begin, int node_end, int from,
+                    int distance) const {
+    if (node_end <= from || gaps_.at(node) <= distance) {
+      return -1;
+    } else if (node >= num_leaves_) {
+      return node_begin;
+    }
+    int node_middle{node_begin + (node_end - node_begin) / 2};
+    int result{FirstGapAbove(2 * node, node_begin, node_middle, from,
+                             distance)};
+    if (result == -1) {
+      result = FirstGapAbove(2 * node + 1, node_middle, node_end, from,
+                             distance);
+    }
+    return result;
+  }
+
+  // Returns the last position `k <= to` whose following gap exceeds
+  // `distance`, or -1 if there is none.
+  //
+  int LastGapAbove(int to, int distance) const {
+    if (to < 0) {
+      return -1;
+    }
+    return LastGapAbove(1, 0, num_leaves_, to, distance);
+  }
+
+  int LastGapAbove(int node, int node_begin, int node_end, int to,
+                   int distance) const {
+    if (node_begin > to || gaps_.at(node) <= distance) {
+      return -1;
+    } else if (node >= num_leaves_) {
+      return node_begin;
+    }
+    int node_middle{node_begin + (node_end - node_begin) / 2};
+    int result{LastGapAbove(2 * node + 1, node_middle, node_end, to,
+                            distance)};
+    if (result == -1) {
+      result = LastGapAbove(2 * node, node_begin, node_middle, to, distance);
+    }
+    return result;
+  }
+
+  int size_;
+  int num_leaves_;
+  std::vector<int> sorted_pos_; // Position in QstartSorted of each alignment.
+  std::vector<int> gaps_; // Max-segment tree; leaf k is the gap after k.
+  std::vector<double> plus_scores_;
+  std::vector<double> minus_scores_;
+};
+
 // Indicates whether `first` is the better candidate for pasting.
 //
 bool BetterCandidate(const PasteCandidate& first,
@@ -215,11 +586,13 @@ bool BetterCandidate(const PasteCandidate& first,
   first_final = helpers::SatisfiesThresholds(
       first.pident, first.score,
       parameters.final_pident_threshold, parameters.final_score_threshold,
-      parameters.float_epsilon);
+      parameters.float_epsilon)
+      && ReachesScoreCutoff(first.score, parameters);
   second_final = helpers::SatisfiesThresholds(
       second.pident, second.score,
       parameters.final_pident_threshold, parameters.final_score_threshold,
-      parameters.float_epsilon);
+      parameters.float_epsilon)
+      && ReachesScoreCutoff(second.score, parameters);
   if (first_final && !second_final) {
     return true;
   } else if (second_final && !first_final) {
@@ -246,11 +619,7 @@ AlignmentConfiguration GetConfiguration(const Alignment& left,
   AlignmentConfiguration config;
 
   config.query_offset = right.Qstart() - left.Qend() - 1;
-  if (left.PlusStrand()) {
-    config.subject_offset = right.Sstart() - left.Send() - 1;
-  } else {
-    config.subject_offset = left.Sstart() - right.Send() - 1;
-  }
+  config.subject_offset = right.CanonicalSstart() - left.CanonicalSend() - 1;
 
   config.query_overlap = std::abs(std::min(0, config.query_offset));
   config.query_distance = std::max(0, config.query_offset);
@@ -286,8 +655,23 @@ MatchCounts GetCounts(const Alignment& first, const Alignment& second,
   return result;
 }
 
+// Counts the candidates scanned while pasting a batch against a limit, which
+// is absent if not positive.
+//
+struct ScanBudget {
+  long num_scanned{0l};
+  long limit{0l};
+
+  // Indicates whether the limit is reached.
+  //
+  bool Exhausted() const {return limit > 0l && num_scanned >= limit;}
+};
+
 // Searches for next pastable alignment to the left of `alignment `in query.
-// Assumes that `candidate_sorted_pos` is in the range [-1, qend_sorted.size()).
+// `qend_sorted` holds the alignments on the strand of `alignment`. Assumes that
+// `candidate_sorted_pos` is in the range [-1, qend_sorted.size()).
+// Each scanned alignment is counted in `budget`, and the search ends without
+// result once it is exhausted.
 //
 PasteCandidate FindLeftCandidate(
     int candidate_sorted_pos,
@@ -297,12 +681,12 @@ PasteCandidate FindLeftCandidate(
     const std::vector<Alignment>& alignments,
     const std::unordered_set<int>& used,
     const ScoringSystem& scoring_system,
-    const PasteParameters& paste_parameters) {
+    const PasteParameters& paste_parameters,
+    ScanBudget& budget) {
   assert(-1 <= candidate_sorted_pos);
   assert(candidate_sorted_pos < static_cast<int>(qend_sorted.size()));
-  int result_distance, result_qstart, max_overlap, result_sstart, result_send;
+  int result_distance, max_overlap;
   MatchCounts counts;
-  bool result_plus_strand;
   PasteCandidate result;
   result.sorted_pos = candidate_sorted_pos;
   if (result.sorted_pos == -1) {
@@ -310,36 +694,28 @@ PasteCandidate FindLeftCandidate(
   }
 
   while (result.sorted_pos != -1) {
+    if (budget.Exhausted()) {
+      result.sorted_pos = -1;
+      break;
+    }
+    ++budget.num_scanned;
     result.alignment_pos = qend_sorted.at(result.sorted_pos).second;
-    result_distance = alignment.Qstart()
-                      - alignments.at(result.alignment_pos).Qend()
-                      - 1;
-    result_qstart = alignments.at(result.alignment_pos).Qstart();
-    result_sstart = alignments.at(result.alignment_pos).Sstart();
-    result_send = alignments.at(result.alignment_pos).Send();
-    result_plus_strand = alignments.at(result.alignment_pos).PlusStrand();
+    const Alignment& candidate{alignments.at(result.alignment_pos)};
+    assert(candidate.PlusStrand() == alignment.PlusStrand());
+    result_distance = alignment.Qstart() - candidate.Qend() - 1;
 
     if (result_distance > distance_bound) {
       result.sorted_pos = -1;
-    } else if (alignment.PlusStrand() == result_plus_strand
-               && result_qstart < alignment.Qstart()
-               && ((alignment.PlusStrand() && (result_sstart
-                                               < alignment.Sstart()
-                                               && result_send
-                                               < alignment.Send()))
-                   || (!alignment.PlusStrand() && (result_sstart
-                                                  > alignment.Sstart()
-                                                  && result_send
-                                                  > alignment.Send())))
+    } else if (candidate.Qstart() < alignment.Qstart()
+               && candidate.CanonicalSstart() < alignment.CanonicalSstart()
+               && candidate.CanonicalSend() < alignment.CanonicalSend()
                && !used.count(result.alignment_pos)) {
-      result.config = GetConfiguration(alignments.at(result.alignment_pos),
-                                       alignment);
+      result.config = GetConfiguration(candidate, alignment);
       max_overlap = std::max(result.config.query_overlap,
                              result.config.subject_overlap);
       if (result.config.shift <= paste_parameters.gap_tolerance
           && max_overlap < alignment.UngappedPrefixEnd()) {
-        counts = GetCounts(alignment, alignments.at(result.alignment_pos),
-                           result.config);
+        counts = GetCounts(alignment, candidate, result.config);
         result.pident = helpers::Percentage(counts.nident,
                                             result.config.pasted_length);
         result.score = scoring_system.RawScore(counts.nident, counts.mismatch,
@@ -361,8 +737,10 @@ PasteCandidate FindLeftCandidate(
 }
 
 // Searches for next pastable alignment to the right of `alignment `in query.
-// Assumes that `candidate_sorted_pos` is in the range
-// [-1, qstart_sorted.size()).
+// `qstart_sorted` holds the alignments on the strand of `alignment`. Assumes
+// that `candidate_sorted_pos` is in the range [-1, qstart_sorted.size()).
+// Each scanned alignment is counted in `budget`, and the search ends without
+// result once it is exhausted.
 //
 PasteCandidate FindRightCandidate(
     int candidate_sorted_pos,
@@ -372,13 +750,12 @@ PasteCandidate FindRightCandidate(
     const std::vector<Alignment>& alignments,
     const std::unordered_set<int>& used,
     const ScoringSystem& scoring_system,
-    const PasteParameters& paste_parameters) {
+    const PasteParameters& paste_parameters,
+    ScanBudget& budget) {
   assert(-1 <= candidate_sorted_pos);
   assert(candidate_sorted_pos < static_cast<int>(qstart_sorted.size()));
-  int result_distance, result_qend, max_overlap, alignment_suffix_length,
-      result_sstart, result_send;
+  int result_distance, max_overlap, alignment_suffix_length;
   MatchCounts counts;
-  bool result_plus_strand;
   PasteCandidate result;
   result.sorted_pos = candidate_sorted_pos;
   if (result.sorted_pos == -1) {
@@ -387,37 +764,29 @@ PasteCandidate FindRightCandidate(
   }
   
   while (result.sorted_pos != -1) {
+    if (budget.Exhausted()) {
+      result.sorted_pos = -1;
+      break;
+    }
+    ++budget.num_scanned;
     result.alignment_pos = qstart_sorted.at(result.sorted_pos).second;
-    result_distance = alignments.at(result.alignment_pos).Qstart()
-                      - alignment.Qend()
-                      - 1;
-    result_qend = alignments.at(result.alignment_pos).Qend();
-    result_sstart = alignments.at(result.alignment_pos).Sstart();
-    result_send = alignments.at(result.alignment_pos).Send();
-    result_plus_strand = alignments.at(result.alignment_pos).PlusStrand();
+    const Alignment& candidate{alignments.at(result.alignment_pos)};
+    assert(candidate.PlusStrand() == alignment.PlusStrand());
+    result_distance = candidate.Qstart() - alignment.Qend() - 1;
     if (result_distance > distance_bound) {
       result.sorted_pos = -1;
-    } else if (alignment.PlusStrand() == result_plus_strand
-               && alignment.Qend() < result_qend
-               && ((alignment.PlusStrand() && (result_sstart
-                                               > alignment.Sstart()
-                                               && result_send
-                                               > alignment.Send()))
-                   || (!alignment.PlusStrand() && (result_sstart
-                                                  < alignment.Sstart()
-                                                  && result_send
-                                                  < alignment.Send())))
+    } else if (alignment.Qend() < candidate.Qend()
+               && alignment.CanonicalSstart() < candidate.CanonicalSstart()
+               && alignment.CanonicalSend() < candidate.CanonicalSend()
                && !used.count(result.alignment_pos)) {
-      result.config = GetConfiguration(alignment,
-                                       alignments.at(result.alignment_pos));
+      result.config = GetConfiguration(alignment, candidate);
       max_overlap = std::max(result.config.query_overlap,
                              result.config.subject_overlap);
       alignment_suffix_length = alignment.Length()
                                 - alignment.UngappedSuffixBegin();
       if (result.config.shift <= paste_parameters.gap_tolerance
           && max_overlap < alignment_suffix_length) {
-        counts = GetCounts(alignment, alignments.at(result.alignment_pos),
-                           result.config);
+        counts = GetCounts(alignment, candidate, result.config);
         result.pident = helpers::Percentage(counts.nident,
                                             result.config.pasted_length);
         result.score = scoring_system.RawScore(counts.nident, counts.mismatch,
@@ -441,6 +810,157 @@ PasteCandidate FindRightCandidate(
   return result;
 }
 
+// Batches of at most this many alignments are pasted without seed bounds by
+// the automatically chosen strategy.
+//
+constexpr int kMaxBruteForceSize{16};
+
+// Batches of fewer alignments are not split into clusters by the automatically
+// chosen strategy.
+//
+constexpr int kMinClusterParallelSize{1024};
+
+// Batches are only pasted cluster by cluster if no cluster holds more than
+// this percentage of the alignments.
+//
+constexpr std::size_t kMaxClusterShare{75};
+
+// Maximum number of chains evaluated as predecessors of each alignment by
+// `AlignmentBatch::ChainAlignments`.
+//
+constexpr int kMaxChainCandidates{64};
+
+// Diagonal on which `alignment` ends in canonical subject coordinates.
+//
+inline int EndDiagonal(const Alignment& alignment) {
+  return alignment.Qend() - alignment.CanonicalSend();
+}
+
+// Range-maximum tree over the scores of chains ending at the positions of a
+// fixed order. Positions without chain hold negative infinity.
+//
+class ChainIndex {
+ public:
+  // Prepares the tree for `size` positions without chains.
+  //
+  explicit ChainIndex(int size) : num_leaves_{1} {
+    while (num_leaves_ < size) {
+      num_leaves_ *= 2;
+    }
+    scores_.assign(2 * num_leaves_, -std::numeric_limits<float>::infinity());
+  }
+
+  // Sets the score of position `k` to `score`.
+  //
+  void Set(int k, float score) {
+    int node{num_leaves_ + k};
+    scores_.at(node) = score;
+    for (node /= 2; node > 0; node /= 2) {
+      scores_.at(node) = std::max(scores_.at(2 * node),
+                                  scores_.at(2 * node + 1));
+    }
+  }
+
+  // Calls `visit(k, score)` for the positions `k` in [`first`, `last`) that
+  // hold a chain in descending order of their scores until `visit` returns
+  // false.
+  //
+  template <typename Visit>
+  void VisitDescending(int first, int last, Visit visit) const {
+    std::priority_queue<std::pair<float,int>> nodes;
+    for (int left = num_leaves_ + first, right = num_leaves_ + last;
+         left < right; left /= 2, right /= 2) {
+      if (left & 1) {
+        Push(left++, nodes);
+      }
+      if (right & 1) {
+        Push(--right, nodes);
+      }
+    }
+    while (!nodes.empty()) {
+      int node{nodes.top().second};
+      nodes.pop();
+      if (node >= num_leaves_) {
+        if (!visit(node - num_leaves_, scores_.at(node))) {
+          return;
+        }
+      } else {
+        Push(2 * node, nodes);
+        Push(2 * node + 1, nodes);
+      }
+    }
+  }
+
+ private:
+  // Adds `node` to `nodes` if its subtree holds a chain.
+  //
+  void Push(int node, std::priority_queue<std::pair<float,int>>& nodes) const {
+    if (scores_.at(node) > -std::numeric_limits<float>::infinity()) {
+      nodes.emplace(scores_.at(node), node);
+    }
+  }
+
+  int num_leaves_;
+  std::vector<float> scores_;
+};
+
+// Indicates whether `alignment` can be pasted onto the right of `chain`, which
+// ends with the alignment at position `chain_end`, under the rules applied by
+// `FindRightCandidate`. If so, `candidate` describes the pasting.
+//
+bool GetChainCandidate(int chain_end,
+                       const Alignment& chain,
+                       const Alignment& alignment,
+                       const ScoringSystem& scoring_system,
+                       const PasteParameters& paste_parameters,
+                       PasteCandidate& candidate) {
+  if (alignment.Qstart() - chain.Qend() - 1
+          > GetDistanceBound(chain, scoring_system, paste_parameters)
+      || chain.PlusStrand() != alignment.PlusStrand()
+      || chain.Qstart() >= alignment.Qstart()
+      || chain.Qend() >= alignment.Qend()
+      || chain.CanonicalSstart() >= alignment.CanonicalSstart()
+      || chain.CanonicalSend() >= alignment.CanonicalSend()) {
+    return false;
+  }
+  candidate.config = GetConfiguration(chain, alignment);
+  int max_overlap{std::max(candidate.config.query_overlap,
+                           candidate.config.subject_overlap)};
+  if (candidate.config.shift > paste_parameters.gap_tolerance
+      || max_overlap >= chain.Length() - chain.UngappedSuffixBegin()) {
+    return false;
+  }
+  MatchCounts counts{GetCounts(chain, alignment, candidate.config)};
+  candidate.sorted_pos = 0;
+  candidate.alignment_pos = chain_end;
+  candidate.pident = helpers::Percentage(counts.nident,
+                                         candidate.config.pasted_length);
+  candidate.score = scoring_system.RawScore(counts.nident, counts.mismatch,
+                                            counts.gapopen, counts.gaps);
+  return helpers::SatisfiesThresholds(
+      candidate.pident, candidate.score,
+      paste_parameters.intermediate_pident_threshold,
+      paste_parameters.intermediate_score_threshold,
+      paste_parameters.float_epsilon);
+}
+
+// Indicates whether pasting `first` yields a better chain than pasting
+// `second`, comparing (raw score, pident, position) lexicographically.
+//
+bool BetterChainCandidate(const PasteCandidate& first,
+                          const PasteCandidate& second,
+                          const PasteParameters& paste_parameters) {
+  if (helpers::FuzzyFloatEquals(first.score, second.score,
+                                paste_parameters.float_epsilon)) {
+    if (helpers::FuzzyFloatEquals(first.pident, second.pident,
+                                  paste_parameters.float_epsilon)) {
+      return first.alignment_pos < second.alignment_pos;
+    }
+    return first.pident > second.pident;
+  }
+  return first.score > second.score;
+}
+
 } // namespace
 
 // AlignmentBatch::PasteAlignments
@@ -452,30 +972,200 @@ void AlignmentBatch::PasteAlignments(const ScoringSystem& scoring_system,
   assert(qstart_sorted_.size() == Size());
   assert(qend_sorted_.size() == Size());
 
+  // Evalue and bitscore thresholds become an exact raw score cutoff, so that
+  // pasting compares raw scores only.
+  if (!alignments_.empty()
+      && (paste_parameters.final_evalue > 0.0
+          || paste_parameters.final_bitscore > 0.0f)) {
+    PasteParameters raw_parameters{paste_parameters};
+    if (paste_parameters.final_evalue > 0.0) {
+      raw_parameters.final_score_cutoff = std::max(
+          raw_parameters.final_score_cutoff,
+          scoring_system.EvalueScoreThreshold(paste_parameters.final_evalue,
+                                              alignments_.front().Qlen(),
+                                              paste_parameters));
+    }
+    if (paste_parameters.final_bitscore > 0.0f) {
+      raw_parameters.final_score_cutoff = std::max(
+          raw_parameters.final_score_cutoff,
+          scoring_system.BitscoreScoreThreshold(
+              paste_parameters.final_bitscore, paste_parameters));
+    }
+    raw_parameters.final_evalue = 0.0;
+    raw_parameters.final_bitscore = 0.0f;
+    PasteAlignments(scoring_system, raw_parameters);
+    return;
+  }
+
+  num_seeds_ = 0;
+  num_pruned_seeds_ = 0;
+  num_scanned_candidates_ = 0l;
+  num_unextended_seeds_ = 0;
+  if (paste_parameters.engine == PastingEngine::kChain) {
+    engine_ = BatchEngine::kChain;
+  } else if (paste_parameters.engine == PastingEngine::kAuto
+             && static_cast<int>(Size()) <= kMaxBruteForceSize) {
+    engine_ = BatchEngine::kBruteForce;
+  } else {
+    engine_ = BatchEngine::kIndexedGreedy;
+  }
   if (alignments_.empty()) {return;}
+
+  if (engine_ == BatchEngine::kChain) {
+    ChainAlignments(scoring_system, paste_parameters);
+    LimitOutput(paste_parameters);
+    return;
+  }
+
+  // Clusters are only worth finding if they can be pasted in parallel.
+  if (paste_parameters.engine == PastingEngine::kAuto
+      && engine_ == BatchEngine::kIndexedGreedy
+      && paste_parameters.num_threads > 1
+      && paste_parameters.candidate_budget <= 0l
+      && paste_parameters.max_alignments_per_batch <= 0
+      && static_cast<int>(Size()) >= kMinClusterParallelSize) {
+    std::vector<std::vector<int>> clusters{IndependentClusters(
+        scoring_system, paste_parameters)};
+    std::size_t largest{0};
+    for (const std::vector<int>& cluster : clusters) {
+      largest = std::max(largest, cluster.size());
+    }
+    if (clusters.size() > 1
+        && largest <= Size() * kMaxClusterShare / 100) {
+      engine_ = BatchEngine::kClusterParallel;
+      PasteClusters(clusters, scoring_system, paste_parameters);
+      return;
+    }
+  }
+  GreedyPaste(scoring_system, paste_parameters,
+              engine_ != BatchEngine::kBruteForce);
+  LimitOutput(paste_parameters);
+}
+
+// AlignmentBatch::LimitOutput
+//
+void AlignmentBatch::LimitOutput(const PasteParameters& paste_parameters) {
+  int max_output{paste_parameters.max_alignments_per_batch};
+  if (max_output <= 0) {return;}
+  std::vector<int> included;
+  for (int i = 0; i < static_cast<int>(alignments_.size()); ++i) {
+    if (alignments_.at(i).IncludeInOutput()) {
+      included.push_back(i);
+    }
+  }
+  if (static_cast<int>(included.size()) <= max_output) {return;}
+  std::nth_element(included.begin(), included.begin() + (max_output - 1),
+                   included.end(),
+                   [this, &paste_parameters](int first, int second) {
+                     return ScoreOrderBefore(alignments_.at(first), first,
+                                             alignments_.at(second), second,
+                                             paste_parameters.float_epsilon);
+                   });
+  for (auto it = included.begin() + max_output; it != included.end(); ++it) {
+    alignments_.at(*it).IncludeInOutput(false);
+  }
+}
+
+// AlignmentBatch::GreedyPaste
+//
+void AlignmentBatch::GreedyPaste(const ScoringSystem& scoring_system,
+                                 const PasteParameters& paste_parameters,
+                                 bool prune_seeds) {
   std::unordered_set<int> used, temp_used;
   PasteCandidate left_candidate, right_candidate;
   int query_distance_bound;
   float cumulative_score;
+  std::unique_ptr<SeedBounds> seed_bounds;
+  ScanBudget budget;
+  budget.limit = paste_parameters.candidate_budget;
+  // Min-heap of the scores of the best alignments output so far if their
+  // number is limited.
+  int max_output{paste_parameters.max_alignments_per_batch};
+  std::vector<float> best_scores;
+  auto record_output{[&](const Alignment& alignment) {
+    if (max_output <= 0 || !alignment.IncludeInOutput()) {return;}
+    best_scores.push_back(alignment.RawScore());
+    std::push_heap(best_scores.begin(), best_scores.end(),
+                   std::greater<float>{});
+    if (static_cast<int>(best_scores.size()) > max_output) {
+      std::pop_heap(best_scores.begin(), best_scores.end(),
+                    std::greater<float>{});
+      best_scores.pop_back();
+    }
+  }};
 
   for (int i : score_sorted_) {
     if (!used.count(i)) {
 
-      // Initialize search parameters.
+      // Output remaining alignments on their own once the budget is exhausted.
+      if (budget.Exhausted()) {
+        ++num_unextended_seeds_;
+        alignments_.at(i).IncludeInOutput(
+            SatisfiesFinalThresholds(alignments_.at(i), paste_parameters));
+        record_output(alignments_.at(i));
+        continue;
+      }
+      ++num_seeds_;
       used.insert(i);
+      if (seed_bounds != nullptr) {
+        seed_bounds->Remove(i, alignments_.at(i));
+      }
+
+      // Skip seeds which cannot reach the final score threshold.
+      if (prune_seeds && (!alignments_.at(i).SatisfiesThresholds(
+              0.0f, paste_parameters.final_score_threshold,
+              paste_parameters)
+          || !ReachesScoreCutoff(alignments_.at(i).RawScore(),
+                                 paste_parameters))) {
+        if (seed_bounds == nullptr) {
+          seed_bounds.reset(new SeedBounds{alignments_, qstart_sorted_,
+                                           used});
+        }
+        if (!seed_bounds->CanReachFinalScore(i, alignments_.at(i),
+                                             scoring_system,
+                                             paste_parameters)) {
+          ++num_pruned_seeds_;
+          alignments_.at(i).IncludeInOutput(false);
+          continue;
+        }
+      }
+
+      // Skip seeds which cannot beat the worst of the best alignments output
+      // so far once the limit on the batch's output is reached.
+      if (max_output > 0
+          && static_cast<int>(best_scores.size()) == max_output) {
+        if (seed_bounds == nullptr) {
+          seed_bounds.reset(new SeedBounds{alignments_, qstart_sorted_,
+                                           used});
+        }
+        if (!seed_bounds->CanReachScore(i, alignments_.at(i),
+                                        best_scores.front(),
+                                        -std::numeric_limits<float>::infinity(),
+                                        scoring_system, paste_parameters)) {
+          alignments_.at(i).IncludeInOutput(false);
+          continue;
+        }
+      }
+
+      // Initialize search parameters. Candidates are only searched among the
+      // alignments on the seed's strand.
       temp_used.clear();
       Alignment current{alignments_.at(i)};
+      const std::vector<std::pair<int,int>>& qstart_sorted{
+          StrandQstartSorted(current.PlusStrand())};
+      const std::vector<std::pair<int,int>>& qend_sorted{
+          StrandQendSorted(current.PlusStrand())};
       cumulative_score = current.RawScore();
       query_distance_bound = GetDistanceBound(current, scoring_system,
                                               paste_parameters);
       left_candidate = FindLeftCandidate(left_candidate.sorted_pos, current,
-                                         query_distance_bound, qend_sorted_,
+                                         query_distance_bound, qend_sorted,
                                          alignments_, used, scoring_system,
-                                         paste_parameters);
+                                         paste_parameters, budget);
       right_candidate = FindRightCandidate(right_candidate.sorted_pos, current,
-                                           query_distance_bound, qstart_sorted_,
+                                           query_distance_bound, qstart_sorted,
                                            alignments_, used, scoring_system,
-                                           paste_parameters);
+                                           paste_parameters, budget);
 
       // Begin search left and right.
       while (left_candidate.sorted_pos != -1
@@ -499,15 +1189,14 @@ void AlignmentBatch::PasteAlignments(const ScoringSystem& scoring_system,
                              paste_parameters);
           temp_used.insert(right_candidate.alignment_pos);
           right_candidate.sorted_pos += 1;
-          if (right_candidate.sorted_pos == static_cast<int>(Size())) {
+          if (right_candidate.sorted_pos
+              == static_cast<int>(qstart_sorted.size())) {
             right_candidate.sorted_pos = -1;
           }
         }
 
         // Make accumulated temporary pastes permanent if final thresholds met.
-        if (current.SatisfiesThresholds(paste_parameters.final_pident_threshold,
-                                        paste_parameters.final_score_threshold,
-                                        paste_parameters)
+        if (SatisfiesFinalThresholds(current, paste_parameters)
             && (!paste_parameters.enforce_average_score
                 || (!helpers::FuzzyFloatLess(
                         current.RawScore(),
@@ -515,6 +1204,13 @@ void AlignmentBatch::PasteAlignments(const ScoringSystem& scoring_system,
                             current.PastedIdentifiers().size()),
                         paste_parameters.float_epsilon)))) {
           alignments_.at(i) = current;
+          if (seed_bounds != nullptr) {
+            for (int j : temp_used) {
+              if (!used.count(j)) {
+                seed_bounds->Remove(j, alignments_.at(j));
+              }
+            }
+          }
           used.merge(temp_used);
         }
 
@@ -523,26 +1219,334 @@ void AlignmentBatch::PasteAlignments(const ScoringSystem& scoring_system,
                                                 paste_parameters);
         if (left_candidate.sorted_pos != -1) {
           left_candidate = FindLeftCandidate(left_candidate.sorted_pos, current,
-                                             query_distance_bound, qend_sorted_,
+                                             query_distance_bound, qend_sorted,
                                              alignments_, used, scoring_system,
-                                             paste_parameters);
+                                             paste_parameters, budget);
         }
         if (right_candidate.sorted_pos != -1) {
           right_candidate = FindRightCandidate(right_candidate.sorted_pos,
                                                current, query_distance_bound,
-                                               qstart_sorted_, alignments_,
+                                               qstart_sorted, alignments_,
                                                used, scoring_system,
-                                               paste_parameters);
+                                               paste_parameters, budget);
         }
       }
+      if (budget.Exhausted()) {
+        ++num_unextended_seeds_;
+      }
 
       // Update whether or not alignment is to be included in output.
-      alignments_.at(i).IncludeInOutput(alignments_.at(i).SatisfiesThresholds(
-          paste_parameters.final_pident_threshold,
-          paste_parameters.final_score_threshold,
-          paste_parameters));
+      alignments_.at(i).IncludeInOutput(
+          SatisfiesFinalThresholds(alignments_.at(i), paste_parameters));
+      record_output(alignments_.at(i));
+    }
+  }
+  num_scanned_candidates_ += budget.num_scanned;
+}
+
+// AlignmentBatch::IndependentClusters
+//
+std::vector<std::vector<int>> AlignmentBatch::IndependentClusters(
+    const ScoringSystem& scoring_system,
+    const PasteParameters& paste_parameters) const {
+  std::vector<std::vector<int>> result;
+  for (bool plus_strand : {true, false}) {
+    std::vector<int> strand_sorted;
+    for (const std::pair<int,int>& qstart_pos
+         : StrandQstartSorted(plus_strand)) {
+      strand_sorted.push_back(qstart_pos.second);
+    }
+
+    // Split `strand_sorted` into parts at query gaps wider than any pasting of
+    // the alignments of the parts on either side can bridge. A part is merged
+    // into its predecessor once its score sum allows bridging the gap.
+    struct Part {
+      int begin;
+      double score_sum;
+      long left_gap;
+    };
+    std::vector<Part> parts;
+    int max_qend{std::numeric_limits<int>::min()};
+    for (int k = 0; k < static_cast<int>(strand_sorted.size()); ++k) {
+      const Alignment& alignment{alignments_.at(strand_sorted.at(k))};
+      long gap{static_cast<long>(alignment.Qstart()) - max_qend - 1};
+      if (parts.empty()
+          || gap > PastingDistanceBound(parts.back().score_sum, scoring_system,
+                                        paste_parameters)) {
+        parts.push_back(Part{k, 0.0, gap});
+      }
+      parts.back().score_sum += std::max(
+          0.0, static_cast<double>(alignment.RawScore()));
+      max_qend = std::max(max_qend, alignment.Qend());
+      while (parts.size() > 1
+             && parts.back().left_gap <= PastingDistanceBound(
+                 parts.back().score_sum, scoring_system, paste_parameters)) {
+        parts.at(parts.size() - 2).score_sum += parts.back().score_sum;
+        parts.pop_back();
+      }
+    }
+    for (int p = 0; p < static_cast<int>(parts.size()); ++p) {
+      int end{p + 1 < static_cast<int>(parts.size())
+              ? parts.at(p + 1).begin : static_cast<int>(strand_sorted.size())};
+      result.emplace_back(strand_sorted.begin() + parts.at(p).begin,
+                          strand_sorted.begin() + end);
+      std::sort(result.back().begin(), result.back().end());
+    }
+  }
+  return result;
+}
+
+// AlignmentBatch::PasteClusters
+//
+void AlignmentBatch::PasteClusters(
+    const std::vector<std::vector<int>>& clusters,
+    const ScoringSystem& scoring_system,
+    const PasteParameters& paste_parameters) {
+  // Each cluster inherits its relative orders from the batch, so that ties are
+  // broken as when pasting the batch as a whole.
+  std::vector<int> cluster_of(Size()), local_pos(Size());
+  std::vector<AlignmentBatch> parts;
+  parts.reserve(clusters.size());
+  for (int c = 0; c < static_cast<int>(clusters.size()); ++c) {
+    parts.emplace_back(qseqid_, sseqid_);
+    for (int l = 0; l < static_cast<int>(clusters.at(c).size()); ++l) {
+      int i{clusters.at(c).at(l)};
+      cluster_of.at(i) = c;
+      local_pos.at(i) = l;
+      parts.back().alignments_.push_back(std::move(alignments_.at(i)));
+    }
+  }
+  for (int i : score_sorted_) {
+    parts.at(cluster_of.at(i)).score_sorted_.push_back(local_pos.at(i));
+  }
+  for (const std::pair<int,int>& qstart_pos : qstart_sorted_) {
+    parts.at(cluster_of.at(qstart_pos.second)).qstart_sorted_.emplace_back(
+        qstart_pos.first, local_pos.at(qstart_pos.second));
+  }
+  for (const std::pair<int,int>& qend_pos : qend_sorted_) {
+    parts.at(cluster_of.at(qend_pos.second)).qend_sorted_.emplace_back(
+        qend_pos.first, local_pos.at(qend_pos.second));
+  }
+  for (AlignmentBatch& part : parts) {
+    part.SplitStrands();
+  }
+
+  helpers::RunTasks(static_cast<int>(parts.size()),
+                    paste_parameters.num_threads, [&](int c) {
+                      parts.at(c).GreedyPaste(scoring_system, paste_parameters,
+                                              true);
+                    });
+
+  for (int c = 0; c < static_cast<int>(clusters.size()); ++c) {
+    for (int l = 0; l < static_cast<int>(clusters.at(c).size()); ++l) {
+      alignments_.at(clusters.at(c).at(l)) = std::move(
+          parts.at(c).alignments_.at(l));
+    }
+    num_seeds_ += parts.at(c).num_seeds_;
+    num_pruned_seeds_ += parts.at(c).num_pruned_seeds_;
+    num_scanned_candidates_ += parts.at(c).num_scanned_candidates_;
+  }
+}
+
+// AlignmentBatch::ChainAlignments
+//
+void AlignmentBatch::ChainAlignments(const ScoringSystem& scoring_system,
+                                     const PasteParameters& paste_parameters) {
+  int size{static_cast<int>(Size())};
+  PasteParameters outline_parameters{paste_parameters};
+  outline_parameters.blind_mode = true;
+
+  // Order alignments by strand and end diagonal.
+  std::vector<std::tuple<bool, int, int>> diagonal_sorted;
+  diagonal_sorted.reserve(size);
+  for (int i = 0; i < size; ++i) {
+    diagonal_sorted.emplace_back(alignments_.at(i).PlusStrand(),
+                                 EndDiagonal(alignments_.at(i)), i);
+  }
+  std::sort(diagonal_sorted.begin(), diagonal_sorted.end());
+  std::vector<int> diagonal_pos(size);
+  for (int k = 0; k < size; ++k) {
+    diagonal_pos.at(std::get<2>(diagonal_sorted.at(k))) = k;
+  }
+
+  // Find the best chain ending with each alignment. Chains are kept as
+  // outlines and dropped from the index once too far to the left to be
+  // pasted onto.
+  std::vector<Alignment> chains;
+  chains.reserve(size);
+  for (const Alignment& alignment : alignments_) {
+    chains.push_back(alignment.Outline());
+  }
+  std::vector<int> predecessor(size, -1);
+  ChainIndex index{size};
+  std::priority_queue<std::pair<long,int>, std::vector<std::pair<long,int>>,
+                      std::greater<std::pair<long,int>>> expiry;
+  for (const std::pair<int,int>& qstart_pos : qstart_sorted_) {
+    int j{qstart_pos.second};
+    const Alignment& alignment{alignments_.at(j)};
+    while (!expiry.empty()
+           && expiry.top().first < static_cast<long>(alignment.Qstart()) - 1) {
+      index.Set(diagonal_pos.at(expiry.top().second),
+                -std::numeric_limits<float>::infinity());
+      expiry.pop();
+    }
+
+    long diagonal{StartDiagonal(alignment)};
+    int first = std::lower_bound(
+        diagonal_sorted.begin(), diagonal_sorted.end(),
+        std::make_tuple(alignment.PlusStrand(),
+                        static_cast<int>(std::max<long>(
+                            diagonal - paste_parameters.gap_tolerance,
+                            std::numeric_limits<int>::min())),
+                        std::numeric_limits<int>::min()))
+        - diagonal_sorted.begin();
+    int last = std::upper_bound(
+        diagonal_sorted.begin(), diagonal_sorted.end(),
+        std::make_tuple(alignment.PlusStrand(),
+                        static_cast<int>(std::min<long>(
+                            diagonal + paste_parameters.gap_tolerance,
+                            std::numeric_limits<int>::max())),
+                        std::numeric_limits<int>::max()))
+        - diagonal_sorted.begin();
+
+    PasteCandidate best, candidate;
+    int num_evaluated{0};
+    index.VisitDescending(first, last, [&](int k, float score) {
+      // Pasting never increases the sum of scores.
+      if (best.sorted_pos != -1
+          && helpers::FuzzyFloatLess(score + alignment.RawScore(), best.score,
+                                     paste_parameters.float_epsilon)) {
+        return false;
+      }
+      int i{std::get<2>(diagonal_sorted.at(k))};
+      if (GetChainCandidate(i, chains.at(i), alignment, scoring_system,
+                            paste_parameters, candidate)
+          && (best.sorted_pos == -1
+              || BetterChainCandidate(candidate, best, paste_parameters))) {
+        best = candidate;
+      }
+      return ++num_evaluated < kMaxChainCandidates;
+    });
+    if (best.sorted_pos != -1
+        && !helpers::FuzzyFloatLess(best.score, alignment.RawScore(),
+                                    paste_parameters.float_epsilon)) {
+      Alignment chain{chains.at(best.alignment_pos)};
+      chain.PasteRight(alignment, best.config, scoring_system,
+                       outline_parameters);
+      chains.at(j) = chain.Outline();
+      predecessor.at(j) = best.alignment_pos;
     }
+    index.Set(diagonal_pos.at(j), chains.at(j).RawScore());
+    expiry.emplace(static_cast<long>(chains.at(j).Qend())
+                   + GetDistanceBound(chains.at(j), scoring_system,
+                                      paste_parameters),
+                   j);
   }
+
+  // Paste chains in descending order of score.
+  std::vector<int> ends(size);
+  std::iota(ends.begin(), ends.end(), 0);
+  std::sort(ends.begin(), ends.end(),
+            [&chains = std::as_const(chains),
+             &epsilon = std::as_const(paste_parameters.float_epsilon)](
+                int first, int second) {
+              const Alignment& first_chain{chains.at(first)};
+              const Alignment& second_chain{chains.at(second)};
+              if (helpers::FuzzyFloatEquals(first_chain.RawScore(),
+                                            second_chain.RawScore(), epsilon)) {
+                if (helpers::FuzzyFloatEquals(first_chain.Pident(),
+                                              second_chain.Pident(), epsilon)) {
+                  return first < second;
+                }
+                return first_chain.Pident() > second_chain.Pident();
+              }
+              return first_chain.RawScore() > second_chain.RawScore();
+            });
+  std::vector<bool> used(size, false);
+  std::vector<int> pieces;
+  for (int j : ends) {
+    pieces.clear();
+    for (int k = j; k != -1 && !used.at(k); k = predecessor.at(k)) {
+      pieces.push_back(k);
+    }
+    if (pieces.empty() || predecessor.at(pieces.back()) != -1) {
+      continue;
+    }
+    std::reverse(pieces.begin(), pieces.end());
+    Alignment current{alignments_.at(pieces.front())};
+    float cumulative_score{current.RawScore()};
+    for (int k = 1; k < static_cast<int>(pieces.size()); ++k) {
+      const Alignment& piece{alignments_.at(pieces.at(k))};
+      cumulative_score += piece.RawScore();
+      current.PasteRight(piece, GetConfiguration(current, piece),
+                         scoring_system, paste_parameters);
+    }
+    assert(current.Nident() == chains.at(j).Nident()
+           && current.Length() == chains.at(j).Length());
+    bool satisfies_final{SatisfiesFinalThresholds(current,
+                                                  paste_parameters)};
+    if (pieces.size() > 1
+        && (!satisfies_final
+            || (paste_parameters.enforce_average_score
+                && helpers::FuzzyFloatLess(
+                    current.RawScore(),
+                    cumulative_score / static_cast<float>(pieces.size()),
+                    paste_parameters.float_epsilon)))) {
+      continue;
+    }
+    for (int k : pieces) {
+      used.at(k) = true;
+      alignments_.at(k).IncludeInOutput(false);
+    }
+    ++num_seeds_;
+    alignments_.at(pieces.front()) = std::move(current);
+    alignments_.at(pieces.front()).IncludeInOutput(satisfies_final);
+  }
+
+  // Alignments not part of any pasted chain are output on their own.
+  for (int i = 0; i < size; ++i) {
+    if (!used.at(i)) {
+      ++num_seeds_;
+      alignments_.at(i).IncludeInOutput(
+          SatisfiesFinalThresholds(alignments_.at(i), paste_parameters));
+    }
+  }
+}
+
+// PastingDistanceBound
+//
+int PastingDistanceBound(double score_sum,
+                         const ScoringSystem& scoring_system,
+                         const PasteParameters& paste_parameters) {
+  // Round up so the bound covers every score not exceeding the sum, and avoid
+  // overflowing conversion for sums too large to bound any distance.
+  float score{std::nextafter(static_cast<float>(score_sum),
+                             std::numeric_limits<float>::infinity())};
+  if (((2.0 * static_cast<double>(score)
+        - paste_parameters.intermediate_score_threshold)
+       / scoring_system.Penalty())
+      + static_cast<double>(paste_parameters.gap_tolerance)
+      >= static_cast<double>(std::numeric_limits<int>::max() / 2)) {
+    return std::numeric_limits<int>::max();
+  }
+  return GetDistanceBound(score, scoring_system, paste_parameters);
+}
+
+// AlignmentBatch::MemoryUsage
+//
+long AlignmentBatch::MemoryUsage() const {
+  long result{static_cast<long>(
+      sizeof(AlignmentBatch) + qseqid_.capacity() + sseqid_.capacity()
+      + score_sorted_.capacity() * sizeof(int)
+      + (qstart_sorted_.capacity() + qend_sorted_.capacity()
+         + plus_qstart_sorted_.capacity() + minus_qstart_sorted_.capacity()
+         + plus_qend_sorted_.capacity() + minus_qend_sorted_.capacity()
+         + removed_.capacity()) * sizeof(std::pair<int,int>)
+      + (alignments_.capacity() - alignments_.size()) * sizeof(Alignment))};
+  for (const Alignment& alignment : alignments_) {
+    result += alignment.MemoryUsage();
+  }
+  return result;
 }
 
 // AlignmentBatch::operator==
@@ -553,7 +1557,8 @@ bool AlignmentBatch::operator==(const AlignmentBatch& other) const {
           && other.alignments_ == alignments_
           && other.score_sorted_ == score_sorted_
           && other.qstart_sorted_ == qstart_sorted_
-          && other.qend_sorted_ == qend_sorted_);
+          && other.qend_sorted_ == qend_sorted_
+          && other.removed_ == removed_);
 }
 
 // AlignmentBatch::DebugString.
@@ -591,6 +1596,12 @@ std::string AlignmentBatch::DebugString() const {
     }
   }
 
+  ss << "], removed: [";
+  for (int i = 0; i < static_cast<int>(removed_.size()); ++i) {
+    ss << (i > 0 ? ", " : "") << '(' << removed_.at(i).first << ','
+       << removed_.at(i).second << ')';
+  }
+
   ss << "]}";
   return ss.str();
 }
@@ -21,6 +21,9 @@
 #include "alignment_reader.h"
 
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
 
 #include "exceptions.h"
 #include "helpers.h"
@@ -39,6 +42,51 @@ enum class FieldTerminator{
   kAny // Field may not terminate with '\t'.
 };
 
+// Returns the approximate number of bytes held by `row` as part of a
+// `RawBatch`.
+//
+inline long RowMemoryUsage(const std::string& row) {
+  return static_cast<long>(sizeof(std::string) + row.capacity());
+}
+
+// Appends `rows` to `file`, each preceded by its length.
+//
+// Basic guarantee. Throws `exceptions::ReadError` if writing fails.
+//
+void SpillRows(const std::vector<std::string>& rows, std::FILE* file) {
+  for (const std::string& row : rows) {
+    std::uint64_t length{row.length()};
+    if (std::fwrite(&length, sizeof(length), 1, file) != 1
+        || std::fwrite(row.data(), 1, row.length(), file) != row.length()) {
+      throw exceptions::ReadError("Unable to write rows of a waiting batch.");
+    }
+  }
+}
+
+// Reads `num_rows` rows written by `SpillRows` from the beginning of `file`.
+//
+// Basic guarantee. Throws `exceptions::ReadError` if reading fails.
+//
+std::vector<std::string> ReadSpilledRows(std::FILE* file, long num_rows) {
+  if (std::fseek(file, 0l, SEEK_SET) != 0) {
+    throw exceptions::ReadError("Unable to read rows of a waiting batch.");
+  }
+  std::vector<std::string> result;
+  result.reserve(static_cast<std::vector<std::string>::size_type>(num_rows));
+  for (long i = 0; i < num_rows; ++i) {
+    std::uint64_t length;
+    if (std::fread(&length, sizeof(length), 1, file) != 1) {
+      throw exceptions::ReadError("Unable to read rows of a waiting batch.");
+    }
+    std::string row(static_cast<std::string::size_type>(length), '\0');
+    if (std::fread(row.data(), 1, row.length(), file) != row.length()) {
+      throw exceptions::ReadError("Unable to read rows of a waiting batch.");
+    }
+    result.push_back(std::move(row));
+  }
+  return result;
+}
+
 // Replaces contents of `row` with the next line from `is`.
 //
 // Basic guarantee. Both `is` and `row` are modified. Throws
@@ -130,7 +178,8 @@ std::vector<std::string_view> GetFields(const std::string& row,
 // AlignmentReader::FromIStream
 //
 AlignmentReader AlignmentReader::FromIStream(std::unique_ptr<std::istream> is,
-                                             int num_fields) {
+                                             int num_fields,
+                                             const InputRange& range) {
   AlignmentReader result;
   if (is == nullptr) {
     throw exceptions::ReadError("Attempted to create `AlignmentReader` object"
@@ -138,9 +187,27 @@ AlignmentReader AlignmentReader::FromIStream(std::unique_ptr<std::istream> is,
                                 " given.");
   }
   result.num_fields_ = helpers::TestPositive(num_fields);
+  result.next_alignment_id_ = range.first_row_id;
+  result.end_offset_ = range.end_offset;
 
   result.is_ = std::move(is);
+  if (range.end_offset >= 0 && range.begin_offset >= range.end_offset) {
+    result.end_of_data_ = true;
+    return result;
+  }
+  if (range.begin_offset > 0) {
+    result.is_->seekg(range.begin_offset);
+    if (result.is_->fail()) {
+      std::stringstream error_message;
+      error_message << "Unable to seek offset " << range.begin_offset
+                    << " in input stream.";
+      throw exceptions::ReadError(error_message.str());
+    }
+  }
   ExtractRow(*(result.is_), result.row_);
+  result.row_offset_ = range.begin_offset;
+  result.next_row_offset_ = range.begin_offset
+                            + static_cast<long>(result.row_.length()) + 1;
 
   ExtractFirstTwoFields(result.row_, result.next_qseqid_, result.next_sseqid_);
   return result;
@@ -151,47 +218,199 @@ AlignmentReader AlignmentReader::FromIStream(std::unique_ptr<std::istream> is,
 AlignmentBatch AlignmentReader::ReadBatch(
     const ScoringSystem& scoring_system,
     const PasteParameters& paste_parameters) {
+  return ParseBatch(ReadRawBatch(), scoring_system, paste_parameters);
+}
+
+// AlignmentReader::ReadRawBatch
+//
+RawBatch AlignmentReader::ReadRawBatch() {
+  MemoryBudget unlimited;
+  long acquired;
+  return ReadRawBatch(unlimited, acquired);
+}
+
+// AlignmentReader::ReadRawBatch
+//
+RawBatch AlignmentReader::ReadRawBatch(MemoryBudget& budget, long& acquired) {
   // Precondition.
   if (end_of_data_) {
     std::stringstream error_message;
     error_message << "Attempted to read more alignments when end of data was"
-                  << " reached after row " << (num_fields_ - 1) << '.';
+                  << " reached after row " << (next_alignment_id_ - 1) << '.';
     throw exceptions::ReadError(error_message.str());
   }
 
   assert(!next_qseqid_.empty() && !next_sseqid_.empty());
-  AlignmentBatch batch{next_qseqid_, next_sseqid_};
+  RawBatch result;
+  result.qseqid = std::string{next_qseqid_};
+  result.sseqid = std::string{next_sseqid_};
+  result.first_row_id = next_alignment_id_;
 
-  // Read batch's alignments.
-  std::vector<Alignment> alignments;
-  std::vector<std::string_view> fields;
-  while (next_qseqid_ == batch.Qseqid() && next_sseqid_ == batch.Sseqid()) {
-
-    // Convert row to alignments.
-    fields = GetFields(row_, next_qseqid_.length() + next_sseqid_.length() + 2,
-                       num_fields_);
-    Alignment a{Alignment::FromStringFields(next_alignment_id_,
-        std::move(fields),
-        scoring_system,
-        paste_parameters)};
-    alignments.push_back(a);
+  // Collect batch's rows. While waiting for memory is likely, rows that do
+  // not fit are moved to disk.
+  long held_bytes{result.MemoryUsage()};
+  long num_spilled{0l}, spilled_bytes{0l};
+  std::unique_ptr<std::FILE, int(*)(std::FILE*)> spill_file{nullptr,
+                                                             std::fclose};
+  while (!end_of_data_ && next_qseqid_ == result.qseqid
+         && next_sseqid_ == result.sseqid) {
+    long row_bytes{RowMemoryUsage(row_)};
+    if (budget.MaxBytes() > 0l && !result.rows.empty()
+        && !budget.Fits(held_bytes + row_bytes) && budget.Acquired() > 0l) {
+      if (spill_file == nullptr) {
+        spill_file.reset(std::tmpfile());
+        if (spill_file == nullptr) {
+          throw exceptions::ReadError("Unable to create temporary file for"
+                                      " rows of a waiting batch.");
+        }
+      }
+      SpillRows(result.rows, spill_file.get());
+      num_spilled += static_cast<long>(result.rows.size());
+      result.rows.clear();
+      result.rows.shrink_to_fit();
+      spilled_bytes += held_bytes - result.MemoryUsage();
+      held_bytes = result.MemoryUsage();
+    }
+    result.rows.push_back(std::move(row_));
+    held_bytes += row_bytes;
     ++next_alignment_id_;
+    AdvanceRow();
+  }
 
-    // Read next row, or stop looking if end of data is reached.
-    if (end_of_data_) {
-      break;
-    } else {
-      ExtractRow(*is_, row_);
-      ExtractFirstTwoFields(row_, next_qseqid_, next_sseqid_);
-      end_of_data_ = (is_->peek() == std::istream::traits_type::eof());
+  // Acquire the whole batch's memory, then read back moved rows.
+  long batch_bytes{result.MemoryUsage() + spilled_bytes};
+  budget.Acquire(batch_bytes);
+  if (spill_file != nullptr) {
+    try {
+      std::vector<std::string> rows{ReadSpilledRows(spill_file.get(),
+                                                    num_spilled)};
+      rows.reserve(rows.size() + result.rows.size());
+      std::move(result.rows.begin(), result.rows.end(),
+                std::back_inserter(rows));
+      result.rows = std::move(rows);
+    } catch (...) {
+      budget.Release(batch_bytes);
+      throw;
     }
   }
+  acquired = batch_bytes;
+  return result;
+}
+
+// AlignmentReader::ReadAlignment
+//
+Alignment AlignmentReader::ReadAlignment(
+    const ScoringSystem& scoring_system,
+    const PasteParameters& paste_parameters) {
+  // Precondition.
+  if (end_of_data_) {
+    std::stringstream error_message;
+    error_message << "Attempted to read more alignments when end of data was"
+                  << " reached after row " << (next_alignment_id_ - 1) << '.';
+    throw exceptions::ReadError(error_message.str());
+  }
+
+  std::string::size_type start_pos{next_qseqid_.length()
+                                   + next_sseqid_.length() + 2};
+  Alignment result{Alignment::FromStringFields(
+      next_alignment_id_, GetFields(row_, start_pos, num_fields_),
+      scoring_system, paste_parameters)};
+  ++next_alignment_id_;
+  AdvanceRow();
+  return result;
+}
+
+// AlignmentReader::AdvanceRow
+//
+void AlignmentReader::AdvanceRow() {
+  // Read next row, or stop looking if end of data is reached.
+  if ((end_offset_ >= 0 && next_row_offset_ >= end_offset_)
+      || is_->peek() == std::istream::traits_type::eof()) {
+    end_of_data_ = true;
+    row_.clear();
+    next_qseqid_ = std::string_view{};
+    next_sseqid_ = std::string_view{};
+  } else {
+    ExtractRow(*is_, row_);
+    row_offset_ = next_row_offset_;
+    next_row_offset_ += static_cast<long>(row_.length()) + 1;
+    ExtractFirstTwoFields(row_, next_qseqid_, next_sseqid_);
+  }
+}
+
+// AlignmentReader::ParseBatch
+//
+AlignmentBatch AlignmentReader::ParseBatch(
+    RawBatch raw_batch,
+    const ScoringSystem& scoring_system,
+    const PasteParameters& paste_parameters) const {
+  AlignmentBatch batch{raw_batch.qseqid, raw_batch.sseqid};
+
+  // Share rows with the alignments, which refer to their fields as read until
+  // they are pasted onto. Rows are only kept if they are short, or if the
+  // alignments are to view their sequences.
+  std::shared_ptr<const std::vector<std::string>> shared_rows;
+  if (paste_parameters.sequence_views || paste_parameters.blind_mode) {
+    shared_rows = std::make_shared<const std::vector<std::string>>(
+        std::move(raw_batch.rows));
+  }
+  const std::vector<std::string>& rows{
+      shared_rows != nullptr ? *shared_rows : raw_batch.rows};
+
+  // Convert rows to alignments.
+  std::vector<Alignment> alignments;
+  alignments.reserve(rows.size());
+  std::string::size_type start_pos{raw_batch.qseqid.length()
+                                   + raw_batch.sseqid.length() + 2};
+  long id{raw_batch.first_row_id};
+  for (const std::string& row : rows) {
+    alignments.push_back(Alignment::FromStringFields(
+        id, GetFields(row, start_pos, num_fields_), scoring_system,
+        paste_parameters, shared_rows));
+    ++id;
+  }
 
   // Populate and return batch.
   batch.ResetAlignments(std::move(alignments), paste_parameters);
   return batch;
 }
 
+// RawBatch::MemoryUsage
+//
+long RawBatch::MemoryUsage() const {
+  long result{static_cast<long>(
+      sizeof(RawBatch) + qseqid.capacity() + sseqid.capacity()
+      + (rows.capacity() - rows.size()) * sizeof(std::string))};
+  for (const std::string& row : rows) {
+    result += RowMemoryUsage(row);
+  }
+  return result;
+}
+
+// RawBatch::operator==
+//
+bool RawBatch::operator==(const RawBatch& other) const {
+  return (qseqid == other.qseqid
+          && sseqid == other.sseqid
+          && first_row_id == other.first_row_id
+          && rows == other.rows);
+}
+
+// RawBatch::DebugString
+//
+std::string RawBatch::DebugString() const {
+  std::stringstream ss;
+  ss << "{qseqid: " << qseqid
+     << ", sseqid: " << sseqid
+     << ", first_row_id: " << first_row_id
+     << ", rows: [";
+  for (int i = 0; i < static_cast<int>(rows.size()); ++i) {
+    ss << (i > 0 ? ", " : "") << rows.at(i);
+  }
+  ss << "]}";
+  return ss.str();
+}
+
 // AlignmentReader::DebugString
 //
 std::string AlignmentReader::DebugString() const {
@@ -199,6 +418,9 @@ std::string AlignmentReader::DebugString() const {
   ss << "{num_fields: " << num_fields_
      << ", end_of_data: " << std::boolalpha << end_of_data_
      << ", next_alignment_id: " << next_alignment_id_ 
+     << ", end_offset: " << end_offset_
+     << ", row_offset: " << row_offset_
+     << ", next_row_offset: " << next_row_offset_
      << ", row: " << row_
      << ", next_qseqid: " << next_qseqid_
      << ", next_sseqid_: " << next_sseqid_
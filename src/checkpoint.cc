@@ -0,0 +1,182 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "checkpoint.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "exceptions.h"
+
+namespace paste_alignments {
+
+// Checkpoint helpers.
+//
+namespace {
+
+// First line of every checkpoint file.
+//
+const std::string kCheckpointHeader{"paste_alignments checkpoint 2"};
+
+// Reads the line `name<TAB>value` from `is` and returns `value`.
+//
+// Basic guarantee. Throws `exceptions::ReadError` if the line cannot be read
+// or is not labeled with `name`.
+//
+std::string ReadField(std::istream& is, const std::string& name) {
+  std::string line;
+  std::getline(is, line);
+  if (is.fail() || line.compare(0, name.length() + 1, name + '\t') != 0) {
+    std::stringstream error_message;
+    error_message << "Unable to read field '" << name << "' of checkpoint.";
+    throw exceptions::ReadError(error_message.str());
+  }
+  return line.substr(name.length() + 1);
+}
+
+// Reads the line `name<TAB>value` from `is` and returns `value` as a long.
+//
+long ReadLongField(std::istream& is, const std::string& name) {
+  std::string value{ReadField(is, name)};
+  try {
+    std::size_t pos;
+    long result{std::stol(value, &pos)};
+    if (pos == value.length()) {
+      return result;
+    }
+  } catch (const std::exception&) {}
+  std::stringstream error_message;
+  error_message << "Invalid value '" << value << "' of checkpoint field '"
+                << name << "'.";
+  throw exceptions::ReadError(error_message.str());
+}
+
+} // namespace
+
+// Checkpoint::FromIStream
+//
+Checkpoint Checkpoint::FromIStream(std::istream& is) {
+  std::string header;
+  std::getline(is, header);
+  if (is.fail() || header != kCheckpointHeader) {
+    throw exceptions::ReadError("Unable to read checkpoint: unknown format.");
+  }
+  Checkpoint result;
+  result.input_filename = ReadField(is, "input_file");
+  result.settings = ReadField(is, "settings");
+  result.shard = ReadField(is, "shard");
+  result.input_offset = ReadLongField(is, "input_offset");
+  result.next_row_id = ReadLongField(is, "next_row_id");
+  result.output_offset = ReadLongField(is, "output_offset");
+  result.stats_collector = StatsCollector::FromIStream(is);
+  return result;
+}
+
+// Checkpoint::Write
+//
+void Checkpoint::Write(std::ostream& os) const {
+  os << kCheckpointHeader << '\n'
+     << "input_file\t" << input_filename << '\n'
+     << "settings\t" << settings << '\n'
+     << "shard\t" << shard << '\n'
+     << "input_offset\t" << input_offset << '\n'
+     << "next_row_id\t" << next_row_id << '\n'
+     << "output_offset\t" << output_offset << '\n';
+  stats_collector.WriteState(os);
+}
+
+// Checkpoint::operator==
+//
+bool Checkpoint::operator==(const Checkpoint& other) const {
+  return (input_filename == other.input_filename
+          && settings == other.settings
+          && shard == other.shard
+          && input_offset == other.input_offset
+          && next_row_id == other.next_row_id
+          && output_offset == other.output_offset
+          && stats_collector == other.stats_collector);
+}
+
+// Checkpoint::DebugString
+//
+std::string Checkpoint::DebugString() const {
+  std::stringstream ss;
+  ss << '('
+     << "input_filename=" << input_filename
+     << ", settings=" << settings
+     << ", shard=" << shard
+     << ", input_offset=" << input_offset
+     << ", next_row_id=" << next_row_id
+     << ", output_offset=" << output_offset
+     << ", stats_collector=" << stats_collector.DebugString()
+     << ')';
+  return ss.str();
+}
+
+// CheckpointFilename
+//
+std::string CheckpointFilename(const std::string& output_filename) {
+  return output_filename + ".checkpoint";
+}
+
+// SaveCheckpoint
+//
+void SaveCheckpoint(const Checkpoint& checkpoint, const std::string& filename) {
+  std::string temporary_filename{filename + ".tmp"};
+  std::ofstream ofs{temporary_filename};
+  checkpoint.Write(ofs);
+  ofs.close();
+  if (ofs.fail()) {
+    std::stringstream error_message;
+    error_message << "Unable to write checkpoint file: " << temporary_filename;
+    throw exceptions::ReadError(error_message.str());
+  }
+  SyncFile(temporary_filename);
+  if (std::rename(temporary_filename.c_str(), filename.c_str()) != 0) {
+    std::stringstream error_message;
+    error_message << "Unable to rename checkpoint file: " << temporary_filename
+                  << " to: " << filename;
+    throw exceptions::ReadError(error_message.str());
+  }
+}
+
+// SyncFile
+//
+void SyncFile(const std::string& filename) {
+  int fd{::open(filename.c_str(), O_RDONLY)};
+  if (fd < 0) {
+    std::stringstream error_message;
+    error_message << "Unable to open file for syncing: " << filename;
+    throw exceptions::ReadError(error_message.str());
+  }
+  int status{::fsync(fd)};
+  ::close(fd);
+  if (status != 0) {
+    std::stringstream error_message;
+    error_message << "Unable to sync file: " << filename;
+    throw exceptions::ReadError(error_message.str());
+  }
+}
+
+} // namespace paste_alignments
@@ -0,0 +1,195 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Expands compactly written rows columns (see `--compact_rows`) of
+// paste_alignments output files into plain comma-separated lists.
+
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arg_parse_convert.h"
+#include "paste_alignments.h"
+
+namespace {
+
+const char* kUsageMessage{
+    "\nusage: decode_rows [options] [INPUT_FILE [OUTPUT_FILE]]\n"};
+
+const char* kVersionMessage{
+    "\nPasteAlignments v1.0.0"
+    "\nCopyright (c) 2020 Jasper Braun"};
+
+// Initializes `ParameterMap` object for argument parsing.
+//
+arg_parse_convert::ParameterMap InitParameters() {
+  arg_parse_convert::ParameterMap parameter_map;
+  parameter_map(arg_parse_convert::Parameter<std::string>::Positional(
+                   arg_parse_convert::converters::StringIdentity,
+                   "input_file", 0)
+                .MinArgs(0).MaxArgs(1).Placeholder("INPUT_FILE")
+                .Description(
+                    "Output file of paste_alignments written with"
+                    " `--compact_rows`. Read from standard input if omitted."))
+
+               (arg_parse_convert::Parameter<std::string>::Positional(
+                    arg_parse_convert::converters::StringIdentity,
+                    "output_file", 1)
+                .MinArgs(0).MaxArgs(1).Placeholder("OUTPUT_FILE")
+                .Description(
+                    "The input file with each range in its rows column expanded"
+                    " into the comma-separated row identifiers it stands for."
+                    " Written to standard output if omitted."))
+
+               (arg_parse_convert::Parameter<int>::Keyword(
+                    arg_parse_convert::converters::stoi,
+                    {"c", "column"})
+                .MinArgs(1).MaxArgs(1).Placeholder("INTEGER")
+                .AddDefault("0")
+                .Description(
+                    "One-based position of the rows column, e.g. the position"
+                    " of rows in `--output_columns`. The last column if 0."))
+
+               (arg_parse_convert::Parameter<bool>::Flag(
+                    {"h", "help"})
+                .Description("Print this help message and exit."))
+
+               (arg_parse_convert::Parameter<bool>::Flag(
+                    {"version"})
+                .Description("Print the software's version and exit."));
+
+  return parameter_map;
+}
+
+// Writes `line` into `os` with the rows column at one-based position `column`
+// expanded, or the last column if `column` is 0.
+//
+void DecodeLine(std::string_view line, int column, std::ostream& os) {
+  std::string_view::size_type rows_begin{0};
+  if (column == 0) {
+    rows_begin = line.rfind('\t') + 1;
+  } else {
+    for (int i = 1; i < column; ++i) {
+      rows_begin = line.find('\t', rows_begin);
+      if (rows_begin == std::string_view::npos) {
+        std::stringstream error_message;
+        error_message << "Line has fewer than " << column << " columns: '"
+                      << line << "'.";
+        throw paste_alignments::exceptions::OutOfRange(error_message.str());
+      }
+      ++rows_begin;
+    }
+  }
+  std::string_view::size_type rows_end{line.find('\t', rows_begin)};
+  if (rows_end == std::string_view::npos) {
+    rows_end = line.length();
+  }
+  std::vector<long> ids{paste_alignments::ExpandRowRanges(
+      line.substr(rows_begin, rows_end - rows_begin))};
+  os << line.substr(0, rows_begin) << ids.at(0);
+  for (int i = 1; i < static_cast<int>(ids.size()); ++i) {
+    os << ',' << ids.at(i);
+  }
+  os << line.substr(rows_end) << '\n';
+}
+
+} // namespace
+
+int main(int argc, const char** argv) {
+
+  try {
+    // Parse command line.
+    arg_parse_convert::ArgumentMap argument_map{InitParameters()};
+    std::vector<std::string> additional_arguments{
+        arg_parse_convert::ParseArgs(argc, argv, argument_map)};
+    if (!additional_arguments.empty()) {
+      std::stringstream error_message;
+      error_message << "Invalid argument: " << additional_arguments.at(0);
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          error_message.str());
+    }
+    argument_map.SetDefaultArguments();
+
+    // Take care of help/version flags.
+    if (argument_map.IsSet("help")) {
+      std::cout << arg_parse_convert::FormattedHelpString(
+                       argument_map.Parameters(), kUsageMessage,
+                       kVersionMessage)
+                << std::endl;
+      return 0;
+    }
+    if (argument_map.IsSet("version")) {
+      std::cout << kVersionMessage << std::endl;
+      return 0;
+    }
+    int column{paste_alignments::helpers::TestNonNegative(
+        argument_map.GetValue<int>("column"))};
+
+    // Input and output files.
+    std::ifstream ifs;
+    if (argument_map.HasArgument("input_file")) {
+      std::string input_filename{
+          argument_map.GetValue<std::string>("input_file")};
+      ifs.open(input_filename);
+      if (!ifs.is_open()) {
+        std::stringstream error_message;
+        error_message << "Unable to open input file: " << input_filename;
+        throw paste_alignments::exceptions::ReadError(error_message.str());
+      }
+    }
+    std::ofstream ofs;
+    if (argument_map.HasArgument("output_file")) {
+      ofs.open(argument_map.GetValue<std::string>("output_file"));
+    }
+    std::istream& is{ifs.is_open() ? static_cast<std::istream&>(ifs)
+                                   : std::cin};
+    std::ostream& os{ofs.is_open() ? static_cast<std::ostream&>(ofs)
+                                   : std::cout};
+
+    std::string line;
+    while (std::getline(is, line)) {
+      DecodeLine(line, column, os);
+    }
+
+  // Argument parsing errors.
+  } catch (const arg_parse_convert::exceptions::BaseError& e) {
+    std::cerr << "Error while parsing arguments. Exception message: "
+              << e.what() << '\n' << kUsageMessage << std::endl;
+    return 1;
+
+  // Decoding errors.
+  } catch (const paste_alignments::exceptions::BaseException& e) {
+    std::cerr << "Error while decoding rows. Exception message: "
+              << e.what() << '\n' << kUsageMessage << std::endl;
+    return 1;
+
+  // Unexpected errors.
+  } catch (const std::exception& e) {
+    std::cerr << "Something went wrong. Exception message: " << e.what()
+              << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -20,6 +20,13 @@
 
 #include "helpers.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace paste_alignments {
 
 namespace helpers {
@@ -54,6 +61,44 @@ int StringViewToInteger(const std::string_view& s_view) {
   return result;
 }
 
+// RunTasks
+//
+void RunTasks(int num_tasks, int num_threads,
+              const std::function<void(int)>& task) {
+  std::atomic<int> next_task{0};
+  std::mutex error_mutex;
+  std::exception_ptr error{nullptr};
+
+  auto worker = [&]() {
+    int i;
+    while ((i = next_task++) < num_tasks) {
+      try {
+        task(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock{error_mutex};
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+        next_task = num_tasks;
+      }
+    }
+  };
+
+  num_threads = std::min(TestPositive(num_threads),
+                         std::max(1, num_tasks));
+  std::vector<std::thread> workers;
+  for (int i = 1; i < num_threads; ++i) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& t : workers) {
+    t.join();
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
 } // namespace helpers
 
 } // namespace paste_alignments
\ No newline at end of file
@@ -0,0 +1,115 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "hit_selection.h"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+#include "exceptions.h"
+#include "helpers.h"
+
+namespace paste_alignments {
+
+// QueryHitSelector::QueryHitSelector
+//
+QueryHitSelector::QueryHitSelector(int max_hits, const OutputFormat& format,
+                                   float float_epsilon, WriteFunction write)
+    : max_hits_{max_hits}, format_{format}, float_epsilon_{float_epsilon},
+      write_{std::move(write)} {
+  if (max_hits < 1) {
+    std::stringstream error_message;
+    error_message << "Maximum number of hits per query must be positive: "
+                  << max_hits;
+    throw exceptions::OutOfRange(error_message.str());
+  }
+  heap_.reserve(static_cast<std::size_t>(max_hits) + 1u);
+}
+
+// QueryHitSelector::Add
+//
+void QueryHitSelector::Add(const AlignmentBatch& batch) {
+  if (batch.Qseqid() != qseqid_) {
+    Flush();
+    qseqid_ = batch.Qseqid();
+  }
+  auto worse{[this](const Hit& first, const Hit& second) {
+    return Better(first, second);
+  }};
+  for (const Alignment& a : batch.Alignments()) {
+    if (!a.IncludeInOutput()) {continue;}
+    Hit hit;
+    hit.score = a.RawScore();
+    hit.pident = a.Pident();
+    hit.sequence = next_sequence_++;
+    if (static_cast<int>(heap_.size()) == max_hits_
+        && !Better(hit, heap_.front())) {
+      continue;
+    }
+    if (sseqid_ == nullptr || *sseqid_ != batch.Sseqid()) {
+      sseqid_ = std::make_shared<const std::string>(batch.Sseqid());
+    }
+    hit.sseqid = sseqid_;
+    format_.Write(batch, a, hit.line);
+    heap_.push_back(std::move(hit));
+    std::push_heap(heap_.begin(), heap_.end(), worse);
+    if (static_cast<int>(heap_.size()) > max_hits_) {
+      std::pop_heap(heap_.begin(), heap_.end(), worse);
+      heap_.pop_back();
+    }
+  }
+}
+
+// QueryHitSelector::Flush
+//
+void QueryHitSelector::Flush() {
+  std::sort(heap_.begin(), heap_.end(), [](const Hit& first,
+                                           const Hit& second) {
+    return first.sequence < second.sequence;
+  });
+  std::string lines;
+  for (std::size_t i = 0; i < heap_.size(); ++i) {
+    lines.append(heap_.at(i).line);
+    if (i + 1 == heap_.size()
+        || *heap_.at(i + 1).sseqid != *heap_.at(i).sseqid) {
+      write_(qseqid_, *heap_.at(i).sseqid, lines);
+      lines.clear();
+    }
+  }
+  heap_.clear();
+  sseqid_.reset();
+  next_sequence_ = 0l;
+}
+
+// QueryHitSelector::Better
+//
+bool QueryHitSelector::Better(const Hit& first, const Hit& second) const {
+  if (!helpers::FuzzyFloatEquals(first.score, second.score, float_epsilon_)) {
+    return first.score > second.score;
+  }
+  if (!helpers::FuzzyFloatEquals(first.pident, second.pident,
+                                 float_epsilon_)) {
+    return first.pident > second.pident;
+  }
+  return first.sequence < second.sequence;
+}
+
+} // namespace paste_alignments
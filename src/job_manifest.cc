@@ -0,0 +1,200 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "job_manifest.h"
+
+#include <sstream>
+
+#include "exceptions.h"
+
+namespace paste_alignments {
+
+// ReadManifest helpers.
+//
+namespace {
+
+// Splits `line` at '\t' characters.
+//
+std::vector<std::string> SplitColumns(const std::string& line) {
+  std::vector<std::string> columns;
+  std::string::size_type start_pos{0}, end_pos;
+  do {
+    end_pos = line.find('\t', start_pos);
+    if (end_pos == std::string::npos) {
+      end_pos = line.length();
+    }
+    columns.emplace_back(line, start_pos, end_pos - start_pos);
+    start_pos = end_pos + 1;
+  } while (end_pos < line.length());
+  return columns;
+}
+
+// Returns `column`, or the empty string if `column` marks an absent file.
+//
+std::string OptionalColumn(const std::string& column) {
+  if (column == "-") {
+    return std::string{};
+  }
+  return column;
+}
+
+} // namespace
+
+// ManifestEntry::operator==
+//
+bool ManifestEntry::operator==(const ManifestEntry& other) const {
+  return (other.input_filename == input_filename
+          && other.output_filename == output_filename
+          && other.stats_filename == stats_filename
+          && other.configuration_filename == configuration_filename);
+}
+
+// ManifestEntry::DebugString
+//
+std::string ManifestEntry::DebugString() const {
+  std::stringstream ss;
+  ss << '('
+     << "input_filename=" << input_filename
+     << ", output_filename=" << output_filename
+     << ", stats_filename=" << stats_filename
+     << ", configuration_filename=" << configuration_filename
+     << ')';
+  return ss.str();
+}
+
+// SweepEntry::operator==
+//
+bool SweepEntry::operator==(const SweepEntry& other) const {
+  return (other.configuration_filename == configuration_filename
+          && other.output_filename == output_filename
+          && other.stats_filename == stats_filename
+          && other.summary_filename == summary_filename);
+}
+
+// SweepEntry::DebugString
+//
+std::string SweepEntry::DebugString() const {
+  std::stringstream ss;
+  ss << '('
+     << "configuration_filename=" << configuration_filename
+     << ", output_filename=" << output_filename
+     << ", stats_filename=" << stats_filename
+     << ", summary_filename=" << summary_filename
+     << ')';
+  return ss.str();
+}
+
+// ReadManifest
+//
+std::vector<ManifestEntry> ReadManifest(std::istream& is) {
+  std::vector<ManifestEntry> result;
+  std::string line;
+  int line_number{0};
+  while (std::getline(is, line)) {
+    ++line_number;
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+
+    std::vector<std::string> columns{SplitColumns(line)};
+    if (columns.size() < 2 || columns.size() > 4) {
+      std::stringstream error_message;
+      error_message << "Manifest line " << line_number << " must have 2 to 4"
+                    << " tab-separated columns, but has " << columns.size()
+                    << ": '" << line << "'.";
+      throw exceptions::ReadError(error_message.str());
+    }
+
+    ManifestEntry entry;
+    entry.input_filename = OptionalColumn(columns.at(0));
+    entry.output_filename = OptionalColumn(columns.at(1));
+    if (entry.input_filename.empty() || entry.output_filename.empty()) {
+      std::stringstream error_message;
+      error_message << "Manifest line " << line_number << " must name both an"
+                    << " input and an output file: '" << line << "'.";
+      throw exceptions::ReadError(error_message.str());
+    }
+    if (columns.size() > 2) {
+      entry.stats_filename = OptionalColumn(columns.at(2));
+    }
+    if (columns.size() > 3) {
+      entry.configuration_filename = OptionalColumn(columns.at(3));
+    }
+    result.emplace_back(std::move(entry));
+  }
+  if (is.bad()) {
+    throw exceptions::ReadError("Something went wrong when attempting to read"
+                                " from manifest stream.");
+  }
+  return result;
+}
+
+// ReadSweepFile
+//
+std::vector<SweepEntry> ReadSweepFile(std::istream& is) {
+  std::vector<SweepEntry> result;
+  std::string line;
+  int line_number{0};
+  while (std::getline(is, line)) {
+    ++line_number;
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+
+    std::vector<std::string> columns{SplitColumns(line)};
+    if (columns.size() < 2 || columns.size() > 4) {
+      std::stringstream error_message;
+      error_message << "Sweep file line " << line_number << " must have 2 to 4"
+                    << " tab-separated columns, but has " << columns.size()
+                    << ": '" << line << "'.";
+      throw exceptions::ReadError(error_message.str());
+    }
+
+    SweepEntry entry;
+    entry.configuration_filename = OptionalColumn(columns.at(0));
+    entry.output_filename = OptionalColumn(columns.at(1));
+    if (entry.output_filename.empty()) {
+      std::stringstream error_message;
+      error_message << "Sweep file line " << line_number << " must name an"
+                    << " output file: '" << line << "'.";
+      throw exceptions::ReadError(error_message.str());
+    }
+    if (columns.size() > 2) {
+      entry.stats_filename = OptionalColumn(columns.at(2));
+    }
+    if (columns.size() > 3) {
+      entry.summary_filename = OptionalColumn(columns.at(3));
+    }
+    result.emplace_back(std::move(entry));
+  }
+  if (is.bad()) {
+    throw exceptions::ReadError("Something went wrong when attempting to read"
+                                " from sweep stream.");
+  }
+  return result;
+}
+
+} // namespace paste_alignments
@@ -18,11 +18,18 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <exception>
+#include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "arg_parse_convert.h"
@@ -31,12 +38,19 @@
 namespace {
 
 const char* kUsageMessage{
-    "\nusage: paste_alignments [options] --db_size INTEGER INPUT_FILE [OUTPUT_FILE]\n"};
+    "\nusage: paste_alignments [options] --db_size INTEGER INPUT_FILE [OUTPUT_FILE]"
+    "\n       paste_alignments [options] --db_size INTEGER --manifest MANIFEST_FILE"
+    "\n       paste_alignments [options] --db_size INTEGER --sweep SWEEP_FILE"
+    " INPUT_FILE\n"};
 
 const char* kVersionMessage{
     "\nPasteAlignments v1.0.0"
     "\nCopyright (c) 2020 Jasper Braun"};
 
+// Number of batches parsed at once in sweep mode.
+//
+const int kSweepChunkSize{1024};
+
 
 // Initializes `ParameterMap` object for argument parsing.
 //
@@ -72,6 +86,99 @@ arg_parse_convert::ParameterMap InitParameters() {
                     " alignments on the minus strand, the subject end"
                     " coordinate precedes its subject start coordinate."))
 
+               (arg_parse_convert::Parameter<std::string>::Keyword(
+                    arg_parse_convert::converters::StringIdentity,
+                    {"output_columns"})
+                .MaxArgs(1).Placeholder("COLUMNS")
+                .Description(
+                    "Comma-separated list of the columns to write into the"
+                    " output file, in the order given, out of: qseqid sseqid"
+                    " qstart qend sstart send nident mismatch gapopen gaps"
+                    " qlen slen length qseq sseq pident score bitscore evalue"
+                    " nmatches rows. Columns qseq and sseq are not available in"
+                    " blind mode. With `--cache`, rows must be the last column"
+                    " if it is written."))
+
+               (arg_parse_convert::Parameter<bool>::Flag(
+                    {"compact_rows"})
+                .Description(
+                    "Write each run of consecutive row identifiers in the rows"
+                    " column as a range, e.g. `1-5,9,7-6` instead of"
+                    " `1,2,3,4,5,9,7,6`. Descending runs are written from"
+                    " their first to their last identifier. The program"
+                    " `decode_rows` expands the ranges again."))
+
+               (arg_parse_convert::Parameter<std::string>::Keyword(
+                    arg_parse_convert::converters::StringIdentity,
+                    {"output_sink"})
+                .MinArgs(1).MaxArgs(1).Placeholder("SINK")
+                .AddDefault("file")
+                .Description(
+                    "How the output file is written: `file` through a C++"
+                    " file stream, `fd` with large direct writes to the file"
+                    " descriptor, `gzip` compressed with zlib, or `null` to"
+                    " discard the output, reporting only its size, e.g. to"
+                    " measure pasting alone. Checkpoints require `file` or"
+                    " `fd`."))
+
+               (arg_parse_convert::Parameter<bool>::Flag(
+                    {"binary_output"})
+                .Description(
+                    "Write the output file in a binary columnar format with"
+                    " one block of fixed-width column arrays per batch, a"
+                    " string table of the sequence identifiers, and an index"
+                    " of the blocks at its end. The program `pa_dump` converts"
+                    " it into the tab-separated table with the default"
+                    " columns. Cannot be combined with `--output_columns`,"
+                    " `--compact_rows`, `--cache`, `--shard`,"
+                    " `--merge_shards`, `--sweep`, or checkpoints."))
+
+               (arg_parse_convert::Parameter<int>::Keyword(
+                    arg_parse_convert::converters::stoi,
+                    {"output_shards"})
+                .MinArgs(1).MaxArgs(1).Placeholder("INTEGER")
+                .AddDefault("1")
+                .Description(
+                    "Split the output into the given number of files, named"
+                    " after the output file with the one-based file index"
+                    " appended. Each batch is written to the file chosen by a"
+                    " stable hash of its query sequence identifier, so all"
+                    " alignments of a query end up in the same file. Stats and"
+                    " degraded batch files are split the same way. Not split"
+                    " if 1. Requires an output file and cannot be combined"
+                    " with `--shard`, `--merge_shards`, `--sweep`, or"
+                    " checkpoints."))
+
+               (arg_parse_convert::Parameter<bool>::Flag(
+                    {"output_index"})
+                .Description(
+                    "Write an index of the output file next to it, with suffix"
+                    " `.idx`, listing for each batch its query and subject"
+                    " sequence identifiers, the offset and size of its output"
+                    " in bytes, and its number of rows. The program"
+                    " `pa_lookup` uses it to extract the output of single"
+                    " queries. Requires an output file written with output"
+                    " sink `file` or `fd` and cannot be combined with"
+                    " `--binary_output` or `--sweep`."))
+
+               (arg_parse_convert::Parameter<int>::Keyword(
+                    arg_parse_convert::converters::stoi,
+                    {"max_hits_per_query"})
+                .MinArgs(1).MaxArgs(1).Placeholder("INTEGER")
+                .AddDefault("0")
+                .Description(
+                    "Output only the given number of best alignments of each"
+                    " query across all of its subjects, ranked by raw score,"
+                    " then percent identity. Requires the batches of each"
+                    " query to be consecutive. Kept alignments are written in"
+                    " input order once the next query begins. Unlike with"
+                    " `--max_alignments_per_batch`, stats and summary describe"
+                    " all output alignments before the limit, including those"
+                    " dropped by it."
+                    " Unlimited if 0. Cannot be combined with"
+                    " `--binary_output`, `--cache`, `--sweep`, or"
+                    " checkpoints."))
+
                (arg_parse_convert::Parameter<int>::Keyword(
                     arg_parse_convert::converters::stoi,
                     {"d", "db", "db_size"})
@@ -107,6 +214,26 @@ arg_parse_convert::ParameterMap InitParameters() {
                     "Raw score threshold alignments must satisfy to be included"
                     " in the output."))
 
+               (arg_parse_convert::Parameter<double>::Keyword(
+                    arg_parse_convert::converters::stod,
+                    {"final_evalue"})
+                .MinArgs(1).MaxArgs(1).Placeholder("FLOAT")
+                .AddDefault("0.0")
+                .Description(
+                    "Maximum evalue of alignments included in the output,"
+                    " applied as the equivalent raw score threshold of each"
+                    " batch. Not applied if 0."))
+
+               (arg_parse_convert::Parameter<float>::Keyword(
+                    arg_parse_convert::converters::stof,
+                    {"final_bitscore"})
+                .MinArgs(1).MaxArgs(1).Placeholder("FLOAT")
+                .AddDefault("0.0")
+                .Description(
+                    "Minimum bitscore of alignments included in the output,"
+                    " applied as the equivalent raw score threshold. Not"
+                    " applied if 0."))
+
                (arg_parse_convert::Parameter<float>::Keyword(
                     arg_parse_convert::converters::stof,
                     {"intermediate_pident", "intermediate_pident_threshold"})
@@ -173,7 +300,15 @@ arg_parse_convert::ParameterMap InitParameters() {
                     " alignment length, 4: average percent identity, 5: average"
                     " raw alignment score, 6: average bitscore, 7: average"
                     " evalue, 8: average number of unknown N-N matches (which"
-                    " are treated as mismatches."))
+                    " are treated as mismatches, 9: number of seeds processed"
+                    " during pasting, 10: number of seeds skipped because they"
+                    " could not reach the final score threshold, 11: fraction"
+                    " of seeds skipped, 12: number of alignments removed as"
+                    " redundant, 13: number of stream window overflows, 14-16:"
+                    " number of batches pasted by brute force, indexed greedy,"
+                    " and cluster-parallel greedy strategies, 17: number of"
+                    " pasting candidates scanned, 18: number of batches whose"
+                    " candidate budget was exhausted."))
 
                (arg_parse_convert::Parameter<std::string>::Keyword(
                     arg_parse_convert::converters::StringIdentity,
@@ -186,7 +321,20 @@ arg_parse_convert::ParameterMap InitParameters() {
                     " average alignment length, 6: average percent identity, 7:"
                     " average raw alignment score, 8: average bitscore, 9:"
                     " average evalue, 10: average number of unknown N-N matches"
-                    " (which are treated as mismatches."))
+                    " (which are treated as mismatches, and with"
+                    " `--remove_redundant` 11: alignments removed as"
+                    " redundant."))
+
+               (arg_parse_convert::Parameter<std::string>::Keyword(
+                    arg_parse_convert::converters::StringIdentity,
+                    {"degraded_file"})
+                .MaxArgs(1).Placeholder("DEGRADED_FILE")
+                .Description(
+                    "Print the batches whose candidate budget was exhausted as"
+                    " tab-separated data with columns: 1: query sequence"
+                    " identifier, 2: subject sequence identifier, 3: number of"
+                    " seeds not or not completely extended. Cannot be combined"
+                    " with `--manifest` or `--sweep`."))
 
                (arg_parse_convert::Parameter<std::string>::Keyword(
                     arg_parse_convert::converters::StringIdentity,
@@ -195,6 +343,124 @@ arg_parse_convert::ParameterMap InitParameters() {
                 .Description(
                     "Read parameters from configuration file."))
 
+               (arg_parse_convert::Parameter<std::string>::Keyword(
+                    arg_parse_convert::converters::StringIdentity,
+                    {"manifest", "manifest_file"})
+                .MaxArgs(1).Placeholder("MANIFEST_FILE")
+                .Description(
+                    "Process every job listed in the manifest file instead of a"
+                    " single input file. Each line lists the tab-separated"
+                    " columns: input file, output file, and optionally stats"
+                    " file and configuration file ('-' marks an absent"
+                    " column). A job's configuration file is read instead of"
+                    " the one passed with `--configuration_file`. If a summary"
+                    " file is given, it describes all jobs combined."))
+
+               (arg_parse_convert::Parameter<std::string>::Keyword(
+                    arg_parse_convert::converters::StringIdentity,
+                    {"sweep", "sweep_file"})
+                .MaxArgs(1).Placeholder("SWEEP_FILE")
+                .Description(
+                    "Paste the input file under each parameter set listed in"
+                    " the sweep file, reading and parsing the input only once."
+                    " Each line lists the tab-separated columns: configuration"
+                    " file, output file, and optionally stats file and summary"
+                    " file ('-' marks an absent column). A set's configuration"
+                    " file is read instead of the one passed with"
+                    " `--configuration_file`. All sets must agree on"
+                    " `--blind_mode` and `--remove_redundant`, and if the"
+                    " latter is set, also on the scoring parameters."))
+
+               (arg_parse_convert::Parameter<int>::Keyword(
+                    arg_parse_convert::converters::stoi,
+                    {"t", "threads", "num_threads"})
+                .MinArgs(1).MaxArgs(1).Placeholder("INTEGER")
+                .AddDefault("1")
+                .Description(
+                    "Number of worker threads sharing the jobs listed in the"
+                    " manifest file, or the parameter sets listed in the sweep"
+                    " file. Otherwise, number of threads pasting independent"
+                    " clusters of large batches with `--engine auto`."))
+
+               (arg_parse_convert::Parameter<int>::Keyword(
+                    arg_parse_convert::converters::stoi,
+                    {"checkpoint_interval"})
+                .MinArgs(1).MaxArgs(1).Placeholder("SECONDS")
+                .AddDefault("0")
+                .Description(
+                    "Record progress at most every given number of seconds in"
+                    " a checkpoint file next to the output file (suffix"
+                    " '.checkpoint'), after the output written so far was"
+                    " synced to disk. Disabled if 0. Requires an output"
+                    " file."))
+
+               (arg_parse_convert::Parameter<bool>::Flag(
+                    {"resume"})
+                .Description(
+                    "Continue from the checkpoint of a previous run, if one"
+                    " exists: the output file is truncated to the"
+                    " checkpoint's size, and reading continues after the last"
+                    " batch recorded. Without a checkpoint, the run starts"
+                    " from the beginning. The input file, pasting and output"
+                    " settings, and shard must match those of the"
+                    " checkpoint's run."))
+
+               (arg_parse_convert::Parameter<std::string>::Keyword(
+                    arg_parse_convert::converters::StringIdentity,
+                    {"cache", "cache_directory"})
+                .MaxArgs(1).Placeholder("DIRECTORY")
+                .Description(
+                    "Reuse the output and stats of batches pasted in previous"
+                    " runs with the same settings from the given cache"
+                    " directory, and add those of new batches to it. Batches"
+                    " are identified by a hash of their rows, so unchanged"
+                    " batches are not parsed or pasted again."))
+
+               (arg_parse_convert::Parameter<int>::Keyword(
+                    arg_parse_convert::converters::stoi,
+                    {"cache_size"})
+                .MinArgs(1).MaxArgs(1).Placeholder("MEGABYTES")
+                .AddDefault("1024")
+                .Description(
+                    "Maximum size of the cache directory. The least recently"
+                    " used entries are removed once it is exceeded."))
+
+               (arg_parse_convert::Parameter<int>::Keyword(
+                    arg_parse_convert::converters::stoi,
+                    {"max_memory"})
+                .MinArgs(1).MaxArgs(1).Placeholder("MEGABYTES")
+                .AddDefault("0")
+                .Description(
+                    "Approximate maximum memory held by batches and collected"
+                    " statistics. A batch is accounted by the size of its"
+                    " input rows. Rows of a batch that does not fit are moved"
+                    " to a temporary file while its thread waits for other"
+                    " threads' batches to be written, sweep mode parses fewer"
+                    " batches at once, and stats are moved to a temporary"
+                    " file. A single batch larger than the maximum is still"
+                    " pasted, alone. Unlimited if 0."))
+
+               (arg_parse_convert::Parameter<std::string>::Keyword(
+                    arg_parse_convert::converters::StringIdentity,
+                    {"shard"})
+                .MaxArgs(1).Placeholder("INDEX/COUNT")
+                .Description(
+                    "Process only the INDEX-th of COUNT parts of the input file"
+                    " (1 <= INDEX <= COUNT). Parts are split at batch"
+                    " boundaries, and row numbers refer to the whole input"
+                    " file. The output, stats, and summary files are written"
+                    " with the suffix '.INDEX' and can be combined using"
+                    " `--merge_shards`."))
+
+               (arg_parse_convert::Parameter<int>::Keyword(
+                    arg_parse_convert::converters::stoi,
+                    {"merge_shards", "num_merged_shards"})
+                .MaxArgs(1).Placeholder("INTEGER")
+                .Description(
+                    "Instead of pasting, combine the files written by the given"
+                    " number of shards (see `--shard`) into the output, stats,"
+                    " and summary files named on the command line."))
+
                (arg_parse_convert::Parameter<float>::Keyword(
                     arg_parse_convert::converters::stof,
                     {"float_epsilon"})
@@ -223,6 +489,83 @@ arg_parse_convert::ParameterMap InitParameters() {
                     " (and thus percent identity, score, bitscore, and evalue)"
                     " are still computed."))
 
+               (arg_parse_convert::Parameter<bool>::Flag(
+                    {"remove_redundant"})
+                .Description(
+                    "Before pasting, remove exact duplicates and alignments"
+                    " whose query and subject intervals are contained in those"
+                    " of an alignment on the same diagonal with at least the"
+                    " same score. Each alignment is only compared to the kept"
+                    " alignment of its diagonal reaching furthest along the"
+                    " query, so some contained alignments may remain. Removed"
+                    " alignments are listed in an additional column of the"
+                    " stats file as `removed:kept` row identifier pairs."))
+
+               (arg_parse_convert::Parameter<bool>::Flag(
+                    {"sequence_views"})
+                .Description(
+                    "Keep the rows of each batch in memory while pasting it,"
+                    " and let alignments refer to their sequences in them"
+                    " until they are pasted onto, instead of packing the"
+                    " sequences of every alignment on reading. Saves time"
+                    " when few alignments are pasted, at the expense of"
+                    " memory. Has no effect in blind mode or when streaming."))
+
+               (arg_parse_convert::Parameter<int>::Keyword(
+                    arg_parse_convert::converters::stoi,
+                    {"stream_window"})
+                .MinArgs(1).MaxArgs(1).Placeholder("INTEGER")
+                .AddDefault("0")
+                .Description(
+                    "Read and paste each batch as a stream holding at most the"
+                    " given number of alignments at once. Requires alignments"
+                    " sorted by query start within each batch. Batches are"
+                    " split where no alignments can be pasted across, so the"
+                    " output equals that of pasting whole batches unless the"
+                    " summary reports window overflows. Disabled if 0. Cannot"
+                    " be combined with `--cache` or `--sweep`."))
+
+               (arg_parse_convert::Parameter<std::string>::Keyword(
+                    arg_parse_convert::converters::StringIdentity,
+                    {"engine"})
+                .MinArgs(1).MaxArgs(1).Placeholder("ENGINE")
+                .AddDefault("greedy")
+                .Description(
+                    "Strategy used to paste the alignments of each batch. With"
+                    " `greedy`, alignments are extended in descending order of"
+                    " score with the best pastable alignments to their left"
+                    " and right. With `chain`, alignments are pasted into"
+                    " colinear chains, each extending the best predecessor"
+                    " among at most 64 highest-scoring candidate chains in its"
+                    " diagonal window, which takes O(n log n) time for a batch"
+                    " of n alignments. With `auto`, each batch is pasted by the"
+                    " variant of `greedy` expected to be cheapest for its size,"
+                    " strands, and coordinate density, all of which yield the"
+                    " same output as `greedy`."))
+
+               (arg_parse_convert::Parameter<long>::Keyword(
+                    arg_parse_convert::converters::stol,
+                    {"candidate_budget"})
+                .MinArgs(1).MaxArgs(1).Placeholder("INTEGER")
+                .AddDefault("0")
+                .Description(
+                    "Maximum number of pasting candidates scanned per batch by"
+                    " the greedy strategies. Once exhausted, the remaining"
+                    " alignments of the batch are output without pasting, and"
+                    " the batch is reported as degraded. Unlimited if 0."))
+
+               (arg_parse_convert::Parameter<int>::Keyword(
+                    arg_parse_convert::converters::stoi,
+                    {"max_alignments_per_batch"})
+                .MinArgs(1).MaxArgs(1).Placeholder("INTEGER")
+                .AddDefault("0")
+                .Description(
+                    "Output only the given number of best alignments of each"
+                    " batch, ranked by raw score, then percent identity. The"
+                    " greedy strategies skip seeds that cannot beat the worst"
+                    " of the best alignments found so far. Unlimited if 0."
+                    " Cannot be combined with `--stream_window`."))
+
                (arg_parse_convert::Parameter<bool>::Flag(
                     {"enforce_avg_score", "enforce_average_score"})
                 .Description(
@@ -240,15 +583,25 @@ arg_parse_convert::ParameterMap InitParameters() {
   return parameter_map;
 }
 
-// Parses arguments argc, argv and contained configuration file, if any.
+// Parses arguments argc, argv and contained configuration file, if any. If
+// `configuration_override` is non-empty, it is read instead of the
+// configuration file passed on the command line.
 //
-arg_parse_convert::ArgumentMap ParseArguments(int argc, const char** argv) {
+arg_parse_convert::ArgumentMap ParseArguments(
+    int argc, const char** argv,
+    const std::string& configuration_override = "") {
   std::vector<std::string> additional_arguments;
   std::stringstream error_message;
   arg_parse_convert::ParameterMap parameter_map{InitParameters()};
   arg_parse_convert::ArgumentMap argument_map{std::move(parameter_map)};
   additional_arguments = arg_parse_convert::ParseArgs(argc, argv,
                                                       argument_map);
+  std::string configuration_filename{configuration_override};
+  if (configuration_filename.empty()
+      && argument_map.HasArgument("configuration_file")) {
+    configuration_filename = argument_map.GetValue<std::string>(
+        "configuration_file");
+  }
 
   if (!additional_arguments.empty()) {
     // Some arguments couldn't be assiged to parameters.
@@ -256,14 +609,13 @@ arg_parse_convert::ArgumentMap ParseArguments(int argc, const char** argv) {
                   << std::endl;
     throw arg_parse_convert::exceptions::ArgumentParsingError(
         error_message.str());
-  } else if (argument_map.HasArgument("configuration_file")) {
-    std::ifstream ifs{argument_map.GetValue<std::string>("configuration_file")};
+  } else if (!configuration_filename.empty()) {
+    std::ifstream ifs{configuration_filename};
     if (ifs.is_open()) {
       additional_arguments = arg_parse_convert::ParseFile(ifs, argument_map);
     } else {
       error_message << "Unable to open configuration file: "
-                    << argument_map.GetValue<std::string>("configuration_file")
-                    << std::endl;
+                    << configuration_filename << std::endl;
       throw arg_parse_convert::exceptions::ArgumentParsingError(
           error_message.str());
     }
@@ -280,6 +632,21 @@ arg_parse_convert::ArgumentMap ParseArguments(int argc, const char** argv) {
   return argument_map;
 }
 
+// Ensures required parameters have arguments. The input file is not required
+// in manifest mode.
+//
+void TestRequiredArguments(const arg_parse_convert::ArgumentMap& argument_map) {
+  bool manifest_mode{argument_map.HasArgument("manifest_file")};
+  for (const std::string& name : argument_map.GetUnfilledParameters()) {
+    if (!manifest_mode || name != "input_file") {
+      std::stringstream error_message;
+      error_message << "Missing argument for parameter: " << name << '.';
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          error_message.str());
+    }
+  }
+}
+
 // Converts arguments stored in `argument_map` into `PasteParameters` object.
 //
 paste_alignments::PasteParameters GetPasteParameters(
@@ -294,8 +661,40 @@ paste_alignments::PasteParameters GetPasteParameters(
       "intermediate_score");
   result.final_pident_threshold = argument_map.GetValue<float>("final_pident");
   result.final_score_threshold = argument_map.GetValue<float>("final_score");
+  result.final_evalue = argument_map.GetValue<double>("final_evalue");
+  result.final_bitscore = argument_map.GetValue<float>("final_bitscore");
+  if (result.final_evalue < 0.0 || result.final_bitscore < 0.0f) {
+    throw arg_parse_convert::exceptions::ArgumentParsingError(
+        "Parameters `--final_evalue` and `--final_bitscore` must be"
+        " non-negative.");
+  }
   result.blind_mode = argument_map.IsSet("blind_mode");
+  result.remove_redundant = argument_map.IsSet("remove_redundant");
+  result.sequence_views = argument_map.IsSet("sequence_views");
+  result.stream_window = paste_alignments::helpers::TestNonNegative(
+      argument_map.GetValue<int>("stream_window"));
   result.enforce_average_score = argument_map.IsSet("enforce_average_score");
+  result.candidate_budget = paste_alignments::helpers::TestNonNegative(
+      argument_map.GetValue<long>("candidate_budget"));
+  result.max_alignments_per_batch = paste_alignments::helpers::TestNonNegative(
+      argument_map.GetValue<int>("max_alignments_per_batch"));
+  if (result.max_alignments_per_batch > 0 && result.stream_window > 0) {
+    throw arg_parse_convert::exceptions::ArgumentParsingError(
+        "Parameter `--max_alignments_per_batch` cannot be combined with"
+        " `--stream_window`.");
+  }
+  std::string engine{argument_map.GetValue<std::string>("engine")};
+  if (engine == "greedy") {
+    result.engine = paste_alignments::PastingEngine::kGreedy;
+  } else if (engine == "chain") {
+    result.engine = paste_alignments::PastingEngine::kChain;
+  } else if (engine == "auto") {
+    result.engine = paste_alignments::PastingEngine::kAuto;
+  } else {
+    throw arg_parse_convert::exceptions::ArgumentParsingError(
+        "Unknown pasting engine: '" + engine + "'. Expected `greedy`,"
+        " `chain`, or `auto`.");
+  }
 
   // Scoring parameters.
   result.reward = argument_map.GetValue<int>("reward");
@@ -305,29 +704,218 @@ paste_alignments::PasteParameters GetPasteParameters(
   result.db_size = argument_map.GetValue<int>("db_size");
 
   // Input/Output.
-  result.input_filename = argument_map.GetValue<std::string>("input_file");
+  if (argument_map.HasArgument("input_file")) {
+    result.input_filename = argument_map.GetValue<std::string>("input_file");
+  }
   if (argument_map.HasArgument("output_file")) {
     result.output_filename = argument_map.GetValue<std::string>("output_file");
   }
+  if (argument_map.HasArgument("output_columns")) {
+    result.output_columns = argument_map.GetValue<std::string>(
+        "output_columns");
+  }
+  result.compact_rows = argument_map.IsSet("compact_rows");
+  result.output_sink = argument_map.GetValue<std::string>("output_sink");
+  result.binary_output = argument_map.IsSet("binary_output");
+  result.output_shards = paste_alignments::helpers::TestPositive(
+      argument_map.GetValue<int>("output_shards"));
+  result.output_index = argument_map.IsSet("output_index");
+  result.max_hits_per_query = paste_alignments::helpers::TestNonNegative(
+      argument_map.GetValue<int>("max_hits_per_query"));
   if (argument_map.HasArgument("summary_file")) {
     result.summary_filename = argument_map.GetValue<std::string>("summary_file");
   }
   if (argument_map.HasArgument("stats_file")) {
     result.stats_filename = argument_map.GetValue<std::string>("stats_file");
   }
+  if (argument_map.HasArgument("degraded_file")) {
+    result.degraded_filename = argument_map.GetValue<std::string>(
+        "degraded_file");
+  }
 
   // Other.
+  result.checkpoint_interval = argument_map.GetValue<int>(
+      "checkpoint_interval");
+  result.resume = argument_map.IsSet("resume");
+
   result.float_epsilon = argument_map.GetValue<float>("float_epsilon");
   result.double_epsilon = argument_map.GetValue<double>("double_epsilon");
 
   return result;
 }
 
+// Writes overall statistics described by `totals` into file `filename`. If
+// `include_totals` is set, the summary can be merged with those of other
+// shards.
+//
+void WriteSummary(const paste_alignments::PasteTotals& totals,
+                  const std::string& filename, bool include_totals = false) {
+  std::ofstream summary_ofs{filename};
+  paste_alignments::WriteSummary(totals, summary_ofs, include_totals);
+  summary_ofs.close();
+}
+
+// Accounts the stats held in memory by `stats_collector` in `budget`, of which
+// `reserved` bytes are already reserved for them. Spills the stats to disk if
+// they do not fit.
+//
+void AccountStats(paste_alignments::StatsCollector& stats_collector,
+                  long& reserved, paste_alignments::MemoryBudget& budget) {
+  if (budget.MaxBytes() == 0l) {return;}
+  long usage{stats_collector.MemoryUsage()};
+  if (!budget.Reserve(usage - reserved)) {
+    stats_collector.Spill();
+    usage = stats_collector.MemoryUsage();
+    if (!budget.Reserve(usage - reserved)) {
+      return;
+    }
+  }
+  reserved = usage;
+}
+
+// Reads the next batch from `reader` and passes its pasted output to
+// `write_output` together with its query and subject sequence identifiers.
+// The output and stats are taken from `cache` if the batch was pasted under
+// `settings` before, and are added to it otherwise. Cached output refers to
+// rows by their position in the batch. The batch's stats are added to
+// `stats_collector` if `collect_stats` is set. The batch's memory is acquired
+// from `budget` while it is read and pasted. Row identifiers are shifted if
+// `format` writes them as its last column.
+//
+void PasteCachedBatch(paste_alignments::AlignmentReader& reader,
+                      const paste_alignments::ScoringSystem& scoring_system,
+                      const paste_alignments::PasteParameters& paste_parameters,
+                      const std::string& settings,
+                      paste_alignments::ResultCache& cache,
+                      bool collect_stats,
+                      paste_alignments::StatsCollector& stats_collector,
+                      paste_alignments::MemoryBudget& budget,
+                      const paste_alignments::OutputFormat& format,
+                      const std::function<void(const std::string&,
+                                               const std::string&,
+                                               const std::string&)>&
+                          write_output) {
+  long batch_bytes;
+  paste_alignments::RawBatch raw_batch{reader.ReadRawBatch(budget,
+                                                           batch_bytes)};
+  std::string qseqid{raw_batch.qseqid}, sseqid{raw_batch.sseqid};
+  long first_row_id{raw_batch.first_row_id};
+  paste_alignments::CacheKey key{
+      paste_alignments::CacheKey::FromRawBatch(raw_batch, settings)};
+  std::string output;
+  paste_alignments::StatsCollector batch_stats;
+  if (!cache.Lookup(key, output, batch_stats)) {
+    paste_alignments::AlignmentBatch batch{reader.ParseBatch(
+        std::move(raw_batch), scoring_system, paste_parameters)};
+    batch.PasteAlignments(scoring_system, paste_parameters);
+    batch_stats.CollectStats(batch);
+    batch_stats.ShiftRowIds(1 - first_row_id);
+    paste_alignments::MemorySink batch_output;
+    paste_alignments::WriteBatch(batch, batch_output, format);
+    output = batch_output.Release();
+    if (format.RowsColumn() != -1) {
+      output = paste_alignments::ShiftRowIds(output, 1 - first_row_id);
+    }
+    cache.Store(key, output, batch_stats);
+  }
+  budget.Release(batch_bytes);
+  if (format.RowsColumn() != -1) {
+    output = paste_alignments::ShiftRowIds(output, first_row_id - 1);
+  }
+  write_output(qseqid, sseqid, output);
+  if (collect_stats) {
+    batch_stats.ShiftRowIds(first_row_id - 1);
+    stats_collector.Merge(batch_stats);
+  }
+}
+
+// Throws `ArgumentParsingError` if options set in `paste_parameters` cannot be
+// combined with each other, with the output columns of `format`, with
+// processing a shard of the input file if `sharded` is set, or with a result
+// cache if `cached` is set. Checked before any output file is opened.
+//
+void TestCompatibleOptions(
+    const paste_alignments::PasteParameters& paste_parameters,
+    const paste_alignments::OutputFormat& format, bool sharded, bool cached) {
+  bool use_checkpoints{paste_parameters.checkpoint_interval > 0
+                       || paste_parameters.resume};
+  if (use_checkpoints && paste_parameters.output_filename.empty()) {
+    throw arg_parse_convert::exceptions::ArgumentParsingError(
+        "Checkpoints require an output file.");
+  }
+  if (use_checkpoints && paste_parameters.output_sink != "file"
+      && paste_parameters.output_sink != "fd") {
+    throw arg_parse_convert::exceptions::ArgumentParsingError(
+        "Checkpoints require output sink `file` or `fd`.");
+  }
+  if (paste_parameters.output_index
+      && (paste_parameters.output_filename.empty()
+          || paste_parameters.binary_output
+          || (paste_parameters.output_sink != "file"
+              && paste_parameters.output_sink != "fd"))) {
+    throw arg_parse_convert::exceptions::ArgumentParsingError(
+        "Parameter `--output_index` requires an output file written with"
+        " output sink `file` or `fd` and cannot be combined with"
+        " `--binary_output`.");
+  }
+  if (paste_parameters.output_shards > 1
+      && (paste_parameters.output_filename.empty() || use_checkpoints
+          || sharded)) {
+    throw arg_parse_convert::exceptions::ArgumentParsingError(
+        "Parameter `--output_shards` requires an output file and cannot be"
+        " combined with `--shard` or checkpoints.");
+  }
+  if (paste_parameters.binary_output
+      && (cached || use_checkpoints || sharded
+          || !paste_parameters.output_columns.empty()
+          || paste_parameters.compact_rows)) {
+    throw arg_parse_convert::exceptions::ArgumentParsingError(
+        "Parameter `--binary_output` cannot be combined with"
+        " `--output_columns`, `--compact_rows`, `--cache`, `--shard`, or"
+        " checkpoints.");
+  }
+  if (paste_parameters.max_hits_per_query > 0
+      && (cached || use_checkpoints || paste_parameters.binary_output)) {
+    throw arg_parse_convert::exceptions::ArgumentParsingError(
+        "Parameter `--max_hits_per_query` cannot be combined with"
+        " `--binary_output`, `--cache`, or checkpoints.");
+  }
+  if (cached && paste_parameters.stream_window > 0) {
+    throw arg_parse_convert::exceptions::ArgumentParsingError(
+        "Parameter `--stream_window` cannot be combined with `--cache`.");
+  }
+  if (cached && format.RowsColumn() != -1
+      && format.RowsColumn() != format.NumColumns() - 1) {
+    throw arg_parse_convert::exceptions::ArgumentParsingError(
+        "With `--cache`, `--output_columns` must list rows last, if at all.");
+  }
+}
+
 // Reads input file, pastes alignments, prints pasted alignments as well as
-// summary and descriptive statistics, if desired, into output files.
+// descriptive statistics, if desired, into output files. Returns the totals
+// of the output alignments, which are only computed if a stats or summary file
+// is requested, or if `collect_stats` is set. If `shard` is given, only the
+// shard's part of the input file is processed and each output file is replaced
+// by the shard's file. If output shards are requested, output, stats, and
+// degraded batches are split into one file per output shard by query. If
+// checkpoints are enabled, progress is recorded
+// periodically and a previous run may be resumed. If `cache` is given, results
+// of previously pasted batches are reused. The memory of batches and collected
+// stats is accounted in `budget`, if given.
 //
-void PasteAlignments(
-    const paste_alignments::PasteParameters& paste_parameters) {
+paste_alignments::PasteTotals PasteAlignments(
+    paste_alignments::PasteParameters paste_parameters,
+    bool collect_stats = false,
+    const paste_alignments::Shard* shard = nullptr,
+    paste_alignments::ResultCache* cache = nullptr,
+    paste_alignments::MemoryBudget* budget = nullptr) {
+  // Output columns.
+  paste_alignments::OutputFormat format{
+      paste_alignments::OutputFormat::FromString(
+          paste_parameters.output_columns, paste_parameters.blind_mode,
+          paste_parameters.compact_rows)};
+  TestCompatibleOptions(paste_parameters, format, shard != nullptr,
+                        cache != nullptr);
 
   // Input file.
   int num_fields = 13;
@@ -336,59 +924,619 @@ void PasteAlignments(
   }
   std::unique_ptr<std::ifstream> inputs_ifs{
       new std::ifstream{paste_parameters.input_filename}};
+  if (!inputs_ifs->is_open()) {
+    std::stringstream error_message;
+    error_message << "Unable to open input file: "
+                  << paste_parameters.input_filename;
+    throw paste_alignments::exceptions::ReadError(error_message.str());
+  }
+  paste_alignments::InputRange range;
+  if (shard != nullptr) {
+    range = paste_alignments::FindShardRange(*inputs_ifs, *shard);
+    for (std::string* filename : {&paste_parameters.output_filename,
+                                  &paste_parameters.stats_filename,
+                                  &paste_parameters.summary_filename,
+                                  &paste_parameters.degraded_filename}) {
+      if (!filename->empty()) {
+        *filename = paste_alignments::ShardFilename(*filename, shard->index);
+      }
+    }
+  }
+
+  // Checkpoints. When resuming, the output file is truncated to the
+  // checkpoint's size and reading continues at the checkpoint's offset.
+  bool use_checkpoints{paste_parameters.checkpoint_interval > 0
+                       || paste_parameters.resume};
+  std::string checkpoint_filename;
+  paste_alignments::Checkpoint progress;
+  progress.input_filename = paste_parameters.input_filename;
+  progress.settings = paste_alignments::CacheSettings(paste_parameters,
+                                                      num_fields);
+  if (shard != nullptr) {
+    progress.shard = (std::to_string(shard->index) + '/'
+                      + std::to_string(shard->num_shards));
+  }
+  bool resumed{false};
+  if (use_checkpoints) {
+    checkpoint_filename = paste_alignments::CheckpointFilename(
+        paste_parameters.output_filename);
+  }
+  if (paste_parameters.resume
+      && std::filesystem::exists(checkpoint_filename)) {
+    std::ifstream checkpoint_ifs{checkpoint_filename};
+    paste_alignments::Checkpoint saved{
+        paste_alignments::Checkpoint::FromIStream(checkpoint_ifs)};
+    if (saved.input_filename != progress.input_filename) {
+      std::stringstream error_message;
+      error_message << "Checkpoint file: " << checkpoint_filename
+                    << " belongs to a run on input file: "
+                    << saved.input_filename;
+      throw paste_alignments::exceptions::ReadError(error_message.str());
+    }
+    if (saved.settings != progress.settings || saved.shard != progress.shard) {
+      std::stringstream error_message;
+      error_message << "Checkpoint file: " << checkpoint_filename
+                    << " belongs to a run with different settings: "
+                    << saved.settings;
+      if (!saved.shard.empty()) {
+        error_message << " on shard: " << saved.shard;
+      }
+      throw paste_alignments::exceptions::ReadError(error_message.str());
+    }
+    progress = std::move(saved);
+    range.begin_offset = progress.input_offset;
+    range.first_row_id = progress.next_row_id;
+    std::filesystem::resize_file(paste_parameters.output_filename,
+                                 progress.output_offset);
+    if (paste_parameters.output_index) {
+      paste_alignments::TruncateOutputIndex(
+          paste_alignments::OutputIndexFilename(
+              paste_parameters.output_filename),
+          progress.output_offset);
+    }
+    resumed = true;
+  } else if (use_checkpoints) {
+    std::filesystem::remove(checkpoint_filename);
+  }
+
   paste_alignments::AlignmentReader reader{
       paste_alignments::AlignmentReader::FromIStream(std::move(inputs_ifs),
-                                                     num_fields)};
+                                                     num_fields, range)};
   // Scoring system.
   paste_alignments::ScoringSystem scoring_system{
       paste_alignments::ScoringSystem::Create(
           paste_parameters.db_size, paste_parameters.reward,
           paste_parameters.penalty, paste_parameters.open_cost,
           paste_parameters.extend_cost)};
-  // Output file.
-  std::ofstream alignments_ofs;
-  if (!paste_parameters.output_filename.empty()) {
-    alignments_ofs.open(paste_parameters.output_filename);
+  // Output file. When resuming, the output is appended to the truncated file.
+  // With output shards, each shard's file is named after the output file and
+  // receives the batches of the queries hashed to it.
+  int num_output_shards{paste_parameters.output_shards};
+  auto output_shard_filename{[&](const std::string& filename, int index) {
+    return (num_output_shards > 1
+            ? paste_alignments::ShardFilename(filename, index + 1)
+            : filename);
+  }};
+  auto output_shard{[&](std::string_view qseqid) {
+    return (num_output_shards > 1
+            ? paste_alignments::OutputShardIndex(qseqid, num_output_shards)
+            : 0);
+  }};
+  std::vector<std::unique_ptr<paste_alignments::OutputSink>> alignments_sinks;
+  for (int index = 0; index < num_output_shards; ++index) {
+    alignments_sinks.push_back(paste_alignments::OpenOutputSink(
+        paste_parameters.output_sink,
+        output_shard_filename(paste_parameters.output_filename, index),
+        resumed));
+  }
+  long output_offset{resumed ? progress.output_offset : 0l};
+  // Output index of each output file.
+  std::vector<std::unique_ptr<std::ofstream>> index_ofs;
+  std::vector<paste_alignments::OutputIndexWriter> index_writers;
+  if (paste_parameters.output_index) {
+    for (int index = 0; index < num_output_shards; ++index) {
+      index_ofs.emplace_back(new std::ofstream{
+          paste_alignments::OutputIndexFilename(output_shard_filename(
+              paste_parameters.output_filename, index)),
+          resumed ? std::ios_base::app : std::ios_base::out});
+      index_writers.emplace_back(*index_ofs.back());
+    }
+  }
+  auto write_output{[&](const std::string& qseqid, const std::string& sseqid,
+                        const std::string& output) {
+    int index{output_shard(qseqid)};
+    paste_alignments::OutputSink& sink{*alignments_sinks.at(index)};
+    long offset{sink.BytesWritten()};
+    sink.Write(output);
+    if (!index_writers.empty()) {
+      index_writers.at(index).Add(
+          qseqid, sseqid, output_offset + offset, sink.BytesWritten() - offset,
+          std::count(output.begin(), output.end(), '\n'));
+    }
+  }};
+  std::string settings;
+  if (cache != nullptr) {
+    settings = paste_alignments::CacheSettings(paste_parameters, num_fields);
+  }
+  std::vector<std::unique_ptr<paste_alignments::BinaryWriter>> binary_writers;
+  if (paste_parameters.binary_output) {
+    for (std::unique_ptr<paste_alignments::OutputSink>& sink
+         : alignments_sinks) {
+      binary_writers.emplace_back(new paste_alignments::BinaryWriter{
+          *sink, !paste_parameters.blind_mode});
+    }
+  }
+  // Best alignments of each query, written once the next query begins.
+  std::unique_ptr<paste_alignments::QueryHitSelector> hit_selector;
+  if (paste_parameters.max_hits_per_query > 0) {
+    hit_selector.reset(new paste_alignments::QueryHitSelector{
+        paste_parameters.max_hits_per_query, format,
+        paste_parameters.float_epsilon, write_output});
   }
+  auto write_batch{[&](const paste_alignments::AlignmentBatch& batch) {
+    if (hit_selector != nullptr) {
+      hit_selector->Add(batch);
+      return;
+    }
+    int index{output_shard(batch.Qseqid())};
+    if (!binary_writers.empty()) {
+      binary_writers.at(index)->WriteBatch(batch);
+      return;
+    }
+    paste_alignments::OutputSink& sink{*alignments_sinks.at(index)};
+    long offset{sink.BytesWritten()};
+    long num_rows{paste_alignments::WriteBatch(batch, sink, format)};
+    if (!index_writers.empty()) {
+      index_writers.at(index).Add(
+          batch.Qseqid(), batch.Sseqid(), output_offset + offset,
+          sink.BytesWritten() - offset, num_rows);
+    }
+  }};
 
-  paste_alignments::StatsCollector stats_collector;
+  collect_stats = (collect_stats
+                   || !paste_parameters.stats_filename.empty()
+                   || !paste_parameters.summary_filename.empty()
+                   || !paste_parameters.degraded_filename.empty());
+  paste_alignments::StatsCollector& stats_collector{progress.stats_collector};
+  paste_alignments::MemoryBudget unlimited;
+  if (budget == nullptr) {
+    budget = &unlimited;
+  }
+  long stats_bytes{0l};
+  std::chrono::steady_clock::time_point last_checkpoint{
+      std::chrono::steady_clock::now()};
   while (!reader.EndOfData()) {
-    paste_alignments::AlignmentBatch batch = reader.ReadBatch(scoring_system,
-                                                              paste_parameters);
-    batch.PasteAlignments(scoring_system, paste_parameters);
-    if (!paste_parameters.stats_filename.empty()) {
-      stats_collector.CollectStats(batch);
-    }
-    if (!paste_parameters.output_filename.empty()) {
-      paste_alignments::WriteBatch(std::move(batch), alignments_ofs,
-                                   paste_parameters);
+    if (cache != nullptr) {
+      PasteCachedBatch(reader, scoring_system, paste_parameters, settings,
+                       *cache, collect_stats, stats_collector, *budget,
+                       format, write_output);
+    } else if (paste_parameters.stream_window > 0) {
+      int num_overflows{paste_alignments::PasteStreamedBatch(
+          reader, scoring_system, paste_parameters,
+          [&](paste_alignments::AlignmentBatch part, bool first_part) {
+            if (collect_stats) {
+              stats_collector.CollectStats(part, !first_part);
+            }
+            write_batch(part);
+          })};
+      if (collect_stats) {
+        stats_collector.CountWindowOverflows(num_overflows);
+      }
     } else {
-      paste_alignments::WriteBatch(std::move(batch), std::cout,
-                                   paste_parameters);
+      long batch_bytes;
+      paste_alignments::AlignmentBatch batch{reader.ParseBatch(
+          reader.ReadRawBatch(*budget, batch_bytes), scoring_system,
+          paste_parameters)};
+      batch.PasteAlignments(scoring_system, paste_parameters);
+      if (collect_stats) {
+        stats_collector.CollectStats(batch);
+      }
+      write_batch(batch);
+      budget->Release(batch_bytes);
+    }
+    if (collect_stats) {
+      AccountStats(stats_collector, stats_bytes, *budget);
+    }
+
+    // Record progress once the output up to this batch is on disk.
+    if (paste_parameters.checkpoint_interval > 0 && !reader.EndOfData()
+        && (std::chrono::steady_clock::now() - last_checkpoint
+            >= std::chrono::seconds(paste_parameters.checkpoint_interval))) {
+      alignments_sinks.front()->Flush();
+      paste_alignments::SyncFile(paste_parameters.output_filename);
+      if (!index_writers.empty()) {
+        index_writers.front().Flush();
+        paste_alignments::SyncFile(paste_alignments::OutputIndexFilename(
+            paste_parameters.output_filename));
+      }
+      progress.input_offset = reader.NextBatchOffset();
+      progress.next_row_id = reader.NextAlignmentId();
+      progress.output_offset = (output_offset
+                                + alignments_sinks.front()->BytesWritten());
+      paste_alignments::SaveCheckpoint(progress, checkpoint_filename);
+      last_checkpoint = std::chrono::steady_clock::now();
     }
   }
-  if (!paste_parameters.output_filename.empty()) {
-    alignments_ofs.close();
+  if (hit_selector != nullptr) {
+    hit_selector->Flush();
+  }
+  for (std::unique_ptr<paste_alignments::BinaryWriter>& writer
+       : binary_writers) {
+    writer->Finish();
+  }
+  long bytes_written{0l};
+  for (std::unique_ptr<paste_alignments::OutputSink>& sink
+       : alignments_sinks) {
+    sink->Flush();
+    bytes_written += sink->BytesWritten();
+  }
+  if (paste_parameters.output_sink == "null") {
+    std::cerr << "Discarded " << bytes_written << " bytes of output."
+              << std::endl;
+  }
+  for (paste_alignments::OutputIndexWriter& writer : index_writers) {
+    writer.Flush();
+  }
+  binary_writers.clear();
+  alignments_sinks.clear();
+  index_writers.clear();
+  index_ofs.clear();
+
+  // Print stats and summary. Stats are split like the output.
+  auto stats_shard{[&](std::vector<std::ofstream>& shard_ofs) {
+    return [&](const paste_alignments::PasteStats& s) -> std::ostream& {
+      return shard_ofs.at(output_shard(s.qseqid));
+    };
+  }};
+  if (!paste_parameters.stats_filename.empty()) {
+    std::vector<std::ofstream> stats_ofs;
+    for (int index = 0; index < num_output_shards; ++index) {
+      stats_ofs.emplace_back(
+          output_shard_filename(paste_parameters.stats_filename, index));
+    }
+    stats_collector.WriteData(stats_shard(stats_ofs),
+                              paste_parameters.remove_redundant);
   }
+  if (!paste_parameters.degraded_filename.empty()) {
+    std::vector<std::ofstream> degraded_ofs;
+    for (int index = 0; index < num_output_shards; ++index) {
+      degraded_ofs.emplace_back(
+          output_shard_filename(paste_parameters.degraded_filename, index));
+    }
+    stats_collector.WriteDegraded(stats_shard(degraded_ofs));
+  }
+  if (!paste_parameters.summary_filename.empty()) {
+    WriteSummary(stats_collector.Totals(), paste_parameters.summary_filename,
+                 shard != nullptr);
+  }
+  if (use_checkpoints) {
+    std::filesystem::remove(checkpoint_filename);
+  }
+  budget->Reserve(-stats_bytes);
+  return stats_collector.Totals();
+}
 
-  // Print summary
+// Merges the index files of the output files written by `num_shards` shards
+// in place of `output_filename`, shifting each shard's offsets by the sizes of
+// the preceding shards' output files.
+//
+void MergeOutputIndexes(const std::string& output_filename, int num_shards) {
+  std::ofstream merged_ofs{
+      paste_alignments::OutputIndexFilename(output_filename)};
+  paste_alignments::OutputIndexWriter merged{merged_ofs};
+  long shift{0l};
+  for (int index = 1; index <= num_shards; ++index) {
+    std::string shard_filename{paste_alignments::ShardFilename(
+        output_filename, index)};
+    std::ifstream index_ifs{
+        paste_alignments::OutputIndexFilename(shard_filename)};
+    if (!index_ifs.is_open()) {
+      std::stringstream error_message;
+      error_message << "Unable to open shard file: "
+                    << paste_alignments::OutputIndexFilename(shard_filename);
+      throw paste_alignments::exceptions::ReadError(error_message.str());
+    }
+    for (const paste_alignments::OutputIndexEntry& entry
+         : paste_alignments::ReadOutputIndex(index_ifs)) {
+      merged.Add(entry.qseqid, entry.sseqid, entry.offset + shift, entry.size,
+                 entry.num_rows);
+    }
+    shift += static_cast<long>(std::filesystem::file_size(shard_filename));
+  }
+  merged.Flush();
+}
+
+// Merges the files written by `num_shards` shards in place of the output,
+// stats, and summary files named in `paste_parameters`. Outputs and stats are
+// concatenated in the order of the shards, and summaries are combined from the
+// shards' totals.
+//
+void MergeShards(const paste_alignments::PasteParameters& paste_parameters,
+                 int num_shards) {
+  paste_alignments::helpers::TestPositive(num_shards);
+  if (!paste_parameters.output_filename.empty()) {
+    paste_alignments::ConcatenateShards(paste_parameters.output_filename,
+                                        num_shards);
+  }
+  if (!paste_parameters.output_filename.empty()
+      && paste_parameters.output_index) {
+    MergeOutputIndexes(paste_parameters.output_filename, num_shards);
+  }
   if (!paste_parameters.stats_filename.empty()) {
-    std::ofstream stats_ofs{paste_parameters.stats_filename};
-    paste_alignments::PasteStats summary{stats_collector.WriteData(stats_ofs)};
-    stats_ofs.close();
-    if (!paste_parameters.summary_filename.empty()) {
-      std::ofstream summary_ofs{paste_parameters.summary_filename};
-      summary_ofs << "{\n"
-                  << "\t\"num_alignments\": " << summary.num_alignments << ",\n"
-                  << "\t\"num_pastings\": " << summary.num_pastings << ",\n"
-                  << "\t\"average_length\": " << summary.average_length << ",\n"
-                  << "\t\"average_pident\": " << summary.average_pident << ",\n"
-                  << "\t\"average_score\": " << summary.average_score << ",\n"
-                  << "\t\"average_bitscore\": " << summary.average_bitscore << ",\n"
-                  << "\t\"average_evalue\": " << summary.average_evalue << ",\n"
-                  << "\t\"average_nmatches\": " << summary.average_nmatches << '\n'
-                  << "}\n";
-      summary_ofs.close();
+    paste_alignments::ConcatenateShards(paste_parameters.stats_filename,
+                                        num_shards);
+  }
+  if (!paste_parameters.degraded_filename.empty()) {
+    paste_alignments::ConcatenateShards(paste_parameters.degraded_filename,
+                                        num_shards);
+  }
+  if (!paste_parameters.summary_filename.empty()) {
+    paste_alignments::PasteTotals totals;
+    for (int index = 1; index <= num_shards; ++index) {
+      std::string shard_filename{paste_alignments::ShardFilename(
+          paste_parameters.summary_filename, index)};
+      std::ifstream summary_ifs{shard_filename};
+      if (!summary_ifs.is_open()) {
+        std::stringstream error_message;
+        error_message << "Unable to open shard file: " << shard_filename;
+        throw paste_alignments::exceptions::ReadError(error_message.str());
+      }
+      totals += paste_alignments::ReadSummaryTotals(summary_ifs);
+    }
+    WriteSummary(totals, paste_parameters.summary_filename);
+  }
+}
+
+// Creates the parameters of each job listed in the manifest file named in
+// `argument_map`. Each job's parameters are parsed from `argc`, `argv`, and the
+// job's configuration file, if any.
+//
+std::vector<paste_alignments::PasteParameters> GetManifestJobs(
+    const arg_parse_convert::ArgumentMap& argument_map,
+    int argc, const char** argv) {
+  arg_parse_convert::ArgumentMap manifest_arguments{argument_map};
+  std::string manifest_filename{
+      manifest_arguments.GetValue<std::string>("manifest_file")};
+  std::ifstream manifest_ifs{manifest_filename};
+  if (!manifest_ifs.is_open()) {
+    std::stringstream error_message;
+    error_message << "Unable to open manifest file: " << manifest_filename;
+    throw paste_alignments::exceptions::ReadError(error_message.str());
+  }
+  std::vector<paste_alignments::ManifestEntry> entries{
+      paste_alignments::ReadManifest(manifest_ifs)};
+
+  std::vector<paste_alignments::PasteParameters> jobs;
+  jobs.reserve(entries.size());
+  for (const paste_alignments::ManifestEntry& entry : entries) {
+    arg_parse_convert::ArgumentMap job_arguments{
+        ParseArguments(argc, argv, entry.configuration_filename)};
+    TestRequiredArguments(job_arguments);
+    paste_alignments::PasteParameters job{
+        GetPasteParameters(std::move(job_arguments))};
+    if (!job.degraded_filename.empty()) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "Parameter `--degraded_file` cannot be combined with `--manifest`.");
+    }
+    job.input_filename = entry.input_filename;
+    job.output_filename = entry.output_filename;
+    job.stats_filename = entry.stats_filename;
+    job.summary_filename.clear();
+    jobs.emplace_back(std::move(job));
+  }
+  return jobs;
+}
+
+// Executes `jobs` using a pool of `num_threads` worker threads and returns the
+// combined totals of all jobs, which are only computed if `collect_stats` is
+// set. All jobs share `cache`, if given, and `budget`.
+//
+paste_alignments::PasteTotals RunJobs(
+    const std::vector<paste_alignments::PasteParameters>& jobs,
+    int num_threads, bool collect_stats,
+    paste_alignments::ResultCache* cache,
+    paste_alignments::MemoryBudget& budget) {
+  std::vector<paste_alignments::PasteTotals> job_totals(jobs.size());
+  paste_alignments::helpers::RunTasks(
+      static_cast<int>(jobs.size()), num_threads, [&](int job) {
+        job_totals.at(job) = PasteAlignments(jobs.at(job), collect_stats,
+                                             nullptr, cache, &budget);
+      });
+  paste_alignments::PasteTotals totals;
+  for (const paste_alignments::PasteTotals& t : job_totals) {
+    totals += t;
+  }
+  return totals;
+}
+
+// Creates the parameters of each set listed in the sweep file named in
+// `argument_map`. Each set's parameters are parsed from `argc`, `argv`, and the
+// set's configuration file, if any.
+//
+std::vector<paste_alignments::PasteParameters> GetSweepSettings(
+    const arg_parse_convert::ArgumentMap& argument_map,
+    int argc, const char** argv) {
+  arg_parse_convert::ArgumentMap sweep_arguments{argument_map};
+  std::string sweep_filename{
+      sweep_arguments.GetValue<std::string>("sweep_file")};
+  std::ifstream sweep_ifs{sweep_filename};
+  if (!sweep_ifs.is_open()) {
+    std::stringstream error_message;
+    error_message << "Unable to open sweep file: " << sweep_filename;
+    throw paste_alignments::exceptions::ReadError(error_message.str());
+  }
+  std::vector<paste_alignments::SweepEntry> entries{
+      paste_alignments::ReadSweepFile(sweep_ifs)};
+  if (entries.empty()) {
+    std::stringstream error_message;
+    error_message << "Sweep file lists no parameter sets: " << sweep_filename;
+    throw paste_alignments::exceptions::ReadError(error_message.str());
+  }
+
+  std::vector<paste_alignments::PasteParameters> settings;
+  settings.reserve(entries.size());
+  for (const paste_alignments::SweepEntry& entry : entries) {
+    arg_parse_convert::ArgumentMap set_arguments{
+        ParseArguments(argc, argv, entry.configuration_filename)};
+    TestRequiredArguments(set_arguments);
+    paste_alignments::PasteParameters set{
+        GetPasteParameters(std::move(set_arguments))};
+    if (set.stream_window > 0) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "Parameter `--stream_window` cannot be combined with `--sweep`.");
+    }
+    if (!set.degraded_filename.empty()) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "Parameter `--degraded_file` cannot be combined with `--sweep`.");
+    }
+    if (!settings.empty() && set.blind_mode != settings.front().blind_mode) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "All parameter sets of a sweep must agree on `--blind_mode`.");
+    }
+    // Redundant alignments are removed once while parsing, comparing scores
+    // under the first set's scoring system.
+    if (!settings.empty()
+        && (set.remove_redundant != settings.front().remove_redundant
+            || (set.remove_redundant
+                && (set.reward != settings.front().reward
+                    || set.penalty != settings.front().penalty
+                    || set.open_cost != settings.front().open_cost
+                    || set.extend_cost != settings.front().extend_cost)))) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "All parameter sets of a sweep must agree on `--remove_redundant`"
+          " and, if it is set, on the scoring parameters.");
+    }
+    set.output_filename = entry.output_filename;
+    set.stats_filename = entry.stats_filename;
+    set.summary_filename = entry.summary_filename;
+    settings.emplace_back(std::move(set));
+  }
+  return settings;
+}
+
+// Reads the input file once and pastes each batch under each parameter set in
+// `settings`, writing each set's output, stats, and summary files. Batches are
+// read and parsed in chunks under the first set's scoring system. Each set
+// pastes its own copy of a chunk's batches, whose similarity measures are
+// recomputed if the set's scoring system differs. Up to `num_threads` sets are
+// pasted simultaneously. Chunks end early once their batches and the collected
+// stats no longer fit into `budget`, and the stats are spilled to disk if
+// needed.
+//
+void SweepAlignments(
+    const std::vector<paste_alignments::PasteParameters>& settings,
+    int num_threads, paste_alignments::MemoryBudget& budget) {
+  assert(!settings.empty());
+  const paste_alignments::PasteParameters& parse_parameters{settings.front()};
+  int num_sets{static_cast<int>(settings.size())};
+
+  // Input file.
+  int num_fields = 13;
+  if (parse_parameters.blind_mode) {
+    num_fields -= 2;
+  }
+  std::unique_ptr<std::ifstream> inputs_ifs{
+      new std::ifstream{parse_parameters.input_filename}};
+  if (!inputs_ifs->is_open()) {
+    std::stringstream error_message;
+    error_message << "Unable to open input file: "
+                  << parse_parameters.input_filename;
+    throw paste_alignments::exceptions::ReadError(error_message.str());
+  }
+  paste_alignments::AlignmentReader reader{
+      paste_alignments::AlignmentReader::FromIStream(std::move(inputs_ifs),
+                                                     num_fields)};
+
+  // Scoring systems, output files, and stats of each set.
+  std::vector<paste_alignments::ScoringSystem> scoring_systems;
+  std::vector<paste_alignments::OutputFormat> formats;
+  std::vector<bool> rescore;
+  std::vector<std::unique_ptr<paste_alignments::OutputSink>> alignments_sinks;
+  std::vector<paste_alignments::StatsCollector> stats_collectors(num_sets);
+  std::vector<long> stats_bytes(num_sets, 0l);
+  for (const paste_alignments::PasteParameters& set : settings) {
+    if (set.binary_output) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "Parameter `--binary_output` cannot be combined with `--sweep`.");
+    }
+    if (set.output_shards > 1) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "Parameter `--output_shards` cannot be combined with `--sweep`.");
+    }
+    if (set.output_index) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "Parameter `--output_index` cannot be combined with `--sweep`.");
+    }
+    if (set.max_hits_per_query > 0) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "Parameter `--max_hits_per_query` cannot be combined with"
+          " `--sweep`.");
+    }
+    scoring_systems.emplace_back(paste_alignments::ScoringSystem::Create(
+        set.db_size, set.reward, set.penalty, set.open_cost,
+        set.extend_cost));
+    formats.push_back(paste_alignments::OutputFormat::FromString(
+        set.output_columns, set.blind_mode, set.compact_rows));
+    rescore.push_back(set.db_size != parse_parameters.db_size
+                      || set.reward != parse_parameters.reward
+                      || set.penalty != parse_parameters.penalty
+                      || set.open_cost != parse_parameters.open_cost
+                      || set.extend_cost != parse_parameters.extend_cost
+                      || set.float_epsilon != parse_parameters.float_epsilon
+                      || set.double_epsilon
+                         != parse_parameters.double_epsilon);
+    alignments_sinks.push_back(paste_alignments::OpenOutputSink(
+        set.output_filename.empty() ? "null" : set.output_sink,
+        set.output_filename));
+  }
+
+  std::vector<paste_alignments::AlignmentBatch> chunk;
+  chunk.reserve(kSweepChunkSize);
+  while (!reader.EndOfData()) {
+    chunk.clear();
+    long chunk_bytes{0l};
+    while (!reader.EndOfData()
+           && static_cast<int>(chunk.size()) < kSweepChunkSize
+           && (chunk.empty() || budget.Fits(chunk_bytes))) {
+      chunk.emplace_back(reader.ReadBatch(scoring_systems.front(),
+                                          parse_parameters));
+      chunk_bytes += chunk.back().MemoryUsage();
+    }
+    paste_alignments::helpers::RunTasks(num_sets, num_threads, [&](int i) {
+      const paste_alignments::PasteParameters& set{settings.at(i)};
+      bool collect_stats{!set.stats_filename.empty()
+                         || !set.summary_filename.empty()};
+      for (const paste_alignments::AlignmentBatch& parsed : chunk) {
+        paste_alignments::AlignmentBatch batch{parsed};
+        if (rescore.at(i)) {
+          batch.UpdateSimilarityMeasures(scoring_systems.at(i), set);
+        }
+        batch.PasteAlignments(scoring_systems.at(i), set);
+        if (collect_stats) {
+          stats_collectors.at(i).CollectStats(batch);
+        }
+        paste_alignments::WriteBatch(batch, *alignments_sinks.at(i),
+                                     formats.at(i));
+      }
+    });
+    for (int i = 0; i < num_sets; ++i) {
+      AccountStats(stats_collectors.at(i), stats_bytes.at(i), budget);
+    }
+  }
+
+  // Print stats and summaries.
+  for (int i = 0; i < num_sets; ++i) {
+    const paste_alignments::PasteParameters& set{settings.at(i)};
+    alignments_sinks.at(i)->Flush();
+    alignments_sinks.at(i).reset();
+    if (!set.stats_filename.empty()) {
+      std::ofstream stats_ofs{set.stats_filename};
+      stats_collectors.at(i).WriteData(stats_ofs,
+                                       settings.at(i).remove_redundant);
+      stats_ofs.close();
+    }
+    if (!set.summary_filename.empty()) {
+      WriteSummary(stats_collectors.at(i).Totals(), set.summary_filename);
     }
   }
 }
@@ -415,20 +1563,99 @@ int main(int argc, const char** argv) {
       return 0;
     }
 
+    // Open result cache.
+    std::unique_ptr<paste_alignments::ResultCache> cache;
+    if (argument_map.HasArgument("cache_directory")) {
+      long cache_size{argument_map.GetValue<int>("cache_size")};
+      cache.reset(new paste_alignments::ResultCache{
+          argument_map.GetValue<std::string>("cache_directory"),
+          cache_size * 1024l * 1024l});
+    }
+
+    // Memory budget shared by all jobs and threads.
+    long max_memory{paste_alignments::helpers::TestNonNegative(
+        argument_map.GetValue<int>("max_memory"))};
+    paste_alignments::MemoryBudget budget{max_memory * 1024l * 1024l};
+
+    // Process jobs listed in manifest file.
+    bool sharded{argument_map.HasArgument("shard")};
+    bool merge{argument_map.HasArgument("num_merged_shards")};
+    if (sharded && merge) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "Parameters `--shard` and `--merge_shards` are mutually exclusive.");
+    }
+    if (argument_map.HasArgument("manifest_file")) {
+      if (argument_map.HasArgument("sweep_file")) {
+        throw arg_parse_convert::exceptions::ArgumentParsingError(
+            "Parameters `--manifest` and `--sweep` are mutually exclusive.");
+      }
+      if (sharded || merge) {
+        throw arg_parse_convert::exceptions::ArgumentParsingError(
+            "Parameters `--shard` and `--merge_shards` cannot be combined with"
+            " `--manifest`.");
+      }
+      std::vector<paste_alignments::PasteParameters> jobs{
+          GetManifestJobs(argument_map, argc, argv)};
+      bool write_summary{argument_map.HasArgument("summary_file")};
+      paste_alignments::PasteTotals totals{
+          RunJobs(jobs, argument_map.GetValue<int>("num_threads"),
+                  write_summary, cache.get(), budget)};
+      if (write_summary) {
+        WriteSummary(totals,
+                     argument_map.GetValue<std::string>("summary_file"));
+      }
+      return 0;
+    }
+
     // Ensure required parameters have arguments.
-    std::vector<std::string> unfilled_parameters;
-    unfilled_parameters = argument_map.GetUnfilledParameters();
-    if (!unfilled_parameters.empty()) {
-      std::cerr << "Missing argument for parameter: "
-                << unfilled_parameters.at(0) << ".\n" << kUsageMessage
-                << std::endl;
-      return 1;
+    TestRequiredArguments(argument_map);
+
+    // Paste input file under each parameter set listed in sweep file.
+    if (argument_map.HasArgument("sweep_file")) {
+      if (sharded || merge || cache != nullptr
+          || argument_map.GetValue<int>("checkpoint_interval") > 0
+          || argument_map.IsSet("resume")) {
+        throw arg_parse_convert::exceptions::ArgumentParsingError(
+            "Parameter `--sweep` cannot be combined with `--shard`,"
+            " `--merge_shards`, `--cache`, or checkpoints.");
+      }
+      SweepAlignments(GetSweepSettings(argument_map, argc, argv),
+                      argument_map.GetValue<int>("num_threads"), budget);
+      return 0;
     }
 
-    // Paste alignments.
+    // Paste alignments, possibly only those of one shard, or merge the shards'
+    // files.
+    paste_alignments::Shard shard;
+    if (sharded) {
+      shard = paste_alignments::Shard::FromString(
+          argument_map.GetValue<std::string>("shard"));
+    }
+    int num_merged_shards{0};
+    if (merge) {
+      num_merged_shards = argument_map.GetValue<int>("num_merged_shards");
+    }
+    int num_threads{paste_alignments::helpers::TestPositive(
+        argument_map.GetValue<int>("num_threads"))};
     paste_alignments::PasteParameters paste_parameters{
         GetPasteParameters(std::move(argument_map))};
-    PasteAlignments(paste_parameters);
+    paste_parameters.num_threads = num_threads;
+    if (merge && paste_parameters.binary_output) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "Parameter `--binary_output` cannot be combined with"
+          " `--merge_shards`.");
+    }
+    if (merge && paste_parameters.output_shards > 1) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "Parameter `--output_shards` cannot be combined with"
+          " `--merge_shards`.");
+    }
+    if (merge) {
+      MergeShards(paste_parameters, num_merged_shards);
+    } else {
+      PasteAlignments(paste_parameters, false, sharded ? &shard : nullptr,
+                      cache.get(), &budget);
+    }
 
   // Argument parsing errors.
   } catch (const arg_parse_convert::exceptions::BaseError& e) {
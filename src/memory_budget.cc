@@ -0,0 +1,110 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "memory_budget.h"
+
+#include <sstream>
+
+#include "exceptions.h"
+
+namespace paste_alignments {
+
+// MemoryBudget::MemoryBudget
+//
+MemoryBudget::MemoryBudget(long max_bytes) : max_bytes_{max_bytes} {
+  if (max_bytes < 0l) {
+    std::stringstream error_message;
+    error_message << "Maximum memory must be non-negative. Provided value:"
+                  << max_bytes << '.';
+    throw exceptions::OutOfRange(error_message.str());
+  }
+}
+
+// MemoryBudget::Used
+//
+long MemoryBudget::Used() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return acquired_ + reserved_;
+}
+
+// MemoryBudget::Acquired
+//
+long MemoryBudget::Acquired() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return acquired_;
+}
+
+// MemoryBudget::Fits
+//
+bool MemoryBudget::Fits(long bytes) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return max_bytes_ == 0l || acquired_ + reserved_ + bytes <= max_bytes_;
+}
+
+// MemoryBudget::Acquire
+//
+void MemoryBudget::Acquire(long bytes) {
+  std::unique_lock<std::mutex> lock{mutex_};
+  released_.wait(lock, [&]() {
+    return (max_bytes_ == 0l || acquired_ == 0l
+            || acquired_ + reserved_ + bytes <= max_bytes_);
+  });
+  acquired_ += bytes;
+}
+
+// MemoryBudget::Release
+//
+void MemoryBudget::Release(long bytes) {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    acquired_ -= bytes;
+  }
+  released_.notify_all();
+}
+
+// MemoryBudget::Reserve
+//
+bool MemoryBudget::Reserve(long bytes) {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (bytes > 0l && max_bytes_ > 0l
+        && acquired_ + reserved_ + bytes > max_bytes_) {
+      return false;
+    }
+    reserved_ += bytes;
+  }
+  if (bytes < 0l) {
+    released_.notify_all();
+  }
+  return true;
+}
+
+// MemoryBudget::DebugString
+//
+std::string MemoryBudget::DebugString() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  std::stringstream ss;
+  ss << "{max_bytes: " << max_bytes_
+     << ", acquired: " << acquired_
+     << ", reserved: " << reserved_ << '}';
+  return ss.str();
+}
+
+} // namespace paste_alignments
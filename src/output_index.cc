@@ -0,0 +1,202 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "output_index.h"
+
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+#include "exceptions.h"
+
+namespace paste_alignments {
+
+// Output index helpers.
+//
+namespace {
+
+// Number of tab-separated columns of an index line.
+//
+constexpr int kNumIndexColumns{5};
+
+// Interprets `field` as non-negative integer of the column `name` of an index
+// line.
+//
+long ParseIndexNumber(std::string_view field, const char* name) {
+  long result{0l};
+  std::from_chars_result conversion_result{std::from_chars(
+      field.data(), field.data() + field.size(), result)};
+  if (field.empty() || conversion_result.ec != std::errc{}
+      || conversion_result.ptr != field.data() + field.size() || result < 0l) {
+    std::stringstream error_message;
+    error_message << "Invalid " << name << " in output index: '" << field
+                  << "'.";
+    throw exceptions::ParsingError(error_message.str());
+  }
+  return result;
+}
+
+} // namespace
+
+// OutputIndexEntry::FromString
+//
+OutputIndexEntry OutputIndexEntry::FromString(std::string_view line) {
+  std::vector<std::string_view> fields;
+  std::size_t begin{0};
+  while (true) {
+    std::size_t end{line.find('\t', begin)};
+    fields.push_back(line.substr(begin, end - begin));
+    if (end == std::string_view::npos) {break;}
+    begin = end + 1;
+  }
+  if (static_cast<int>(fields.size()) != kNumIndexColumns) {
+    std::stringstream error_message;
+    error_message << "Output index line has " << fields.size()
+                  << " columns instead of " << kNumIndexColumns << ": '"
+                  << line << "'.";
+    throw exceptions::ParsingError(error_message.str());
+  }
+  OutputIndexEntry result;
+  result.qseqid = std::string{fields.at(0)};
+  result.sseqid = std::string{fields.at(1)};
+  result.offset = ParseIndexNumber(fields.at(2), "offset");
+  result.size = ParseIndexNumber(fields.at(3), "size");
+  result.num_rows = ParseIndexNumber(fields.at(4), "number of rows");
+  return result;
+}
+
+// OutputIndexEntry::Write
+//
+void OutputIndexEntry::Write(std::ostream& os) const {
+  os << qseqid << '\t' << sseqid << '\t' << offset << '\t' << size << '\t'
+     << num_rows << '\n';
+}
+
+// OutputIndexEntry::operator==
+//
+bool OutputIndexEntry::operator==(const OutputIndexEntry& other) const {
+  return (qseqid == other.qseqid
+          && sseqid == other.sseqid
+          && offset == other.offset
+          && size == other.size
+          && num_rows == other.num_rows);
+}
+
+// OutputIndexEntry::DebugString
+//
+std::string OutputIndexEntry::DebugString() const {
+  std::stringstream ss;
+  ss << '('
+     << "qseqid=" << qseqid
+     << ", sseqid=" << sseqid
+     << ", offset=" << offset
+     << ", size=" << size
+     << ", num_rows=" << num_rows
+     << ')';
+  return ss.str();
+}
+
+// OutputIndexWriter::Add
+//
+void OutputIndexWriter::Add(std::string_view qseqid, std::string_view sseqid,
+                            long offset, long size, long num_rows) {
+  if (num_rows == 0l) {return;}
+  if (has_pending_ && pending_.qseqid == qseqid && pending_.sseqid == sseqid
+      && pending_.offset + pending_.size == offset) {
+    pending_.size += size;
+    pending_.num_rows += num_rows;
+    return;
+  }
+  if (has_pending_) {
+    pending_.Write(*os_);
+  }
+  pending_.qseqid = std::string{qseqid};
+  pending_.sseqid = std::string{sseqid};
+  pending_.offset = offset;
+  pending_.size = size;
+  pending_.num_rows = num_rows;
+  has_pending_ = true;
+}
+
+// OutputIndexWriter::Flush
+//
+void OutputIndexWriter::Flush() {
+  if (has_pending_) {
+    pending_.Write(*os_);
+    has_pending_ = false;
+  }
+  os_->flush();
+}
+
+// OutputIndexFilename
+//
+std::string OutputIndexFilename(const std::string& output_filename) {
+  return output_filename + ".idx";
+}
+
+// ReadOutputIndex
+//
+std::vector<OutputIndexEntry> ReadOutputIndex(std::istream& is) {
+  std::vector<OutputIndexEntry> result;
+  std::string line;
+  while (std::getline(is, line)) {
+    result.push_back(OutputIndexEntry::FromString(line));
+  }
+  return result;
+}
+
+// TruncateOutputIndex
+//
+void TruncateOutputIndex(const std::string& filename, long output_size) {
+  std::ifstream ifs{filename};
+  if (!ifs.is_open()) {
+    std::stringstream error_message;
+    error_message << "Unable to open output index file: " << filename;
+    throw exceptions::ReadError(error_message.str());
+  }
+  std::stringstream kept;
+  std::string line;
+  while (std::getline(ifs, line) && !ifs.eof()) {
+    OutputIndexEntry entry;
+    try {
+      entry = OutputIndexEntry::FromString(line);
+    } catch (const exceptions::ParsingError&) {
+      break;
+    }
+    if (entry.offset + entry.size > output_size) {break;}
+    entry.Write(kept);
+  }
+  if (ifs.bad()) {
+    std::stringstream error_message;
+    error_message << "Unable to read output index file: " << filename;
+    throw exceptions::ReadError(error_message.str());
+  }
+  ifs.close();
+  std::ofstream ofs{filename, std::ios_base::trunc};
+  ofs << kept.str();
+  ofs.close();
+  if (ofs.fail()) {
+    std::stringstream error_message;
+    error_message << "Unable to write output index file: " << filename;
+    throw exceptions::WriteError(error_message.str());
+  }
+}
+
+} // namespace paste_alignments
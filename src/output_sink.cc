@@ -0,0 +1,226 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "output_sink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "exceptions.h"
+
+namespace paste_alignments {
+
+// OutputSink helpers.
+//
+namespace {
+
+// Throws `exceptions::WriteError` describing the failure to write `filename`.
+//
+[[noreturn]] void ThrowWriteError(const std::string& action,
+                                  const std::string& filename) {
+  std::stringstream error_message;
+  error_message << "Unable to " << action << " output file: "
+                << (filename.empty() ? "<standard output>" : filename) << '.';
+  throw exceptions::WriteError(error_message.str());
+}
+
+} // namespace
+
+// OutputSink::Write
+//
+void OutputSink::Write(std::string_view data) {
+  DoWrite(data);
+  bytes_written_ += static_cast<long>(data.length());
+}
+
+// FileSink::FileSink
+//
+FileSink::FileSink(const std::string& filename, bool append) : os_{&std::cout} {
+  if (!filename.empty()) {
+    ofs_.open(filename, append ? std::ios_base::app : std::ios_base::out);
+    if (!ofs_.is_open()) {
+      ThrowWriteError("open", filename);
+    }
+    os_ = &ofs_;
+  }
+}
+
+// FileSink::Flush
+//
+void FileSink::Flush() {
+  if (!os_->flush()) {
+    throw exceptions::WriteError("Unable to flush output file.");
+  }
+}
+
+// FileSink::DoWrite
+//
+void FileSink::DoWrite(std::string_view data) {
+  if (!os_->write(data.data(), data.length())) {
+    throw exceptions::WriteError("Unable to write output file.");
+  }
+}
+
+// FdSink::FdSink
+//
+FdSink::FdSink(const std::string& filename, bool append, long buffer_size)
+    : fd_{STDOUT_FILENO}, owns_fd_{false}, buffer_size_{buffer_size} {
+  if (!filename.empty()) {
+    fd_ = ::open(filename.c_str(),
+                 O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0666);
+    if (fd_ == -1) {
+      ThrowWriteError("open", filename);
+    }
+    owns_fd_ = true;
+  }
+  buffer_.reserve(buffer_size_);
+}
+
+// FdSink::~FdSink
+//
+FdSink::~FdSink() {
+  try {
+    Flush();
+  } catch (const exceptions::WriteError&) {}
+  if (owns_fd_) {
+    ::close(fd_);
+  }
+}
+
+// FdSink::Flush
+//
+void FdSink::Flush() {
+  WriteFully(buffer_);
+  buffer_.clear();
+}
+
+// FdSink::DoWrite
+//
+void FdSink::DoWrite(std::string_view data) {
+  if (static_cast<long>(buffer_.length() + data.length()) > buffer_size_) {
+    Flush();
+    if (static_cast<long>(data.length()) >= buffer_size_) {
+      WriteFully(data);
+      return;
+    }
+  }
+  buffer_.append(data);
+}
+
+// FdSink::WriteFully
+//
+void FdSink::WriteFully(std::string_view data) {
+  while (!data.empty()) {
+    ssize_t written{::write(fd_, data.data(), data.length())};
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      std::stringstream error_message;
+      error_message << "Unable to write output file: " << std::strerror(errno)
+                    << '.';
+      throw exceptions::WriteError(error_message.str());
+    }
+    data.remove_prefix(written);
+  }
+}
+
+// MemorySink::Release
+//
+std::string MemorySink::Release() {
+  std::string result;
+  result.swap(data_);
+  return result;
+}
+
+// MemorySink::DoWrite
+//
+void MemorySink::DoWrite(std::string_view data) {
+  data_.append(data);
+}
+
+// GzipSink::GzipSink
+//
+GzipSink::GzipSink(const std::string& filename) {
+  file_ = (filename.empty() ? gzdopen(::dup(STDOUT_FILENO), "wb")
+                            : gzopen(filename.c_str(), "wb"));
+  if (file_ == nullptr) {
+    ThrowWriteError("open", filename);
+  }
+}
+
+// GzipSink::~GzipSink
+//
+GzipSink::~GzipSink() {
+  gzclose(file_);
+}
+
+// GzipSink::Flush
+//
+void GzipSink::Flush() {
+  if (gzflush(file_, Z_SYNC_FLUSH) != Z_OK) {
+    throw exceptions::WriteError("Unable to write compressed output file.");
+  }
+}
+
+// GzipSink::DoWrite
+//
+void GzipSink::DoWrite(std::string_view data) {
+  while (!data.empty()) {
+    unsigned length{static_cast<unsigned>(
+        std::min<std::string_view::size_type>(data.length(), 1u << 30))};
+    if (gzwrite(file_, data.data(), length) != static_cast<int>(length)) {
+      throw exceptions::WriteError("Unable to write compressed output file.");
+    }
+    data.remove_prefix(length);
+  }
+}
+
+// OpenOutputSink
+//
+std::unique_ptr<OutputSink> OpenOutputSink(std::string_view kind,
+                                           const std::string& filename,
+                                           bool append) {
+  if (kind == "file") {
+    return std::make_unique<FileSink>(filename, append);
+  } else if (kind == "fd") {
+    return std::make_unique<FdSink>(filename, append);
+  } else if (kind == "gzip" && !append) {
+    return std::make_unique<GzipSink>(filename);
+  } else if (kind == "null") {
+    return std::make_unique<NullSink>();
+  }
+  std::stringstream error_message;
+  if (kind == "gzip") {
+    error_message << "Output sink: 'gzip' cannot append to existing files.";
+  } else {
+    error_message << "Unknown output sink: '" << kind << "'.";
+  }
+  throw exceptions::ParsingError(error_message.str());
+}
+
+} // namespace paste_alignments
@@ -0,0 +1,153 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Converts binary output files of paste_alignments (see `--binary_output`)
+// into tab-separated tables with the default output columns.
+
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "arg_parse_convert.h"
+#include "paste_alignments.h"
+
+namespace {
+
+const char* kUsageMessage{
+    "\nusage: pa_dump [options] INPUT_FILE [OUTPUT_FILE]\n"};
+
+const char* kVersionMessage{
+    "\nPasteAlignments v1.0.0"
+    "\nCopyright (c) 2020 Jasper Braun"};
+
+// Initializes `ParameterMap` object for argument parsing.
+//
+arg_parse_convert::ParameterMap InitParameters() {
+  arg_parse_convert::ParameterMap parameter_map;
+  parameter_map(arg_parse_convert::Parameter<std::string>::Positional(
+                   arg_parse_convert::converters::StringIdentity,
+                   "input_file", 0)
+                .MinArgs(1).MaxArgs(1).Placeholder("INPUT_FILE")
+                .Description(
+                    "Output file of paste_alignments written with"
+                    " `--binary_output`."))
+
+               (arg_parse_convert::Parameter<std::string>::Positional(
+                    arg_parse_convert::converters::StringIdentity,
+                    "output_file", 1)
+                .MinArgs(0).MaxArgs(1).Placeholder("OUTPUT_FILE")
+                .Description(
+                    "Tab-delimited HSP table with the default output columns"
+                    " of paste_alignments. Written to standard output if"
+                    " omitted."))
+
+               (arg_parse_convert::Parameter<bool>::Flag(
+                    {"h", "help"})
+                .Description("Print this help message and exit."))
+
+               (arg_parse_convert::Parameter<bool>::Flag(
+                    {"version"})
+                .Description("Print the software's version and exit."));
+
+  return parameter_map;
+}
+
+} // namespace
+
+int main(int argc, const char** argv) {
+
+  try {
+    // Parse command line.
+    arg_parse_convert::ArgumentMap argument_map{InitParameters()};
+    std::vector<std::string> additional_arguments{
+        arg_parse_convert::ParseArgs(argc, argv, argument_map)};
+    if (!additional_arguments.empty()) {
+      std::stringstream error_message;
+      error_message << "Invalid argument: " << additional_arguments.at(0);
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          error_message.str());
+    }
+    argument_map.SetDefaultArguments();
+
+    // Take care of help/version flags.
+    if (argument_map.IsSet("help")) {
+      std::cout << arg_parse_convert::FormattedHelpString(
+                       argument_map.Parameters(), kUsageMessage,
+                       kVersionMessage)
+                << std::endl;
+      return 0;
+    }
+    if (argument_map.IsSet("version")) {
+      std::cout << kVersionMessage << std::endl;
+      return 0;
+    }
+    if (!argument_map.HasArgument("input_file")) {
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          "Missing argument for parameter: input_file.");
+    }
+
+    // Input and output files.
+    std::string input_filename{
+        argument_map.GetValue<std::string>("input_file")};
+    std::unique_ptr<std::ifstream> ifs{
+        new std::ifstream{input_filename, std::ios_base::binary}};
+    if (!ifs->is_open()) {
+      std::stringstream error_message;
+      error_message << "Unable to open input file: " << input_filename;
+      throw paste_alignments::exceptions::ReadError(error_message.str());
+    }
+    paste_alignments::BinaryReader reader{
+        paste_alignments::BinaryReader::FromIStream(std::move(ifs))};
+    std::ofstream ofs;
+    if (argument_map.HasArgument("output_file")) {
+      ofs.open(argument_map.GetValue<std::string>("output_file"));
+    }
+    std::ostream& os{ofs.is_open() ? static_cast<std::ostream&>(ofs)
+                                   : std::cout};
+
+    for (int i = 0; i < static_cast<int>(reader.Batches().size()); ++i) {
+      reader.WriteTsv(i, os);
+    }
+
+  // Argument parsing errors.
+  } catch (const arg_parse_convert::exceptions::BaseError& e) {
+    std::cerr << "Error while parsing arguments. Exception message: "
+              << e.what() << '\n' << kUsageMessage << std::endl;
+    return 1;
+
+  // Conversion errors.
+  } catch (const paste_alignments::exceptions::BaseException& e) {
+    std::cerr << "Error while converting binary output. Exception message: "
+              << e.what() << '\n' << kUsageMessage << std::endl;
+    return 1;
+
+  // Unexpected errors.
+  } catch (const std::exception& e) {
+    std::cerr << "Something went wrong. Exception message: " << e.what()
+              << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,205 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Prints the output of single queries from output files of paste_alignments
+// using the index written alongside them (see `--output_index`).
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "arg_parse_convert.h"
+#include "exceptions.h"
+#include "output_index.h"
+
+namespace {
+
+const char* kUsageMessage{
+    "\nusage: pa_lookup [options] OUTPUT_FILE QSEQID [SSEQID]\n"};
+
+const char* kVersionMessage{
+    "\nPasteAlignments v1.0.0"
+    "\nCopyright (c) 2020 Jasper Braun"};
+
+// Size of the chunks in which a batch's output is copied.
+//
+constexpr long kCopyChunkSize{1l << 16};
+
+// Initializes `ParameterMap` object for argument parsing.
+//
+arg_parse_convert::ParameterMap InitParameters() {
+  arg_parse_convert::ParameterMap parameter_map;
+  parameter_map(arg_parse_convert::Parameter<std::string>::Positional(
+                   arg_parse_convert::converters::StringIdentity,
+                   "output_file", 0)
+                .MinArgs(1).MaxArgs(1).Placeholder("OUTPUT_FILE")
+                .Description(
+                    "Output file of paste_alignments written with"
+                    " `--output_index`."))
+
+               (arg_parse_convert::Parameter<std::string>::Positional(
+                    arg_parse_convert::converters::StringIdentity,
+                    "qseqid", 1)
+                .MinArgs(1).MaxArgs(1).Placeholder("QSEQID")
+                .Description("Query sequence identifier to look up."))
+
+               (arg_parse_convert::Parameter<std::string>::Positional(
+                    arg_parse_convert::converters::StringIdentity,
+                    "sseqid", 2)
+                .MinArgs(0).MaxArgs(1).Placeholder("SSEQID")
+                .Description(
+                    "Subject sequence identifier to look up. All subjects of"
+                    " the query if omitted."))
+
+               (arg_parse_convert::Parameter<std::string>::Keyword(
+                    arg_parse_convert::converters::StringIdentity,
+                    {"i", "index", "index_file"})
+                .MinArgs(1).MaxArgs(1).Placeholder("INDEX_FILE")
+                .Description(
+                    "Index of the output file. The output file's name with"
+                    " suffix `.idx` if omitted."))
+
+               (arg_parse_convert::Parameter<bool>::Flag(
+                    {"h", "help"})
+                .Description("Print this help message and exit."))
+
+               (arg_parse_convert::Parameter<bool>::Flag(
+                    {"version"})
+                .Description("Print the software's version and exit."));
+
+  return parameter_map;
+}
+
+// Copies the `size` bytes of `is` beginning at `offset` into `os`.
+//
+void CopyRange(std::istream& is, long offset, long size, std::ostream& os) {
+  std::vector<char> buffer(static_cast<std::size_t>(
+      std::min(size, kCopyChunkSize)));
+  is.seekg(offset);
+  while (size > 0l && is) {
+    long chunk{std::min(size, kCopyChunkSize)};
+    is.read(buffer.data(), chunk);
+    os.write(buffer.data(), is.gcount());
+    size -= is.gcount();
+  }
+  if (size > 0l) {
+    throw paste_alignments::exceptions::ReadError(
+        "Output file is shorter than its index states.");
+  }
+}
+
+} // namespace
+
+int main(int argc, const char** argv) {
+
+  try {
+    // Parse command line.
+    arg_parse_convert::ArgumentMap argument_map{InitParameters()};
+    std::vector<std::string> additional_arguments{
+        arg_parse_convert::ParseArgs(argc, argv, argument_map)};
+    if (!additional_arguments.empty()) {
+      std::stringstream error_message;
+      error_message << "Invalid argument: " << additional_arguments.at(0);
+      throw arg_parse_convert::exceptions::ArgumentParsingError(
+          error_message.str());
+    }
+    argument_map.SetDefaultArguments();
+
+    // Take care of help/version flags.
+    if (argument_map.IsSet("help")) {
+      std::cout << arg_parse_convert::FormattedHelpString(
+                       argument_map.Parameters(), kUsageMessage,
+                       kVersionMessage)
+                << std::endl;
+      return 0;
+    }
+    if (argument_map.IsSet("version")) {
+      std::cout << kVersionMessage << std::endl;
+      return 0;
+    }
+    for (const char* name : {"output_file", "qseqid"}) {
+      if (!argument_map.HasArgument(name)) {
+        std::stringstream error_message;
+        error_message << "Missing argument for parameter: " << name << '.';
+        throw arg_parse_convert::exceptions::ArgumentParsingError(
+            error_message.str());
+      }
+    }
+
+    // Output and index files.
+    std::string output_filename{
+        argument_map.GetValue<std::string>("output_file")};
+    std::string index_filename{
+        argument_map.HasArgument("index_file")
+        ? argument_map.GetValue<std::string>("index_file")
+        : paste_alignments::OutputIndexFilename(output_filename)};
+    std::ifstream output_ifs{output_filename, std::ios_base::binary};
+    if (!output_ifs.is_open()) {
+      std::stringstream error_message;
+      error_message << "Unable to open output file: " << output_filename;
+      throw paste_alignments::exceptions::ReadError(error_message.str());
+    }
+    std::ifstream index_ifs{index_filename};
+    if (!index_ifs.is_open()) {
+      std::stringstream error_message;
+      error_message << "Unable to open index file: " << index_filename;
+      throw paste_alignments::exceptions::ReadError(error_message.str());
+    }
+
+    // Copy the output of each matching batch.
+    std::string qseqid{argument_map.GetValue<std::string>("qseqid")};
+    bool any_subject{!argument_map.HasArgument("sseqid")};
+    std::string sseqid;
+    if (!any_subject) {
+      sseqid = argument_map.GetValue<std::string>("sseqid");
+    }
+    for (const paste_alignments::OutputIndexEntry& entry
+         : paste_alignments::ReadOutputIndex(index_ifs)) {
+      if (entry.qseqid == qseqid && (any_subject || entry.sseqid == sseqid)) {
+        CopyRange(output_ifs, entry.offset, entry.size, std::cout);
+      }
+    }
+    std::cout.flush();
+
+  // Argument parsing errors.
+  } catch (const arg_parse_convert::exceptions::BaseError& e) {
+    std::cerr << "Error while parsing arguments. Exception message: "
+              << e.what() << '\n' << kUsageMessage << std::endl;
+    return 1;
+
+  // Lookup errors.
+  } catch (const paste_alignments::exceptions::BaseException& e) {
+    std::cerr << "Error while looking up output. Exception message: "
+              << e.what() << '\n' << kUsageMessage << std::endl;
+    return 1;
+
+  // Unexpected errors.
+  } catch (const std::exception& e) {
+    std::cerr << "Something went wrong. Exception message: " << e.what()
+              << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,363 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "packed_sequence.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <sstream>
+
+#include "exceptions.h"
+
+namespace paste_alignments {
+
+// PackedSequence helpers.
+//
+namespace {
+
+// Number of bases packed into each word.
+//
+constexpr int kBasesPerWord{32};
+
+// Characters of the base codes.
+//
+constexpr char kBases[4]{'A', 'C', 'G', 'T'};
+
+// Lookup tables for packing and unpacking.
+//
+struct CodeTables {
+  // Code of each character, or -1 if the character is not packed.
+  //
+  std::array<std::int8_t, 256> codes;
+
+  // Characters of the four bases coded by each byte.
+  //
+  std::array<std::array<char, 4>, 256> bytes;
+};
+
+CodeTables MakeCodeTables() {
+  CodeTables result;
+  result.codes.fill(-1);
+  for (int code = 0; code < 4; ++code) {
+    result.codes.at(static_cast<unsigned char>(kBases[code])) = code;
+  }
+  for (int byte = 0; byte < 256; ++byte) {
+    for (int i = 0; i < 4; ++i) {
+      result.bytes.at(byte).at(i) = kBases[(byte >> (2 * i)) & 3];
+    }
+  }
+  return result;
+}
+
+const CodeTables& GetCodeTables() {
+  static const CodeTables tables{MakeCodeTables()};
+  return tables;
+}
+
+// Returns mask of the lowest `count` bases of a word.
+//
+inline std::uint64_t BaseMask(int count) {
+  return (count >= kBasesPerWord ? ~std::uint64_t{0}
+                                 : (std::uint64_t{1} << (2 * count)) - 1);
+}
+
+} // namespace
+
+// PackedSequence::FromString
+//
+PackedSequence PackedSequence::FromString(std::string_view sequence) {
+  const CodeTables& tables{GetCodeTables()};
+  PackedSequence result;
+  result.words_.reserve((sequence.length() + kBasesPerWord - 1)
+                        / kBasesPerWord);
+  int length{static_cast<int>(sequence.length())};
+  for (int begin = 0; begin < length; begin += kBasesPerWord) {
+    int end{std::min(length, begin + kBasesPerWord)};
+    std::uint64_t word{0};
+    for (int i = begin; i < end; ++i) {
+      std::int8_t code{tables.codes[static_cast<unsigned char>(sequence[i])]};
+      if (code < 0) {
+        result.AddRun(i, 1, sequence[i]);
+      } else {
+        word |= static_cast<std::uint64_t>(code) << (2 * (i - begin));
+      }
+    }
+    result.words_.push_back(word);
+  }
+  result.length_ = length;
+  return result;
+}
+
+// PackedSequence::View
+//
+PackedSequence PackedSequence::View(std::string_view sequence) {
+  PackedSequence result;
+  result.view_ = (sequence.data() == nullptr ? std::string_view{""}
+                                             : sequence);
+  result.length_ = static_cast<int>(sequence.length());
+  return result;
+}
+
+// PackedSequence::operator=
+//
+PackedSequence& PackedSequence::operator=(const PackedSequence& other) {
+  if (this != &other) {
+    if (other.words_.size() > words_.capacity()) {
+      words_.reserve(std::max(other.words_.size(), 2 * words_.capacity()));
+    }
+    words_.assign(other.words_.begin(), other.words_.end());
+    runs_ = other.runs_;
+    view_ = other.view_;
+    length_ = other.length_;
+  }
+  return *this;
+}
+
+// PackedSequence::At
+//
+char PackedSequence::At(int pos) const {
+  if (pos < 0 || pos >= length_) {
+    std::stringstream error_message;
+    error_message << "Position " << pos << " is outside of sequence of length "
+                  << length_ << '.';
+    throw exceptions::OutOfRange(error_message.str());
+  }
+  if (IsView()) {
+    return view_[pos];
+  }
+  std::vector<Run>::const_iterator run{std::upper_bound(
+      runs_.begin(), runs_.end(), pos,
+      [](int p, const Run& r) {return p < r.begin;})};
+  if (run != runs_.begin() && pos < (run - 1)->begin + (run - 1)->length) {
+    return (run - 1)->character;
+  }
+  return kBases[(words_[pos / kBasesPerWord] >> (2 * (pos % kBasesPerWord)))
+                & 3];
+}
+
+// PackedSequence::ToString
+//
+std::string PackedSequence::ToString() const {
+  std::string result;
+  AppendTo(result);
+  return result;
+}
+
+// PackedSequence::AppendTo
+//
+void PackedSequence::AppendTo(std::string& target) const {
+  if (IsView()) {
+    target.append(view_);
+    return;
+  }
+  const CodeTables& tables{GetCodeTables()};
+  std::size_t offset{target.size()};
+  target.resize(offset + length_);
+  char* out{&target[offset]};
+
+  // Unpack four bases per byte, then overwrite the runs.
+  int num_full_bytes{length_ / 4};
+  for (int b = 0; b < num_full_bytes; ++b) {
+    unsigned char byte{static_cast<unsigned char>(
+        words_[b / 8] >> (8 * (b % 8)))};
+    std::memcpy(out + 4 * b, tables.bytes[byte].data(), 4);
+  }
+  for (int i = 4 * num_full_bytes; i < length_; ++i) {
+    out[i] = kBases[(words_[i / kBasesPerWord] >> (2 * (i % kBasesPerWord)))
+                    & 3];
+  }
+  for (const Run& run : runs_) {
+    std::fill(out + run.begin, out + run.begin + run.length, run.character);
+  }
+}
+
+// PackedSequence::Reserve
+//
+void PackedSequence::Reserve(int length) {
+  if (IsView()) {return;}
+  std::size_t num_words{static_cast<std::size_t>(
+      (length + kBasesPerWord - 1) / kBasesPerWord)};
+  if (num_words > words_.capacity()) {
+    words_.reserve(std::max(num_words, 2 * words_.capacity()));
+  }
+}
+
+// PackedSequence::Truncate
+//
+void PackedSequence::Truncate(int length) {
+  if (length < 0 || length > length_) {
+    std::stringstream error_message;
+    error_message << "Unable to truncate sequence of length " << length_
+                  << " to length " << length << '.';
+    throw exceptions::OutOfRange(error_message.str());
+  }
+  if (IsView()) {
+    view_ = view_.substr(0, length);
+    length_ = length;
+    return;
+  }
+  words_.resize((length + kBasesPerWord - 1) / kBasesPerWord);
+  if (length % kBasesPerWord != 0) {
+    words_.back() &= BaseMask(length % kBasesPerWord);
+  }
+  while (!runs_.empty() && runs_.back().begin >= length) {
+    runs_.pop_back();
+  }
+  if (!runs_.empty()) {
+    runs_.back().length = std::min(runs_.back().length,
+                                   length - runs_.back().begin);
+  }
+  length_ = length;
+}
+
+// PackedSequence::AppendRun
+//
+void PackedSequence::AppendRun(char character, int count) {
+  if (count < 0) {
+    std::stringstream error_message;
+    error_message << "Unable to append " << count << " characters.";
+    throw exceptions::OutOfRange(error_message.str());
+  }
+  if (count == 0) {return;}
+  Materialize();
+  std::int8_t code{
+      GetCodeTables().codes[static_cast<unsigned char>(character)]};
+  int begin{length_};
+  std::uint64_t codes{0};
+  if (code > 0) {
+    for (int i = 0; i < kBasesPerWord; ++i) {
+      codes |= static_cast<std::uint64_t>(code) << (2 * i);
+    }
+  }
+  for (int done = 0; done < count; done += kBasesPerWord) {
+    int num{std::min(kBasesPerWord, count - done)};
+    PutCodes(codes & BaseMask(num), num);
+  }
+  if (code < 0) {
+    AddRun(begin, count, character);
+  }
+}
+
+// PackedSequence::Append
+//
+void PackedSequence::Append(const PackedSequence& other, int begin,
+                            int length) {
+  if (begin < 0 || length < 0 || begin + length > other.length_) {
+    std::stringstream error_message;
+    error_message << "Unable to append " << length << " characters starting at"
+                  << " position " << begin << " of sequence of length "
+                  << other.length_ << '.';
+    throw exceptions::OutOfRange(error_message.str());
+  }
+  if (length == 0) {return;}
+  Materialize();
+  if (other.IsView()) {
+    Append(FromString(other.view_.substr(begin, length)), 0, length);
+    return;
+  }
+  int offset{length_ - begin};
+  Reserve(length_ + length);
+  for (int done = 0; done < length; done += kBasesPerWord) {
+    int num{std::min(kBasesPerWord, length - done)};
+    PutCodes(other.GetCodes(begin + done, num), num);
+  }
+  std::vector<Run>::const_iterator run{std::upper_bound(
+      other.runs_.begin(), other.runs_.end(), begin,
+      [](int p, const Run& r) {return p < r.begin;})};
+  if (run != other.runs_.begin()) {
+    --run;
+  }
+  for (; run != other.runs_.end() && run->begin < begin + length; ++run) {
+    int run_begin{std::max(run->begin, begin)};
+    int run_end{std::min(run->begin + run->length, begin + length)};
+    if (run_begin < run_end) {
+      AddRun(run_begin + offset, run_end - run_begin, run->character);
+    }
+  }
+}
+
+// PackedSequence::MemoryUsage
+//
+long PackedSequence::MemoryUsage() const {
+  if (IsView()) {
+    return static_cast<long>(view_.size());
+  }
+  return static_cast<long>(words_.capacity() * sizeof(std::uint64_t)
+                           + runs_.capacity() * sizeof(Run));
+}
+
+// PackedSequence::operator==
+//
+bool PackedSequence::operator==(const PackedSequence& other) const {
+  if (IsView() || other.IsView()) {
+    return (length_ == other.length_ && ToString() == other.ToString());
+  }
+  return (length_ == other.length_ && words_ == other.words_
+          && runs_ == other.runs_);
+}
+
+// PackedSequence::GetCodes
+//
+std::uint64_t PackedSequence::GetCodes(int pos, int count) const {
+  int word{pos / kBasesPerWord};
+  int shift{2 * (pos % kBasesPerWord)};
+  std::uint64_t result{words_[word] >> shift};
+  if (shift > 0 && word + 1 < static_cast<int>(words_.size())) {
+    result |= words_[word + 1] << (64 - shift);
+  }
+  return result & BaseMask(count);
+}
+
+// PackedSequence::PutCodes
+//
+void PackedSequence::PutCodes(std::uint64_t codes, int count) {
+  int shift{2 * (length_ % kBasesPerWord)};
+  if (shift == 0) {
+    words_.push_back(codes);
+  } else {
+    words_.back() |= codes << shift;
+    if (2 * count > 64 - shift) {
+      words_.push_back(codes >> (64 - shift));
+    }
+  }
+  length_ += count;
+}
+
+// PackedSequence::Materialize
+//
+void PackedSequence::Materialize() {
+  if (IsView()) {
+    *this = FromString(view_);
+  }
+}
+
+// PackedSequence::AddRun
+//
+void PackedSequence::AddRun(int begin, int length, char character) {
+  if (!runs_.empty() && runs_.back().character == character
+      && runs_.back().begin + runs_.back().length == begin) {
+    runs_.back().length += length;
+  } else {
+    runs_.push_back(Run{begin, length, character});
+  }
+}
+
+} // namespace paste_alignments
@@ -20,49 +20,711 @@
 
 #include "paste_output.h"
 
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <type_traits>
+
+#include "exceptions.h"
+
 namespace paste_alignments {
 
+// OutputFormat helpers.
+//
+namespace {
+
+// Appends `value` as `std::ostream::operator<<` would write it with default
+// formatting.
+//
+template <typename T>
+void AppendNumber(T value, std::string& line) {
+  char digits[32];
+  std::to_chars_result result;
+  if constexpr (std::is_floating_point_v<T>) {
+    result = std::to_chars(digits, digits + sizeof(digits), value,
+                           std::chars_format::general, 6);
+  } else {
+    result = std::to_chars(digits, digits + sizeof(digits), value);
+  }
+  line.append(digits, result.ptr);
+}
+
+void WriteQseqid(const AlignmentBatch& batch, const Alignment&,
+                 std::string& line) {
+  line.append(batch.Qseqid());
+}
+
+void WriteSseqid(const AlignmentBatch& batch, const Alignment&,
+                 std::string& line) {
+  line.append(batch.Sseqid());
+}
+
+void WriteQstart(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.Qstart(), line);
+}
+
+void WriteQend(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.Qend(), line);
+}
+
+// Subject coordinates are written in their input order, so that the subject
+// end precedes the subject start on the minus strand.
+//
+void WriteSstart(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.PlusStrand() ? a.Sstart() : a.Send(), line);
+}
+
+void WriteSend(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.PlusStrand() ? a.Send() : a.Sstart(), line);
+}
+
+void WriteNident(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.Nident(), line);
+}
+
+void WriteMismatch(const AlignmentBatch&, const Alignment& a,
+                   std::string& line) {
+  AppendNumber(a.Mismatch(), line);
+}
+
+void WriteGapopen(const AlignmentBatch&, const Alignment& a,
+                  std::string& line) {
+  AppendNumber(a.Gapopen(), line);
+}
+
+void WriteGaps(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.Gaps(), line);
+}
+
+void WriteQlen(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.Qlen(), line);
+}
+
+void WriteSlen(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.Slen(), line);
+}
+
+void WriteLength(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.Length(), line);
+}
+
+void WriteQseq(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  a.PackedQseq().AppendTo(line);
+}
+
+void WriteSseq(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  a.PackedSseq().AppendTo(line);
+}
+
+void WritePident(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.Pident(), line);
+}
+
+void WriteScore(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.RawScore(), line);
+}
+
+void WriteBitscore(const AlignmentBatch&, const Alignment& a,
+                   std::string& line) {
+  AppendNumber(a.Bitscore(), line);
+}
+
+void WriteEvalue(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.Evalue(), line);
+}
+
+void WriteNmatches(const AlignmentBatch&, const Alignment& a,
+                   std::string& line) {
+  AppendNumber(a.Nmatches(), line);
+}
+
+void WriteRows(const AlignmentBatch&, const Alignment& a, std::string& line) {
+  AppendNumber(a.PastedIdentifiers().at(0), line);
+  for (int i = 1; i < static_cast<int>(a.PastedIdentifiers().size()); ++i) {
+    line.push_back(',');
+    AppendNumber(a.PastedIdentifiers().at(i), line);
+  }
+}
+
+void WriteCompactRows(const AlignmentBatch&, const Alignment& a,
+                      std::string& line) {
+  AppendRowRanges(a.PastedIdentifiers(), line);
+}
+
+struct Column {
+  std::string_view name;
+  void (*writer)(const AlignmentBatch&, const Alignment&, std::string&);
+};
+
+// All columns in default order. The input columns qstart through sseq are
+// those referred to by `Alignment::RawFields`.
+//
+constexpr std::array<Column, 21> kColumns{{
+    {"qseqid", WriteQseqid}, {"sseqid", WriteSseqid},
+    {"qstart", WriteQstart}, {"qend", WriteQend}, {"sstart", WriteSstart},
+    {"send", WriteSend}, {"nident", WriteNident}, {"mismatch", WriteMismatch},
+    {"gapopen", WriteGapopen}, {"gaps", WriteGaps}, {"qlen", WriteQlen},
+    {"slen", WriteSlen}, {"length", WriteLength}, {"qseq", WriteQseq},
+    {"sseq", WriteSseq}, {"pident", WritePident}, {"score", WriteScore},
+    {"bitscore", WriteBitscore}, {"evalue", WriteEvalue},
+    {"nmatches", WriteNmatches}, {"rows", WriteRows}}};
+constexpr int kFirstInputColumn{2};
+
+// Number of bytes of output lines collected before they are passed to a sink.
+//
+constexpr long kWriteChunkSize{1l << 20};
+constexpr int kLastBlindInputColumn{12};
+constexpr int kLastInputColumn{14};
+constexpr int kRowsColumn{20};
+
+// Indicates whether the column at `pos` holds qseq or sseq.
+//
+bool IsSequenceColumn(int pos) {
+  return (pos == kLastBlindInputColumn + 1 || pos == kLastBlindInputColumn + 2);
+}
+
+// Writes the input columns, as read if possible.
+//
+template <int kLast>
+void WriteInputColumns(const AlignmentBatch& batch, const Alignment& a,
+                       std::string& line) {
+  if (!a.RawFields().empty()) {
+    line.append(a.RawFields());
+    return;
+  }
+  for (int i = kFirstInputColumn; i <= kLast; ++i) {
+    if (i > kFirstInputColumn) {
+      line.push_back('\t');
+    }
+    kColumns.at(i).writer(batch, a, line);
+  }
+}
+
+} // namespace
+
+// BinaryWriter and BinaryReader helpers.
+//
+namespace {
+
+constexpr std::string_view kBinaryMagic{"PASTEBC1"};
+constexpr std::uint32_t kByteOrderMark{0x01020304u};
+constexpr std::uint32_t kSequencesFlag{1u};
+constexpr long kHeaderSize{16l};
+constexpr long kIndexEntrySize{48l};
+constexpr long kTrailerSize{40l};
+
+template <typename T>
+void AppendValue(T value, std::string& buffer) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Zero-pads `buffer` to a multiple of 8 bytes.
+//
+void PadBuffer(std::string& buffer) {
+  buffer.append((8 - buffer.length() % 8) % 8, '\0');
+}
+
+// Appends one value of type `T` per alignment, as returned by `get`.
+//
+template <typename T, typename Getter>
+void AppendColumn(const std::vector<const Alignment*>& alignments, Getter get,
+                  std::string& buffer) {
+  for (const Alignment* a : alignments) {
+    AppendValue(static_cast<T>(get(*a)), buffer);
+  }
+  PadBuffer(buffer);
+}
+
+// Appends a variable-length column as offsets followed by values.
+//
+void AppendRowsColumn(const std::vector<const Alignment*>& alignments,
+                      std::string& buffer) {
+  std::uint32_t offset{0};
+  AppendValue(offset, buffer);
+  for (const Alignment* a : alignments) {
+    offset += static_cast<std::uint32_t>(a->PastedIdentifiers().size());
+    AppendValue(offset, buffer);
+  }
+  PadBuffer(buffer);
+  for (const Alignment* a : alignments) {
+    for (int id : a->PastedIdentifiers()) {
+      AppendValue(static_cast<std::int32_t>(id), buffer);
+    }
+  }
+  PadBuffer(buffer);
+}
+
+void AppendSequenceColumn(const std::vector<const Alignment*>& alignments,
+                          const PackedSequence& (Alignment::*get)() const,
+                          std::string& buffer) {
+  std::uint32_t offset{0};
+  AppendValue(offset, buffer);
+  for (const Alignment* a : alignments) {
+    offset += static_cast<std::uint32_t>((a->*get)().Length());
+    AppendValue(offset, buffer);
+  }
+  PadBuffer(buffer);
+  for (const Alignment* a : alignments) {
+    (a->*get)().AppendTo(buffer);
+  }
+  PadBuffer(buffer);
+}
+
+// Reads a block's arrays in the order they were appended.
+//
+class BlockCursor {
+ public:
+  BlockCursor(std::string_view block, long num_rows)
+      : block_{block}, num_rows_{num_rows} {}
+
+  // Returns the next array of `length` values of type `T`.
+  //
+  template <typename T>
+  const char* Next(long length) {
+    long size{length * static_cast<long>(sizeof(T))};
+    if (pos_ + size > static_cast<long>(block_.length())) {
+      throw exceptions::ReadError("Binary output block is truncated.");
+    }
+    const char* result{block_.data() + pos_};
+    pos_ += size + (8 - size % 8) % 8;
+    return result;
+  }
+
+  // Returns the next array of one value of type `T` per alignment.
+  //
+  template <typename T>
+  const char* Next() {return Next<T>(num_rows_);}
+
+ private:
+  std::string_view block_;
+  long num_rows_;
+  long pos_{0};
+};
+
+template <typename T>
+T ValueAt(const char* array, long i) {
+  T result;
+  std::memcpy(&result, array + i * static_cast<long>(sizeof(T)), sizeof(T));
+  return result;
+}
+
+template <typename T>
+T ReadValue(std::istream& is) {
+  T result;
+  is.read(reinterpret_cast<char*>(&result), sizeof(T));
+  return result;
+}
+
+} // namespace
+
+// OutputFormat::FromString
+//
+OutputFormat OutputFormat::FromString(std::string_view columns,
+                                      bool blind_mode, bool compact_rows) {
+  // Column positions in `kColumns`.
+  std::vector<int> positions;
+  if (columns.empty()) {
+    for (int pos = 0; pos < static_cast<int>(kColumns.size()); ++pos) {
+      if (!blind_mode || !IsSequenceColumn(pos)) {
+        positions.push_back(pos);
+      }
+    }
+  } else {
+    std::string_view::size_type begin{0};
+    while (begin <= columns.length()) {
+      std::string_view::size_type end{columns.find(',', begin)};
+      if (end == std::string_view::npos) {
+        end = columns.length();
+      }
+      std::string_view name{columns.substr(begin, end - begin)};
+      int pos{0};
+      while (pos < static_cast<int>(kColumns.size())
+             && kColumns.at(pos).name != name) {
+        ++pos;
+      }
+      if (pos == static_cast<int>(kColumns.size())) {
+        std::stringstream error_message;
+        error_message << "Unknown output column: '" << name << "'.";
+        throw exceptions::ParsingError(error_message.str());
+      } else if (blind_mode && IsSequenceColumn(pos)) {
+        std::stringstream error_message;
+        error_message << "Output column: '" << name << "' is not available in"
+                      << " blind mode.";
+        throw exceptions::ParsingError(error_message.str());
+      }
+      positions.push_back(pos);
+      begin = end + 1;
+    }
+  }
+
+  // A run of all input columns in input order is written by one writer.
+  OutputFormat result;
+  int num_input_columns{(blind_mode ? kLastBlindInputColumn : kLastInputColumn)
+                        - kFirstInputColumn + 1};
+  for (int i = 0; i < static_cast<int>(positions.size()); ++i) {
+    bool input_run{i + num_input_columns
+                   <= static_cast<int>(positions.size())};
+    for (int j = 0; input_run && j < num_input_columns; ++j) {
+      input_run = (positions.at(i + j) == kFirstInputColumn + j);
+    }
+    if (input_run) {
+      result.writers_.push_back(
+          blind_mode ? WriteInputColumns<kLastBlindInputColumn>
+                     : WriteInputColumns<kLastInputColumn>);
+      i += num_input_columns - 1;
+    } else if (compact_rows && positions.at(i) == kRowsColumn) {
+      result.writers_.push_back(WriteCompactRows);
+    } else {
+      result.writers_.push_back(kColumns.at(positions.at(i)).writer);
+    }
+    if (positions.at(i) == kRowsColumn) {
+      result.rows_column_ = i;
+    }
+  }
+  result.num_columns_ = static_cast<int>(positions.size());
+  return result;
+}
+
+// OutputFormat::Write
+//
+void OutputFormat::Write(const AlignmentBatch& batch,
+                         const Alignment& alignment, std::string& line) const {
+  for (int i = 0; i < static_cast<int>(writers_.size()); ++i) {
+    if (i > 0) {
+      line.push_back('\t');
+    }
+    writers_.at(i)(batch, alignment, line);
+  }
+  line.push_back('\n');
+}
+
+// AppendRowRanges
+//
+void AppendRowRanges(const std::vector<int>& ids, std::string& result) {
+  int num_ids{static_cast<int>(ids.size())};
+  int begin{0};
+  while (begin < num_ids) {
+    if (begin > 0) {
+      result.push_back(',');
+    }
+    AppendNumber(ids.at(begin), result);
+    int end{begin + 1};
+    if (end < num_ids && (ids.at(end) == ids.at(begin) + 1
+                          || ids.at(end) == ids.at(begin) - 1)) {
+      int step{ids.at(end) - ids.at(begin)};
+      while (end + 1 < num_ids && ids.at(end + 1) == ids.at(end) + step) {
+        ++end;
+      }
+      result.push_back('-');
+      AppendNumber(ids.at(end), result);
+      ++end;
+    }
+    begin = end;
+  }
+}
+
+// ExpandRowRanges
+//
+std::vector<long> ExpandRowRanges(std::string_view rows) {
+  std::vector<long> result;
+  const char* pos{rows.data()};
+  const char* end{rows.data() + rows.length()};
+  bool range{false};
+  while (true) {
+    long id;
+    std::from_chars_result conversion{std::from_chars(pos, end, id)};
+    if (conversion.ec != std::errc() || id < 0
+        || (conversion.ptr != end && *conversion.ptr != ','
+            && (range || *conversion.ptr != '-'))) {
+      std::stringstream error_message;
+      error_message << "Unable to convert row identifiers: '" << rows << "'.";
+      throw exceptions::ParsingError(error_message.str());
+    }
+    if (range) {
+      long step{id < result.back() ? -1l : 1l};
+      for (long i = result.back() + step; i != id + step; i += step) {
+        result.push_back(i);
+      }
+    } else {
+      result.push_back(id);
+    }
+    if (conversion.ptr == end) {
+      break;
+    }
+    range = (*conversion.ptr == '-');
+    pos = conversion.ptr + 1;
+  }
+  return result;
+}
+
+// WriteBatch
+//
+long WriteBatch(const AlignmentBatch& batch, OutputSink& sink,
+                const OutputFormat& format) {
+  if (batch.Size() == 0) {return 0l;}
+  std::string lines;
+  long num_rows{0l};
+  for (const Alignment& a : batch.Alignments()) {
+    if (a.IncludeInOutput()) {
+      format.Write(batch, a, lines);
+      ++num_rows;
+      if (static_cast<long>(lines.length()) >= kWriteChunkSize) {
+        sink.Write(lines);
+        lines.clear();
+      }
+    }
+  }
+  if (!lines.empty()) {
+    sink.Write(lines);
+  }
+  return num_rows;
+}
+
 // WriteBatch
 //
-void WriteBatch(AlignmentBatch batch, std::ostream& os,
+long WriteBatch(const AlignmentBatch& batch, OutputSink& sink,
                 const PasteParameters& paste_parameters) {
-  if (batch.Size() == 0) {return;}
+  return WriteBatch(batch, sink,
+             OutputFormat::FromString(paste_parameters.output_columns,
+                                      paste_parameters.blind_mode,
+                                      paste_parameters.compact_rows));
+}
+
+// BinaryWriter::BinaryWriter
+//
+BinaryWriter::BinaryWriter(OutputSink& sink, bool write_sequences)
+    : sink_{&sink}, write_sequences_{write_sequences} {
+  std::string header{kBinaryMagic};
+  AppendValue(kByteOrderMark, header);
+  AppendValue(write_sequences ? kSequencesFlag : 0u, header);
+  sink_->Write(header);
+  offset_ = kHeaderSize;
+}
+
+// BinaryWriter::WriteBatch
+//
+void BinaryWriter::WriteBatch(const AlignmentBatch& batch) {
+  std::vector<const Alignment*> alignments;
   for (const Alignment& a : batch.Alignments()) {
     if (a.IncludeInOutput()) {
-      os << batch.Qseqid()
-         << '\t' << batch.Sseqid()
-         << '\t' << a.Qstart()
-         << '\t' << a.Qend();
-      if (a.PlusStrand()) {
-        os << '\t' << a.Sstart()
-           << '\t' << a.Send();
-      } else {
-        os << '\t' << a.Send()
-           << '\t' << a.Sstart();
+      alignments.push_back(&a);
+    }
+  }
+  if (alignments.empty()) {return;}
+  block_.clear();
+  AppendColumn<std::int32_t>(alignments, std::mem_fn(&Alignment::Qstart),
+                             block_);
+  AppendColumn<std::int32_t>(alignments, std::mem_fn(&Alignment::Qend),
+                             block_);
+  AppendColumn<std::int32_t>(alignments, [](const Alignment& a) {
+                               return a.PlusStrand() ? a.Sstart() : a.Send();
+                             }, block_);
+  AppendColumn<std::int32_t>(alignments, [](const Alignment& a) {
+                               return a.PlusStrand() ? a.Send() : a.Sstart();
+                             }, block_);
+  for (auto get : {&Alignment::Nident, &Alignment::Mismatch,
+                   &Alignment::Gapopen, &Alignment::Gaps, &Alignment::Qlen,
+                   &Alignment::Slen, &Alignment::Length}) {
+    AppendColumn<std::int32_t>(alignments, std::mem_fn(get), block_);
+  }
+  for (auto get : {&Alignment::Pident, &Alignment::RawScore,
+                   &Alignment::Bitscore}) {
+    AppendColumn<float>(alignments, std::mem_fn(get), block_);
+  }
+  AppendColumn<double>(alignments, std::mem_fn(&Alignment::Evalue), block_);
+  AppendColumn<std::int32_t>(alignments, std::mem_fn(&Alignment::Nmatches),
+                             block_);
+  AppendRowsColumn(alignments, block_);
+  if (write_sequences_) {
+    AppendSequenceColumn(alignments, &Alignment::PackedQseq, block_);
+    AppendSequenceColumn(alignments, &Alignment::PackedSseq, block_);
+  }
+  sink_->Write(block_);
+
+  BinaryBatchEntry entry;
+  entry.offset = offset_;
+  entry.size = static_cast<long>(block_.length());
+  entry.num_rows = static_cast<long>(alignments.size());
+  entry.qseqid = batch.Qseqid();
+  entry.sseqid = batch.Sseqid();
+  StringOffset(entry.qseqid);
+  StringOffset(entry.sseqid);
+  index_.push_back(std::move(entry));
+  offset_ += static_cast<long>(block_.length());
+}
+
+// BinaryWriter::Finish
+//
+void BinaryWriter::Finish() {
+  long strings_offset{offset_};
+  block_ = strings_;
+  PadBuffer(block_);
+  long index_offset{strings_offset + static_cast<long>(block_.length())};
+  for (const BinaryBatchEntry& entry : index_) {
+    AppendValue(static_cast<std::uint64_t>(entry.offset), block_);
+    AppendValue(static_cast<std::uint64_t>(entry.size), block_);
+    AppendValue(static_cast<std::uint64_t>(entry.num_rows), block_);
+    AppendValue(static_cast<std::uint64_t>(StringOffset(entry.qseqid)),
+                block_);
+    AppendValue(static_cast<std::uint64_t>(StringOffset(entry.sseqid)),
+                block_);
+    AppendValue(static_cast<std::uint32_t>(entry.qseqid.length()), block_);
+    AppendValue(static_cast<std::uint32_t>(entry.sseqid.length()), block_);
+  }
+  AppendValue(static_cast<std::uint64_t>(strings_offset), block_);
+  AppendValue(static_cast<std::uint64_t>(strings_.length()), block_);
+  AppendValue(static_cast<std::uint64_t>(index_offset), block_);
+  AppendValue(static_cast<std::uint64_t>(index_.size()), block_);
+  block_.append(kBinaryMagic);
+  sink_->Write(block_);
+  offset_ += static_cast<long>(block_.length());
+  sink_->Flush();
+}
+
+// BinaryWriter::StringOffset
+//
+long BinaryWriter::StringOffset(const std::string& id) {
+  auto [it, inserted] = string_offsets_.emplace(
+      id, static_cast<long>(strings_.length()));
+  if (inserted) {
+    strings_.append(id);
+  }
+  return it->second;
+}
+
+// BinaryReader::FromIStream
+//
+BinaryReader BinaryReader::FromIStream(std::unique_ptr<std::istream> is) {
+  if (is == nullptr) {
+    throw exceptions::ReadError("Binary output stream is null.");
+  }
+  BinaryReader result;
+  std::string magic(kBinaryMagic.length(), '\0');
+  is->read(magic.data(), magic.length());
+  std::uint32_t byte_order{ReadValue<std::uint32_t>(*is)};
+  std::uint32_t flags{ReadValue<std::uint32_t>(*is)};
+  if (!*is || magic != kBinaryMagic) {
+    throw exceptions::ReadError("Not a binary output file.");
+  } else if (byte_order != kByteOrderMark) {
+    throw exceptions::ReadError(
+        "Binary output file was written in a different byte order.");
+  }
+  result.has_sequences_ = ((flags & kSequencesFlag) != 0u);
+
+  is->seekg(-kTrailerSize, std::ios_base::end);
+  long strings_offset{static_cast<long>(ReadValue<std::uint64_t>(*is))};
+  long strings_size{static_cast<long>(ReadValue<std::uint64_t>(*is))};
+  long index_offset{static_cast<long>(ReadValue<std::uint64_t>(*is))};
+  long num_batches{static_cast<long>(ReadValue<std::uint64_t>(*is))};
+  is->read(magic.data(), magic.length());
+  if (!*is || magic != kBinaryMagic) {
+    throw exceptions::ReadError("Binary output file is incomplete.");
+  }
+
+  std::string strings(strings_size, '\0');
+  is->seekg(strings_offset);
+  is->read(strings.data(), strings_size);
+  std::string index(num_batches * kIndexEntrySize, '\0');
+  is->seekg(index_offset);
+  is->read(index.data(), index.length());
+  if (!*is) {
+    throw exceptions::ReadError("Unable to read binary output index.");
+  }
+  for (long i = 0; i < num_batches; ++i) {
+    const char* entry_data{index.data() + i * kIndexEntrySize};
+    std::uint64_t qseqid_offset{ValueAt<std::uint64_t>(entry_data, 3)};
+    std::uint64_t sseqid_offset{ValueAt<std::uint64_t>(entry_data, 4)};
+    std::uint32_t qseqid_length{ValueAt<std::uint32_t>(entry_data, 10)};
+    std::uint32_t sseqid_length{ValueAt<std::uint32_t>(entry_data, 11)};
+    if (qseqid_offset + qseqid_length > strings.length()
+        || sseqid_offset + sseqid_length > strings.length()) {
+      throw exceptions::ReadError("Binary output index is corrupted.");
+    }
+    BinaryBatchEntry entry;
+    entry.offset = static_cast<long>(ValueAt<std::uint64_t>(entry_data, 0));
+    entry.size = static_cast<long>(ValueAt<std::uint64_t>(entry_data, 1));
+    entry.num_rows = static_cast<long>(ValueAt<std::uint64_t>(entry_data, 2));
+    entry.qseqid = strings.substr(qseqid_offset, qseqid_length);
+    entry.sseqid = strings.substr(sseqid_offset, sseqid_length);
+    result.index_.push_back(std::move(entry));
+  }
+  result.is_ = std::move(is);
+  return result;
+}
+
+// BinaryReader::WriteTsv
+//
+void BinaryReader::WriteTsv(int i, std::ostream& os) {
+  if (i < 0 || i >= static_cast<int>(index_.size())) {
+    std::stringstream error_message;
+    error_message << "Block index out of range: " << i << '.';
+    throw exceptions::OutOfRange(error_message.str());
+  }
+  const BinaryBatchEntry& entry{index_.at(i)};
+  block_.resize(entry.size);
+  is_->clear();
+  is_->seekg(entry.offset);
+  is_->read(block_.data(), entry.size);
+  if (!*is_) {
+    throw exceptions::ReadError("Unable to read binary output block.");
+  }
+
+  long n{entry.num_rows};
+  BlockCursor cursor{block_, n};
+  std::array<const char*, 11> integers;
+  for (const char*& column : integers) {
+    column = cursor.Next<std::int32_t>();
+  }
+  std::array<const char*, 3> floats;
+  for (const char*& column : floats) {
+    column = cursor.Next<float>();
+  }
+  const char* evalues{cursor.Next<double>()};
+  const char* nmatches{cursor.Next<std::int32_t>()};
+  const char* rows_offsets{cursor.Next<std::uint32_t>(n + 1)};
+  const char* rows{cursor.Next<std::int32_t>(
+      ValueAt<std::uint32_t>(rows_offsets, n))};
+  const char* qseq_offsets{nullptr};
+  const char* qseqs{nullptr};
+  const char* sseq_offsets{nullptr};
+  const char* sseqs{nullptr};
+  if (has_sequences_) {
+    qseq_offsets = cursor.Next<std::uint32_t>(n + 1);
+    qseqs = cursor.Next<char>(ValueAt<std::uint32_t>(qseq_offsets, n));
+    sseq_offsets = cursor.Next<std::uint32_t>(n + 1);
+    sseqs = cursor.Next<char>(ValueAt<std::uint32_t>(sseq_offsets, n));
+  }
+
+  for (long row = 0; row < n; ++row) {
+    os << entry.qseqid << '\t' << entry.sseqid;
+    for (const char* column : integers) {
+      os << '\t' << ValueAt<std::int32_t>(column, row);
+    }
+    if (has_sequences_) {
+      for (auto [offsets, chars] : {std::make_pair(qseq_offsets, qseqs),
+                                    std::make_pair(sseq_offsets, sseqs)}) {
+        std::uint32_t begin{ValueAt<std::uint32_t>(offsets, row)};
+        std::uint32_t end{ValueAt<std::uint32_t>(offsets, row + 1)};
+        os << '\t' << std::string_view(chars + begin, end - begin);
       }
-      os << '\t' << a.Nident()
-         << '\t' << a.Mismatch()
-         << '\t' << a.Gapopen()
-         << '\t' << a.Gaps()
-         << '\t' << a.Qlen()
-         << '\t' << a.Slen()
-         << '\t' << a.Length();
-    if (!paste_parameters.blind_mode) {
-      os << '\t' << a.Qseq()
-         << '\t' << a.Sseq();
-    }
-      os << '\t' << a.Pident()
-         << '\t' << a.RawScore()
-         << '\t' << a.Bitscore()
-         << '\t' << a.Evalue()
-         << '\t' << a.Nmatches()
-         << '\t' << a.PastedIdentifiers().at(0);
-      for (int i = 1; i < static_cast<int>(a.PastedIdentifiers().size()); ++i) {
-        os << ',' << a.PastedIdentifiers().at(i);
+    }
+    for (const char* column : floats) {
+      os << '\t' << ValueAt<float>(column, row);
+    }
+    os << '\t' << ValueAt<double>(evalues, row) << '\t'
+       << ValueAt<std::int32_t>(nmatches, row) << '\t';
+    std::uint32_t begin{ValueAt<std::uint32_t>(rows_offsets, row)};
+    std::uint32_t end{ValueAt<std::uint32_t>(rows_offsets, row + 1)};
+    for (std::uint32_t id = begin; id < end; ++id) {
+      if (id > begin) {
+        os << ',';
       }
-      os << '\n';
+      os << ValueAt<std::int32_t>(rows, id);
     }
+    os << '\n';
   }
 }
 
-} // namespace paste_alignments
\ No newline at end of file
+} // namespace paste_alignments
@@ -0,0 +1,393 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "result_cache.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "exceptions.h"
+
+namespace paste_alignments {
+
+// Result cache helpers.
+//
+namespace {
+
+// First line of every cache entry.
+//
+const std::string kEntryHeader{"paste_alignments cache 4"};
+
+// FNV-1a parameters. The offset basis of the check hash differs from the
+// standard one to obtain an independent hash.
+//
+constexpr std::uint64_t kFnvPrime{1099511628211u};
+constexpr std::uint64_t kNameOffsetBasis{14695981039346656037u};
+constexpr std::uint64_t kCheckOffsetBasis{9650029242287828579u};
+
+// Adds `data` to the FNV-1a hash `hash`.
+//
+inline void HashBytes(std::string_view data, std::uint64_t& hash) {
+  for (unsigned char c : data) {
+    hash ^= static_cast<std::uint64_t>(c);
+    hash *= kFnvPrime;
+  }
+}
+
+// Adds `data` to both hashes of `key`, followed by `terminator`.
+//
+inline void HashField(std::string_view data, char terminator, CacheKey& key) {
+  HashBytes(data, key.name_hash);
+  HashBytes(std::string_view{&terminator, 1}, key.name_hash);
+  HashBytes(data, key.check_hash);
+  HashBytes(std::string_view{&terminator, 1}, key.check_hash);
+}
+
+// Returns `hash` as 16 hexadecimal digits.
+//
+std::string Hex(std::uint64_t hash) {
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return ss.str();
+}
+
+} // namespace
+
+// CacheKey::FromRawBatch
+//
+CacheKey CacheKey::FromRawBatch(const RawBatch& raw_batch,
+                                std::string_view settings) {
+  CacheKey result;
+  result.name_hash = kNameOffsetBasis;
+  result.check_hash = kCheckOffsetBasis;
+  HashField(settings, '\0', result);
+  for (const std::string& row : raw_batch.rows) {
+    HashField(row, '\n', result);
+  }
+  return result;
+}
+
+// CacheKey::Filename
+//
+std::string CacheKey::Filename() const {
+  return Hex(name_hash) + ".entry";
+}
+
+// CacheKey::operator==
+//
+bool CacheKey::operator==(const CacheKey& other) const {
+  return (name_hash == other.name_hash && check_hash == other.check_hash);
+}
+
+// CacheKey::DebugString
+//
+std::string CacheKey::DebugString() const {
+  std::stringstream ss;
+  ss << '(' << "name_hash=" << Hex(name_hash)
+     << ", check_hash=" << Hex(check_hash) << ')';
+  return ss.str();
+}
+
+// ResultCache::ResultCache
+//
+ResultCache::ResultCache(const std::string& directory, long max_bytes)
+    : directory_{directory}, max_bytes_{max_bytes} {
+  if (max_bytes < 0) {
+    std::stringstream error_message;
+    error_message << "Maximum cache size must be non-negative. Provided value:"
+                  << max_bytes << '.';
+    throw exceptions::OutOfRange(error_message.str());
+  }
+
+  // Index existing entries, least recently used first.
+  std::vector<std::pair<std::filesystem::file_time_type, Entry>> entries;
+  try {
+    std::filesystem::create_directories(directory_);
+    for (const std::filesystem::directory_entry& file
+         : std::filesystem::directory_iterator(directory_)) {
+      if (file.is_regular_file() && file.path().extension() == ".entry") {
+        entries.emplace_back(file.last_write_time(),
+                             Entry{file.path().filename().string(),
+                                   static_cast<long>(file.file_size())});
+      }
+    }
+  } catch (const std::filesystem::filesystem_error& e) {
+    std::stringstream error_message;
+    error_message << "Unable to open cache directory: " << directory_ << " ("
+                  << e.what() << ')';
+    throw exceptions::ReadError(error_message.str());
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const auto& first, const auto& second) {
+              return first.first < second.first;
+            });
+  for (const auto& entry : entries) {
+    recency_.push_front(entry.second);
+    index_[entry.second.filename] = recency_.begin();
+    size_ += entry.second.size;
+  }
+}
+
+// ResultCache::Size
+//
+long ResultCache::Size() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return size_;
+}
+
+// ResultCache::Lookup
+//
+bool ResultCache::Lookup(const CacheKey& key, std::string& output,
+                         StatsCollector& stats) {
+  // Entries are replaced by renaming, so they are read without the lock.
+  std::string filename{key.Filename()};
+  std::filesystem::path path{std::filesystem::path{directory_} / filename};
+  std::ifstream ifs{path, std::ios_base::binary};
+  if (!ifs.is_open()) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (index_.count(filename) > 0) {
+      Remove(filename);
+    }
+    return false;
+  }
+
+  // Read and verify entry.
+  std::string header, check_hash;
+  long output_length{-1};
+  std::getline(ifs, header);
+  std::getline(ifs, check_hash);
+  ifs >> output_length;
+  ifs.ignore(1);
+  if (ifs.fail() || header != kEntryHeader || output_length < 0) {
+    ifs.close();
+    std::lock_guard<std::mutex> lock{mutex_};
+    Remove(filename);
+    return false;
+  } else if (check_hash != Hex(key.check_hash)) {
+    return false;
+  }
+  std::string cached_output(static_cast<std::string::size_type>(output_length),
+                            '\0');
+  ifs.read(cached_output.data(), output_length);
+  StatsCollector cached_stats;
+  try {
+    if (ifs.fail()) {
+      throw exceptions::ReadError("Truncated cache entry.");
+    }
+    cached_stats = StatsCollector::FromIStream(ifs);
+  } catch (const exceptions::ReadError&) {
+    ifs.close();
+    std::lock_guard<std::mutex> lock{mutex_};
+    Remove(filename);
+    return false;
+  }
+  ifs.close();
+
+  // Mark entry as most recently used.
+  std::error_code error;
+  std::filesystem::last_write_time(
+      path, std::filesystem::file_time_type::clock::now(), error);
+  long size{static_cast<long>(std::filesystem::file_size(path, error))};
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    Touch(filename, size);
+  }
+  output = std::move(cached_output);
+  stats = std::move(cached_stats);
+  return true;
+}
+
+// ResultCache::Store
+//
+void ResultCache::Store(const CacheKey& key, std::string_view output,
+                        const StatsCollector& stats) {
+  std::stringstream entry;
+  entry << kEntryHeader << '\n'
+        << Hex(key.check_hash) << '\n'
+        << output.length() << '\n'
+        << output;
+  stats.WriteState(entry);
+  std::string data{entry.str()};
+  long size{static_cast<long>(data.length())};
+  if (size > max_bytes_) {
+    return;
+  }
+
+  // Each thread writes its own temporary file, which is renamed into place
+  // without the lock.
+  std::string filename{key.Filename()};
+  std::filesystem::path path{std::filesystem::path{directory_} / filename};
+  std::filesystem::path temporary_path{path};
+  temporary_path += ('.' + Hex(std::hash<std::thread::id>{}(
+                               std::this_thread::get_id()))
+                     + ".tmp");
+  std::ofstream ofs{temporary_path, std::ios_base::binary};
+  ofs << data;
+  ofs.close();
+  std::error_code error;
+  if (!ofs.fail()) {
+    std::filesystem::rename(temporary_path, path, error);
+  }
+  if (ofs.fail() || error) {
+    std::filesystem::remove(temporary_path, error);
+    std::stringstream error_message;
+    error_message << "Unable to write cache entry: " << path.string();
+    throw exceptions::ReadError(error_message.str());
+  }
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  Touch(filename, size);
+
+  // Evict least recently used entries.
+  while (size_ > max_bytes_ && !recency_.empty()) {
+    std::string evicted{recency_.back().filename};
+    Remove(evicted);
+  }
+}
+
+// ResultCache::DebugString
+//
+std::string ResultCache::DebugString() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  std::stringstream ss;
+  ss << "{directory: " << directory_
+     << ", max_bytes: " << max_bytes_
+     << ", size: " << size_
+     << ", num_entries: " << recency_.size()
+     << '}';
+  return ss.str();
+}
+
+// ResultCache::Touch
+//
+void ResultCache::Touch(const std::string& filename, long size) {
+  std::unordered_map<std::string, std::list<Entry>::iterator>::iterator it{
+      index_.find(filename)};
+  if (it != index_.end()) {
+    size_ -= it->second->size;
+    recency_.erase(it->second);
+  }
+  recency_.push_front(Entry{filename, size});
+  index_[filename] = recency_.begin();
+  size_ += size;
+}
+
+// ResultCache::Remove
+//
+void ResultCache::Remove(const std::string& filename) {
+  std::unordered_map<std::string, std::list<Entry>::iterator>::iterator it{
+      index_.find(filename)};
+  if (it != index_.end()) {
+    size_ -= it->second->size;
+    recency_.erase(it->second);
+    index_.erase(it);
+  }
+  std::error_code error;
+  std::filesystem::remove(std::filesystem::path{directory_} / filename, error);
+}
+
+// CacheSettings
+//
+std::string CacheSettings(const PasteParameters& paste_parameters,
+                          int num_fields) {
+  std::stringstream ss;
+  ss << std::setprecision(std::numeric_limits<double>::max_digits10)
+     << "num_fields=" << num_fields
+     << ";gap_tolerance=" << paste_parameters.gap_tolerance
+     << ";intermediate_pident="
+     << paste_parameters.intermediate_pident_threshold
+     << ";intermediate_score=" << paste_parameters.intermediate_score_threshold
+     << ";final_pident=" << paste_parameters.final_pident_threshold
+     << ";final_score=" << paste_parameters.final_score_threshold
+     << ";final_evalue=" << paste_parameters.final_evalue
+     << ";final_bitscore=" << paste_parameters.final_bitscore
+     << ";enforce_average_score=" << paste_parameters.enforce_average_score
+     << ";blind_mode=" << paste_parameters.blind_mode
+     << ";output_columns=" << paste_parameters.output_columns
+     << ";compact_rows=" << paste_parameters.compact_rows
+     << ";binary_output=" << paste_parameters.binary_output
+     << ";remove_redundant=" << paste_parameters.remove_redundant
+     << ";engine=" << static_cast<int>(paste_parameters.engine)
+     << ";candidate_budget=" << paste_parameters.candidate_budget
+     << ";max_alignments_per_batch="
+     << paste_parameters.max_alignments_per_batch
+     << ";reward=" << paste_parameters.reward
+     << ";penalty=" << paste_parameters.penalty
+     << ";open_cost=" << paste_parameters.open_cost
+     << ";extend_cost=" << paste_parameters.extend_cost
+     << ";db_size=" << paste_parameters.db_size
+     << ";float_epsilon=" << paste_parameters.float_epsilon
+     << ";double_epsilon=" << paste_parameters.double_epsilon;
+  return ss.str();
+}
+
+// ShiftRowIds
+//
+std::string ShiftRowIds(std::string_view output, long shift) {
+  std::string result;
+  result.reserve(output.length());
+  std::string_view::size_type line_begin{0};
+  while (line_begin < output.length()) {
+    std::string_view::size_type line_end{output.find('\n', line_begin)};
+    if (line_end == std::string_view::npos) {
+      line_end = output.length();
+    }
+    std::string_view line{output.substr(line_begin, line_end - line_begin)};
+    std::string_view::size_type rows_begin{line.rfind('\t') + 1};
+    result.append(line.substr(0, rows_begin));
+
+    // Shift each row identifier, including both ends of ranges.
+    std::string_view rows{line.substr(rows_begin)};
+    const char* pos{rows.data()};
+    const char* rows_end{rows.data() + rows.length()};
+    while (true) {
+      long id;
+      std::from_chars_result conversion{std::from_chars(pos, rows_end, id)};
+      if (conversion.ec != std::errc()
+          || (conversion.ptr != rows_end && *conversion.ptr != ','
+              && *conversion.ptr != '-')) {
+        std::stringstream error_message;
+        error_message << "Unable to convert row identifiers: '" << rows << "'.";
+        throw exceptions::ParsingError(error_message.str());
+      }
+      result.append(std::to_string(id + shift));
+      if (conversion.ptr == rows_end) {
+        break;
+      }
+      result.push_back(*conversion.ptr);
+      pos = conversion.ptr + 1;
+    }
+    if (line_end < output.length()) {
+      result.push_back('\n');
+    }
+    line_begin = line_end + 1;
+  }
+  return result;
+}
+
+} // namespace paste_alignments
@@ -21,6 +21,8 @@
 #include "scoring_system.h"
 
 #include <math.h>
+#include <cmath>
+#include <limits>
 #include <sstream>
 
 namespace paste_alignments {
@@ -43,6 +45,34 @@ float NextLowerEven(float x, float epsilon = 0.05f) {
   return result;
 }
 
+// Raw scores are multiples of 0.5, as all scoring parameters are integers
+// except for the extension costs of Megablast, which are multiples of 0.5.
+constexpr double kScoreResolution{0.5};
+
+// Beyond this magnitude, consecutive multiples of `kScoreResolution` may not be
+// distinguishable as floats.
+constexpr double kMaxResolvedScore{4194304.0};
+
+// Returns the smallest multiple of `kScoreResolution` for which `satisfies`
+// holds, given that `satisfies` is monotone and approximately holds from
+// `estimate` on.
+//
+template<typename Predicate>
+float SmallestSatisfyingScore(double estimate, Predicate satisfies) {
+  if (std::isnan(estimate) || estimate <= -kMaxResolvedScore) {
+    return std::numeric_limits<float>::lowest();
+  }
+  double result{std::ceil(estimate / kScoreResolution) * kScoreResolution};
+  if (result >= kMaxResolvedScore) {return static_cast<float>(result);}
+  while (satisfies(static_cast<float>(result - kScoreResolution))) {
+    result -= kScoreResolution;
+  }
+  while (!satisfies(static_cast<float>(result))) {
+    result += kScoreResolution;
+  }
+  return static_cast<float>(result);
+}
+
 } // namespace
 
 // ScoringSystem::Create
@@ -117,6 +147,34 @@ double ScoringSystem::Evalue(float raw_score, int qlen,
           * ::exp((-1.0) * static_cast<double>(lambda_) * score));
 }
 
+// ScoringSystem::EvalueScoreThreshold
+//
+float ScoringSystem::EvalueScoreThreshold(
+    double evalue, int qlen, const PasteParameters& parameters) const {
+  double estimate{(::log(static_cast<double>(k_)
+                         * static_cast<double>(qlen)
+                         * static_cast<double>(db_size_))
+                   - ::log(evalue))
+                  / static_cast<double>(lambda_)};
+  return SmallestSatisfyingScore(
+      estimate, [this, evalue, qlen, &parameters](float raw_score) {
+        return Evalue(raw_score, qlen, parameters) <= evalue;
+      });
+}
+
+// ScoringSystem::BitscoreScoreThreshold
+//
+float ScoringSystem::BitscoreScoreThreshold(
+    float bitscore, const PasteParameters& parameters) const {
+  double estimate{(static_cast<double>(bitscore) * ::log(2.0)
+                   + ::log(static_cast<double>(k_)))
+                  / static_cast<double>(lambda_)};
+  return SmallestSatisfyingScore(
+      estimate, [this, bitscore, &parameters](float raw_score) {
+        return Bitscore(raw_score, parameters) >= bitscore;
+      });
+}
+
 // ScoringSystem::DebugString()
 //
 std::string ScoringSystem::DebugString() const {
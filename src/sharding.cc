@@ -0,0 +1,274 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "sharding.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "exceptions.h"
+
+namespace paste_alignments {
+
+// Sharding helpers.
+//
+namespace {
+
+// Size of the chunks in which bytes are scanned.
+//
+constexpr long kChunkSize{1l << 16};
+
+// Returns the number of bytes in `is`.
+//
+// Basic guarantee. Throws `exceptions::ReadError` if the size cannot be
+// determined.
+//
+long StreamSize(std::istream& is) {
+  is.clear();
+  is.seekg(0, std::ios_base::end);
+  long size{static_cast<long>(is.tellg())};
+  if (is.fail() || size < 0l) {
+    throw exceptions::ReadError("Unable to determine size of input stream.");
+  }
+  return size;
+}
+
+// Reads up to `length` bytes starting at `offset` from `is` into `buffer` and
+// returns the number of bytes read.
+//
+// Basic guarantee. Throws `exceptions::ReadError` if `badbit` is set.
+//
+long ReadChunk(std::istream& is, long offset, long length,
+               std::vector<char>& buffer) {
+  buffer.resize(length);
+  is.clear();
+  is.seekg(offset);
+  is.read(buffer.data(), length);
+  if (is.bad()) {
+    throw exceptions::ReadError("Something went wrong when attempting to read"
+                                " from input stream.");
+  }
+  return static_cast<long>(is.gcount());
+}
+
+// Returns the offset of the first byte of the line containing the byte at
+// `offset`.
+//
+long LineBegin(std::istream& is, long offset) {
+  std::vector<char> buffer;
+  long end{offset};
+  while (end > 0l) {
+    long begin{std::max(0l, end - kChunkSize)};
+    ReadChunk(is, begin, end - begin, buffer);
+    for (long i = end - begin; i > 0l; --i) {
+      if (buffer.at(i - 1l) == '\n') {
+        return begin + i;
+      }
+    }
+    end = begin;
+  }
+  return 0l;
+}
+
+// Replaces `line` with the line beginning at `offset` in `is` and returns the
+// offset of the following line.
+//
+long ReadLine(std::istream& is, long offset, std::string& line) {
+  is.clear();
+  is.seekg(offset);
+  std::getline(is, line);
+  if (is.bad()) {
+    throw exceptions::ReadError("Something went wrong when attempting to read"
+                                " from input stream.");
+  }
+  return offset + static_cast<long>(line.length()) + 1l;
+}
+
+// Returns the part of `line` that determines its batch, i.e. its first two
+// fields.
+//
+std::string_view BatchKey(const std::string& line) {
+  std::string::size_type pos{line.find('\t')};
+  if (pos != std::string::npos) {
+    pos = line.find('\t', pos + 1);
+  }
+  return std::string_view{line}.substr(0, pos);
+}
+
+// Returns the offset of the first batch beginning at or after `offset`.
+//
+long BatchBoundary(std::istream& is, long offset, long size) {
+  if (offset <= 0l) {
+    return 0l;
+  } else if (offset >= size) {
+    return size;
+  }
+  std::string previous_line, line;
+  long next{ReadLine(is, LineBegin(is, offset - 1l), previous_line)};
+  std::string_view previous_key{BatchKey(previous_line)};
+  while (next < size) {
+    long following{ReadLine(is, next, line)};
+    if (BatchKey(line) != previous_key) {
+      return next;
+    }
+    next = following;
+  }
+  return size;
+}
+
+// Returns the number of '\n' characters preceding `offset` in `is`.
+//
+long CountLines(std::istream& is, long offset) {
+  std::vector<char> buffer;
+  long count{0l};
+  for (long begin = 0l; begin < offset; begin += kChunkSize) {
+    long length{ReadChunk(is, begin, std::min(kChunkSize, offset - begin),
+                          buffer)};
+    count += std::count(buffer.begin(), buffer.begin() + length, '\n');
+  }
+  return count;
+}
+
+} // namespace
+
+// Shard::FromString
+//
+Shard Shard::FromString(std::string_view specification) {
+  Shard result;
+  std::stringstream ss{std::string{specification}};
+  char separator{'\0'};
+  ss >> result.index >> separator >> result.num_shards;
+  if (ss.fail() || separator != '/' || !(ss >> std::ws).eof()
+      || result.index < 1 || result.num_shards < result.index) {
+    std::stringstream error_message;
+    error_message << "Invalid shard specification: '" << specification
+                  << "'. Expected 'INDEX/COUNT' with 1 <= INDEX <= COUNT.";
+    throw exceptions::ParsingError(error_message.str());
+  }
+  return result;
+}
+
+// Shard::operator==
+//
+bool Shard::operator==(const Shard& other) const {
+  return (index == other.index && num_shards == other.num_shards);
+}
+
+// Shard::DebugString
+//
+std::string Shard::DebugString() const {
+  std::stringstream ss;
+  ss << '(' << index << '/' << num_shards << ')';
+  return ss.str();
+}
+
+// InputRange::operator==
+//
+bool InputRange::operator==(const InputRange& other) const {
+  return (begin_offset == other.begin_offset
+          && end_offset == other.end_offset
+          && first_row_id == other.first_row_id);
+}
+
+// InputRange::DebugString
+//
+std::string InputRange::DebugString() const {
+  std::stringstream ss;
+  ss << '('
+     << "begin_offset=" << begin_offset
+     << ", end_offset=" << end_offset
+     << ", first_row_id=" << first_row_id
+     << ')';
+  return ss.str();
+}
+
+// FindShardRange
+//
+InputRange FindShardRange(std::istream& is, const Shard& shard) {
+  long size{StreamSize(is)};
+  long num_shards{static_cast<long>(shard.num_shards)};
+  long chunk{size / num_shards}, remainder{size % num_shards};
+  auto nominal_boundary = [chunk, remainder, num_shards](long i) {
+    return chunk * i + remainder * i / num_shards;
+  };
+
+  InputRange result;
+  result.begin_offset = BatchBoundary(is, nominal_boundary(shard.index - 1),
+                                      size);
+  result.end_offset = BatchBoundary(is, nominal_boundary(shard.index), size);
+  result.first_row_id = CountLines(is, result.begin_offset) + 1l;
+  is.clear();
+  is.seekg(result.begin_offset);
+  return result;
+}
+
+// ShardFilename
+//
+std::string ShardFilename(const std::string& filename, int index) {
+  std::stringstream ss;
+  ss << filename << '.' << index;
+  return ss.str();
+}
+
+// OutputShardIndex
+//
+int OutputShardIndex(std::string_view qseqid, int num_shards) {
+  if (num_shards < 1) {
+    std::stringstream error_message;
+    error_message << "Number of output shards must be positive: "
+                  << num_shards;
+    throw exceptions::OutOfRange(error_message.str());
+  }
+  std::uint64_t hash{14695981039346656037ull};
+  for (char c : qseqid) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+  return static_cast<int>(hash % static_cast<std::uint64_t>(num_shards));
+}
+
+// ConcatenateShards
+//
+void ConcatenateShards(const std::string& filename, int num_shards) {
+  std::ofstream ofs{filename, std::ios_base::binary};
+  for (int index = 1; index <= num_shards; ++index) {
+    std::ifstream ifs{ShardFilename(filename, index), std::ios_base::binary};
+    if (!ifs.is_open()) {
+      std::stringstream error_message;
+      error_message << "Unable to open shard file: "
+                    << ShardFilename(filename, index);
+      throw exceptions::ReadError(error_message.str());
+    }
+    if (ifs.peek() != std::ifstream::traits_type::eof()) {
+      ofs << ifs.rdbuf();
+    }
+    if (ifs.bad() || ofs.fail()) {
+      std::stringstream error_message;
+      error_message << "Unable to copy shard file: "
+                    << ShardFilename(filename, index) << " into: " << filename;
+      throw exceptions::ReadError(error_message.str());
+    }
+  }
+}
+
+} // namespace paste_alignments
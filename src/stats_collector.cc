@@ -20,8 +20,230 @@
 
 #include "stats_collector.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <map>
+
 namespace paste_alignments {
 
+// Summary helpers.
+//
+namespace {
+
+// Returns the value of the field named `key` in `fields`.
+//
+// Strong guarantee. Throws `exceptions::ReadError` if the field is missing or
+// its value cannot be converted.
+//
+template<class T>
+T GetSummaryField(const std::map<std::string, std::string>& fields,
+                  const std::string& key) {
+  std::map<std::string, std::string>::const_iterator it{fields.find(key)};
+  if (it == fields.end()) {
+    std::stringstream error_message;
+    error_message << "Summary is missing field: '" << key << "'.";
+    throw exceptions::ReadError(error_message.str());
+  }
+  std::stringstream ss{it->second};
+  T value;
+  ss >> value;
+  if (ss.fail() || !(ss >> std::ws).eof()) {
+    std::stringstream error_message;
+    error_message << "Unable to convert value: '" << it->second
+                  << "' of summary field: '" << key << "'.";
+    throw exceptions::ReadError(error_message.str());
+  }
+  return value;
+}
+
+// Throws `exceptions::ReadError` describing malformed collector state if
+// `is` failed.
+//
+void TestState(const std::istream& is) {
+  if (is.fail()) {
+    throw exceptions::ReadError("Unable to read malformed statistics collector"
+                                " state.");
+  }
+}
+
+// Writes `removed_rows` as comma-separated `removed:kept` pairs, or `-` if
+// empty.
+//
+void WriteRemovedRows(const std::vector<std::pair<int,int>>& removed_rows,
+                      std::ostream& os) {
+  if (removed_rows.empty()) {
+    os << '-';
+  }
+  for (int i = 0; i < static_cast<int>(removed_rows.size()); ++i) {
+    os << (i > 0 ? "," : "") << removed_rows.at(i).first << ':'
+       << removed_rows.at(i).second;
+  }
+}
+
+// Reads removed rows written by `WriteRemovedRows`.
+//
+// Basic guarantee. Throws `exceptions::ReadError` if they are malformed.
+//
+std::vector<std::pair<int,int>> ReadRemovedRows(std::istream& is) {
+  std::string token;
+  is >> token;
+  TestState(is);
+  std::vector<std::pair<int,int>> result;
+  if (token == "-") {
+    return result;
+  }
+  std::stringstream ss{token};
+  std::pair<int,int> pair;
+  char colon, comma;
+  do {
+    ss >> pair.first >> colon >> pair.second;
+    if (ss.fail() || colon != ':') {
+      throw exceptions::ReadError("Unable to read malformed statistics"
+                                  " collector state.");
+    }
+    result.push_back(pair);
+  } while (ss >> comma && comma == ',');
+  return result;
+}
+
+// Writes the fields of `s` as one tab-separated line without line break, as
+// read by `ReadStatsState`.
+//
+void WriteStatsState(const PasteStats& s, std::ostream& os) {
+  os << s.qseqid
+     << '\t' << s.sseqid
+     << '\t' << s.num_alignments
+     << '\t' << s.num_pastings
+     << '\t' << s.average_length
+     << '\t' << s.average_pident
+     << '\t' << s.average_score
+     << '\t' << s.average_bitscore
+     << '\t' << s.average_evalue
+     << '\t' << s.average_nmatches
+     << '\t';
+  WriteRemovedRows(s.removed_rows, os);
+  os << '\t' << s.num_unextended_seeds;
+}
+
+// Reads the fields written by `WriteStatsState`.
+//
+// Basic guarantee. Throws `exceptions::ReadError` if the fields are malformed.
+//
+PasteStats ReadStatsState(std::istream& is) {
+  PasteStats stats;
+  is >> std::ws;
+  std::getline(is, stats.qseqid, '\t');
+  std::getline(is, stats.sseqid, '\t');
+  is >> stats.num_alignments >> stats.num_pastings >> stats.average_length
+     >> stats.average_pident >> stats.average_score >> stats.average_bitscore
+     >> stats.average_evalue >> stats.average_nmatches;
+  TestState(is);
+  stats.removed_rows = ReadRemovedRows(is);
+  is >> stats.num_unextended_seeds;
+  TestState(is);
+  return stats;
+}
+
+// Adds the weighted averages of `s` to the sums of `global_stats`.
+//
+void AddToCombined(const PasteStats& s, PasteStats& global_stats) {
+  global_stats.num_alignments += s.num_alignments;
+  global_stats.num_pastings += s.num_pastings;
+  global_stats.average_length += s.average_length
+                                 * s.num_alignments;
+  global_stats.average_pident += s.average_pident
+                                 * s.num_alignments;
+  global_stats.average_score += s.average_score
+                                 * s.num_alignments;
+  global_stats.average_bitscore += s.average_bitscore
+                                 * s.num_alignments;
+  global_stats.average_evalue += s.average_evalue
+                                 * s.num_alignments;
+  global_stats.average_nmatches += s.average_nmatches
+                                   * s.num_alignments;
+}
+
+// Divides the sums of `global_stats` by its number of alignments.
+//
+void FinishCombined(PasteStats& global_stats) {
+  if (global_stats.num_alignments > 0) {
+    float f_num_alignments{static_cast<float>(global_stats.num_alignments)};
+    global_stats.average_length /= f_num_alignments;
+    global_stats.average_pident /= f_num_alignments;
+    global_stats.average_score /= f_num_alignments;
+    global_stats.average_bitscore /= f_num_alignments;
+    global_stats.average_evalue /= static_cast<double>(f_num_alignments);
+    global_stats.average_nmatches /= f_num_alignments;
+  }
+}
+
+// Returns the number of bytes `stats` occupies on the heap.
+//
+// No-throw guarantee.
+//
+long HeapBytes(const PasteStats& stats) {
+  return static_cast<long>(
+      stats.qseqid.capacity() + stats.sseqid.capacity()
+      + stats.removed_rows.capacity() * sizeof(stats.removed_rows.front()));
+}
+
+// Creates an anonymous temporary file removed once closed.
+//
+// Basic guarantee. Throws `exceptions::ReadError` if the file cannot be
+// created.
+//
+std::shared_ptr<std::FILE> CreateSpillFile() {
+  std::FILE* file{std::tmpfile()};
+  if (file == nullptr) {
+    throw exceptions::ReadError("Unable to create temporary file for spilling"
+                                " statistics.");
+  }
+  return std::shared_ptr<std::FILE>(file, std::fclose);
+}
+
+// Copies the first `size` bytes of `source` to the beginning of `target`.
+//
+// Basic guarantee. Throws `exceptions::ReadError` if copying fails.
+//
+void CopySpillFile(std::FILE* source, std::FILE* target, long size) {
+  std::vector<char> buffer(1 << 16);
+  if (std::fseek(source, 0l, SEEK_SET) != 0
+      || std::fseek(target, 0l, SEEK_SET) != 0) {
+    throw exceptions::ReadError("Unable to copy spilled statistics.");
+  }
+  while (size > 0l) {
+    std::size_t count{static_cast<std::size_t>(
+        std::min(size, static_cast<long>(buffer.size())))};
+    if (std::fread(buffer.data(), 1, count, source) != count
+        || std::fwrite(buffer.data(), 1, count, target) != count) {
+      throw exceptions::ReadError("Unable to copy spilled statistics.");
+    }
+    size -= static_cast<long>(count);
+  }
+}
+
+} // namespace
+
+// PasteStats::operator==
+//
+bool PasteStats::operator==(const PasteStats& other) const {
+  return (qseqid == other.qseqid
+          && sseqid == other.sseqid
+          && num_alignments == other.num_alignments
+          && num_pastings == other.num_pastings
+          && average_length == other.average_length
+          && average_pident == other.average_pident
+          && average_score == other.average_score
+          && average_bitscore == other.average_bitscore
+          && average_evalue == other.average_evalue
+          && average_nmatches == other.average_nmatches
+          && removed_rows == other.removed_rows
+          && num_unextended_seeds == other.num_unextended_seeds);
+}
+
 // PasteStats::DebugString
 //
 std::string PasteStats::DebugString() const {
@@ -37,29 +259,317 @@ std::string PasteStats::DebugString() const {
      << ", average_bitscore=" << average_bitscore
      << ", average_evalue=" << average_evalue
      << ", average_nmatches=" << average_nmatches
+     << ", removed_rows=";
+  WriteRemovedRows(removed_rows, ss);
+  ss << ", num_unextended_seeds=" << num_unextended_seeds
+     << ')';
+  return ss.str();
+}
+
+// PasteTotals::Add
+//
+void PasteTotals::Add(const Alignment& a) {
+  num_alignments += 1l;
+  num_pastings += static_cast<long>(a.PastedIdentifiers().size()) - 1l;
+  total_length += static_cast<double>(a.Length());
+  total_pident += static_cast<double>(a.Pident());
+  total_score += static_cast<double>(a.RawScore());
+  total_bitscore += static_cast<double>(a.Bitscore());
+  total_evalue += a.Evalue();
+  total_nmatches += static_cast<double>(a.Nmatches());
+}
+
+// PasteTotals::operator+=
+//
+PasteTotals& PasteTotals::operator+=(const PasteTotals& other) {
+  num_alignments += other.num_alignments;
+  num_pastings += other.num_pastings;
+  total_length += other.total_length;
+  total_pident += other.total_pident;
+  total_score += other.total_score;
+  total_bitscore += other.total_bitscore;
+  total_evalue += other.total_evalue;
+  total_nmatches += other.total_nmatches;
+  num_seeds += other.num_seeds;
+  num_pruned_seeds += other.num_pruned_seeds;
+  num_removed_alignments += other.num_removed_alignments;
+  num_window_overflows += other.num_window_overflows;
+  num_brute_force_batches += other.num_brute_force_batches;
+  num_indexed_greedy_batches += other.num_indexed_greedy_batches;
+  num_cluster_parallel_batches += other.num_cluster_parallel_batches;
+  num_scanned_candidates += other.num_scanned_candidates;
+  num_degraded_batches += other.num_degraded_batches;
+  return *this;
+}
+
+// PasteTotals::Averages
+//
+PasteStats PasteTotals::Averages() const {
+  PasteStats result;
+  result.num_alignments = num_alignments;
+  result.num_pastings = num_pastings;
+  if (num_alignments > 0) {
+    double d_num_alignments{static_cast<double>(num_alignments)};
+    result.average_length = static_cast<float>(total_length
+                                               / d_num_alignments);
+    result.average_pident = static_cast<float>(total_pident
+                                               / d_num_alignments);
+    result.average_score = static_cast<float>(total_score / d_num_alignments);
+    result.average_bitscore = static_cast<float>(total_bitscore
+                                                 / d_num_alignments);
+    result.average_evalue = total_evalue / d_num_alignments;
+    result.average_nmatches = static_cast<float>(total_nmatches
+                                                 / d_num_alignments);
+  }
+  return result;
+}
+
+// PasteTotals::operator==
+//
+bool PasteTotals::operator==(const PasteTotals& other) const {
+  return (num_alignments == other.num_alignments
+          && num_pastings == other.num_pastings
+          && total_length == other.total_length
+          && total_pident == other.total_pident
+          && total_score == other.total_score
+          && total_bitscore == other.total_bitscore
+          && total_evalue == other.total_evalue
+          && total_nmatches == other.total_nmatches
+          && num_seeds == other.num_seeds
+          && num_pruned_seeds == other.num_pruned_seeds
+          && num_removed_alignments == other.num_removed_alignments
+          && num_window_overflows == other.num_window_overflows
+          && num_brute_force_batches == other.num_brute_force_batches
+          && num_indexed_greedy_batches == other.num_indexed_greedy_batches
+          && num_cluster_parallel_batches
+             == other.num_cluster_parallel_batches
+          && num_scanned_candidates == other.num_scanned_candidates
+          && num_degraded_batches == other.num_degraded_batches);
+}
+
+// PasteTotals::DebugString
+//
+std::string PasteTotals::DebugString() const {
+  std::stringstream ss;
+  ss << '('
+     << "num_alignments=" << num_alignments
+     << ", num_pastings=" << num_pastings
+     << ", total_length=" << total_length
+     << ", total_pident=" << total_pident
+     << ", total_score=" << total_score
+     << ", total_bitscore=" << total_bitscore
+     << ", total_evalue=" << total_evalue
+     << ", total_nmatches=" << total_nmatches
+     << ", num_seeds=" << num_seeds
+     << ", num_pruned_seeds=" << num_pruned_seeds
+     << ", num_removed_alignments=" << num_removed_alignments
+     << ", num_window_overflows=" << num_window_overflows
+     << ", num_brute_force_batches=" << num_brute_force_batches
+     << ", num_indexed_greedy_batches=" << num_indexed_greedy_batches
+     << ", num_cluster_parallel_batches=" << num_cluster_parallel_batches
+     << ", num_scanned_candidates=" << num_scanned_candidates
+     << ", num_degraded_batches=" << num_degraded_batches
      << ')';
   return ss.str();
 }
 
+// CombineStats
+//
+PasteStats CombineStats(const std::vector<PasteStats>& stats) {
+  PasteStats global_stats;
+  for (const PasteStats& s : stats) {
+    AddToCombined(s, global_stats);
+  }
+  FinishCombined(global_stats);
+  return global_stats;
+}
+
+// WriteSummary
+//
+void WriteSummary(const PasteTotals& totals, std::ostream& os,
+                  bool include_totals) {
+  PasteStats summary{totals.Averages()};
+  os << "{\n"
+     << "\t\"num_alignments\": " << summary.num_alignments << ",\n"
+     << "\t\"num_pastings\": " << summary.num_pastings << ",\n"
+     << "\t\"average_length\": " << summary.average_length << ",\n"
+     << "\t\"average_pident\": " << summary.average_pident << ",\n"
+     << "\t\"average_score\": " << summary.average_score << ",\n"
+     << "\t\"average_bitscore\": " << summary.average_bitscore << ",\n"
+     << "\t\"average_evalue\": " << summary.average_evalue << ",\n"
+     << "\t\"average_nmatches\": " << summary.average_nmatches << ",\n"
+     << "\t\"num_seeds\": " << totals.num_seeds << ",\n"
+     << "\t\"num_pruned_seeds\": " << totals.num_pruned_seeds << ",\n"
+     << "\t\"seed_pruning_rate\": "
+     << (totals.num_seeds > 0l
+         ? static_cast<double>(totals.num_pruned_seeds)
+           / static_cast<double>(totals.num_seeds)
+         : 0.0) << ",\n"
+     << "\t\"num_removed_alignments\": " << totals.num_removed_alignments
+     << ",\n"
+     << "\t\"num_window_overflows\": " << totals.num_window_overflows << ",\n"
+     << "\t\"num_brute_force_batches\": " << totals.num_brute_force_batches
+     << ",\n"
+     << "\t\"num_indexed_greedy_batches\": "
+     << totals.num_indexed_greedy_batches << ",\n"
+     << "\t\"num_cluster_parallel_batches\": "
+     << totals.num_cluster_parallel_batches << ",\n"
+     << "\t\"num_scanned_candidates\": " << totals.num_scanned_candidates
+     << ",\n"
+     << "\t\"num_degraded_batches\": " << totals.num_degraded_batches;
+  if (include_totals) {
+    std::streamsize precision{os.precision(
+        std::numeric_limits<double>::max_digits10)};
+    os << ",\n"
+       << "\t\"total_length\": " << totals.total_length << ",\n"
+       << "\t\"total_pident\": " << totals.total_pident << ",\n"
+       << "\t\"total_score\": " << totals.total_score << ",\n"
+       << "\t\"total_bitscore\": " << totals.total_bitscore << ",\n"
+       << "\t\"total_evalue\": " << totals.total_evalue << ",\n"
+       << "\t\"total_nmatches\": " << totals.total_nmatches;
+    os.precision(precision);
+  }
+  os << "\n}\n";
+}
+
+// ReadSummaryTotals
+//
+PasteTotals ReadSummaryTotals(std::istream& is) {
+  // Collect `"key": value` pairs, one per line.
+  std::map<std::string, std::string> fields;
+  std::string line;
+  while (std::getline(is, line)) {
+    std::string::size_type key_begin{line.find('"')};
+    std::string::size_type key_end{line.find('"', key_begin + 1)};
+    std::string::size_type colon{line.find(':', key_end)};
+    if (key_begin == std::string::npos || key_end == std::string::npos
+        || colon == std::string::npos) {
+      continue;
+    }
+    std::string value{line.substr(colon + 1)};
+    if (!value.empty() && value.back() == ',') {
+      value.pop_back();
+    }
+    fields[line.substr(key_begin + 1, key_end - key_begin - 1)] = value;
+  }
+  if (is.bad()) {
+    throw exceptions::ReadError("Something went wrong when attempting to read"
+                                " summary from input stream.");
+  }
+
+  PasteTotals result;
+  result.num_alignments = GetSummaryField<long>(fields, "num_alignments");
+  result.num_pastings = GetSummaryField<long>(fields, "num_pastings");
+  result.total_length = GetSummaryField<double>(fields, "total_length");
+  result.total_pident = GetSummaryField<double>(fields, "total_pident");
+  result.total_score = GetSummaryField<double>(fields, "total_score");
+  result.total_bitscore = GetSummaryField<double>(fields, "total_bitscore");
+  result.total_evalue = GetSummaryField<double>(fields, "total_evalue");
+  result.total_nmatches = GetSummaryField<double>(fields, "total_nmatches");
+  result.num_seeds = GetSummaryField<long>(fields, "num_seeds");
+  result.num_pruned_seeds = GetSummaryField<long>(fields, "num_pruned_seeds");
+  result.num_removed_alignments = GetSummaryField<long>(
+      fields, "num_removed_alignments");
+  result.num_window_overflows = GetSummaryField<long>(fields,
+                                                      "num_window_overflows");
+  result.num_brute_force_batches = GetSummaryField<long>(
+      fields, "num_brute_force_batches");
+  result.num_indexed_greedy_batches = GetSummaryField<long>(
+      fields, "num_indexed_greedy_batches");
+  result.num_cluster_parallel_batches = GetSummaryField<long>(
+      fields, "num_cluster_parallel_batches");
+  result.num_scanned_candidates = GetSummaryField<long>(
+      fields, "num_scanned_candidates");
+  result.num_degraded_batches = GetSummaryField<long>(fields,
+                                                      "num_degraded_batches");
+  return result;
+}
+
+// StatsCollector::FromIStream
+//
+StatsCollector StatsCollector::FromIStream(std::istream& is) {
+  StatsCollector result;
+  long num_batch_stats{-1l};
+  is >> num_batch_stats;
+  TestState(is);
+  if (num_batch_stats < 0l) {
+    throw exceptions::ReadError("Unable to read malformed statistics collector"
+                                " state.");
+  }
+  for (long i = 0l; i < num_batch_stats; ++i) {
+    result.batch_stats_.emplace_back(ReadStatsState(is));
+  }
+  PasteTotals& t{result.totals_};
+  is >> t.num_alignments >> t.num_pastings >> t.total_length >> t.total_pident
+     >> t.total_score >> t.total_bitscore >> t.total_evalue >> t.total_nmatches
+     >> t.num_seeds >> t.num_pruned_seeds >> t.num_removed_alignments
+     >> t.num_window_overflows >> t.num_brute_force_batches
+     >> t.num_indexed_greedy_batches >> t.num_cluster_parallel_batches
+     >> t.num_scanned_candidates >> t.num_degraded_batches;
+  TestState(is);
+  return result;
+}
+
 // StatsCollector::CollectStats
 //
-void StatsCollector::CollectStats(const AlignmentBatch& batch) {
-  PasteStats stats;
-  stats.qseqid = batch.Qseqid();
-  stats.sseqid = batch.Sseqid();
+void StatsCollector::CollectStats(const AlignmentBatch& batch,
+                                  bool continues_previous) {
+  if (!continues_previous) {
+    batch_sums_ = PasteStats{};
+    batch_sums_.qseqid = batch.Qseqid();
+    batch_sums_.sseqid = batch.Sseqid();
+    batch_stored_ = false;
+  }
+  PasteStats& sums{batch_sums_};
+  totals_.num_seeds += static_cast<long>(batch.NumSeeds());
+  totals_.num_pruned_seeds += static_cast<long>(batch.NumPrunedSeeds());
+  totals_.num_removed_alignments += static_cast<long>(batch.Removed().size());
+  if (batch.Engine() == BatchEngine::kBruteForce) {
+    totals_.num_brute_force_batches += 1l;
+  } else if (batch.Engine() == BatchEngine::kIndexedGreedy) {
+    totals_.num_indexed_greedy_batches += 1l;
+  } else if (batch.Engine() == BatchEngine::kClusterParallel) {
+    totals_.num_cluster_parallel_batches += 1l;
+  }
+  totals_.num_scanned_candidates += batch.NumScannedCandidates();
+  if (batch.NumUnextendedSeeds() > 0 && sums.num_unextended_seeds == 0l) {
+    totals_.num_degraded_batches += 1l;
+  }
+  sums.num_unextended_seeds += static_cast<long>(batch.NumUnextendedSeeds());
+  sums.removed_rows.insert(sums.removed_rows.end(), batch.Removed().begin(),
+                           batch.Removed().end());
   for (const Alignment& a : batch.Alignments()) {
     if (a.IncludeInOutput()) {
-      stats.num_alignments += 1l;
-      stats.num_pastings += static_cast<long>(a.PastedIdentifiers().size())
-                            - 1l;
-      stats.average_length += static_cast<float>(a.Length());
-      stats.average_pident += a.Pident();
-      stats.average_score += a.RawScore();
-      stats.average_bitscore += a.Bitscore();
-      stats.average_evalue += a.Evalue();
-      stats.average_nmatches += static_cast<float>(a.Nmatches());
+      totals_.Add(a);
+      sums.num_alignments += 1l;
+      sums.num_pastings += static_cast<long>(a.PastedIdentifiers().size())
+                           - 1l;
+      sums.average_length += static_cast<float>(a.Length());
+      sums.average_pident += a.Pident();
+      sums.average_score += a.RawScore();
+      sums.average_bitscore += a.Bitscore();
+      sums.average_evalue += a.Evalue();
+      sums.average_nmatches += static_cast<float>(a.Nmatches());
     }
   }
+  if (sums.num_alignments == 0 && sums.removed_rows.empty()
+      && sums.num_unextended_seeds == 0l && !batch_stored_) {
+    return;
+  }
+
+  // Removed rows are moved into the stored stats, so that collecting a batch
+  // in parts does not copy them repeatedly.
+  if (!batch_stored_) {
+    batch_stats_.emplace_back();
+    batch_stored_ = true;
+  }
+  PasteStats& stats{batch_stats_.back()};
+  std::vector<std::pair<int,int>> removed_rows{std::move(stats.removed_rows)};
+  removed_rows.insert(removed_rows.end(), sums.removed_rows.begin(),
+                      sums.removed_rows.end());
+  sums.removed_rows.clear();
+  stats = sums;
+  stats.removed_rows = std::move(removed_rows);
   if (stats.num_alignments > 0) {
     float f_num_alignments{static_cast<float>(stats.num_alignments)};
     stats.average_length /= f_num_alignments;
@@ -68,68 +578,238 @@ void StatsCollector::CollectStats(const AlignmentBatch& batch) {
     stats.average_bitscore /= f_num_alignments;
     stats.average_evalue /= static_cast<double>(stats.num_alignments);
     stats.average_nmatches /= f_num_alignments;
-    batch_stats_.emplace_back(std::move(stats));
   }
 }
 
+// StatsCollector::CountWindowOverflows
+//
+void StatsCollector::CountWindowOverflows(long num_overflows) {
+  totals_.num_window_overflows += num_overflows;
+}
+
+// StatsCollector::Merge
+//
+void StatsCollector::Merge(const StatsCollector& other) {
+  if (other.num_spilled_ == 0l) {
+    batch_stats_.insert(batch_stats_.end(), other.batch_stats_.begin(),
+                        other.batch_stats_.end());
+  } else {
+    other.VisitBatchStats([&](const PasteStats& s) {
+      batch_stats_.push_back(s);
+    });
+  }
+  totals_ += other.totals_;
+}
+
+// StatsCollector::ShiftRowIds
+//
+void StatsCollector::ShiftRowIds(long shift) {
+  assert(num_spilled_ == 0l);
+  for (PasteStats& s : batch_stats_) {
+    for (std::pair<int,int>& removed : s.removed_rows) {
+      removed.first = static_cast<int>(removed.first + shift);
+      removed.second = static_cast<int>(removed.second + shift);
+    }
+  }
+}
+
+// StatsCollector::MemoryUsage
+//
+long StatsCollector::MemoryUsage() const {
+  if (batch_stats_.empty()) {
+    return static_cast<long>(batch_stats_.capacity() * sizeof(PasteStats));
+  }
+  while (num_measured_ + 1 < batch_stats_.size()) {
+    measured_bytes_ += HeapBytes(batch_stats_.at(num_measured_));
+    ++num_measured_;
+  }
+  return (static_cast<long>(batch_stats_.capacity() * sizeof(PasteStats))
+          + measured_bytes_ + HeapBytes(batch_stats_.back()));
+}
+
+// StatsCollector::Spill
+//
+void StatsCollector::Spill() {
+  std::size_t num_kept{batch_stored_ ? 1u : 0u};
+  if (batch_stats_.size() <= num_kept) {return;}
+
+  // Stop sharing the file with copies of the object before appending to it.
+  if (spill_file_ == nullptr || spill_file_.use_count() > 1) {
+    std::shared_ptr<std::FILE> file{CreateSpillFile()};
+    if (spill_file_ != nullptr) {
+      CopySpillFile(spill_file_.get(), file.get(), spill_size_);
+    }
+    spill_file_ = std::move(file);
+  }
+  if (std::fseek(spill_file_.get(), spill_size_, SEEK_SET) != 0) {
+    throw exceptions::ReadError("Unable to write spilled statistics.");
+  }
+  std::stringstream ss;
+  ss.precision(std::numeric_limits<double>::max_digits10);
+  std::vector<PasteStats>::iterator spilled_end{batch_stats_.end()
+                                                - num_kept};
+  for (std::vector<PasteStats>::iterator it = batch_stats_.begin();
+       it != spilled_end; ++it) {
+    ss.str("");
+    WriteStatsState(*it, ss);
+    std::string record{ss.str()};
+    std::uint64_t length{record.size()};
+    if (std::fwrite(&length, sizeof(length), 1, spill_file_.get()) != 1
+        || std::fwrite(record.data(), 1, record.size(), spill_file_.get())
+           != record.size()) {
+      throw exceptions::ReadError("Unable to write spilled statistics.");
+    }
+    spill_size_ += static_cast<long>(sizeof(length) + record.size());
+    ++num_spilled_;
+  }
+  batch_stats_.erase(batch_stats_.begin(), spilled_end);
+  batch_stats_.shrink_to_fit();
+  measured_bytes_ = 0l;
+  num_measured_ = 0u;
+}
+
 // StatsCollector::WriteData
 //
-PasteStats StatsCollector::WriteData(std::ostream& os) {
+PasteStats StatsCollector::WriteData(std::ostream& os,
+                                     bool include_removed_rows) {
+  return WriteData([&os](const PasteStats&) -> std::ostream& { return os; },
+                   include_removed_rows);
+}
+
+// StatsCollector::WriteData
+//
+PasteStats StatsCollector::WriteData(
+    const std::function<std::ostream&(const PasteStats&)>& stream_of,
+    bool include_removed_rows) {
   PasteStats global_stats;
-  if (!batch_stats_.empty()) {
-    for (const PasteStats& s : batch_stats_) {
-      global_stats.num_alignments += s.num_alignments;
-      global_stats.num_pastings += s.num_pastings;
-      global_stats.average_length += s.average_length
-                                     * s.num_alignments;
-      global_stats.average_pident += s.average_pident
-                                     * s.num_alignments;
-      global_stats.average_score += s.average_score
-                                     * s.num_alignments;
-      global_stats.average_bitscore += s.average_bitscore
-                                     * s.num_alignments;
-      global_stats.average_evalue += s.average_evalue
-                                     * s.num_alignments;
-      global_stats.average_nmatches += s.average_nmatches
-                                       * s.num_alignments;
-
-      os << s.qseqid
-         << '\t' << s.sseqid
-         << '\t' << s.num_alignments
-         << '\t' << s.num_pastings
-         << '\t' << s.average_length
-         << '\t' << s.average_pident
-         << '\t' << s.average_score
-         << '\t' << s.average_bitscore
-         << '\t' << s.average_evalue
-         << '\t' << s.average_nmatches
-         << '\n';
+  VisitBatchStats([&](const PasteStats& s) {
+    std::ostream& os{stream_of(s)};
+    os << s.qseqid
+       << '\t' << s.sseqid
+       << '\t' << s.num_alignments
+       << '\t' << s.num_pastings
+       << '\t' << s.average_length
+       << '\t' << s.average_pident
+       << '\t' << s.average_score
+       << '\t' << s.average_bitscore
+       << '\t' << s.average_evalue
+       << '\t' << s.average_nmatches;
+    if (include_removed_rows) {
+      os << '\t';
+      WriteRemovedRows(s.removed_rows, os);
     }
-    float f_num_alignments{static_cast<float>(global_stats.num_alignments)};
-    global_stats.average_length /= f_num_alignments;
-    global_stats.average_pident /= f_num_alignments;
-    global_stats.average_score /= f_num_alignments;
-    global_stats.average_bitscore /= f_num_alignments;
-    global_stats.average_evalue /= static_cast<double>(f_num_alignments);
-    global_stats.average_nmatches /= f_num_alignments;
-  }
+    os << '\n';
+    AddToCombined(s, global_stats);
+  });
+  FinishCombined(global_stats);
   return global_stats;
 }
 
+// StatsCollector::WriteDegraded
+//
+void StatsCollector::WriteDegraded(std::ostream& os) const {
+  WriteDegraded([&os](const PasteStats&) -> std::ostream& { return os; });
+}
+
+// StatsCollector::WriteDegraded
+//
+void StatsCollector::WriteDegraded(
+    const std::function<std::ostream&(const PasteStats&)>& stream_of) const {
+  VisitBatchStats([&](const PasteStats& s) {
+    if (s.num_unextended_seeds > 0l) {
+      stream_of(s) << s.qseqid
+                   << '\t' << s.sseqid
+                   << '\t' << s.num_unextended_seeds << '\n';
+    }
+  });
+}
+
+// StatsCollector::WriteState
+//
+void StatsCollector::WriteState(std::ostream& os) const {
+  std::streamsize precision{os.precision(
+      std::numeric_limits<double>::max_digits10)};
+  os << num_spilled_ + static_cast<long>(batch_stats_.size()) << '\n';
+  VisitBatchStats([&](const PasteStats& s) {
+    WriteStatsState(s, os);
+    os << '\n';
+  });
+  os << totals_.num_alignments
+     << '\t' << totals_.num_pastings
+     << '\t' << totals_.total_length
+     << '\t' << totals_.total_pident
+     << '\t' << totals_.total_score
+     << '\t' << totals_.total_bitscore
+     << '\t' << totals_.total_evalue
+     << '\t' << totals_.total_nmatches
+     << '\t' << totals_.num_seeds
+     << '\t' << totals_.num_pruned_seeds
+     << '\t' << totals_.num_removed_alignments
+     << '\t' << totals_.num_window_overflows
+     << '\t' << totals_.num_brute_force_batches
+     << '\t' << totals_.num_indexed_greedy_batches
+     << '\t' << totals_.num_cluster_parallel_batches
+     << '\t' << totals_.num_scanned_candidates
+     << '\t' << totals_.num_degraded_batches
+     << '\n';
+  os.precision(precision);
+}
+
+// StatsCollector::operator==
+//
+bool StatsCollector::operator==(const StatsCollector& other) const {
+  if (num_spilled_ == 0l && other.num_spilled_ == 0l) {
+    return (batch_stats_ == other.batch_stats_ && totals_ == other.totals_);
+  }
+  std::vector<PasteStats> stats, other_stats;
+  VisitBatchStats([&](const PasteStats& s) {stats.push_back(s);});
+  other.VisitBatchStats([&](const PasteStats& s) {other_stats.push_back(s);});
+  return (stats == other_stats && totals_ == other.totals_);
+}
+
 // StatsCollector::DebugString
 //
 std::string StatsCollector::DebugString() const {
   std::stringstream ss;
   ss << '{'
-     << "batch_stats: [";
+     << "totals: " << totals_.DebugString()
+     << ", batch_stats: [";
   if (batch_stats_.size() > 0) {
     ss << batch_stats_.at(0).DebugString();
     for (int i = 1; i < static_cast<int>(batch_stats_.size()); ++i) {
       ss << ',' << batch_stats_.at(i).DebugString();
     }
   }
-  ss << "]}";
+  ss << "], num_spilled: " << num_spilled_ << '}';
   return ss.str();
 }
 
+// StatsCollector::VisitBatchStats
+//
+void StatsCollector::VisitBatchStats(
+    const std::function<void(const PasteStats&)>& visit) const {
+  if (spill_file_ != nullptr) {
+    std::FILE* file{spill_file_.get()};
+    if (std::fseek(file, 0l, SEEK_SET) != 0) {
+      throw exceptions::ReadError("Unable to read spilled statistics.");
+    }
+    std::string record;
+    for (long i = 0l; i < num_spilled_; ++i) {
+      std::uint64_t length;
+      if (std::fread(&length, sizeof(length), 1, file) != 1) {
+        throw exceptions::ReadError("Unable to read spilled statistics.");
+      }
+      record.resize(length);
+      if (std::fread(record.data(), 1, length, file) != length) {
+        throw exceptions::ReadError("Unable to read spilled statistics.");
+      }
+      std::stringstream ss{record};
+      visit(ReadStatsState(ss));
+    }
+  }
+  for (const PasteStats& s : batch_stats_) {
+    visit(s);
+  }
+}
+
 } // namespace paste_alignments
\ No newline at end of file
@@ -0,0 +1,174 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "streaming.h"
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "exceptions.h"
+
+namespace paste_alignments {
+
+// PasteStreamedBatch helpers.
+//
+namespace {
+
+// Consecutive alignments of a batch sorted by query start.
+//
+struct StreamPart {
+
+  // The part's alignments in input order.
+  //
+  std::vector<Alignment> alignments;
+
+  // Sum of the positive raw scores of the part's alignments.
+  //
+  double score_sum{0.0};
+
+  // Whether alignments of the batch precede the part.
+  //
+  bool preceded{false};
+
+  // Gap between the query start of the part's first alignment and the query
+  // ends of all preceding alignments. Only meaningful if `preceded` is set.
+  //
+  int left_gap{0};
+
+  // Whether the part's left boundary was counted as a window overflow.
+  //
+  bool overflowed{false};
+};
+
+} // namespace
+
+// PasteStreamedBatch
+//
+int PasteStreamedBatch(
+    AlignmentReader& reader, const ScoringSystem& scoring_system,
+    const PasteParameters& paste_parameters,
+    const std::function<void(AlignmentBatch, bool)>& emit) {
+  if (paste_parameters.stream_window <= 0) {
+    std::stringstream error_message;
+    error_message << "Stream window must be positive, but is: "
+                  << paste_parameters.stream_window << '.';
+    throw exceptions::OutOfRange(error_message.str());
+  }
+  if (reader.EndOfData()) {
+    throw exceptions::ReadError("Attempted to read more alignments when end of"
+                                " data was reached.");
+  }
+  std::string qseqid{reader.NextQseqid()}, sseqid{reader.NextSseqid()};
+  std::deque<StreamPart> parts;
+  int num_held{0}, num_overflows{0}, last_qstart{0};
+  int max_qend{std::numeric_limits<int>::min()};
+  bool first_alignment{true}, first_part{true};
+
+  // Pastes the first held part and passes it on.
+  auto emit_front = [&]() {
+    AlignmentBatch batch{qseqid, sseqid};
+    num_held -= static_cast<int>(parts.front().alignments.size());
+    batch.ResetAlignments(std::move(parts.front().alignments),
+                          paste_parameters);
+    parts.pop_front();
+    batch.PasteAlignments(scoring_system, paste_parameters);
+    emit(std::move(batch), first_part);
+    first_part = false;
+  };
+
+  while (!reader.EndOfData() && reader.NextQseqid() == qseqid
+         && reader.NextSseqid() == sseqid) {
+    long id{reader.NextAlignmentId()};
+    Alignment alignment{reader.ReadAlignment(scoring_system,
+                                             paste_parameters)};
+
+    // Begin a new part if the open part cannot reach the alignment, or if the
+    // previous part was pasted because it exceeded the window.
+    if (first_alignment) {
+      parts.emplace_back();
+      first_alignment = false;
+    } else {
+      if (alignment.Qstart() < last_qstart) {
+        std::stringstream error_message;
+        error_message << "Streaming requires alignments sorted by query start"
+                      << " within each batch, but row " << id
+                      << " precedes the query start of the previous row.";
+        throw exceptions::ReadError(error_message.str());
+      }
+      int gap{alignment.Qstart() - max_qend - 1};
+      if (parts.empty()
+          || (gap >= 0 && gap > PastingDistanceBound(parts.back().score_sum,
+                                                     scoring_system,
+                                                     paste_parameters))) {
+        parts.emplace_back();
+        parts.back().preceded = true;
+        parts.back().left_gap = gap;
+        parts.back().overflowed = (parts.size() == 1);
+      }
+    }
+    last_qstart = alignment.Qstart();
+    max_qend = std::max(max_qend, alignment.Qend());
+    parts.back().score_sum += std::max(0.0, static_cast<double>(
+        alignment.RawScore()));
+    parts.back().alignments.push_back(std::move(alignment));
+    ++num_held;
+
+    // Merge the open part into its predecessor while pasting might reach
+    // across its left boundary.
+    while (parts.back().preceded
+           && parts.back().left_gap <= PastingDistanceBound(
+               parts.back().score_sum, scoring_system, paste_parameters)) {
+      if (parts.size() == 1) {
+        if (!parts.back().overflowed) {
+          ++num_overflows;
+          parts.back().overflowed = true;
+        }
+        break;
+      }
+      StreamPart open{std::move(parts.back())};
+      parts.pop_back();
+      parts.back().score_sum += open.score_sum;
+      parts.back().alignments.insert(
+          parts.back().alignments.end(),
+          std::make_move_iterator(open.alignments.begin()),
+          std::make_move_iterator(open.alignments.end()));
+    }
+
+    // Paste parts until the held alignments fit the window.
+    while (num_held > paste_parameters.stream_window) {
+      if (parts.size() == 1) {
+        ++num_overflows;
+      }
+      emit_front();
+    }
+  }
+  while (!parts.empty()) {
+    emit_front();
+  }
+  return num_overflows;
+}
+
+} // namespace paste_alignments
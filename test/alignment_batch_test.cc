@@ -28,6 +28,7 @@
 
 #include <algorithm>
 #include <random>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
@@ -35,7 +36,13 @@
 //
 // Test correctness for:
 // * ResetAlignments
+// * UpdateSimilarityMeasures
+// * Removed
 // * PasteAlignments
+// * StrandQstartSorted
+// * StrandQendSorted
+// * NumSeeds
+// * NumPrunedSeeds
 // 
 // Test invariants for:
 // * ResetAlignments
@@ -993,6 +1000,153 @@ SCENARIO("Test invariant preservation by AlignmentBatch::ResetAlignments"
   }
 }
 
+SCENARIO("Test correctness of AlignmentBatch::UpdateSimilarityMeasures.",
+         "[AlignmentBatch][UpdateSimilarityMeasures][correctness]") {
+  PasteParameters paste_parameters;
+  std::vector<std::vector<std::string_view>> fields{
+      {"101", "125", "1101", "1125", "24", "1", "0", "0",
+       "10000", "100000", "25",
+       "GCCCCAAAATTCCCCAAAATTCCCC", "ACCCCAAAATTCCCCAAAATTCCCC"},
+      {"101", "150", "1001", "1050", "40", "10", "0", "0",
+       "10000", "100000", "50",
+       "GGGGGGGGGGCCCCAAAATTCCCCAAAATTCCCCAAAATTCCCCAAAATT",
+       "AAAAAAAAAACCCCAAAATTCCCCAAAATTCCCCAAAATTCCCCAAAATT"},
+      {"101", "120", "1131", "1150", "20", "0", "0", "0",
+       "10000", "100000", "20",
+       "CCCCAAAATTCCCCAAAATT", "CCCCAAAATTCCCCAAAATT"}};
+
+  GIVEN("A batch created under one scoring system.") {
+    ScoringSystem first_scoring{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+    ScoringSystem second_scoring{ScoringSystem::Create(200000l, 2, 3, 0, 0)};
+    std::vector<Alignment> first_alignments, second_alignments;
+    for (int i = 0; i < static_cast<int>(fields.size()); ++i) {
+      first_alignments.push_back(Alignment::FromStringFields(
+          i, fields.at(i), first_scoring, paste_parameters));
+      second_alignments.push_back(Alignment::FromStringFields(
+          i, fields.at(i), second_scoring, paste_parameters));
+    }
+    AlignmentBatch batch{"qseqid", "sseqid"};
+    batch.ResetAlignments(first_alignments, paste_parameters);
+
+    WHEN("Similarity measures are updated under another scoring system.") {
+      batch.UpdateSimilarityMeasures(second_scoring, paste_parameters);
+
+      THEN("The batch equals one created under the other scoring system.") {
+        AlignmentBatch expected{"qseqid", "sseqid"};
+        expected.ResetAlignments(second_alignments, paste_parameters);
+        CHECK(batch == expected);
+        CHECK(batch.ScoreSorted() == std::vector<int>{1, 0, 2});
+      }
+    }
+  }
+}
+
+SCENARIO("Test correctness of removal of redundant alignments by"
+         " AlignmentBatch::ResetAlignments.",
+         "[AlignmentBatch][ResetAlignments][Removed][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::vector<std::vector<std::string_view>> fields{
+      // score 20
+      {"101", "120", "1101", "1120", "20", "0", "0", "0",
+       "10000", "100000", "20"},
+      // duplicate of alignment 1
+      {"101", "120", "1101", "1120", "20", "0", "0", "0",
+       "10000", "100000", "20"},
+      // score 10, contained in alignment 1 on the same diagonal
+      {"105", "114", "1105", "1114", "10", "0", "0", "0",
+       "10000", "100000", "10"},
+      // duplicate of alignment 1
+      {"101", "120", "1101", "1120", "20", "0", "0", "0",
+       "10000", "100000", "20"},
+      // same intervals as alignment 1 on the minus strand
+      {"101", "120", "1120", "1101", "20", "0", "0", "0",
+       "10000", "100000", "20"},
+      // contained in alignment 1 on another diagonal
+      {"105", "114", "1106", "1115", "10", "0", "0", "0",
+       "10000", "100000", "10"},
+      // score 10
+      {"3001", "3040", "4001", "4040", "30", "10", "0", "0",
+       "10000", "100000", "40"},
+      // score 16, contained in alignment 7 with a larger score
+      {"3005", "3020", "4005", "4020", "16", "0", "0", "0",
+       "10000", "100000", "16"}};
+  std::vector<Alignment> alignments;
+  for (int i = 0; i < static_cast<int>(fields.size()); ++i) {
+    alignments.push_back(Alignment::FromStringFields(
+        i + 1, fields.at(i), scoring_system, paste_parameters));
+  }
+
+  GIVEN("Parameters requesting removal of redundant alignments.") {
+    paste_parameters.remove_redundant = true;
+    AlignmentBatch batch{"qseqid", "sseqid"};
+    batch.ResetAlignments(alignments, paste_parameters);
+
+    THEN("Duplicates collapse to the smallest identifier and contained"
+         " alignments with smaller scores are removed.") {
+      CHECK(batch.Removed() == std::vector<std::pair<int,int>>{
+                                   {2, 1}, {3, 1}, {4, 1}});
+      std::vector<int> remaining;
+      for (const Alignment& a : batch.Alignments()) {
+        remaining.push_back(a.Id());
+      }
+      CHECK(remaining == std::vector<int>{1, 5, 6, 7, 8});
+    }
+
+    THEN("The batch equals one created from the remaining alignments.") {
+      std::vector<Alignment> remaining;
+      for (int i : {0, 4, 5, 6, 7}) {
+        remaining.push_back(alignments.at(i));
+      }
+      AlignmentBatch expected{"qseqid", "sseqid"};
+      expected.ResetAlignments(remaining, PasteParameters{});
+      CHECK(batch.Alignments() == expected.Alignments());
+      CHECK(batch.ScoreSorted() == expected.ScoreSorted());
+      CHECK(batch.QstartSorted() == expected.QstartSorted());
+      CHECK(batch.QendSorted() == expected.QendSorted());
+    }
+  }
+
+  GIVEN("Parameters not requesting removal of redundant alignments.") {
+    AlignmentBatch batch{"qseqid", "sseqid"};
+    batch.ResetAlignments(alignments, paste_parameters);
+
+    THEN("No alignment is removed.") {
+      CHECK(batch.Removed().empty());
+      CHECK(batch.Alignments().size() == alignments.size());
+    }
+  }
+
+  GIVEN("A contained alignment behind a low-scoring alignment reaching"
+        " further on the same diagonal.") {
+    paste_parameters.remove_redundant = true;
+    std::vector<std::vector<std::string_view>> shadowed_fields{
+        // score 100
+        {"1", "100", "1001", "1100", "100", "0", "0", "0",
+         "10000", "100000", "100"},
+        // negative score, reaching furthest in query
+        {"2", "200", "1002", "1200", "1", "198", "0", "0",
+         "10000", "100000", "199"},
+        // score 46, contained in alignment 1
+        {"5", "50", "1005", "1050", "46", "0", "0", "0",
+         "10000", "100000", "46"}};
+    std::vector<Alignment> shadowed;
+    for (int i = 0; i < static_cast<int>(shadowed_fields.size()); ++i) {
+      shadowed.push_back(Alignment::FromStringFields(
+          i + 1, shadowed_fields.at(i), scoring_system, paste_parameters));
+    }
+    AlignmentBatch batch{"qseqid", "sseqid"};
+    batch.ResetAlignments(shadowed, paste_parameters);
+
+    THEN("The contained alignment is only compared to the alignment reaching"
+         " furthest and remains.") {
+      CHECK(batch.Removed().empty());
+      CHECK(batch.Alignments().size() == shadowed.size());
+    }
+  }
+}
+
 SCENARIO("Test exceptions thrown by"
          " AlignmentBatch::AlignmentBatch(string_view, string_view).",
          "[AlignmentBatch][AlignmentBatch(string_view, string_view)]"
@@ -4432,6 +4586,681 @@ SCENARIO("Test correctness of AlignmentBatch::PasteAlignments <aware>.",
   }
 }
 
+SCENARIO("Test correctness of seed pruning by AlignmentBatch::PasteAlignments.",
+         "[AlignmentBatch][PasteAlignments][NumSeeds][NumPrunedSeeds]"
+         "[correctness]") {
+  PasteParameters paste_parameters;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::vector<Alignment> alignments{
+      // score 20, pastable with the next alignment
+      Alignment::FromStringFields(0, {"101", "120", "1101", "1120",
+                                   "20", "0", "0", "0",
+                                   "10000", "100000", "20",
+                                   "CCCCAAAATTCCCCAAAATT",
+                                   "CCCCAAAATTCCCCAAAATT"},
+                                  scoring_system, paste_parameters),
+      // score 19
+      Alignment::FromStringFields(1, {"126", "145", "1126", "1145",
+                                   "19", "0", "0", "0",
+                                   "10000", "100000", "19",
+                                   "CCCCAAAATTCCCCAAAAT",
+                                   "CCCCAAAATTCCCCAAAAT"},
+                                  scoring_system, paste_parameters),
+      // score 18, far from all others
+      Alignment::FromStringFields(2, {"5001", "5018", "6001", "6018",
+                                   "18", "0", "0", "0",
+                                   "10000", "100000", "18",
+                                   "CCCCAAAATTCCCCAAAA",
+                                   "CCCCAAAATTCCCCAAAA"},
+                                  scoring_system, paste_parameters)};
+
+  GIVEN("A final score threshold only reachable by pasting.") {
+    paste_parameters.final_score_threshold = 25.0f;
+    AlignmentBatch batch{"qseqid", "sseqid"};
+    batch.ResetAlignments(alignments, paste_parameters);
+    batch.PasteAlignments(scoring_system, paste_parameters);
+
+    THEN("The isolated seed is pruned and the other is pasted.") {
+      CHECK(batch.NumSeeds() == 2);
+      CHECK(batch.NumPrunedSeeds() == 1);
+      CHECK(batch.Alignments().at(0).PastedIdentifiers()
+            == std::vector<int>{0, 1});
+      CHECK(batch.Alignments().at(0).IncludeInOutput());
+      CHECK_FALSE(batch.Alignments().at(2).IncludeInOutput());
+    }
+  }
+
+  GIVEN("A final score threshold no seed can reach.") {
+    paste_parameters.final_score_threshold = 100.0f;
+    AlignmentBatch batch{"qseqid", "sseqid"};
+    batch.ResetAlignments(alignments, paste_parameters);
+    batch.PasteAlignments(scoring_system, paste_parameters);
+
+    THEN("All seeds are pruned and nothing is pasted.") {
+      CHECK(batch.NumSeeds() == 3);
+      CHECK(batch.NumPrunedSeeds() == 3);
+      for (const Alignment& a : batch.Alignments()) {
+        CHECK(a.PastedIdentifiers().size() == 1);
+        CHECK_FALSE(a.IncludeInOutput());
+      }
+    }
+  }
+
+  GIVEN("A final score threshold satisfied by all alignments.") {
+    AlignmentBatch batch{"qseqid", "sseqid"};
+    batch.ResetAlignments(alignments, paste_parameters);
+    batch.PasteAlignments(scoring_system, paste_parameters);
+
+    THEN("No seed is pruned.") {
+      CHECK(batch.NumSeeds() == 2);
+      CHECK(batch.NumPrunedSeeds() == 0);
+    }
+  }
+}
+
+SCENARIO("Test correctness of AlignmentBatch::PasteAlignments <chain>.",
+         "[AlignmentBatch][PasteAlignments][chain][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  paste_parameters.engine = PastingEngine::kChain;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::vector<Alignment> alignments{
+      // plus strand chain 0, 1, 2 on one diagonal
+      Alignment::FromStringFields(0, {"101", "120", "1101", "1120",
+                                      "20", "0", "0", "0",
+                                      "10000", "100000", "20"},
+                                  scoring_system, paste_parameters),
+      Alignment::FromStringFields(1, {"126", "145", "1126", "1145",
+                                      "19", "0", "0", "0",
+                                      "10000", "100000", "19"},
+                                  scoring_system, paste_parameters),
+      Alignment::FromStringFields(2, {"151", "170", "1151", "1170",
+                                      "20", "0", "0", "0",
+                                      "10000", "100000", "20"},
+                                  scoring_system, paste_parameters),
+      // overlaps the chain in query on a distant diagonal
+      Alignment::FromStringFields(3, {"131", "160", "3131", "3160",
+                                      "30", "0", "0", "0",
+                                      "10000", "100000", "30"},
+                                  scoring_system, paste_parameters),
+      // minus strand chain 4, 5
+      Alignment::FromStringFields(4, {"301", "320", "2020", "2001",
+                                      "20", "0", "0", "0",
+                                      "10000", "100000", "20"},
+                                  scoring_system, paste_parameters),
+      Alignment::FromStringFields(5, {"326", "345", "1995", "1976",
+                                      "20", "0", "0", "0",
+                                      "10000", "100000", "20"},
+                                  scoring_system, paste_parameters),
+      // pasting onto the plus strand chain would lower the score too much
+      Alignment::FromStringFields(6, {"200", "209", "1200", "1209",
+                                      "10", "0", "0", "0",
+                                      "10000", "100000", "10"},
+                                  scoring_system, paste_parameters)};
+  AlignmentBatch batch{"qseqid", "sseqid"};
+
+  GIVEN("Thresholds satisfied by all chains.") {
+    batch.ResetAlignments(alignments, paste_parameters);
+    batch.PasteAlignments(scoring_system, paste_parameters);
+
+    THEN("Colinear chains are pasted and the rest is left alone.") {
+      Alignment plus_chain{alignments.at(0)}, minus_chain{alignments.at(4)};
+      plus_chain.PasteRight(alignments.at(1),
+                            GetConfiguration(plus_chain, alignments.at(1)),
+                            scoring_system, paste_parameters);
+      plus_chain.PasteRight(alignments.at(2),
+                            GetConfiguration(plus_chain, alignments.at(2)),
+                            scoring_system, paste_parameters);
+      minus_chain.PasteRight(alignments.at(5),
+                             GetConfiguration(minus_chain, alignments.at(5)),
+                             scoring_system, paste_parameters);
+      plus_chain.IncludeInOutput(true);
+      minus_chain.IncludeInOutput(true);
+      alignments.at(3).IncludeInOutput(true);
+      alignments.at(6).IncludeInOutput(true);
+      CHECK(batch.NumSeeds() == 4);
+      CHECK(batch.Alignments().at(0) == plus_chain);
+      CHECK(batch.Alignments().at(4) == minus_chain);
+      CHECK(batch.Alignments().at(3) == alignments.at(3));
+      CHECK(batch.Alignments().at(6) == alignments.at(6));
+      CHECK_FALSE(batch.Alignments().at(1).IncludeInOutput());
+      CHECK_FALSE(batch.Alignments().at(2).IncludeInOutput());
+      CHECK_FALSE(batch.Alignments().at(5).IncludeInOutput());
+    }
+  }
+
+  GIVEN("A gap tolerance exceeded by the shift to the distant diagonal.") {
+    paste_parameters.gap_tolerance = 0;
+    alignments.at(2) = Alignment::FromStringFields(
+        2, {"151", "170", "1152", "1171", "20", "0", "0", "0",
+            "10000", "100000", "20"},
+        scoring_system, paste_parameters);
+    batch.ResetAlignments(alignments, paste_parameters);
+    batch.PasteAlignments(scoring_system, paste_parameters);
+
+    THEN("Chains only extend along a diagonal.") {
+      CHECK(batch.Alignments().at(0).PastedIdentifiers()
+            == std::vector<int>{0, 1});
+      CHECK(batch.Alignments().at(2).PastedIdentifiers()
+            == std::vector<int>{2});
+      CHECK(batch.Alignments().at(2).IncludeInOutput());
+    }
+  }
+
+  GIVEN("A final score threshold no chain can reach.") {
+    paste_parameters.final_score_threshold = 100.0f;
+    batch.ResetAlignments(alignments, paste_parameters);
+    batch.PasteAlignments(scoring_system, paste_parameters);
+
+    THEN("Nothing is pasted or output.") {
+      CHECK(batch.NumSeeds() == 7);
+      for (const Alignment& alignment : batch.Alignments()) {
+        CHECK(alignment.PastedIdentifiers().size() == 1);
+        CHECK_FALSE(alignment.IncludeInOutput());
+      }
+    }
+  }
+}
+
+SCENARIO("Test correctness of AlignmentBatch::PasteAlignments <auto>.",
+         "[AlignmentBatch][PasteAlignments][Engine][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::mt19937 generator{5};
+
+  // Alignments near `num_clusters` loci of the query spaced 100000 apart, on
+  // both strands.
+  auto make_alignments = [&](int num_alignments, int num_clusters) {
+    std::vector<Alignment> result;
+    std::uniform_int_distribution<int> cluster(0, num_clusters - 1),
+                                       offset(1, 2000), length(10, 40),
+                                       diagonal(-3, 3), strand(0, 2);
+    for (int i = 0; i < num_alignments; ++i) {
+      int qstart{100000 * cluster(generator) + offset(generator)};
+      int len{length(generator)};
+      int sstart{qstart + 1000 + diagonal(generator)};
+      int mismatch{len / 8};
+      bool plus_strand{strand(generator) > 0};
+      std::string qs{std::to_string(qstart)},
+                  qe{std::to_string(qstart + len - 1)},
+                  ss{std::to_string(plus_strand ? sstart : 900000 - sstart)},
+                  se{std::to_string(plus_strand ? sstart + len - 1
+                                                : 900000 - sstart - len + 1)},
+                  nident{std::to_string(len - mismatch)},
+                  mm{std::to_string(mismatch)}, l{std::to_string(len)};
+      result.push_back(Alignment::FromStringFields(
+          i, {qs, qe, ss, se, nident, mm, "0", "0", "1000000", "1000000", l},
+          scoring_system, paste_parameters));
+    }
+    return result;
+  };
+
+  // Pastes `alignments` into `automatic` under the automatically chosen
+  // strategy and checks that the greedy strategy yields the same result.
+  auto paste_both = [&](const std::vector<Alignment>& alignments,
+                        AlignmentBatch& automatic) {
+    AlignmentBatch greedy{"qseqid", "sseqid"};
+    greedy.ResetAlignments(alignments, paste_parameters);
+    greedy.PasteAlignments(scoring_system, paste_parameters);
+    PasteParameters auto_parameters{paste_parameters};
+    auto_parameters.engine = PastingEngine::kAuto;
+    auto_parameters.num_threads = 4;
+    automatic.ResetAlignments(alignments, auto_parameters);
+    automatic.PasteAlignments(scoring_system, auto_parameters);
+    CHECK(greedy.Engine() == BatchEngine::kIndexedGreedy);
+    CHECK(automatic.Alignments() == greedy.Alignments());
+    CHECK(automatic.NumSeeds() == greedy.NumSeeds());
+  };
+
+  GIVEN("A tiny batch.") {
+    AlignmentBatch automatic{"qseqid", "sseqid"};
+    paste_both(make_alignments(12, 1), automatic);
+
+    THEN("It is pasted by brute force with the same result.") {
+      CHECK(automatic.Engine() == BatchEngine::kBruteForce);
+    }
+  }
+
+  GIVEN("A large batch with several clusters.") {
+    paste_parameters.final_score_threshold = 60.0f;
+    AlignmentBatch automatic{"qseqid", "sseqid"};
+    paste_both(make_alignments(3000, 6), automatic);
+
+    THEN("Clusters are pasted in parallel with the same result.") {
+      CHECK(automatic.Engine() == BatchEngine::kClusterParallel);
+    }
+  }
+
+  GIVEN("A large batch with a single cluster on one strand.") {
+    std::vector<Alignment> alignments;
+    for (const Alignment& alignment : make_alignments(3000, 1)) {
+      if (alignment.PlusStrand()) {
+        alignments.push_back(alignment);
+      }
+    }
+    AlignmentBatch automatic{"qseqid", "sseqid"};
+    paste_both(alignments, automatic);
+
+    THEN("It is pasted by the indexed greedy strategy.") {
+      CHECK(automatic.Engine() == BatchEngine::kIndexedGreedy);
+    }
+  }
+}
+
+SCENARIO("Test correctness of AlignmentBatch::PasteAlignments <budget>.",
+         "[AlignmentBatch][PasteAlignments][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::vector<Alignment> alignments;
+  for (int i = 0; i < 6; ++i) {
+    std::string qstart{std::to_string(101 + 24 * i)},
+                qend{std::to_string(120 + 24 * i)},
+                sstart{std::to_string(1101 + 24 * i)},
+                send{std::to_string(1120 + 24 * i)};
+    alignments.push_back(Alignment::FromStringFields(
+        i + 1, {qstart, qend, sstart, send, "20", "0", "0", "0", "10000",
+                "100000", "20"},
+        scoring_system, paste_parameters));
+  }
+  AlignmentBatch unlimited{"qseqid", "sseqid"};
+  unlimited.ResetAlignments(alignments, paste_parameters);
+  unlimited.PasteAlignments(scoring_system, paste_parameters);
+
+  GIVEN("A budget large enough for the batch.") {
+    paste_parameters.candidate_budget = unlimited.NumScannedCandidates();
+    AlignmentBatch batch{"qseqid", "sseqid"};
+    batch.ResetAlignments(alignments, paste_parameters);
+    batch.PasteAlignments(scoring_system, paste_parameters);
+
+    THEN("The batch is pasted as without budget.") {
+      CHECK(unlimited.NumUnextendedSeeds() == 0);
+      CHECK(batch.Alignments() == unlimited.Alignments());
+      CHECK(batch.NumScannedCandidates() == unlimited.NumScannedCandidates());
+    }
+  }
+
+  GIVEN("A budget exhausted while pasting.") {
+    paste_parameters.candidate_budget = 2l;
+    AlignmentBatch batch{"qseqid", "sseqid"};
+    batch.ResetAlignments(alignments, paste_parameters);
+    batch.PasteAlignments(scoring_system, paste_parameters);
+
+    THEN("No more candidates are scanned and the batch is degraded.") {
+      CHECK(batch.NumScannedCandidates() == 2l);
+      CHECK(batch.NumUnextendedSeeds() > 0);
+    }
+
+    THEN("Every alignment is output, on its own if not pasted.") {
+      std::vector<int> ids;
+      int num_output{0};
+      for (const Alignment& alignment : batch.Alignments()) {
+        if (alignment.IncludeInOutput()) {
+          ++num_output;
+          ids.insert(ids.end(), alignment.PastedIdentifiers().begin(),
+                     alignment.PastedIdentifiers().end());
+        }
+      }
+      std::sort(ids.begin(), ids.end());
+      CHECK(ids == std::vector<int>{1, 2, 3, 4, 5, 6});
+      CHECK(num_output > 1);
+    }
+  }
+}
+
+SCENARIO("Test correctness of AlignmentBatch::PasteAlignments <limit>.",
+         "[AlignmentBatch][PasteAlignments][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+
+  // Returns the positions of the alignments of `batch` marked as final.
+  auto included = [](const AlignmentBatch& batch) {
+    std::vector<int> result;
+    for (int i = 0; i < static_cast<int>(batch.Size()); ++i) {
+      if (batch.Alignments().at(i).IncludeInOutput()) {
+        result.push_back(i);
+      }
+    }
+    return result;
+  };
+
+  GIVEN("Alignments too far apart to be pasted.") {
+    // Alignment i consists of `lengths.at(i)` identities.
+    std::vector<int> lengths{20, 25, 29, 21, 25, 27, 22, 23, 28, 24};
+    std::vector<Alignment> alignments;
+    for (int i = 0; i < static_cast<int>(lengths.size()); ++i) {
+      int qstart{101 + 100000 * i}, length{lengths.at(i)};
+      alignments.push_back(Alignment::FromStringFields(
+          i + 1, {std::to_string(qstart), std::to_string(qstart + length - 1),
+                  std::to_string(qstart + 1000),
+                  std::to_string(qstart + 999 + length),
+                  std::to_string(length), "0", "0", "0", "10000000",
+                  "10000000", std::to_string(length)},
+          scoring_system, paste_parameters));
+    }
+
+    THEN("The alignments of largest score are output under each engine.") {
+      for (PastingEngine engine : {PastingEngine::kGreedy,
+                                   PastingEngine::kChain,
+                                   PastingEngine::kAuto}) {
+        paste_parameters.engine = engine;
+        paste_parameters.max_alignments_per_batch = 3;
+        AlignmentBatch batch{"qseqid", "sseqid"};
+        batch.ResetAlignments(alignments, paste_parameters);
+        batch.PasteAlignments(scoring_system, paste_parameters);
+        CHECK(included(batch) == std::vector<int>{2, 5, 8});
+      }
+    }
+
+    THEN("Ties are broken by position as in ScoreSorted.") {
+      paste_parameters.max_alignments_per_batch = 4;
+      AlignmentBatch batch{"qseqid", "sseqid"};
+      batch.ResetAlignments(alignments, paste_parameters);
+      batch.PasteAlignments(scoring_system, paste_parameters);
+      CHECK(included(batch) == std::vector<int>{1, 2, 5, 8});
+    }
+
+    THEN("A limit above the number of output alignments has no effect.") {
+      paste_parameters.max_alignments_per_batch = 20;
+      AlignmentBatch batch{"qseqid", "sseqid"}, unlimited{"qseqid", "sseqid"};
+      batch.ResetAlignments(alignments, paste_parameters);
+      batch.PasteAlignments(scoring_system, paste_parameters);
+      paste_parameters.max_alignments_per_batch = 0;
+      unlimited.ResetAlignments(alignments, paste_parameters);
+      unlimited.PasteAlignments(scoring_system, paste_parameters);
+      CHECK(batch.Alignments() == unlimited.Alignments());
+    }
+  }
+
+  GIVEN("A dense batch of pastable alignments.") {
+    std::mt19937 generator{7};
+    std::uniform_int_distribution<int> offset(1, 3000), length(10, 40),
+                                       diagonal(-3, 3);
+    std::vector<Alignment> alignments;
+    for (int i = 0; i < 2000; ++i) {
+      int qstart{offset(generator)}, len{length(generator)};
+      int sstart{qstart + 1000 + diagonal(generator)};
+      int mismatch{len / 8};
+      alignments.push_back(Alignment::FromStringFields(
+          i, {std::to_string(qstart), std::to_string(qstart + len - 1),
+              std::to_string(sstart), std::to_string(sstart + len - 1),
+              std::to_string(len - mismatch), std::to_string(mismatch), "0",
+              "0", "1000000", "1000000", std::to_string(len)},
+          scoring_system, paste_parameters));
+    }
+    AlignmentBatch unlimited{"qseqid", "sseqid"};
+    unlimited.ResetAlignments(alignments, paste_parameters);
+    unlimited.PasteAlignments(scoring_system, paste_parameters);
+    paste_parameters.max_alignments_per_batch = 4;
+    AlignmentBatch limited{"qseqid", "sseqid"};
+    limited.ResetAlignments(alignments, paste_parameters);
+    limited.PasteAlignments(scoring_system, paste_parameters);
+
+    THEN("Only the limit is output and fewer candidates are scanned.") {
+      REQUIRE(included(unlimited).size() > 4);
+      CHECK(included(limited).size() == 4);
+      CHECK(limited.NumScannedCandidates()
+            < unlimited.NumScannedCandidates());
+    }
+
+    THEN("The automatically chosen strategy yields the same output.") {
+      PasteParameters auto_parameters{paste_parameters};
+      auto_parameters.engine = PastingEngine::kAuto;
+      auto_parameters.num_threads = 4;
+      AlignmentBatch automatic{"qseqid", "sseqid"};
+      automatic.ResetAlignments(alignments, auto_parameters);
+      automatic.PasteAlignments(scoring_system, auto_parameters);
+      CHECK(automatic.Engine() != BatchEngine::kClusterParallel);
+      CHECK(automatic.Alignments() == limited.Alignments());
+    }
+  }
+}
+
+SCENARIO("Test correctness of AlignmentBatch::PasteAlignments <evalue>.",
+         "[AlignmentBatch][PasteAlignments][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  int qlen{10000000};
+
+  // Returns the positions of the alignments of `batch` marked as final.
+  auto included = [](const AlignmentBatch& batch) {
+    std::vector<int> result;
+    for (int i = 0; i < static_cast<int>(batch.Size()); ++i) {
+      if (batch.Alignments().at(i).IncludeInOutput()) {
+        result.push_back(i);
+      }
+    }
+    return result;
+  };
+
+  GIVEN("Alignments too far apart to be pasted.") {
+    // Alignment i consists of `lengths.at(i)` identities.
+    std::vector<int> lengths{20, 25, 29, 21, 25, 27, 22, 23, 28, 24};
+    std::vector<Alignment> alignments;
+    for (int i = 0; i < static_cast<int>(lengths.size()); ++i) {
+      int qstart{101 + 100000 * i}, length{lengths.at(i)};
+      alignments.push_back(Alignment::FromStringFields(
+          i + 1, {std::to_string(qstart), std::to_string(qstart + length - 1),
+                  std::to_string(qstart + 1000),
+                  std::to_string(qstart + 999 + length),
+                  std::to_string(length), "0", "0", "0",
+                  std::to_string(qlen), "10000000", std::to_string(length)},
+          scoring_system, paste_parameters));
+    }
+
+    WHEN("An evalue threshold is set.") {
+      paste_parameters.final_evalue = scoring_system.Evalue(
+          25.0f, qlen, paste_parameters);
+      AlignmentBatch batch{"qseqid", "sseqid"};
+      batch.ResetAlignments(alignments, paste_parameters);
+      batch.PasteAlignments(scoring_system, paste_parameters);
+
+      THEN("Exactly the alignments satisfying it are output.") {
+        CHECK(included(batch) == std::vector<int>{1, 2, 4, 5, 8});
+      }
+    }
+
+    WHEN("A bitscore threshold is set.") {
+      paste_parameters.final_bitscore = scoring_system.Bitscore(
+          27.0f, paste_parameters);
+      AlignmentBatch batch{"qseqid", "sseqid"};
+      batch.ResetAlignments(alignments, paste_parameters);
+      batch.PasteAlignments(scoring_system, paste_parameters);
+
+      THEN("Exactly the alignments satisfying it are output.") {
+        CHECK(included(batch) == std::vector<int>{2, 5, 8});
+      }
+    }
+
+    WHEN("Both are set along with a raw score threshold.") {
+      paste_parameters.final_evalue = scoring_system.Evalue(
+          25.0f, qlen, paste_parameters);
+      paste_parameters.final_bitscore = scoring_system.Bitscore(
+          21.0f, paste_parameters);
+      paste_parameters.final_score_threshold = 23.0f;
+      AlignmentBatch batch{"qseqid", "sseqid"};
+      batch.ResetAlignments(alignments, paste_parameters);
+      batch.PasteAlignments(scoring_system, paste_parameters);
+
+      THEN("The strictest threshold applies.") {
+        CHECK(included(batch) == std::vector<int>{1, 2, 4, 5, 8});
+      }
+    }
+  }
+
+  GIVEN("Alignments scoring around the converted cutoff.") {
+    // Raw scores 25, 24.5 and 25.5; one gap extension costs 2.5.
+    std::vector<std::vector<int>> counts{{25, 0, 0, 25}, {27, 1, 1, 28},
+                                         {28, 1, 1, 29}};
+    std::vector<Alignment> alignments;
+    for (int i = 0; i < static_cast<int>(counts.size()); ++i) {
+      int qstart{101 + 100000 * i}, length{counts.at(i).at(3)};
+      int slength{length - counts.at(i).at(2)};
+      alignments.push_back(Alignment::FromStringFields(
+          i + 1, {std::to_string(qstart), std::to_string(qstart + length - 1),
+                  std::to_string(qstart + 1000),
+                  std::to_string(qstart + 999 + slength),
+                  std::to_string(counts.at(i).at(0)), "0",
+                  std::to_string(counts.at(i).at(1)),
+                  std::to_string(counts.at(i).at(2)), std::to_string(qlen),
+                  "10000000", std::to_string(length)},
+          scoring_system, paste_parameters));
+    }
+    // Large enough for 24.5 to be fuzzily equal to 25.
+    paste_parameters.float_epsilon = 0.05f;
+    REQUIRE(alignments.at(1).RawScore() == 24.5f);
+
+    WHEN("An evalue threshold is set.") {
+      paste_parameters.final_evalue = scoring_system.Evalue(
+          25.0f, qlen, paste_parameters);
+      REQUIRE(scoring_system.EvalueScoreThreshold(
+                  paste_parameters.final_evalue, qlen, paste_parameters)
+              == 25.0f);
+      AlignmentBatch batch{"qseqid", "sseqid"};
+      batch.ResetAlignments(alignments, paste_parameters);
+      batch.PasteAlignments(scoring_system, paste_parameters);
+
+      THEN("The alignment one step below the cutoff is excluded.") {
+        CHECK(included(batch) == std::vector<int>{0, 2});
+      }
+    }
+
+    WHEN("A bitscore threshold is set.") {
+      paste_parameters.final_bitscore = scoring_system.Bitscore(
+          25.0f, paste_parameters);
+      REQUIRE(scoring_system.BitscoreScoreThreshold(
+                  paste_parameters.final_bitscore, paste_parameters)
+              == 25.0f);
+      for (PastingEngine engine : {PastingEngine::kGreedy,
+                                   PastingEngine::kChain}) {
+        paste_parameters.engine = engine;
+        AlignmentBatch batch{"qseqid", "sseqid"};
+        batch.ResetAlignments(alignments, paste_parameters);
+        batch.PasteAlignments(scoring_system, paste_parameters);
+
+        THEN("The alignment one step below the cutoff is excluded.") {
+          CHECK(included(batch) == std::vector<int>{0, 2});
+        }
+      }
+    }
+  }
+
+  GIVEN("A dense batch of pastable alignments.") {
+    std::mt19937 generator{11};
+    std::uniform_int_distribution<int> offset(1, 3000), length(10, 40),
+                                       diagonal(-3, 3);
+    std::vector<Alignment> alignments;
+    for (int i = 0; i < 2000; ++i) {
+      int qstart{offset(generator)}, len{length(generator)};
+      int sstart{qstart + 1000 + diagonal(generator)};
+      int mismatch{len / 8};
+      alignments.push_back(Alignment::FromStringFields(
+          i, {std::to_string(qstart), std::to_string(qstart + len - 1),
+              std::to_string(sstart), std::to_string(sstart + len - 1),
+              std::to_string(len - mismatch), std::to_string(mismatch), "0",
+              "0", std::to_string(qlen), "1000000", std::to_string(len)},
+          scoring_system, paste_parameters));
+    }
+
+    THEN("Pasting equals pasting with the equivalent raw score cutoff.") {
+      for (PastingEngine engine : {PastingEngine::kGreedy,
+                                   PastingEngine::kChain}) {
+        PasteParameters evalue_parameters{paste_parameters};
+        evalue_parameters.engine = engine;
+        evalue_parameters.final_evalue = 1e-20;
+        PasteParameters score_parameters{evalue_parameters};
+        score_parameters.final_evalue = 0.0;
+        score_parameters.final_score_cutoff =
+            scoring_system.EvalueScoreThreshold(1e-20, qlen, paste_parameters);
+        AlignmentBatch evalue_batch{"qseqid", "sseqid"},
+                       score_batch{"qseqid", "sseqid"};
+        evalue_batch.ResetAlignments(alignments, evalue_parameters);
+        evalue_batch.PasteAlignments(scoring_system, evalue_parameters);
+        score_batch.ResetAlignments(alignments, score_parameters);
+        score_batch.PasteAlignments(scoring_system, score_parameters);
+        CHECK(evalue_batch.Alignments() == score_batch.Alignments());
+        for (int i : included(evalue_batch)) {
+          CHECK(scoring_system.Evalue(
+                    evalue_batch.Alignments().at(i).RawScore(), qlen,
+                    paste_parameters)
+                <= 1e-20);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Test correctness of AlignmentBatch::PasteAlignments <strands>.",
+         "[AlignmentBatch][PasteAlignments][StrandQstartSorted]"
+         "[StrandQendSorted][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::vector<Alignment> alignments;
+  for (int i = 0; i < 3; ++i) {
+    alignments.push_back(Alignment::FromStringFields(
+        2 * i + 1, {std::to_string(101 + 24 * i), std::to_string(120 + 24 * i),
+                    std::to_string(1101 + 24 * i), std::to_string(1120 + 24 * i),
+                    "20", "0", "0", "0", "10000", "100000", "20"},
+        scoring_system, paste_parameters));
+    alignments.push_back(Alignment::FromStringFields(
+        2 * i + 2, {std::to_string(113 + 24 * i), std::to_string(132 + 24 * i),
+                    std::to_string(5120 - 24 * i), std::to_string(5101 - 24 * i),
+                    "20", "0", "0", "0", "10000", "100000", "20"},
+        scoring_system, paste_parameters));
+  }
+
+  GIVEN("Colinear alignments on both strands interleaved in query.") {
+    AlignmentBatch batch{"qseqid", "sseqid"};
+    batch.ResetAlignments(alignments, paste_parameters);
+
+    THEN("Each strand's orders are subsequences of the combined orders.") {
+      for (bool plus_strand : {true, false}) {
+        std::vector<std::pair<int,int>> qstart_sorted, qend_sorted;
+        for (const std::pair<int,int>& p : batch.QstartSorted()) {
+          if (batch.Alignments().at(p.second).PlusStrand() == plus_strand) {
+            qstart_sorted.push_back(p);
+          }
+        }
+        for (const std::pair<int,int>& p : batch.QendSorted()) {
+          if (batch.Alignments().at(p.second).PlusStrand() == plus_strand) {
+            qend_sorted.push_back(p);
+          }
+        }
+        CHECK(batch.StrandQstartSorted(plus_strand).size() == 3);
+        CHECK(batch.StrandQstartSorted(plus_strand) == qstart_sorted);
+        CHECK(batch.StrandQendSorted(plus_strand) == qend_sorted);
+      }
+    }
+
+    THEN("The alignments of each strand are pasted separately.") {
+      batch.PasteAlignments(scoring_system, paste_parameters);
+      std::vector<Alignment> output;
+      for (const Alignment& alignment : batch.Alignments()) {
+        if (alignment.IncludeInOutput()) {
+          output.push_back(alignment);
+        }
+      }
+      REQUIRE(output.size() == 2);
+      CHECK(output.at(0).PastedIdentifiers() == std::vector<int>{1, 3, 5});
+      CHECK(output.at(0).Qstart() == 101);
+      CHECK(output.at(0).Qend() == 168);
+      CHECK(output.at(0).Sstart() == 1101);
+      CHECK(output.at(0).Send() == 1168);
+      CHECK(output.at(1).PastedIdentifiers() == std::vector<int>{2, 4, 6});
+      CHECK(output.at(1).Qstart() == 113);
+      CHECK(output.at(1).Qend() == 180);
+      CHECK(output.at(1).Sstart() == 5053);
+      CHECK(output.at(1).Send() == 5120);
+      CHECK(output.at(1).CanonicalSstart() == 94881);
+      CHECK(output.at(1).CanonicalSend() == 94948);
+    }
+  }
+}
+
 SCENARIO("Test correctness of AlignmentBatch::PasteAlignments <blind>.",
          "[AlignmentBatch][PasteAlignments][correctness][blind]") {
   PasteParameters paste_parameters;
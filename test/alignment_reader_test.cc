@@ -26,7 +26,9 @@
 
 #include "string_conversions.h" // include after catch.h
 
+#include <chrono>
 #include <limits>
+#include <thread>
 
 #include "exceptions.h"
 
@@ -34,6 +36,9 @@
 //
 // Test correctness for:
 // * ReadBatch
+// * EndOfData
+// * ReadRawBatch(MemoryBudget&, long&)
+// * ReadAlignment
 //
 // Test exceptions for:
 // * FromIStream
@@ -460,6 +465,20 @@ SCENARIO("Test correctness of AlignmentReader::ReadBatch.",
           CHECK(computed_batch == blind_expected_batches.at(i));
         }
       }
+
+      THEN("Batches viewing their sequences equal packed batches.") {
+        PasteParameters view_paste_parameters{paste_parameters};
+        view_paste_parameters.sequence_views = true;
+        for (int i = 0; i < static_cast<int>(sequence_identifiers.size()); ++i) {
+          AlignmentBatch computed_batch{reader.ReadBatch(
+              scoring_system, view_paste_parameters)};
+          CHECK(computed_batch == expected_batches.at(i));
+          for (const Alignment& alignment : computed_batch.Alignments()) {
+            CHECK(alignment.PackedQseq().IsView());
+            CHECK(alignment.PackedSseq().IsView());
+          }
+        }
+      }
     }
 
     WHEN("Input stream has exact number of columns and trailing newline.") {
@@ -541,6 +560,134 @@ SCENARIO("Test correctness of AlignmentReader::ReadBatch.",
         }
       }
     }
+
+    WHEN("Input stream contains a single row.") {
+      std::stringstream row;
+      row << "qseq1\tsseq1";
+      for (const std::string& field : alignment_input_data.at(0)) {
+        row << '\t' << field;
+      }
+      std::unique_ptr<std::istream> is{new std::stringstream{row.str()}};
+      AlignmentReader reader{AlignmentReader::FromIStream(std::move(is))};
+      AlignmentBatch expected_batch{"qseq1", "sseq1"};
+      expected_batch.ResetAlignments(
+          MakeAlignments({alignment_input_data.at(0)}, 1, scoring_system,
+                         paste_parameters),
+          paste_parameters);
+
+      THEN("The row constitutes the only batch.") {
+        CHECK(reader.ReadBatch(scoring_system, paste_parameters)
+              == expected_batch);
+        CHECK(reader.EndOfData());
+      }
+    }
+
+    WHEN("The last batch of the input stream consists of its last row.") {
+      std::stringstream input;
+      input << kValidInput << "\nqseq5\tsseq5";
+      for (const std::string& field : alignment_input_data.at(0)) {
+        input << '\t' << field;
+      }
+      std::unique_ptr<std::istream> is{new std::stringstream{input.str()}};
+      AlignmentReader reader{AlignmentReader::FromIStream(std::move(is))};
+      AlignmentBatch expected_last_batch{"qseq5", "sseq5"};
+      expected_last_batch.ResetAlignments(
+          MakeAlignments({alignment_input_data.at(0)},
+                         1 + 10 * static_cast<int>(sequence_identifiers.size()),
+                         scoring_system,
+                         paste_parameters),
+          paste_parameters);
+
+      THEN("The last row is returned as the last batch.") {
+        for (int i = 0; i < static_cast<int>(sequence_identifiers.size()); ++i) {
+          AlignmentBatch computed_batch{reader.ReadBatch(scoring_system,
+                                                         paste_parameters)};
+          CHECK(computed_batch == expected_batches.at(i));
+          CHECK(!reader.EndOfData());
+        }
+        CHECK(reader.ReadBatch(scoring_system, paste_parameters)
+              == expected_last_batch);
+        CHECK(reader.EndOfData());
+      }
+    }
+  }
+}
+
+SCENARIO("Test correctness of AlignmentReader::ReadRawBatch with a budget.",
+         "[AlignmentReader][ReadRawBatch][correctness]") {
+
+  GIVEN("Two readers of the same input stream.") {
+    AlignmentReader reader{AlignmentReader::FromIStream(
+        std::unique_ptr<std::istream>{new std::stringstream{kValidInput}})};
+    AlignmentReader raw_reader{AlignmentReader::FromIStream(
+        std::unique_ptr<std::istream>{new std::stringstream{kValidInput}})};
+
+    THEN("An unlimited budget accounts the rows' memory.") {
+      MemoryBudget budget;
+      while (!raw_reader.EndOfData()) {
+        long acquired{0l};
+        RawBatch raw_batch{reader.ReadRawBatch(budget, acquired)};
+        CHECK(raw_batch == raw_reader.ReadRawBatch());
+        CHECK(acquired == budget.Acquired());
+        CHECK(acquired >= raw_batch.MemoryUsage());
+        budget.Release(acquired);
+      }
+      CHECK(reader.EndOfData());
+    }
+
+    THEN("Rows read while waiting for memory are restored in order.") {
+      MemoryBudget budget{100l};
+      while (!raw_reader.EndOfData()) {
+        budget.Acquire(100l);
+        std::thread releasing{[&]() {
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+          budget.Release(100l);
+        }};
+        long acquired{0l};
+        RawBatch raw_batch{reader.ReadRawBatch(budget, acquired)};
+        releasing.join();
+        CHECK(raw_batch == raw_reader.ReadRawBatch());
+        CHECK(acquired == budget.Acquired());
+        CHECK(acquired >= raw_batch.MemoryUsage());
+        budget.Release(acquired);
+      }
+      CHECK(reader.EndOfData());
+    }
+  }
+}
+
+SCENARIO("Test correctness of AlignmentReader::ReadAlignment.",
+         "[AlignmentReader][ReadAlignment][correctness]") {
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 1, 1)};
+  PasteParameters paste_parameters;
+
+  GIVEN("Two readers of the same input stream.") {
+    AlignmentReader reader{AlignmentReader::FromIStream(
+        std::unique_ptr<std::istream>{new std::stringstream{kValidInput}})};
+    AlignmentReader batch_reader{AlignmentReader::FromIStream(
+        std::unique_ptr<std::istream>{new std::stringstream{kValidInput}})};
+
+    THEN("Alignments read one at a time make up the batches.") {
+      while (!batch_reader.EndOfData()) {
+        AlignmentBatch expected{batch_reader.ReadBatch(scoring_system,
+                                                       paste_parameters)};
+        REQUIRE_FALSE(reader.EndOfData());
+        CHECK(reader.NextQseqid() == expected.Qseqid());
+        CHECK(reader.NextSseqid() == expected.Sseqid());
+        std::string qseqid{reader.NextQseqid()}, sseqid{reader.NextSseqid()};
+        std::vector<Alignment> alignments;
+        while (!reader.EndOfData() && reader.NextQseqid() == qseqid
+               && reader.NextSseqid() == sseqid) {
+          alignments.push_back(reader.ReadAlignment(scoring_system,
+                                                    paste_parameters));
+        }
+        CHECK(alignments == expected.Alignments());
+        CHECK(reader.NextAlignmentId() == batch_reader.NextAlignmentId());
+        CHECK(reader.EndOfData() == batch_reader.EndOfData());
+      }
+      CHECK_THROWS_AS(reader.ReadAlignment(scoring_system, paste_parameters),
+                      exceptions::ReadError);
+    }
   }
 }
 
@@ -27,6 +27,7 @@
 #include "string_conversions.h" // include after catch.h
 
 #include <cmath>
+#include <memory>
 
 #include "exceptions.h"
 #include "paste_parameters.h"
@@ -38,6 +39,8 @@
 // * FromStringFields
 // * PasteRight
 // * PasteLeft
+// * Outline
+// * Sequence views
 //
 // Test invariants for:
 // * PasteRight
@@ -92,6 +95,11 @@ bool Equals(const Alignment& alignment,
           && alignment.Sstart() == std::min(sstart, send)
           && alignment.Send() == std::max(sstart, send)
           && alignment.PlusStrand() == (sstart <= send)
+          && alignment.CanonicalSstart()
+             == (sstart <= send ? sstart
+                                : std::stoi(fields.at(9)) - sstart + 1)
+          && alignment.CanonicalSend()
+             == (sstart <= send ? send : std::stoi(fields.at(9)) - send + 1)
           && alignment.Nident() == nident
           && alignment.Mismatch() == mismatch
           && alignment.Gapopen() == gapopen
@@ -2220,6 +2228,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -2306,6 +2318,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -2396,6 +2412,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -2486,6 +2506,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -2574,6 +2598,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -2662,6 +2690,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -2752,6 +2784,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -2842,6 +2878,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -2932,6 +2972,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -3022,6 +3066,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -3112,6 +3160,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -3202,6 +3254,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -3292,6 +3348,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -3382,6 +3442,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -3473,6 +3537,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -3564,6 +3632,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -3655,6 +3727,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -3746,6 +3822,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -3836,6 +3916,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -3926,6 +4010,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -4016,6 +4104,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -4106,6 +4198,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -4196,6 +4292,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -4286,6 +4386,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -4376,6 +4480,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -4466,6 +4574,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <aware>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -6288,6 +6400,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -6374,6 +6490,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -6464,6 +6584,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -6554,6 +6678,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -6642,6 +6770,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -6730,6 +6862,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -6820,6 +6956,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -6910,6 +7050,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -7000,6 +7144,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -7090,6 +7238,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -7180,6 +7332,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -7270,6 +7426,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -7360,6 +7520,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -7450,6 +7614,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -7541,6 +7709,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -7632,6 +7804,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -7723,6 +7899,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -7814,6 +7994,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -7904,6 +8088,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -7994,6 +8182,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -8084,6 +8276,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -8174,6 +8370,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -8264,6 +8464,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -8354,6 +8558,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -8444,6 +8652,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -8534,6 +8746,10 @@ SCENARIO("Test correctness of Alignment::PasteRight <main> <blind>.",
         CHECK(left.Sstart() == pasted_sstart);
         CHECK(left.Send() == pasted_send);
         CHECK(left.PlusStrand() == plus_strand);
+        CHECK(left.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(left.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(left.Nident() == pasted_nident);
         CHECK(left.Mismatch() == pasted_mismatch);
         CHECK(left.Gapopen() == pasted_gapopen);
@@ -10377,6 +10593,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -10463,6 +10683,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -10553,6 +10777,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -10643,6 +10871,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -10731,6 +10963,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -10819,6 +11055,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -10909,6 +11149,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -10999,6 +11243,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -11089,6 +11337,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -11179,6 +11431,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -11269,6 +11525,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -11359,6 +11619,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -11449,6 +11713,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -11539,6 +11807,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -11630,6 +11902,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -11721,6 +11997,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -11812,6 +12092,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -11903,6 +12187,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -11993,6 +12281,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -12083,6 +12375,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -12173,6 +12469,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -12263,6 +12563,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -12353,6 +12657,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -12443,6 +12751,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -12533,6 +12845,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -12623,6 +12939,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <aware>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -14461,6 +14781,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -14547,6 +14871,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -14637,6 +14965,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -14727,6 +15059,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -14815,6 +15151,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -14903,6 +15243,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -14993,6 +15337,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -15083,6 +15431,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -15173,6 +15525,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -15263,6 +15619,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -15353,6 +15713,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -15443,6 +15807,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -15533,6 +15901,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -15623,6 +15995,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -15714,6 +16090,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -15805,6 +16185,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -15896,6 +16280,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -15987,6 +16375,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -16077,6 +16469,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -16167,6 +16563,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -16257,6 +16657,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -16347,6 +16751,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -16437,6 +16845,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -16527,6 +16939,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -16617,6 +17033,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -16707,6 +17127,10 @@ SCENARIO("Test correctness of Alignment::PasteLeft <main> <blind>.",
         CHECK(right.Sstart() == pasted_sstart);
         CHECK(right.Send() == pasted_send);
         CHECK(right.PlusStrand() == plus_strand);
+        CHECK(right.CanonicalSstart()
+              == (plus_strand ? pasted_sstart : slen - pasted_send + 1));
+        CHECK(right.CanonicalSend()
+              == (plus_strand ? pasted_send : slen - pasted_sstart + 1));
         CHECK(right.Nident() == pasted_nident);
         CHECK(right.Mismatch() == pasted_mismatch);
         CHECK(right.Gapopen() == pasted_gapopen);
@@ -17284,6 +17708,114 @@ SCENARIO("Test exceptions thrown by Alignment::PasteLeft <blind>.",
   }
 }
 
+SCENARIO("Test correctness of Alignment::Outline.",
+         "[Alignment][Outline][correctness]") {
+  PasteParameters paste_parameters, blind_parameters;
+  blind_parameters.blind_mode = true;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  Alignment left{Alignment::FromStringFields(0,
+      {"101", "110", "1101", "1110", "9", "1", "0", "0",
+       "10000", "100000", "10", "ACGTACGTAC", "ACGTACGTAA"},
+      scoring_system, paste_parameters)};
+  Alignment middle{Alignment::FromStringFields(1,
+      {"113", "122", "1114", "1123", "10", "0", "0", "0",
+       "10000", "100000", "10", "ACGTACGTAC", "ACGTACGTAC"},
+      scoring_system, paste_parameters)};
+  Alignment right{Alignment::FromStringFields(2,
+      {"125", "134", "1126", "1135", "10", "0", "0", "0",
+       "10000", "100000", "10", "ACGTACGTAC", "ACGTACGTAC"},
+      scoring_system, paste_parameters)};
+  // query offset 2, subject offset 3
+  left.PasteRight(middle, GetConfiguration(2, 3, 10, 10), scoring_system,
+                  paste_parameters);
+
+  GIVEN("The outline of a pasted alignment.") {
+    Alignment outline{left.Outline()};
+
+    THEN("Sequences and other pasted identifiers are dropped.") {
+      CHECK(outline.Id() == 0);
+      CHECK(outline.PastedIdentifiers().size() == 1);
+      CHECK(outline.Qseq().empty());
+      CHECK(outline.Sseq().empty());
+    }
+
+    THEN("Pasting onto the outline in blind mode yields the same values.") {
+      // query offset 2, subject offset 2
+      AlignmentConfiguration config{GetConfiguration(2, 2, left.Length(), 10)};
+      left.PasteRight(right, config, scoring_system, paste_parameters);
+      outline.PasteRight(right, config, scoring_system, blind_parameters);
+      CHECK(outline.Qstart() == left.Qstart());
+      CHECK(outline.Qend() == left.Qend());
+      CHECK(outline.Sstart() == left.Sstart());
+      CHECK(outline.Send() == left.Send());
+      CHECK(outline.Nident() == left.Nident());
+      CHECK(outline.Mismatch() == left.Mismatch());
+      CHECK(outline.Gapopen() == left.Gapopen());
+      CHECK(outline.Gaps() == left.Gaps());
+      CHECK(outline.Length() == left.Length());
+      CHECK(outline.RawScore() == left.RawScore());
+      CHECK(outline.UngappedPrefixEnd() == left.UngappedPrefixEnd());
+      CHECK(outline.UngappedSuffixBegin() == left.UngappedSuffixBegin());
+    }
+  }
+}
+
+SCENARIO("Test correctness of Alignment sequence views.",
+         "[Alignment][FromStringFields][PasteRight][PasteLeft][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.sequence_views = true;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::vector<std::vector<std::string>> fields{
+      {"101", "110", "1101", "1110", "9", "1", "0", "0",
+       "10000", "100000", "10", "ACGTACGTAC", "ACGTACGTAA"},
+      {"113", "122", "1114", "1123", "10", "0", "0", "0",
+       "10000", "100000", "10", "ACGTACGTAC", "ACGTACGTAC"},
+      {"125", "134", "1126", "1135", "10", "0", "0", "0",
+       "10000", "100000", "10", "ACGTACGTAC", "ACGTACGTAC"}};
+  std::shared_ptr<const std::vector<std::vector<std::string>>> owner{
+      std::make_shared<const std::vector<std::vector<std::string>>>(fields)};
+  std::vector<Alignment> packed, viewed;
+  for (int i = 0; i < 3; ++i) {
+    std::vector<std::string_view> views(owner->at(i).cbegin(),
+                                        owner->at(i).cend());
+    packed.push_back(Alignment::FromStringFields(i, views, scoring_system,
+                                                 paste_parameters));
+    viewed.push_back(Alignment::FromStringFields(i, views, scoring_system,
+                                                 paste_parameters, owner));
+  }
+
+  GIVEN("Alignments viewing their sequences.") {
+
+    THEN("They equal alignments holding packed sequences.") {
+      for (int i = 0; i < 3; ++i) {
+        CHECK(viewed.at(i).PackedQseq().IsView());
+        CHECK(viewed.at(i).PackedSseq().IsView());
+        CHECK(viewed.at(i) == packed.at(i));
+      }
+    }
+
+    THEN("Pasting onto them packs their sequences.") {
+      // query offset 2, subject offset 3
+      AlignmentConfiguration config{GetConfiguration(2, 3, 10, 10)};
+      packed.at(0).PasteRight(packed.at(1), config, scoring_system,
+                              paste_parameters);
+      viewed.at(0).PasteRight(viewed.at(1), config, scoring_system,
+                              paste_parameters);
+      CHECK_FALSE(viewed.at(0).PackedQseq().IsView());
+      CHECK_FALSE(viewed.at(0).PackedSseq().IsView());
+      CHECK(viewed.at(0) == packed.at(0));
+      // query offset 2, subject offset 2
+      config = GetConfiguration(2, 2, packed.at(0).Length(), 10);
+      packed.at(2).PasteLeft(packed.at(0), config, scoring_system,
+                             paste_parameters);
+      viewed.at(2).PasteLeft(viewed.at(0), config, scoring_system,
+                             paste_parameters);
+      CHECK_FALSE(viewed.at(2).PackedQseq().IsView());
+      CHECK(viewed.at(2) == packed.at(2));
+    }
+  }
+}
+
 } // namespace
 
 } // namespace test
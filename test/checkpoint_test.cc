@@ -0,0 +1,141 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "checkpoint.h"
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_COLOUR_NONE
+#include "catch.h"
+
+#include "string_conversions.h" // include after catch.h
+
+#include <sstream>
+#include <vector>
+
+#include "exceptions.h"
+
+// Checkpoint tests
+//
+// Test correctness for:
+// * Checkpoint::FromIStream
+// * Checkpoint::Write
+//
+// Test invariants for:
+//
+// Test exceptions for:
+// * Checkpoint::FromIStream
+
+namespace paste_alignments {
+
+namespace test {
+
+namespace {
+
+// Returns a checkpoint whose statistics cover two batches.
+//
+Checkpoint MakeCheckpoint() {
+  PasteParameters paste_parameters;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::vector<Alignment> alignments{
+      Alignment::FromStringFields(1, {"101", "125", "1101", "1125",
+                                   "24", "1", "0", "0",
+                                   "10000", "100000", "25",
+                                   "GCCCCAAAATTCCCCAAAATTCCCC",
+                                   "ACCCCAAAATTCCCCAAAATTCCCC"},
+                                  scoring_system, paste_parameters),
+      Alignment::FromStringFields(2, {"101", "120", "1131", "1150",
+                                   "20", "0", "0", "0",
+                                   "10000", "100000", "20",
+                                   "CCCCAAAATTCCCCAAAATT",
+                                   "CCCCAAAATTCCCCAAAATT"},
+                                  scoring_system, paste_parameters)};
+  for (Alignment& a : alignments) {
+    a.IncludeInOutput(true);
+  }
+  Checkpoint result;
+  result.input_filename = "some input file.tsv";
+  result.settings = "num_fields=13;gap_tolerance=5";
+  result.shard = "2/8";
+  result.input_offset = 12345l;
+  result.next_row_id = 678l;
+  result.output_offset = 9012l;
+  AlignmentBatch first_batch{"query one", "subject"};
+  first_batch.ResetAlignments(alignments, paste_parameters);
+  AlignmentBatch second_batch{"query", "subject two"};
+  second_batch.ResetAlignments({alignments.at(1)}, paste_parameters);
+  result.stats_collector.CollectStats(first_batch);
+  result.stats_collector.CollectStats(second_batch);
+  return result;
+}
+
+SCENARIO("Test correctness of Checkpoint::FromIStream and Checkpoint::Write.",
+         "[Checkpoint][FromIStream][Write][correctness]") {
+
+  GIVEN("An empty checkpoint.") {
+    Checkpoint checkpoint;
+
+    THEN("The checkpoint is restored from what it writes.") {
+      std::stringstream ss;
+      checkpoint.Write(ss);
+      CHECK(Checkpoint::FromIStream(ss) == checkpoint);
+    }
+  }
+
+  GIVEN("A checkpoint with collected statistics.") {
+    Checkpoint checkpoint{MakeCheckpoint()};
+
+    THEN("The checkpoint, including statistics, is restored exactly.") {
+      std::stringstream ss;
+      checkpoint.Write(ss);
+      CHECK(Checkpoint::FromIStream(ss) == checkpoint);
+    }
+  }
+}
+
+SCENARIO("Test exceptions thrown by Checkpoint::FromIStream.",
+         "[Checkpoint][FromIStream][exceptions]") {
+  std::stringstream written;
+  MakeCheckpoint().Write(written);
+  std::string data{written.str()};
+
+  THEN("Data of unknown format causes exception.") {
+    std::stringstream ss{"some other file\n" + data};
+    CHECK_THROWS_AS(Checkpoint::FromIStream(ss), exceptions::ReadError);
+  }
+
+  THEN("Truncated data causes exception.") {
+    std::string::size_type length = GENERATE(0, 10, 40, 80, 120);
+    std::stringstream ss{data.substr(0, length)};
+    CHECK_THROWS_AS(Checkpoint::FromIStream(ss), exceptions::ReadError);
+  }
+
+  THEN("Malformed offsets cause exception.") {
+    std::string malformed{data};
+    malformed.replace(malformed.find("12345"), 5, "12a45");
+    std::stringstream ss{malformed};
+    CHECK_THROWS_AS(Checkpoint::FromIStream(ss), exceptions::ReadError);
+  }
+}
+
+} // namespace
+
+} // namespace test
+
+} // namespace paste_alignments
@@ -27,9 +27,12 @@
 #include "string_conversions.h" // include after catch.h
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <limits>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "exceptions.h"
 
@@ -48,6 +51,7 @@
 // * FuzzyFloatLess
 // * SatisfiesThresholds
 // * MegablastExtendCost
+// * RunTasks
 // 
 // Test invariants for:
 //
@@ -710,6 +714,42 @@ SCENARIO("Test exceptions thrown by helpers::MegablastExtendCost.",
   }
 }
 
+SCENARIO("Test correctness of helpers::RunTasks.",
+         "[helpers][RunTasks][correctness]") {
+
+  GIVEN("More tasks than threads.") {
+    std::vector<int> runs(100, 0);
+    helpers::RunTasks(100, 4, [&](int i) {runs.at(i) += 1;});
+
+    THEN("Each task is run exactly once.") {
+      CHECK(std::all_of(runs.begin(), runs.end(),
+                        [](int count) {return count == 1;}));
+    }
+  }
+
+  GIVEN("A failing task.") {
+    std::atomic<int> num_started{0};
+    auto task = [&](int i) {
+      ++num_started;
+      if (i == 0) {
+        throw std::runtime_error("failed");
+      }
+    };
+
+    THEN("The exception is rethrown and no further tasks are started.") {
+      CHECK_THROWS_AS(helpers::RunTasks(100, 1, task), std::runtime_error);
+      CHECK(num_started == 1);
+    }
+  }
+
+  GIVEN("No threads.") {
+    THEN("An exception is thrown.") {
+      CHECK_THROWS_AS(helpers::RunTasks(1, 0, [](int) {}),
+                      exceptions::OutOfRange);
+    }
+  }
+}
+
 } // namespace
 
 } // namespace test
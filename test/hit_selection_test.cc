@@ -0,0 +1,208 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "hit_selection.h"
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_COLOUR_NONE
+#include "catch.h"
+
+#include "string_conversions.h" // include after catch.h
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "exceptions.h"
+
+// QueryHitSelector tests
+//
+// Test correctness for:
+// * Add
+// * Flush
+//
+// Test exceptions for:
+// * QueryHitSelector
+
+namespace paste_alignments {
+
+namespace test {
+
+namespace {
+
+using Write = std::tuple<std::string, std::string, std::string>;
+
+// Returns a batch of `qseqid` and `sseqid` holding one alignment marked as
+// final per entry of `lengths`, each consisting of that many identities.
+// Identifiers are assigned consecutively starting at `first_id`.
+//
+AlignmentBatch MakeBatch(const std::string& qseqid, const std::string& sseqid,
+                         const std::vector<int>& lengths, int first_id,
+                         const ScoringSystem& scoring_system,
+                         const PasteParameters& paste_parameters) {
+  std::vector<Alignment> alignments;
+  int qstart{101};
+  for (int length : lengths) {
+    alignments.push_back(Alignment::FromStringFields(
+        first_id++,
+        {std::to_string(qstart), std::to_string(qstart + length - 1),
+         std::to_string(qstart + 1000), std::to_string(qstart + 999 + length),
+         std::to_string(length), "0", "0", "0", "10000", "100000",
+         std::to_string(length)},
+        scoring_system, paste_parameters));
+    alignments.back().IncludeInOutput(true);
+    qstart += 1000;
+  }
+  AlignmentBatch batch{qseqid, sseqid};
+  batch.ResetAlignments(std::move(alignments), paste_parameters);
+  return batch;
+}
+
+// Returns the output lines of the alignments of `batch` at `positions`.
+//
+std::string Lines(const AlignmentBatch& batch, const std::vector<int>& positions,
+                  const OutputFormat& format) {
+  std::string result;
+  for (int pos : positions) {
+    format.Write(batch, batch.Alignments().at(pos), result);
+  }
+  return result;
+}
+
+SCENARIO("Test correctness of QueryHitSelector.",
+         "[QueryHitSelector][Add][Flush][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  OutputFormat format{OutputFormat::FromString("", true, false)};
+  std::vector<Write> writes;
+  auto record{[&](const std::string& qseqid, const std::string& sseqid,
+                  const std::string& lines) {
+    writes.emplace_back(qseqid, sseqid, lines);
+  }};
+  AlignmentBatch q1s1{MakeBatch("q1", "s1", {20, 10}, 1, scoring_system,
+                                paste_parameters)};
+  AlignmentBatch q1s2{MakeBatch("q1", "s2", {15, 5}, 3, scoring_system,
+                                paste_parameters)};
+  AlignmentBatch q1s3{MakeBatch("q1", "s3", {30, 25}, 5, scoring_system,
+                                paste_parameters)};
+  AlignmentBatch q2s1{MakeBatch("q2", "s1", {8}, 7, scoring_system,
+                                paste_parameters)};
+
+  GIVEN("A limit below the number of a query's alignments.") {
+    QueryHitSelector selector{2, format, paste_parameters.float_epsilon,
+                              record};
+    selector.Add(q1s1);
+    selector.Add(q1s2);
+
+    THEN("Nothing is written before the query ends.") {
+      CHECK(writes.empty());
+      CHECK(selector.NumHits() == 2);
+    }
+
+    THEN("The best alignments are written in input order by subject.") {
+      selector.Add(q2s1);
+      REQUIRE(writes.size() == 2);
+      CHECK(writes.at(0) == Write{"q1", "s1", Lines(q1s1, {0}, format)});
+      CHECK(writes.at(1) == Write{"q1", "s2", Lines(q1s2, {0}, format)});
+      selector.Flush();
+      REQUIRE(writes.size() == 3);
+      CHECK(writes.at(2) == Write{"q2", "s1", Lines(q2s1, {0}, format)});
+    }
+
+    THEN("Alignments of later subjects replace worse ones.") {
+      selector.Add(q1s3);
+      selector.Flush();
+      REQUIRE(writes.size() == 1);
+      CHECK(writes.at(0) == Write{"q1", "s3", Lines(q1s3, {0, 1}, format)});
+    }
+  }
+
+  GIVEN("A limit above the number of a query's alignments.") {
+    QueryHitSelector selector{10, format, paste_parameters.float_epsilon,
+                              record};
+    selector.Add(q1s1);
+    selector.Add(q1s2);
+    selector.Flush();
+
+    THEN("All alignments are written in input order.") {
+      REQUIRE(writes.size() == 2);
+      CHECK(writes.at(0) == Write{"q1", "s1", Lines(q1s1, {0, 1}, format)});
+      CHECK(writes.at(1) == Write{"q1", "s2", Lines(q1s2, {0, 1}, format)});
+    }
+
+    THEN("Flushing again writes nothing.") {
+      selector.Flush();
+      CHECK(writes.size() == 2);
+    }
+  }
+
+  GIVEN("A subject whose alignments were all dropped between two batches of"
+        " another subject.") {
+    AlignmentBatch weak{MakeBatch("q1", "s2", {5, 4}, 3, scoring_system,
+                                  paste_parameters)};
+    AlignmentBatch again{MakeBatch("q1", "s1", {15}, 5, scoring_system,
+                                   paste_parameters)};
+    QueryHitSelector selector{3, format, paste_parameters.float_epsilon,
+                              record};
+    selector.Add(q1s1);
+    selector.Add(weak);
+    selector.Add(again);
+    selector.Flush();
+
+    THEN("The kept alignments of the subject are written together.") {
+      REQUIRE(writes.size() == 1);
+      CHECK(writes.at(0) == Write{"q1", "s1", Lines(q1s1, {0, 1}, format)
+                                              + Lines(again, {0}, format)});
+    }
+  }
+
+  GIVEN("Alignments of equal score and percent identity.") {
+    AlignmentBatch ties{MakeBatch("q1", "s1", {10, 10, 10}, 1, scoring_system,
+                                  paste_parameters)};
+    QueryHitSelector selector{2, format, paste_parameters.float_epsilon,
+                              record};
+    selector.Add(ties);
+    selector.Flush();
+
+    THEN("The earlier alignments are kept.") {
+      REQUIRE(writes.size() == 1);
+      CHECK(writes.at(0) == Write{"q1", "s1", Lines(ties, {0, 1}, format)});
+    }
+  }
+}
+
+SCENARIO("Test exceptions thrown by QueryHitSelector.",
+         "[QueryHitSelector][exceptions]") {
+  OutputFormat format{OutputFormat::FromString("", true, false)};
+
+  THEN("A non-positive limit is rejected.") {
+    CHECK_THROWS_AS(QueryHitSelector(0, format, 0.01f, nullptr),
+                    exceptions::OutOfRange);
+    CHECK_THROWS_AS(QueryHitSelector(-1, format, 0.01f, nullptr),
+                    exceptions::OutOfRange);
+  }
+}
+
+} // namespace
+
+} // namespace test
+
+} // namespace paste_alignments
@@ -0,0 +1,181 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "job_manifest.h"
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_COLOUR_NONE
+#include "catch.h"
+
+#include "string_conversions.h" // include after catch.h
+
+#include <sstream>
+#include <vector>
+
+#include "exceptions.h"
+
+// Job manifest tests
+//
+// Test correctness for:
+// * ReadManifest
+// * ReadSweepFile
+//
+// Test invariants for:
+//
+// Test exceptions for:
+// * ReadManifest
+// * ReadSweepFile
+
+namespace paste_alignments {
+
+namespace test {
+
+namespace {
+
+ManifestEntry MakeEntry(const std::string& input, const std::string& output,
+                        const std::string& stats = "",
+                        const std::string& configuration = "") {
+  ManifestEntry result;
+  result.input_filename = input;
+  result.output_filename = output;
+  result.stats_filename = stats;
+  result.configuration_filename = configuration;
+  return result;
+}
+
+SweepEntry MakeSweepEntry(const std::string& configuration,
+                          const std::string& output,
+                          const std::string& stats = "",
+                          const std::string& summary = "") {
+  SweepEntry result;
+  result.configuration_filename = configuration;
+  result.output_filename = output;
+  result.stats_filename = stats;
+  result.summary_filename = summary;
+  return result;
+}
+
+SCENARIO("Test correctness of ReadManifest.",
+         "[ReadManifest][correctness]") {
+
+  GIVEN("An empty manifest.") {
+    std::stringstream ss{""};
+
+    THEN("No jobs are read.") {
+      CHECK(ReadManifest(ss).empty());
+    }
+  }
+
+  GIVEN("A manifest with comments, blank lines, and optional columns.") {
+    std::stringstream ss{"# input\toutput\tstats\tconfig\n"
+                         "in1.tsv\tout1.tsv\n"
+                         "\n"
+                         "in2.tsv\tout2.tsv\tstats2.tsv\n"
+                         "in3.tsv\tout3.tsv\t-\tthree.config\r\n"
+                         "in4.tsv\tout4.tsv\tstats4.tsv\tfour.config"};
+    std::vector<ManifestEntry> expected{
+        MakeEntry("in1.tsv", "out1.tsv"),
+        MakeEntry("in2.tsv", "out2.tsv", "stats2.tsv"),
+        MakeEntry("in3.tsv", "out3.tsv", "", "three.config"),
+        MakeEntry("in4.tsv", "out4.tsv", "stats4.tsv", "four.config")};
+
+    THEN("Each job line is read in order.") {
+      CHECK(ReadManifest(ss) == expected);
+    }
+  }
+}
+
+SCENARIO("Test exceptions thrown by ReadManifest.",
+         "[ReadManifest][exceptions]") {
+
+  GIVEN("A line with too few columns.") {
+    std::stringstream ss{"in1.tsv\tout1.tsv\nin2.tsv\n"};
+
+    THEN("An exception is thrown.") {
+      CHECK_THROWS_AS(ReadManifest(ss), exceptions::ReadError);
+    }
+  }
+
+  GIVEN("A line with too many columns.") {
+    std::stringstream ss{"in1.tsv\tout1.tsv\ts.tsv\tc.config\textra\n"};
+
+    THEN("An exception is thrown.") {
+      CHECK_THROWS_AS(ReadManifest(ss), exceptions::ReadError);
+    }
+  }
+
+  GIVEN("A line with an absent input or output column.") {
+    std::stringstream missing_input{"-\tout1.tsv\n"};
+    std::stringstream missing_output{"in1.tsv\t\n"};
+
+    THEN("An exception is thrown.") {
+      CHECK_THROWS_AS(ReadManifest(missing_input), exceptions::ReadError);
+      CHECK_THROWS_AS(ReadManifest(missing_output), exceptions::ReadError);
+    }
+  }
+}
+
+SCENARIO("Test correctness of ReadSweepFile.",
+         "[ReadSweepFile][correctness]") {
+
+  GIVEN("A sweep file with comments, blank lines, and optional columns.") {
+    std::stringstream ss{"# config\toutput\tstats\tsummary\n"
+                         "one.config\tout1.tsv\n"
+                         "\n"
+                         "-\tout2.tsv\tstats2.tsv\n"
+                         "three.config\tout3.tsv\t-\tsummary3.txt\r\n"};
+    std::vector<SweepEntry> expected{
+        MakeSweepEntry("one.config", "out1.tsv"),
+        MakeSweepEntry("", "out2.tsv", "stats2.tsv"),
+        MakeSweepEntry("three.config", "out3.tsv", "", "summary3.txt")};
+
+    THEN("Each parameter set is read in order.") {
+      CHECK(ReadSweepFile(ss) == expected);
+    }
+  }
+}
+
+SCENARIO("Test exceptions thrown by ReadSweepFile.",
+         "[ReadSweepFile][exceptions]") {
+
+  GIVEN("Lines with too few or too many columns.") {
+    std::stringstream too_few{"one.config\n"};
+    std::stringstream too_many{"c\to\ts\ty\textra\n"};
+
+    THEN("An exception is thrown.") {
+      CHECK_THROWS_AS(ReadSweepFile(too_few), exceptions::ReadError);
+      CHECK_THROWS_AS(ReadSweepFile(too_many), exceptions::ReadError);
+    }
+  }
+
+  GIVEN("A line with an absent output column.") {
+    std::stringstream ss{"one.config\t-\n"};
+
+    THEN("An exception is thrown.") {
+      CHECK_THROWS_AS(ReadSweepFile(ss), exceptions::ReadError);
+    }
+  }
+}
+
+} // namespace
+
+} // namespace test
+
+} // namespace paste_alignments
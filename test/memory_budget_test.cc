@@ -0,0 +1,123 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "memory_budget.h"
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_COLOUR_NONE
+#include "catch.h"
+
+#include "string_conversions.h" // include after catch.h
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "exceptions.h"
+
+// MemoryBudget tests
+//
+// Test correctness for:
+// * Fits
+// * Acquire
+// * Release
+// * Reserve
+//
+// Test invariants for:
+//
+// Test exceptions for:
+// * MemoryBudget(long)
+
+namespace paste_alignments {
+
+namespace test {
+
+namespace {
+
+SCENARIO("Test correctness of MemoryBudget.", "[MemoryBudget][correctness]") {
+
+  GIVEN("An unlimited budget.") {
+    MemoryBudget budget;
+
+    THEN("Everything fits.") {
+      CHECK(budget.Fits(1l << 40));
+      CHECK(budget.Reserve(1l << 40));
+      budget.Acquire(1l << 40);
+      CHECK(budget.Used() == (1l << 41));
+    }
+  }
+
+  GIVEN("A limited budget.") {
+    MemoryBudget budget{100l};
+
+    THEN("Reservations fail once the maximum would be exceeded.") {
+      CHECK(budget.Reserve(60l));
+      CHECK(budget.Fits(40l));
+      CHECK_FALSE(budget.Fits(41l));
+      CHECK_FALSE(budget.Reserve(41l));
+      CHECK(budget.Used() == 60l);
+      CHECK(budget.Reserve(-60l));
+      CHECK(budget.Used() == 0l);
+    }
+
+    THEN("An acquisition larger than the maximum proceeds alone.") {
+      budget.Acquire(150l);
+      CHECK(budget.Used() == 150l);
+      budget.Release(150l);
+      CHECK(budget.Used() == 0l);
+    }
+
+    THEN("An acquisition that does not fit waits for releases.") {
+      budget.Acquire(80l);
+      std::atomic<bool> acquired{false};
+      std::thread waiting{[&]() {
+        budget.Acquire(50l);
+        acquired = true;
+      }};
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      CHECK_FALSE(acquired);
+      budget.Release(80l);
+      waiting.join();
+      CHECK(acquired);
+      CHECK(budget.Used() == 50l);
+    }
+
+    THEN("Reserved memory does not make acquisitions wait forever.") {
+      CHECK(budget.Reserve(90l));
+      budget.Acquire(50l);
+      CHECK(budget.Used() == 140l);
+      CHECK(budget.Acquired() == 50l);
+    }
+  }
+}
+
+SCENARIO("Test exceptions thrown by MemoryBudget(long).",
+         "[MemoryBudget][exceptions]") {
+
+  THEN("Negative maximums are rejected.") {
+    CHECK_THROWS_AS(MemoryBudget{-1l}, exceptions::OutOfRange);
+  }
+}
+
+} // namespace
+
+} // namespace test
+
+} // namespace paste_alignments
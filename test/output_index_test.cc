@@ -0,0 +1,186 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "output_index.h"
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_COLOUR_NONE
+#include "catch.h"
+
+#include "string_conversions.h" // include after catch.h
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "exceptions.h"
+
+// OutputIndex tests
+//
+// Test correctness for:
+// * OutputIndexEntry::FromString
+// * OutputIndexEntry::Write
+// * OutputIndexWriter
+// * ReadOutputIndex
+// * TruncateOutputIndex
+//
+// Test exceptions for:
+// * OutputIndexEntry::FromString
+
+namespace paste_alignments {
+
+namespace test {
+
+namespace {
+
+// Returns the path of a test's index file, which does not exist.
+//
+std::string IndexFilename() {
+  std::filesystem::path path{std::filesystem::temp_directory_path()
+                             / "paste_alignments_output_index_test.idx"};
+  std::filesystem::remove(path);
+  return path.string();
+}
+
+std::string ReadFile(const std::string& filename) {
+  std::ifstream ifs{filename};
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  return ss.str();
+}
+
+SCENARIO("Test correctness of OutputIndexEntry.",
+         "[OutputIndexEntry][FromString][Write][correctness]") {
+
+  GIVEN("An index line.") {
+    OutputIndexEntry entry{OutputIndexEntry::FromString(
+        "q1\ts1\t1024\t512\t7")};
+
+    THEN("Its columns are parsed.") {
+      CHECK(entry.qseqid == "q1");
+      CHECK(entry.sseqid == "s1");
+      CHECK(entry.offset == 1024l);
+      CHECK(entry.size == 512l);
+      CHECK(entry.num_rows == 7l);
+    }
+
+    THEN("The entry is written as the same line.") {
+      std::stringstream ss;
+      entry.Write(ss);
+      CHECK(ss.str() == "q1\ts1\t1024\t512\t7\n");
+    }
+  }
+
+  THEN("Offsets beyond the range of int are parsed.") {
+    CHECK(OutputIndexEntry::FromString("q\ts\t8589934592\t1\t1").offset
+          == 8589934592l);
+  }
+}
+
+SCENARIO("Test exceptions thrown by OutputIndexEntry::FromString.",
+         "[OutputIndexEntry][FromString][exceptions]") {
+
+  THEN("Malformed lines are rejected.") {
+    for (const char* line : {"", "q\ts\t1\t2", "q\ts\t1\t2\t3\t4",
+                             "q\ts\tx\t2\t3", "q\ts\t1\t-2\t3",
+                             "q\ts\t1\t2\t3x", "q\ts\t\t2\t3"}) {
+      CHECK_THROWS_AS(OutputIndexEntry::FromString(line),
+                      exceptions::ParsingError);
+    }
+  }
+}
+
+SCENARIO("Test correctness of OutputIndexWriter and ReadOutputIndex.",
+         "[OutputIndexWriter][ReadOutputIndex][correctness]") {
+  std::stringstream ss;
+  OutputIndexWriter writer{ss};
+
+  GIVEN("Batches written one after another.") {
+    writer.Add("q1", "s1", 0l, 100l, 2l);
+    writer.Add("q1", "s2", 100l, 50l, 1l);
+    writer.Add("q2", "s1", 150l, 0l, 0l);
+    writer.Add("q2", "s2", 150l, 80l, 3l);
+
+    THEN("Entries are written once the next batch begins or on Flush.") {
+      CHECK(ss.str() == "q1\ts1\t0\t100\t2\nq1\ts2\t100\t50\t1\n");
+      writer.Flush();
+      CHECK(ss.str() == "q1\ts1\t0\t100\t2\nq1\ts2\t100\t50\t1\n"
+                        "q2\ts2\t150\t80\t3\n");
+    }
+
+    THEN("Reading the index returns the batches without output rows.") {
+      writer.Flush();
+      std::vector<OutputIndexEntry> entries{ReadOutputIndex(ss)};
+      REQUIRE(entries.size() == 3);
+      CHECK(entries.at(0) == OutputIndexEntry{"q1", "s1", 0l, 100l, 2l});
+      CHECK(entries.at(1) == OutputIndexEntry{"q1", "s2", 100l, 50l, 1l});
+      CHECK(entries.at(2) == OutputIndexEntry{"q2", "s2", 150l, 80l, 3l});
+    }
+  }
+
+  GIVEN("A batch written in parts.") {
+    writer.Add("q1", "s1", 0l, 100l, 2l);
+    writer.Add("q1", "s1", 100l, 40l, 1l);
+    writer.Add("q1", "s1", 140l, 60l, 4l);
+    writer.Flush();
+
+    THEN("The parts are recorded as one entry.") {
+      CHECK(ss.str() == "q1\ts1\t0\t200\t7\n");
+    }
+  }
+}
+
+SCENARIO("Test correctness of TruncateOutputIndex.",
+         "[TruncateOutputIndex][correctness]") {
+  std::string filename{IndexFilename()};
+
+  GIVEN("An index file whose last line is incomplete.") {
+    {
+      std::ofstream ofs{filename};
+      ofs << "q1\ts1\t0\t100\t2\nq1\ts2\t100\t50\t1\nq2\ts1\t150\t80\t3\n"
+          << "q3\ts1\t23";
+    }
+
+    THEN("Entries ending within the output size are kept.") {
+      TruncateOutputIndex(filename, 150l);
+      CHECK(ReadFile(filename) == "q1\ts1\t0\t100\t2\nq1\ts2\t100\t50\t1\n");
+    }
+
+    THEN("Incomplete lines are removed.") {
+      TruncateOutputIndex(filename, 1000l);
+      CHECK(ReadFile(filename) == "q1\ts1\t0\t100\t2\nq1\ts2\t100\t50\t1\n"
+                                  "q2\ts1\t150\t80\t3\n");
+    }
+
+    THEN("All entries are removed for empty output.") {
+      TruncateOutputIndex(filename, 0l);
+      CHECK(ReadFile(filename).empty());
+    }
+  }
+  std::filesystem::remove(filename);
+}
+
+} // namespace
+
+} // namespace test
+
+} // namespace paste_alignments
@@ -0,0 +1,194 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "output_sink.h"
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_COLOUR_NONE
+#include "catch.h"
+
+#include "string_conversions.h" // include after catch.h
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <zlib.h>
+
+#include "exceptions.h"
+
+// OutputSink tests
+//
+// Test correctness for:
+// * FileSink
+// * FdSink
+// * MemorySink
+// * GzipSink
+// * NullSink
+// * OpenOutputSink
+//
+// Test exceptions for:
+// * OpenOutputSink
+
+namespace paste_alignments {
+
+namespace test {
+
+namespace {
+
+// Returns the path of a test's output file, which does not exist.
+//
+std::string OutputFilename() {
+  std::filesystem::path path{std::filesystem::temp_directory_path()
+                             / "paste_alignments_output_sink_test"};
+  std::filesystem::remove(path);
+  return path.string();
+}
+
+std::string ReadFile(const std::string& filename) {
+  std::ifstream ifs{filename};
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  return ss.str();
+}
+
+std::string ReadGzipFile(const std::string& filename) {
+  gzFile file{gzopen(filename.c_str(), "rb")};
+  std::string result;
+  char buffer[256];
+  int length;
+  while ((length = gzread(file, buffer, sizeof(buffer))) > 0) {
+    result.append(buffer, length);
+  }
+  gzclose(file);
+  return result;
+}
+
+SCENARIO("Test correctness of output sinks.", "[OutputSink][correctness]") {
+  std::string filename{OutputFilename()};
+  std::string data{"q\ts\t1\t20\t1,2,3\n"};
+
+  GIVEN("A kind of sink writing a file.") {
+    std::string kind{GENERATE("file", "fd")};
+
+    THEN("Written data is in the file and counted.") {
+      {
+        std::unique_ptr<OutputSink> sink{OpenOutputSink(kind, filename)};
+        sink->Write(data);
+        sink->Write("");
+        sink->Write(data);
+        CHECK(sink->BytesWritten() == 2l * static_cast<long>(data.length()));
+        sink->Flush();
+        CHECK(ReadFile(filename) == data + data);
+      }
+      CHECK(ReadFile(filename) == data + data);
+    }
+
+    THEN("Existing files are truncated unless appending.") {
+      OpenOutputSink(kind, filename)->Write(data);
+      OpenOutputSink(kind, filename)->Write(data);
+      CHECK(ReadFile(filename) == data);
+      OpenOutputSink(kind, filename, true)->Write(data);
+      CHECK(ReadFile(filename) == data + data);
+    }
+  }
+
+  GIVEN("A file descriptor sink with a small buffer.") {
+    THEN("Data larger than the buffer is written in order.") {
+      {
+        FdSink sink{filename, false, 8l};
+        sink.Write("abc");
+        sink.Write(data);
+        sink.Write("def");
+      }
+      CHECK(ReadFile(filename) == "abc" + data + "def");
+    }
+  }
+
+  GIVEN("A memory sink.") {
+    MemorySink sink;
+    sink.Write(data);
+    sink.Write("x");
+
+    THEN("Data is kept until released.") {
+      CHECK(sink.Data() == data + "x");
+      CHECK(sink.Release() == data + "x");
+      CHECK(sink.Data().empty());
+      CHECK(sink.BytesWritten() == static_cast<long>(data.length()) + 1l);
+    }
+  }
+
+  GIVEN("A gzip sink.") {
+    THEN("The file decompresses to the written data.") {
+      {
+        std::unique_ptr<OutputSink> sink{OpenOutputSink("gzip", filename)};
+        for (int i = 0; i < 1000; ++i) {
+          sink->Write(data);
+        }
+        CHECK(sink->BytesWritten() == 1000l * static_cast<long>(data.length()));
+      }
+      std::string expected;
+      for (int i = 0; i < 1000; ++i) {
+        expected.append(data);
+      }
+      CHECK(ReadGzipFile(filename) == expected);
+      CHECK(std::filesystem::file_size(filename) < expected.length());
+    }
+  }
+
+  GIVEN("A null sink.") {
+    std::unique_ptr<OutputSink> sink{OpenOutputSink("null", filename)};
+    sink->Write(data);
+    sink->Flush();
+
+    THEN("Data is counted but not written.") {
+      CHECK(sink->BytesWritten() == static_cast<long>(data.length()));
+      CHECK(!std::filesystem::exists(filename));
+    }
+  }
+  std::filesystem::remove(filename);
+}
+
+SCENARIO("Test exceptions thrown by OpenOutputSink.",
+         "[OpenOutputSink][exceptions]") {
+  std::string filename{OutputFilename()};
+
+  THEN("Unknown kinds and appending gzip files cause exceptions.") {
+    CHECK_THROWS_AS(OpenOutputSink("bz2", filename), exceptions::ParsingError);
+    CHECK_THROWS_AS(OpenOutputSink("", filename), exceptions::ParsingError);
+    CHECK_THROWS_AS(OpenOutputSink("gzip", filename, true),
+                    exceptions::ParsingError);
+  }
+
+  THEN("Files that cannot be opened cause exceptions.") {
+    std::string directory{std::filesystem::temp_directory_path().string()};
+    CHECK_THROWS_AS(OpenOutputSink("file", directory), exceptions::WriteError);
+    CHECK_THROWS_AS(OpenOutputSink("fd", directory), exceptions::WriteError);
+  }
+  std::filesystem::remove(filename);
+}
+
+} // namespace
+
+} // namespace test
+
+} // namespace paste_alignments
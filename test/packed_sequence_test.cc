@@ -0,0 +1,182 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "packed_sequence.h"
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_COLOUR_NONE
+#include "catch.h"
+
+#include "string_conversions.h" // include after catch.h
+
+#include <string>
+
+#include "exceptions.h"
+
+// PackedSequence tests
+//
+// Test correctness for:
+// * FromString
+// * View
+// * At
+// * ToString
+// * Truncate
+// * AppendRun
+// * Append
+//
+// Test invariants for:
+// * operator==
+//
+// Test exceptions for:
+// * At
+// * Truncate
+// * AppendRun
+// * Append
+
+namespace paste_alignments {
+
+namespace test {
+
+namespace {
+
+// A sequence crossing several words, with runs of unpacked characters at word
+// boundaries.
+const std::string kSequence{
+    "ACGTACGTTGCAAAAACCCCGGGGTTTTACG-"
+    "--NNNNacgtRYACGTACGTACGTACGTACGT"
+    "ACGTNACGTACGTTTTTTTTTTTTTTTTTTTTTGCATGCA--A"};
+
+SCENARIO("Test correctness of PackedSequence.",
+         "[PackedSequence][correctness]") {
+
+  GIVEN("A packed sequence.") {
+    PackedSequence packed{PackedSequence::FromString(kSequence)};
+
+    THEN("It unpacks to the original sequence.") {
+      CHECK(packed.Length() == static_cast<int>(kSequence.length()));
+      CHECK(packed.ToString() == kSequence);
+      for (int i = 0; i < static_cast<int>(kSequence.length()); ++i) {
+        CHECK(packed.At(i) == kSequence.at(i));
+      }
+      std::string target{"prefix"};
+      packed.AppendTo(target);
+      CHECK(target == "prefix" + kSequence);
+    }
+
+    THEN("Truncating keeps a prefix.") {
+      for (int length : {0, 1, 31, 32, 33, 34, 40, 64, 70}) {
+        PackedSequence truncated{packed};
+        truncated.Truncate(length);
+        CHECK(truncated.ToString() == kSequence.substr(0, length));
+        CHECK(truncated == PackedSequence::FromString(
+                               kSequence.substr(0, length)));
+      }
+    }
+
+    THEN("Appending substrings and runs matches appending strings.") {
+      for (int begin : {0, 1, 5, 31, 32, 33, 63}) {
+        for (int length : {0, 1, 7, 32, 33, 40}) {
+          if (begin + length > static_cast<int>(kSequence.length())) {
+            continue;
+          }
+          for (int prefix : {0, 3, 32, 33}) {
+            PackedSequence result{PackedSequence::FromString(
+                kSequence.substr(0, prefix))};
+            result.AppendRun('N', 2);
+            result.AppendRun('-', 3);
+            result.AppendRun('G', 35);
+            result.Append(packed, begin, length);
+            std::string expected{kSequence.substr(0, prefix) + "NN---"
+                                 + std::string(35, 'G')
+                                 + kSequence.substr(begin, length)};
+            CHECK(result.ToString() == expected);
+            CHECK(result == PackedSequence::FromString(expected));
+          }
+        }
+      }
+    }
+
+    THEN("Sequences differing in one character are unequal.") {
+      std::string other{kSequence};
+      other.at(40) = 'N';
+      CHECK(packed != PackedSequence::FromString(other));
+      other.at(40) = 'A';
+      CHECK(packed != PackedSequence::FromString(other));
+    }
+
+    THEN("Views behave like packed sequences until modified.") {
+      PackedSequence view{PackedSequence::View(kSequence)};
+      CHECK(view.IsView());
+      CHECK_FALSE(packed.IsView());
+      CHECK(view == packed);
+      CHECK(view.ToString() == kSequence);
+      CHECK(view.At(33) == kSequence.at(33));
+      view.Truncate(40);
+      CHECK(view.IsView());
+      CHECK(view == PackedSequence::FromString(kSequence.substr(0, 40)));
+      view.AppendRun('N', 2);
+      view.Append(PackedSequence::View(kSequence), 5, 30);
+      CHECK_FALSE(view.IsView());
+      std::string expected{kSequence.substr(0, 40) + "NN"
+                           + kSequence.substr(5, 30)};
+      CHECK(view.ToString() == expected);
+      CHECK(view == PackedSequence::FromString(expected));
+      view = packed;
+      CHECK_FALSE(view.IsView());
+      CHECK(view == packed);
+      view = PackedSequence::View(kSequence);
+      CHECK(view.IsView());
+      CHECK(view == packed);
+    }
+
+    THEN("Sequences need about a fourth of the memory.") {
+      std::string sequence(10000, 'A');
+      for (int i = 0; i < 10000; ++i) {
+        sequence.at(i) = "ACGT"[(i * 7) % 4];
+      }
+      CHECK(PackedSequence::FromString(sequence).MemoryUsage() <= 2600l);
+    }
+  }
+}
+
+SCENARIO("Test exceptions thrown by PackedSequence.",
+         "[PackedSequence][exceptions]") {
+
+  GIVEN("A packed sequence.") {
+    PackedSequence packed{PackedSequence::FromString("ACGTN")};
+
+    THEN("Positions outside of the sequence cause exceptions.") {
+      CHECK_THROWS_AS(packed.At(-1), exceptions::OutOfRange);
+      CHECK_THROWS_AS(packed.At(5), exceptions::OutOfRange);
+      CHECK_THROWS_AS(packed.Truncate(6), exceptions::OutOfRange);
+      CHECK_THROWS_AS(packed.Truncate(-1), exceptions::OutOfRange);
+      CHECK_THROWS_AS(packed.AppendRun('N', -1), exceptions::OutOfRange);
+      PackedSequence other;
+      CHECK_THROWS_AS(other.Append(packed, 3, 3), exceptions::OutOfRange);
+      CHECK_THROWS_AS(other.Append(packed, -1, 2), exceptions::OutOfRange);
+    }
+  }
+}
+
+} // namespace
+
+} // namespace test
+
+} // namespace paste_alignments
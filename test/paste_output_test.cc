@@ -26,8 +26,11 @@
 
 #include "string_conversions.h" // include after catch.h
 
+#include <algorithm>
+#include <memory>
 #include <set>
 #include <sstream>
+#include <string_view>
 #include <vector>
 
 #include "alignment.h"
@@ -38,6 +41,16 @@
 //
 // Test correctness for:
 // * WriteBatch
+// * WriteBatch of alignments referring to their fields as read
+// * OutputFormat::FromString
+// * AppendRowRanges
+// * ExpandRowRanges
+// * BinaryWriter and BinaryReader
+//
+// Test exceptions for:
+// * OutputFormat::FromString
+// * ExpandRowRanges
+// * BinaryReader
 
 namespace paste_alignments {
 
@@ -74,7 +87,8 @@ SCENARIO("Test correctness of WriteBatch <aware>.",
   PasteParameters paste_parameters;
 
   GIVEN("A valid output stream and alignment data.") {
-    std::stringstream ss, expected_ss;
+    MemorySink sink;
+    std::stringstream expected_ss;
     ScoringSystem scoring_system{ScoringSystem::Create(400000l, 1, 2, 0, 0)};
 
     std::vector<AlignmentBatch> batches{
@@ -162,9 +176,9 @@ SCENARIO("Test correctness of WriteBatch <aware>.",
                    paste_parameters);
             expected_ss << '\n';
           }
-          WriteBatch(std::move(batch), ss, paste_parameters);
+          WriteBatch(batch, sink, paste_parameters);
         }
-        std::string expected{expected_ss.str()}, computed{ss.str()};
+        std::string expected{expected_ss.str()}, computed{sink.Data()};
         CHECK(expected == computed);
       }
     }
@@ -178,9 +192,9 @@ SCENARIO("Test correctness of WriteBatch <aware>.",
       }
       THEN("No alignments are printed.") {
         for (AlignmentBatch& batch : batches) {
-          WriteBatch(std::move(batch), ss, paste_parameters);
+          WriteBatch(batch, sink, paste_parameters);
         }
-        std::string expected{expected_ss.str()}, computed{ss.str()};
+        std::string expected{expected_ss.str()}, computed{sink.Data()};
         CHECK(expected == computed);
       }
     }
@@ -188,9 +202,9 @@ SCENARIO("Test correctness of WriteBatch <aware>.",
     WHEN("Batches are empty.") {
       THEN("No alignments are printed.") {
         for (AlignmentBatch& batch : batches) {
-          WriteBatch(std::move(batch), ss, paste_parameters);
+          WriteBatch(batch, sink, paste_parameters);
         }
-        std::string expected{expected_ss.str()}, computed{ss.str()};
+        std::string expected{expected_ss.str()}, computed{sink.Data()};
         CHECK(expected == computed);
       }
     }
@@ -209,9 +223,9 @@ SCENARIO("Test correctness of WriteBatch <aware>.",
               expected_ss << '\n';
             }
           }
-          WriteBatch(std::move(batch), ss, paste_parameters);
+          WriteBatch(batch, sink, paste_parameters);
         }
-        std::string expected{expected_ss.str()}, computed{ss.str()};
+        std::string expected{expected_ss.str()}, computed{sink.Data()};
         CHECK(expected == computed);
       }
     }
@@ -233,9 +247,9 @@ SCENARIO("Test correctness of WriteBatch <aware>.",
                    expected_ss, paste_parameters);
             expected_ss << '\n';
           }
-          WriteBatch(std::move(batch), ss, paste_parameters);
+          WriteBatch(batch, sink, paste_parameters);
         }
-        std::string expected{expected_ss.str()}, computed{ss.str()};
+        std::string expected{expected_ss.str()}, computed{sink.Data()};
         CHECK(expected == computed);
       }
     }
@@ -248,7 +262,8 @@ SCENARIO("Test correctness of WriteBatch <blind>.",
   paste_parameters.blind_mode = true;
 
   GIVEN("A valid output stream and alignment data.") {
-    std::stringstream ss, expected_ss;
+    MemorySink sink;
+    std::stringstream expected_ss;
     ScoringSystem scoring_system{ScoringSystem::Create(400000l, 1, 2, 0, 0)};
 
     std::vector<AlignmentBatch> batches{
@@ -318,9 +333,9 @@ SCENARIO("Test correctness of WriteBatch <blind>.",
                    paste_parameters);
             expected_ss << '\n';
           }
-          WriteBatch(std::move(batch), ss, paste_parameters);
+          WriteBatch(batch, sink, paste_parameters);
         }
-        std::string expected{expected_ss.str()}, computed{ss.str()};
+        std::string expected{expected_ss.str()}, computed{sink.Data()};
         CHECK(expected == computed);
       }
     }
@@ -334,9 +349,9 @@ SCENARIO("Test correctness of WriteBatch <blind>.",
       }
       THEN("No alignments are printed.") {
         for (AlignmentBatch& batch : batches) {
-          WriteBatch(std::move(batch), ss, paste_parameters);
+          WriteBatch(batch, sink, paste_parameters);
         }
-        std::string expected{expected_ss.str()}, computed{ss.str()};
+        std::string expected{expected_ss.str()}, computed{sink.Data()};
         CHECK(expected == computed);
       }
     }
@@ -344,9 +359,9 @@ SCENARIO("Test correctness of WriteBatch <blind>.",
     WHEN("Batches are empty.") {
       THEN("No alignments are printed.") {
         for (AlignmentBatch& batch : batches) {
-          WriteBatch(std::move(batch), ss, paste_parameters);
+          WriteBatch(batch, sink, paste_parameters);
         }
-        std::string expected{expected_ss.str()}, computed{ss.str()};
+        std::string expected{expected_ss.str()}, computed{sink.Data()};
         CHECK(expected == computed);
       }
     }
@@ -365,9 +380,9 @@ SCENARIO("Test correctness of WriteBatch <blind>.",
               expected_ss << '\n';
             }
           }
-          WriteBatch(std::move(batch), ss, paste_parameters);
+          WriteBatch(batch, sink, paste_parameters);
         }
-        std::string expected{expected_ss.str()}, computed{ss.str()};
+        std::string expected{expected_ss.str()}, computed{sink.Data()};
         CHECK(expected == computed);
       }
     }
@@ -389,15 +404,331 @@ SCENARIO("Test correctness of WriteBatch <blind>.",
                    expected_ss, paste_parameters);
             expected_ss << '\n';
           }
-          WriteBatch(std::move(batch), ss, paste_parameters);
+          WriteBatch(batch, sink, paste_parameters);
         }
-        std::string expected{expected_ss.str()}, computed{ss.str()};
+        std::string expected{expected_ss.str()}, computed{sink.Data()};
         CHECK(expected == computed);
       }
     }
   }
 }
 
+SCENARIO("Test correctness of WriteBatch <raw fields>.",
+         "[WriteBatch][correctness][raw]") {
+  PasteParameters parameters;
+  parameters.sequence_views = GENERATE(false, true);
+  parameters.blind_mode = GENERATE(false, true);
+  ScoringSystem scoring_system{ScoringSystem::Create(400000l, 1, 2, 0, 0)};
+
+  // Integer fields of the third row have a leading zero and must be written
+  // differently than read.
+  std::shared_ptr<const std::vector<std::string>> rows{
+      std::make_shared<const std::vector<std::string>>(std::vector<std::string>{
+          "101\t125\t1101\t1125\t24\t1\t0\t0\t10000\t100000\t25\t"
+          "GCCCCAAAATTCCCCAAAATTCCCC\tACCCCAAAATTCCCCAAAATTCCCC",
+          "127\t146\t1147\t1128\t20\t0\t0\t0\t10000\t100000\t20\t"
+          "CCCCAAAATTCCCCAAAATT\tCCCCAAAATTCCCCAAAATT",
+          "0201\t210\t2111\t2120\t10\t0\t0\t0\t10000\t100000\t10\t"
+          "CCCCAAAATT\tCCCCAAAATT",
+          "401\t420\t4120\t4101\t20\t0\t0\t0\t10000\t100000\t20\t"
+          "CCCCAAAATTCCCCAAAATT\tCCCCAAAATTCCCCAAAATT",
+          "501\t525\t5101\t5125\t24\t1\t0\t0\t10000\t100000\t25\t"
+          "GCCCCAAAATTCCCCAAAATTCCCC\tACCCCAAAATTCCCCAAAATTCCCC",
+          "527\t546\t5128\t5147\t20\t0\t0\t0\t10000\t100000\t20\t"
+          "CCCCAAAATTCCCCAAAATT\tCCCCAAAATTCCCCAAAATT"})};
+
+  GIVEN("Alignments referring to their fields as read.") {
+    std::vector<Alignment> alignments;
+    for (int i = 0; i < static_cast<int>(rows->size()); ++i) {
+      std::vector<std::string_view> fields;
+      std::string_view row{rows->at(i)};
+      for (std::string_view::size_type begin = 0, end = 0;
+           begin <= row.length(); begin = end + 1) {
+        end = std::min(row.find('\t', begin), row.length());
+        fields.push_back(row.substr(begin, end - begin));
+      }
+      alignments.push_back(Alignment::FromStringFields(
+          i + 1, fields, scoring_system, parameters, rows));
+      alignments.back().IncludeInOutput(true);
+    }
+    CHECK(alignments.at(0).RawFields().substr(0, 9) == "101\t125\t1");
+    CHECK(alignments.at(1).RawFields().substr(0, 18)
+          == "127\t146\t1147\t1128\t");
+    CHECK(alignments.at(2).RawFields().empty());
+    AlignmentBatch batch{"qseq1", "sseq1"};
+    MemorySink sink;
+    std::stringstream expected_ss;
+
+    WHEN("Alignments are written unpasted.") {
+      batch.ResetAlignments(alignments, parameters);
+
+      THEN("Output equals output formatted from values.") {
+        for (const Alignment& a : batch.Alignments()) {
+          AddRow(batch.Qseqid(), batch.Sseqid(), a, expected_ss,
+                 parameters);
+          expected_ss << '\n';
+        }
+        WriteBatch(batch, sink, parameters);
+        CHECK(sink.Data() == expected_ss.str());
+      }
+    }
+
+    WHEN("Some alignments are pasted.") {
+      batch.ResetAlignments(alignments, parameters);
+      batch.PasteAlignments(scoring_system, parameters);
+
+      THEN("Output equals output formatted from values.") {
+        int num_pasted{0};
+        for (const Alignment& a : batch.Alignments()) {
+          if (a.PastedIdentifiers().size() > 1) {
+            CHECK(a.RawFields().empty());
+            ++num_pasted;
+          }
+          if (a.IncludeInOutput()) {
+            AddRow(batch.Qseqid(), batch.Sseqid(), a, expected_ss,
+                   parameters);
+            expected_ss << '\n';
+          }
+        }
+        CHECK(num_pasted == 1);
+        WriteBatch(batch, sink, parameters);
+        CHECK(sink.Data() == expected_ss.str());
+      }
+    }
+  }
+}
+
+SCENARIO("Test correctness of OutputFormat::FromString.",
+         "[OutputFormat][FromString][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = GENERATE(false, true);
+  ScoringSystem scoring_system{ScoringSystem::Create(400000l, 1, 2, 0, 0)};
+  std::vector<Alignment> alignments{
+      Alignment::FromStringFields(1, {"101", "125", "1101", "1125",
+                                      "24", "1", "0", "0",
+                                      "10000", "100000", "25",
+                                      "GCCCCAAAATTCCCCAAAATTCCCC",
+                                      "ACCCCAAAATTCCCCAAAATTCCCC"},
+                                  scoring_system, paste_parameters),
+      Alignment::FromStringFields(2, {"127", "146", "1147", "1128",
+                                      "20", "0", "0", "0",
+                                      "10000", "100000", "20",
+                                      "CCCCAAAATTCCCCAAAATT",
+                                      "CCCCAAAATTCCCCAAAATT"},
+                                  scoring_system, paste_parameters)};
+  for (Alignment& a : alignments) {
+    a.IncludeInOutput(true);
+  }
+  AlignmentBatch batch{"qseq1", "sseq1"};
+  batch.ResetAlignments(alignments, paste_parameters);
+
+  GIVEN("The default columns.") {
+    OutputFormat format{OutputFormat::FromString(
+        "", paste_parameters.blind_mode, false)};
+
+    THEN("All columns are written.") {
+      MemorySink sink;
+      std::stringstream expected_ss;
+      for (const Alignment& a : batch.Alignments()) {
+        AddRow(batch.Qseqid(), batch.Sseqid(), a, expected_ss,
+               paste_parameters);
+        expected_ss << '\n';
+      }
+      WriteBatch(batch, sink, format);
+      CHECK(sink.Data() == expected_ss.str());
+      CHECK(format.NumColumns() == (paste_parameters.blind_mode ? 19 : 21));
+      CHECK(format.RowsColumn() == format.NumColumns() - 1);
+    }
+  }
+
+  GIVEN("Selected columns.") {
+    OutputFormat format{OutputFormat::FromString(
+        "evalue,qseqid,sstart,send,rows,qstart", paste_parameters.blind_mode,
+        GENERATE(false, true))};
+
+    THEN("Only selected columns are written in the given order.") {
+      MemorySink sink;
+      std::stringstream expected_ss;
+      for (const Alignment& a : batch.Alignments()) {
+        expected_ss << a.Evalue() << '\t' << batch.Qseqid() << '\t'
+                    << (a.PlusStrand() ? a.Sstart() : a.Send()) << '\t'
+                    << (a.PlusStrand() ? a.Send() : a.Sstart()) << '\t'
+                    << a.PastedIdentifiers().at(0) << '\t' << a.Qstart()
+                    << '\n';
+      }
+      WriteBatch(batch, sink, format);
+      CHECK(sink.Data() == expected_ss.str());
+      CHECK(format.NumColumns() == 6);
+      CHECK(format.RowsColumn() == 4);
+      CHECK(OutputFormat::FromString("qseqid,score", paste_parameters.blind_mode,
+                                     false).RowsColumn() == -1);
+    }
+  }
+}
+
+SCENARIO("Test exceptions thrown by OutputFormat::FromString.",
+         "[OutputFormat][FromString][exceptions]") {
+
+  THEN("Unknown, empty, and unavailable columns cause exceptions.") {
+    CHECK_THROWS_AS(OutputFormat::FromString("qseqid,foo", false, false),
+                    exceptions::ParsingError);
+    CHECK_THROWS_AS(OutputFormat::FromString("qseqid,,rows", false, false),
+                    exceptions::ParsingError);
+    CHECK_THROWS_AS(OutputFormat::FromString("qseqid,", false, false),
+                    exceptions::ParsingError);
+    CHECK_THROWS_AS(OutputFormat::FromString("qseqid,sseq", true, false),
+                    exceptions::ParsingError);
+    CHECK_NOTHROW(OutputFormat::FromString("qseqid,sseq", false, false));
+  }
+}
+
+SCENARIO("Test correctness of AppendRowRanges and ExpandRowRanges.",
+         "[AppendRowRanges][ExpandRowRanges][correctness]") {
+
+  GIVEN("Lists of row identifiers.") {
+    std::vector<std::vector<int>> lists{{7}, {1, 2, 3, 4, 5, 9, 7, 6},
+                                        {3, 2, 1, 2, 3},
+                                        {0, 10, 11, 13, 12, 20}};
+
+    THEN("Runs are written as ranges that expand to the same list.") {
+      for (const std::vector<int>& ids : lists) {
+        std::string rows;
+        AppendRowRanges(ids, rows);
+        CHECK(ExpandRowRanges(rows) == std::vector<long>(ids.begin(),
+                                                         ids.end()));
+      }
+    }
+  }
+
+  THEN("Runs of consecutive identifiers are written as ranges.") {
+    std::string rows{"prefix\t"};
+    AppendRowRanges({1, 2, 3, 4, 5, 9, 7, 6}, rows);
+    CHECK(rows == "prefix\t1-5,9,7-6");
+    rows.clear();
+    AppendRowRanges({3, 2, 1, 2, 3}, rows);
+    CHECK(rows == "3-1,2-3");
+    rows.clear();
+    AppendRowRanges({4, 8, 12}, rows);
+    CHECK(rows == "4,8,12");
+  }
+
+  THEN("Plain lists are expanded as they are.") {
+    CHECK(ExpandRowRanges("4,8,12") == std::vector<long>{4l, 8l, 12l});
+    CHECK(ExpandRowRanges("3") == std::vector<long>{3l});
+  }
+}
+
+SCENARIO("Test exceptions thrown by ExpandRowRanges.",
+         "[ExpandRowRanges][exceptions]") {
+
+  THEN("Malformed lists cause exceptions.") {
+    CHECK_THROWS_AS(ExpandRowRanges(""), exceptions::ParsingError);
+    CHECK_THROWS_AS(ExpandRowRanges("1,,2"), exceptions::ParsingError);
+    CHECK_THROWS_AS(ExpandRowRanges("1-2-3"), exceptions::ParsingError);
+    CHECK_THROWS_AS(ExpandRowRanges("1-"), exceptions::ParsingError);
+    CHECK_THROWS_AS(ExpandRowRanges("-1"), exceptions::ParsingError);
+    CHECK_THROWS_AS(ExpandRowRanges("1,a"), exceptions::ParsingError);
+  }
+}
+
+SCENARIO("Test correctness of BinaryWriter and BinaryReader.",
+         "[BinaryWriter][BinaryReader][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = GENERATE(false, true);
+  ScoringSystem scoring_system{ScoringSystem::Create(400000l, 1, 2, 0, 0)};
+  std::vector<Alignment> alignments{
+      Alignment::FromStringFields(1, {"101", "125", "1101", "1125",
+                                      "24", "1", "0", "0",
+                                      "10000", "100000", "25",
+                                      "GCCCCAAAATTCCCCAAAATTCCCC",
+                                      "ACCCCAAAATTCCCCAAAATTCCCC"},
+                                  scoring_system, paste_parameters),
+      Alignment::FromStringFields(2, {"127", "146", "1147", "1128",
+                                      "20", "0", "0", "0",
+                                      "10000", "100000", "20",
+                                      "CCCCAAAATTCCCCAAAATT",
+                                      "CCCCAAAATTCCCCAAAATT"},
+                                  scoring_system, paste_parameters)};
+  AlignmentBatch excluded{"qseq1", "sseq0"};
+  excluded.ResetAlignments(alignments, paste_parameters);
+  for (Alignment& a : alignments) {
+    a.IncludeInOutput(true);
+  }
+  AlignmentBatch first{"qseq1", "sseq1"};
+  first.ResetAlignments(alignments, paste_parameters);
+  AlignmentBatch second{"qseq1", "sseq2"};
+  second.ResetAlignments({alignments.at(1)}, paste_parameters);
+
+  GIVEN("Batches written in binary format.") {
+    MemorySink binary, expected;
+    BinaryWriter writer{binary, !paste_parameters.blind_mode};
+    for (const AlignmentBatch* batch : {&excluded, &first, &second}) {
+      writer.WriteBatch(*batch);
+      WriteBatch(*batch, expected, paste_parameters);
+    }
+    writer.Finish();
+
+    THEN("Batches without output alignments are not written.") {
+      CHECK(writer.NumBatches() == 2);
+    }
+
+    THEN("Blocks start at multiples of 8 bytes.") {
+      BinaryReader reader{BinaryReader::FromIStream(
+          std::make_unique<std::stringstream>(binary.Data()))};
+      for (const BinaryBatchEntry& entry : reader.Batches()) {
+        CHECK(entry.offset % 8 == 0);
+        CHECK(entry.size % 8 == 0);
+      }
+    }
+
+    THEN("The reader lists the blocks and writes the same lines.") {
+      BinaryReader reader{BinaryReader::FromIStream(
+          std::make_unique<std::stringstream>(binary.Data()))};
+      CHECK(reader.HasSequences() == !paste_parameters.blind_mode);
+      REQUIRE(reader.Batches().size() == 2);
+      CHECK(reader.Batches().at(0).qseqid == "qseq1");
+      CHECK(reader.Batches().at(0).sseqid == "sseq1");
+      CHECK(reader.Batches().at(0).num_rows == 2);
+      CHECK(reader.Batches().at(1).sseqid == "sseq2");
+      CHECK(reader.Batches().at(1).num_rows == 1);
+      std::stringstream tsv;
+      for (int i = 0; i < 2; ++i) {
+        reader.WriteTsv(i, tsv);
+      }
+      CHECK(tsv.str() == expected.Data());
+    }
+  }
+}
+
+SCENARIO("Test exceptions thrown by BinaryReader.",
+         "[BinaryReader][exceptions]") {
+  MemorySink binary;
+  BinaryWriter writer{binary, false};
+  writer.Finish();
+  std::string complete{binary.Data()};
+
+  THEN("Null, foreign, and incomplete streams cause exceptions.") {
+    CHECK_THROWS_AS(BinaryReader::FromIStream(nullptr),
+                    exceptions::ReadError);
+    CHECK_THROWS_AS(BinaryReader::FromIStream(
+                        std::make_unique<std::stringstream>("q\ts\t1\n")),
+                    exceptions::ReadError);
+    CHECK_THROWS_AS(BinaryReader::FromIStream(
+                        std::make_unique<std::stringstream>(
+                            complete.substr(0, complete.length() - 1))),
+                    exceptions::ReadError);
+    CHECK_NOTHROW(BinaryReader::FromIStream(
+        std::make_unique<std::stringstream>(complete)));
+  }
+
+  THEN("Reading a block out of range causes an exception.") {
+    BinaryReader reader{BinaryReader::FromIStream(
+        std::make_unique<std::stringstream>(complete))};
+    std::stringstream tsv;
+    CHECK_THROWS_AS(reader.WriteTsv(0, tsv), exceptions::OutOfRange);
+  }
+}
+
 } // namespace
 
 } // namespace test
@@ -0,0 +1,261 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "result_cache.h"
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_COLOUR_NONE
+#include "catch.h"
+
+#include "string_conversions.h" // include after catch.h
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "exceptions.h"
+
+// ResultCache tests
+//
+// Test correctness for:
+// * CacheKey::FromRawBatch
+// * CacheKey::Filename
+// * ResultCache::Lookup
+// * ResultCache::Store
+// * ShiftRowIds
+//
+// Test invariants for:
+// * ResultCache::Size
+//
+// Test exceptions for:
+// * ResultCache::ResultCache
+// * ShiftRowIds
+
+namespace paste_alignments {
+
+namespace test {
+
+namespace {
+
+// Returns an empty directory for a test's cache.
+//
+std::string EmptyCacheDirectory() {
+  std::filesystem::path directory{std::filesystem::temp_directory_path()
+                                  / "paste_alignments_result_cache_test"};
+  std::filesystem::remove_all(directory);
+  return directory.string();
+}
+
+// Returns statistics of one batch with one alignment.
+//
+StatsCollector MakeStats() {
+  PasteParameters paste_parameters;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::vector<Alignment> alignments{
+      Alignment::FromStringFields(1, {"101", "120", "1131", "1150",
+                                   "20", "0", "0", "0",
+                                   "10000", "100000", "20",
+                                   "CCCCAAAATTCCCCAAAATT",
+                                   "CCCCAAAATTCCCCAAAATT"},
+                                  scoring_system, paste_parameters)};
+  alignments.at(0).IncludeInOutput(true);
+  AlignmentBatch batch{"query", "subject"};
+  batch.ResetAlignments(alignments, paste_parameters);
+  StatsCollector result;
+  result.CollectStats(batch);
+  return result;
+}
+
+SCENARIO("Test correctness of CacheKey::FromRawBatch.",
+         "[CacheKey][FromRawBatch][correctness]") {
+  RawBatch raw_batch{"query", "subject", 1l,
+                     {"query\tsubject\t1\t20", "query\tsubject\t31\t50"}};
+  CacheKey key{CacheKey::FromRawBatch(raw_batch, "settings")};
+
+  THEN("The key doesn't depend on the rows' identifiers.") {
+    RawBatch moved{raw_batch};
+    moved.first_row_id = 1001l;
+    CHECK(CacheKey::FromRawBatch(moved, "settings") == key);
+  }
+
+  THEN("The key depends on the settings.") {
+    CacheKey other{CacheKey::FromRawBatch(raw_batch, "other settings")};
+    CHECK(other.name_hash != key.name_hash);
+    CHECK(other.check_hash != key.check_hash);
+  }
+
+  THEN("The key depends on the rows and their boundaries.") {
+    RawBatch changed{raw_batch};
+    changed.rows.at(1) = "query\tsubject\t31\t51";
+    CHECK_FALSE(CacheKey::FromRawBatch(changed, "settings") == key);
+    RawBatch joined{raw_batch};
+    joined.rows = {"query\tsubject\t1\t20query\tsubject\t31\t50"};
+    CHECK_FALSE(CacheKey::FromRawBatch(joined, "settings") == key);
+  }
+
+  THEN("The hashes are independent.") {
+    CHECK(key.name_hash != key.check_hash);
+  }
+
+  THEN("The filename consists of the name hash in hexadecimal.") {
+    CHECK(key.Filename().length() == 22);
+    CHECK(key.Filename().substr(16) == ".entry");
+    CHECK(std::stoull(key.Filename().substr(0, 16), nullptr, 16)
+          == key.name_hash);
+  }
+}
+
+SCENARIO("Test correctness of ShiftRowIds.",
+         "[ShiftRowIds][correctness]") {
+
+  GIVEN("Output lines.") {
+    std::string output{"q\ts\t1\t20\t1,2,3\n"
+                       "q\ts\t31\t50\t4\n"};
+
+    THEN("Identifiers in the last column are shifted.") {
+      CHECK(ShiftRowIds(output, 10l) == "q\ts\t1\t20\t11,12,13\n"
+                                        "q\ts\t31\t50\t14\n");
+      CHECK(ShiftRowIds(ShiftRowIds(output, 99l), -99l) == output);
+    }
+
+    THEN("Both ends of ranges are shifted.") {
+      CHECK(ShiftRowIds("q\ts\t1-3,7,9-8\n", 10l)
+            == "q\ts\t11-13,17,19-18\n");
+    }
+
+    THEN("Empty output remains empty.") {
+      CHECK(ShiftRowIds("", 5l) == "");
+    }
+  }
+}
+
+SCENARIO("Test exceptions thrown by ShiftRowIds.",
+         "[ShiftRowIds][exceptions]") {
+  CHECK_THROWS_AS(ShiftRowIds("q\ts\t1,a\n", 1l), exceptions::ParsingError);
+  CHECK_THROWS_AS(ShiftRowIds("q\ts\t1,,2\n", 1l), exceptions::ParsingError);
+  CHECK_THROWS_AS(ShiftRowIds("q\ts\t\n", 1l), exceptions::ParsingError);
+}
+
+SCENARIO("Test correctness of ResultCache::Lookup and ResultCache::Store.",
+         "[ResultCache][Lookup][Store][correctness]") {
+  std::string directory{EmptyCacheDirectory()};
+  StatsCollector stats{MakeStats()};
+  std::vector<CacheKey> keys;
+  for (std::string settings : {"a", "b", "c"}) {
+    keys.emplace_back(CacheKey::FromRawBatch(RawBatch(), settings));
+  }
+
+  GIVEN("An empty cache.") {
+    ResultCache cache{directory, 1000000l};
+    std::string output;
+    StatsCollector found_stats;
+
+    THEN("Lookups miss.") {
+      CHECK_FALSE(cache.Lookup(keys.at(0), output, found_stats));
+      CHECK(cache.Size() == 0l);
+    }
+
+    WHEN("An entry is stored.") {
+      cache.Store(keys.at(0), "q\ts\t1\n", stats);
+
+      THEN("Its output and statistics are found.") {
+        CHECK(cache.Lookup(keys.at(0), output, found_stats));
+        CHECK(output == "q\ts\t1\n");
+        CHECK(found_stats == stats);
+        CHECK(cache.Size() > 0l);
+        CHECK_FALSE(cache.Lookup(keys.at(1), output, found_stats));
+      }
+
+      THEN("A new cache on the directory finds the entry.") {
+        ResultCache reopened{directory, 1000000l};
+        CHECK(reopened.Size() == cache.Size());
+        CHECK(reopened.Lookup(keys.at(0), output, found_stats));
+        CHECK(output == "q\ts\t1\n");
+      }
+
+      THEN("A corrupt entry is removed and misses.") {
+        std::ofstream ofs{std::filesystem::path{directory}
+                          / keys.at(0).Filename()};
+        ofs << "paste_alignments cache 1\ngarbage";
+        ofs.close();
+        CHECK_FALSE(cache.Lookup(keys.at(0), output, found_stats));
+        CHECK(cache.Size() == 0l);
+      }
+    }
+  }
+
+  GIVEN("A cache with room for two entries.") {
+    long entry_size;
+    {
+      ResultCache measure{directory, 1000000l};
+      measure.Store(keys.at(0), "q\ts\t1\n", stats);
+      entry_size = measure.Size();
+    }
+    std::filesystem::remove_all(directory);
+    ResultCache cache{directory, 2 * entry_size + entry_size / 2};
+    cache.Store(keys.at(0), "q\ts\t1\n", stats);
+    cache.Store(keys.at(1), "q\ts\t2\n", stats);
+    std::string output;
+    StatsCollector found_stats;
+
+    THEN("The least recently stored entry is evicted.") {
+      cache.Store(keys.at(2), "q\ts\t3\n", stats);
+      CHECK(cache.Size() == 2 * entry_size);
+      CHECK_FALSE(cache.Lookup(keys.at(0), output, found_stats));
+      CHECK(cache.Lookup(keys.at(1), output, found_stats));
+      CHECK(cache.Lookup(keys.at(2), output, found_stats));
+    }
+
+    THEN("The least recently used entry is evicted.") {
+      CHECK(cache.Lookup(keys.at(0), output, found_stats));
+      cache.Store(keys.at(2), "q\ts\t3\n", stats);
+      CHECK(cache.Lookup(keys.at(0), output, found_stats));
+      CHECK_FALSE(cache.Lookup(keys.at(1), output, found_stats));
+      CHECK(cache.Lookup(keys.at(2), output, found_stats));
+    }
+  }
+
+  GIVEN("A cache smaller than an entry.") {
+    ResultCache cache{directory, 10l};
+
+    THEN("Entries are not stored.") {
+      cache.Store(keys.at(0), "q\ts\t1\n", stats);
+      std::string output;
+      StatsCollector found_stats;
+      CHECK_FALSE(cache.Lookup(keys.at(0), output, found_stats));
+      CHECK(cache.Size() == 0l);
+    }
+  }
+  std::filesystem::remove_all(directory);
+}
+
+SCENARIO("Test exceptions thrown by ResultCache::ResultCache.",
+         "[ResultCache][ResultCache][exceptions]") {
+  std::string directory{EmptyCacheDirectory()};
+  CHECK_THROWS_AS(ResultCache(directory, -1l), exceptions::OutOfRange);
+  std::filesystem::remove_all(directory);
+}
+
+} // namespace
+
+} // namespace test
+
+} // namespace paste_alignments
@@ -28,6 +28,7 @@
 
 #include <cmath>
 #include <limits>
+#include <vector>
 
 #include "alignment.h"
 #include "exceptions.h"
@@ -42,6 +43,8 @@
 // * RawScore
 // * Bitscore
 // * Evalue
+// * EvalueScoreThreshold
+// * BitscoreScoreThreshold
 // 
 // Test invariants for:
 // * Create
@@ -808,6 +811,90 @@ SCENARIO("Testing correctness of ScoringSystem::Evalue.",
   }
 }
 
+SCENARIO("Test correctness of ScoringSystem::EvalueScoreThreshold.",
+         "[ScoringSystem][EvalueScoreThreshold][correctness]") {
+  PasteParameters paste_parameters;
+
+  GIVEN("Scoring systems with and without rounding to even scores.") {
+    // Megablast extension costs make scores multiples of 0.5 for reward 1;
+    // scores are rounded to the next lower even number for reward 2, penalty 3.
+    std::vector<ScoringSystem> scoring_systems{
+        ScoringSystem::Create(10000l, 1, 2, 0, 0),
+        ScoringSystem::Create(100000000l, 1, 5, 3, 3),
+        ScoringSystem::Create(10000l, 2, 3, 0, 0)};
+
+    THEN("The threshold is the smallest multiple of 0.5 of at most the evalue.") {
+      for (const ScoringSystem& scoring_system : scoring_systems) {
+        for (double evalue : {1e-50, 1e-5, 0.001, 1.0, 10.0}) {
+          for (int qlen : {80, 10000}) {
+            float threshold{scoring_system.EvalueScoreThreshold(
+                evalue, qlen, paste_parameters)};
+            CHECK(std::fmod(threshold, 0.5f) == 0.0f);
+            CHECK(scoring_system.Evalue(threshold, qlen, paste_parameters)
+                  <= evalue);
+            CHECK(scoring_system.Evalue(threshold - 0.5f, qlen,
+                                        paste_parameters)
+                  > evalue);
+          }
+        }
+      }
+    }
+
+    THEN("Thresholds are even when scores are rounded to even numbers.") {
+      for (double evalue : {1e-50, 1e-5, 0.001, 1.0, 10.0}) {
+        float threshold{scoring_systems.back().EvalueScoreThreshold(
+            evalue, 80, paste_parameters)};
+        CHECK(std::fmod(threshold, 2.0f) == 0.0f);
+      }
+    }
+  }
+
+  GIVEN("An evalue satisfied by every score.") {
+    ScoringSystem scoring_system{ScoringSystem::Create(10000l, 1, 2, 0, 0)};
+
+    THEN("The threshold is the lowest float.") {
+      CHECK(scoring_system.EvalueScoreThreshold(
+                std::numeric_limits<double>::infinity(), 80, paste_parameters)
+            == std::numeric_limits<float>::lowest());
+    }
+  }
+}
+
+SCENARIO("Test correctness of ScoringSystem::BitscoreScoreThreshold.",
+         "[ScoringSystem][BitscoreScoreThreshold][correctness]") {
+  PasteParameters paste_parameters;
+
+  GIVEN("Scoring systems with and without rounding to even scores.") {
+    std::vector<ScoringSystem> scoring_systems{
+        ScoringSystem::Create(10000l, 1, 2, 0, 0),
+        ScoringSystem::Create(10000l, 1, 5, 3, 3),
+        ScoringSystem::Create(10000l, 2, 3, 0, 0)};
+
+    THEN("The threshold is the smallest multiple of 0.5 of at least the"
+         " bitscore.") {
+      for (const ScoringSystem& scoring_system : scoring_systems) {
+        for (float bitscore : {1.0f, 20.0f, 37.5f, 1000.0f}) {
+          float threshold{scoring_system.BitscoreScoreThreshold(
+              bitscore, paste_parameters)};
+          CHECK(std::fmod(threshold, 0.5f) == 0.0f);
+          CHECK(scoring_system.Bitscore(threshold, paste_parameters)
+                >= bitscore);
+          CHECK(scoring_system.Bitscore(threshold - 0.5f, paste_parameters)
+                < bitscore);
+        }
+      }
+    }
+
+    THEN("Thresholds are even when scores are rounded to even numbers.") {
+      for (float bitscore : {1.0f, 20.0f, 37.5f, 1000.0f}) {
+        CHECK(std::fmod(scoring_systems.back().BitscoreScoreThreshold(
+                            bitscore, paste_parameters), 2.0f)
+              == 0.0f);
+      }
+    }
+  }
+}
+
 } // namespace
 
 } // namespace test
@@ -0,0 +1,204 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "sharding.h"
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_COLOUR_NONE
+#include "catch.h"
+
+#include "string_conversions.h" // include after catch.h
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "alignment_reader.h"
+#include "exceptions.h"
+
+// Sharding tests
+//
+// Test correctness for:
+// * Shard::FromString
+// * FindShardRange
+// * ShardFilename
+// * OutputShardIndex
+//
+// Test invariants for:
+//
+// Test exceptions for:
+// * Shard::FromString
+
+namespace paste_alignments {
+
+namespace test {
+
+namespace {
+
+// Returns input data with batches of 1, 2, ..., `num_batches` rows.
+//
+std::string MakeInput(int num_batches) {
+  std::stringstream ss;
+  for (int batch = 1; batch <= num_batches; ++batch) {
+    for (int row = 0; row < batch; ++row) {
+      ss << "qseq" << batch / 3 << "\tsseq" << batch % 3
+         << "\t101\t125\t1101\t1125\t24\t1\t0\t0\t10000\t100000\t25"
+         << "\tGCCCCAAAATTCCCCAAAATTCCCC\tACCCCAAAATTCCCCAAAATTCCCC\n";
+    }
+  }
+  return ss.str();
+}
+
+// Returns all batches read from `input` within `range`.
+//
+std::vector<AlignmentBatch> ReadAll(const std::string& input,
+                                    const InputRange& range) {
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  PasteParameters paste_parameters;
+  std::unique_ptr<std::istream> is{new std::stringstream{input}};
+  AlignmentReader reader{AlignmentReader::FromIStream(std::move(is), 13,
+                                                      range)};
+  std::vector<AlignmentBatch> result;
+  while (!reader.EndOfData()) {
+    result.push_back(reader.ReadBatch(scoring_system, paste_parameters));
+  }
+  return result;
+}
+
+SCENARIO("Test correctness of Shard::FromString.",
+         "[Shard][FromString][correctness]") {
+
+  THEN("Index and count are extracted.") {
+    Shard expected;
+    expected.index = 2;
+    expected.num_shards = 8;
+    CHECK(Shard::FromString("2/8") == expected);
+    expected.index = 1;
+    expected.num_shards = 1;
+    CHECK(Shard::FromString("1/1") == expected);
+  }
+}
+
+SCENARIO("Test exceptions thrown by Shard::FromString.",
+         "[Shard][FromString][exceptions]") {
+
+  THEN("Malformed or out of range specifications cause exception.") {
+    std::string specification = GENERATE(as<std::string>{}, "", "2", "2/",
+                                         "/2", "0/2", "3/2", "-1/2", "1/2x",
+                                         "1-2", "a/b");
+    CHECK_THROWS_AS(Shard::FromString(specification), exceptions::ParsingError);
+  }
+}
+
+SCENARIO("Test correctness of FindShardRange.",
+         "[FindShardRange][correctness]") {
+  std::string input{MakeInput(12)};
+  std::vector<AlignmentBatch> expected_batches{ReadAll(input, InputRange())};
+  int num_shards = GENERATE(1, 2, 3, 5, 40);
+
+  GIVEN("The ranges of all shards of the input.") {
+    std::vector<InputRange> ranges;
+    std::stringstream ss{input};
+    for (int index = 1; index <= num_shards; ++index) {
+      Shard shard;
+      shard.index = index;
+      shard.num_shards = num_shards;
+      ranges.push_back(FindShardRange(ss, shard));
+    }
+
+    THEN("Ranges are consecutive and cover the input.") {
+      CHECK(ranges.front().begin_offset == 0l);
+      CHECK(ranges.back().end_offset == static_cast<long>(input.length()));
+      for (int i = 1; i < num_shards; ++i) {
+        CHECK(ranges.at(i - 1).end_offset == ranges.at(i).begin_offset);
+      }
+    }
+
+    THEN("Ranges begin at rows and first row identifiers are line numbers.") {
+      for (const InputRange& range : ranges) {
+        long offset{range.begin_offset};
+        CHECK((offset == 0l || offset == static_cast<long>(input.length())
+               || input.at(offset - 1l) == '\n'));
+        CHECK(range.first_row_id
+              == 1l + std::count(input.begin(), input.begin() + offset, '\n'));
+      }
+    }
+
+    THEN("The stream is positioned at the beginning of the last range.") {
+      CHECK(static_cast<long>(ss.tellg()) == ranges.back().begin_offset);
+    }
+
+    THEN("Reading each shard yields the batches of the whole input.") {
+      std::vector<AlignmentBatch> computed_batches;
+      for (const InputRange& range : ranges) {
+        for (AlignmentBatch& batch : ReadAll(input, range)) {
+          computed_batches.push_back(std::move(batch));
+        }
+      }
+      CHECK(computed_batches == expected_batches);
+    }
+  }
+}
+
+SCENARIO("Test correctness of ShardFilename.",
+         "[ShardFilename][correctness]") {
+
+  THEN("The shard's index is appended to the file name.") {
+    CHECK(ShardFilename("out.tsv", 3) == "out.tsv.3");
+  }
+}
+
+SCENARIO("Test correctness of OutputShardIndex.",
+         "[OutputShardIndex][correctness]") {
+
+  THEN("The index is the FNV-1a hash of the identifier modulo the count.") {
+    CHECK(OutputShardIndex("", 7) == 2);
+    CHECK(OutputShardIndex("a", 7) == 5);
+    CHECK(OutputShardIndex("query1", 7) == 5);
+    CHECK(OutputShardIndex("query1", 4) == 2);
+    CHECK(OutputShardIndex("NC_000913.3", 4) == 3);
+  }
+
+  THEN("A single shard receives every query.") {
+    CHECK(OutputShardIndex("query1", 1) == 0);
+    CHECK(OutputShardIndex("a", 1) == 0);
+  }
+
+  THEN("Indices lie in the range of shards.") {
+    for (int i = 0; i < 100; ++i) {
+      int index{OutputShardIndex("query" + std::to_string(i), 3)};
+      CHECK(index >= 0);
+      CHECK(index < 3);
+    }
+  }
+
+  THEN("A non-positive number of shards is rejected.") {
+    CHECK_THROWS_AS(OutputShardIndex("a", 0), exceptions::OutOfRange);
+    CHECK_THROWS_AS(OutputShardIndex("a", -2), exceptions::OutOfRange);
+  }
+}
+
+} // namespace
+
+} // namespace test
+
+} // namespace paste_alignments
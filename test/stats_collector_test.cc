@@ -27,6 +27,9 @@
 #include "string_conversions.h" // include after catch.h
 
 #include <set>
+#include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "helpers.h"
@@ -36,6 +39,15 @@
 // Test correctness for:
 // * CollectStats
 // * WriteData
+// * WriteDegraded
+// * ShiftRowIds
+// * Spill
+// * WriteState
+// * FromIStream
+// * CombineStats
+// * PasteTotals
+// * WriteSummary
+// * ReadSummaryTotals
 
 namespace paste_alignments {
 
@@ -600,6 +612,452 @@ SCENARIO("Test correctness of StatsCollector::WriteData.",
       CHECK(FuzzyEquals(expected_return_value, computed_return_value));
       CHECK(expected_ss.str() == computed_ss.str());
     }
+
+    THEN("Rows are routed to the stream chosen for their batch in order.") {
+      Average(expected_return_value);
+      std::vector<std::stringstream> computed_streams(2), expected_streams(2);
+      std::string line;
+      for (int i = 0; std::getline(expected_ss, line); ++i) {
+        expected_streams.at(i % 2) << line << '\n';
+      }
+      computed_return_value = collector.WriteData(
+          [&](const PasteStats& s) -> std::ostream& {
+            return computed_streams.at((std::stoi(s.qseqid.substr(6)) - 1)
+                                       % 2);
+          });
+      CHECK(FuzzyEquals(expected_return_value, computed_return_value));
+      CHECK(expected_streams.at(0).str() == computed_streams.at(0).str());
+      CHECK(expected_streams.at(1).str() == computed_streams.at(1).str());
+    }
+  }
+}
+
+SCENARIO("Test correctness of StatsCollector's handling of removed"
+         " alignments.",
+         "[StatsCollector][CollectStats][WriteData][ShiftRowIds][WriteState]"
+         "[FromIStream][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  paste_parameters.remove_redundant = true;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::vector<Alignment> alignments{
+      Alignment::FromStringFields(1, {"101", "120", "1101", "1120",
+                                   "20", "0", "0", "0",
+                                   "10000", "100000", "20"},
+                                  scoring_system, paste_parameters),
+      Alignment::FromStringFields(2, {"101", "120", "1101", "1120",
+                                   "20", "0", "0", "0",
+                                   "10000", "100000", "20"},
+                                  scoring_system, paste_parameters),
+      Alignment::FromStringFields(3, {"105", "114", "1105", "1114",
+                                   "10", "0", "0", "0",
+                                   "10000", "100000", "10"},
+                                  scoring_system, paste_parameters)};
+
+  GIVEN("Stats collected from a batch with removed alignments.") {
+    AlignmentBatch batch{"qseqid", "sseqid"};
+    batch.ResetAlignments(alignments, paste_parameters);
+    batch.PasteAlignments(scoring_system, paste_parameters);
+    StatsCollector collector;
+    collector.CollectStats(batch);
+
+    THEN("Removed alignments are recorded.") {
+      REQUIRE(collector.BatchStats().size() == 1);
+      CHECK(collector.BatchStats().at(0).removed_rows
+            == std::vector<std::pair<int,int>>{{2, 1}, {3, 1}});
+      CHECK(collector.BatchStats().at(0).num_alignments == 1l);
+      CHECK(collector.Totals().num_removed_alignments == 2l);
+    }
+
+    THEN("Removed alignments are written in an additional column on"
+         " request.") {
+      std::stringstream with_column, without_column;
+      collector.WriteData(with_column, true);
+      collector.WriteData(without_column);
+      CHECK(with_column.str().substr(with_column.str().rfind('\t'))
+            == "\t2:1,3:1\n");
+      CHECK(without_column.str().find(':') == std::string::npos);
+    }
+
+    THEN("Shifting row identifiers shifts removed alignments.") {
+      collector.ShiftRowIds(10l);
+      CHECK(collector.BatchStats().at(0).removed_rows
+            == std::vector<std::pair<int,int>>{{12, 11}, {13, 11}});
+    }
+
+    THEN("The state is restored from what was written.") {
+      StatsCollector empty;
+      empty.CollectStats(AlignmentBatch{"qseqid", "sseqid"});
+      collector.Merge(empty);
+      std::stringstream ss;
+      collector.WriteState(ss);
+      CHECK(StatsCollector::FromIStream(ss) == collector);
+    }
+  }
+
+  GIVEN("A batch whose remaining alignments are all filtered.") {
+    paste_parameters.final_score_threshold = 100.0f;
+    AlignmentBatch batch{"qseqid", "sseqid"};
+    batch.ResetAlignments(alignments, paste_parameters);
+    batch.PasteAlignments(scoring_system, paste_parameters);
+    StatsCollector collector;
+    collector.CollectStats(batch);
+
+    THEN("The batch's stats are stored for its removed alignments.") {
+      REQUIRE(collector.BatchStats().size() == 1);
+      CHECK(collector.BatchStats().at(0).num_alignments == 0l);
+      CHECK(collector.BatchStats().at(0).removed_rows.size() == 2);
+    }
+  }
+}
+
+SCENARIO("Test correctness of StatsCollector's handling of degraded"
+         " batches.",
+         "[StatsCollector][CollectStats][WriteDegraded][WriteState]"
+         "[FromIStream][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  paste_parameters.candidate_budget = 1l;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::vector<Alignment> alignments{
+      Alignment::FromStringFields(1, {"101", "120", "1101", "1120",
+                                   "20", "0", "0", "0",
+                                   "10000", "100000", "20"},
+                                  scoring_system, paste_parameters),
+      Alignment::FromStringFields(2, {"125", "144", "1125", "1144",
+                                   "20", "0", "0", "0",
+                                   "10000", "100000", "20"},
+                                  scoring_system, paste_parameters),
+      Alignment::FromStringFields(3, {"149", "168", "1149", "1168",
+                                   "20", "0", "0", "0",
+                                   "10000", "100000", "20"},
+                                  scoring_system, paste_parameters)};
+
+  GIVEN("Stats collected from a batch whose budget was exhausted.") {
+    AlignmentBatch degraded{"qseqid", "sseqid"}, first{"other", "sseqid"},
+                   second{"other", "sseqid"};
+    degraded.ResetAlignments(alignments, paste_parameters);
+    first.ResetAlignments({alignments.at(0)}, paste_parameters);
+    second.ResetAlignments({alignments.at(1), alignments.at(2)},
+                           paste_parameters);
+    for (AlignmentBatch* batch : {&degraded, &first, &second}) {
+      batch->PasteAlignments(scoring_system, paste_parameters);
+    }
+    REQUIRE(degraded.NumUnextendedSeeds() > 0);
+    REQUIRE(first.NumUnextendedSeeds() == 0);
+    REQUIRE(second.NumUnextendedSeeds() > 0);
+    StatsCollector collector;
+    collector.CollectStats(degraded);
+
+    THEN("The batch is recorded as degraded.") {
+      REQUIRE(collector.BatchStats().size() == 1);
+      CHECK(collector.BatchStats().at(0).num_unextended_seeds
+            == static_cast<long>(degraded.NumUnextendedSeeds()));
+      CHECK(collector.Totals().num_degraded_batches == 1l);
+      CHECK(collector.Totals().num_scanned_candidates == 1l);
+    }
+
+    THEN("Only degraded batches are written to the degraded batches"
+         " report.") {
+      collector.CollectStats(first);
+      std::stringstream ss;
+      collector.WriteDegraded(ss);
+      CHECK(ss.str() == "qseqid\tsseqid\t"
+                        + std::to_string(degraded.NumUnextendedSeeds())
+                        + "\n");
+    }
+
+    THEN("Degraded batches are routed to the stream chosen for them.") {
+      collector.CollectStats(first);
+      collector.CollectStats(second);
+      std::stringstream degraded_ss, other_ss;
+      collector.WriteDegraded([&](const PasteStats& s) -> std::ostream& {
+        return (s.qseqid == "qseqid" ? degraded_ss : other_ss);
+      });
+      CHECK(degraded_ss.str() == "qseqid\tsseqid\t"
+                                 + std::to_string(degraded.NumUnextendedSeeds())
+                                 + "\n");
+      CHECK(other_ss.str() == "other\tsseqid\t"
+                              + std::to_string(second.NumUnextendedSeeds())
+                              + "\n");
+    }
+
+    THEN("A batch collected in parts is counted as degraded once.") {
+      collector.CollectStats(first);
+      collector.CollectStats(second, true);
+      CHECK(collector.Totals().num_degraded_batches == 2l);
+      CHECK(collector.BatchStats().at(1).num_unextended_seeds
+            == static_cast<long>(second.NumUnextendedSeeds()));
+    }
+
+    THEN("The state is restored from what was written.") {
+      std::stringstream ss;
+      collector.WriteState(ss);
+      CHECK(StatsCollector::FromIStream(ss) == collector);
+    }
+  }
+}
+
+SCENARIO("Test correctness of StatsCollector::Spill.",
+         "[StatsCollector][Spill][WriteData][WriteState][FromIStream]"
+         "[correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::vector<AlignmentBatch> batches;
+  for (int i = 0; i < 5; ++i) {
+    AlignmentBatch batch{"qseqid" + std::to_string(i), "sseqid"};
+    batch.ResetAlignments(
+        {Alignment::FromStringFields(i + 1, {"101", "125", "1101", "1125",
+                                             "24", "1", "0", "0",
+                                             "10000", "100000", "25"},
+                                     scoring_system, paste_parameters)},
+        paste_parameters);
+    batch.PasteAlignments(scoring_system, paste_parameters);
+    batches.push_back(batch);
+  }
+
+  GIVEN("Stats of several batches, some of which were spilled.") {
+    StatsCollector spilled, resident;
+    for (int i = 0; i < 3; ++i) {
+      spilled.CollectStats(batches.at(i));
+      resident.CollectStats(batches.at(i));
+    }
+    spilled.Spill();
+    for (int i = 3; i < 5; ++i) {
+      spilled.CollectStats(batches.at(i));
+      resident.CollectStats(batches.at(i));
+    }
+
+    THEN("Only the last batch's stats stay in memory.") {
+      CHECK(spilled.NumSpilled() == 2l);
+      CHECK(spilled.BatchStats().size() == 3);
+      CHECK(spilled.BatchStats().at(0).qseqid == "qseqid2");
+      CHECK(spilled.MemoryUsage() < resident.MemoryUsage());
+    }
+
+    THEN("The object behaves as if nothing was spilled.") {
+      CHECK(spilled == resident);
+      std::stringstream spilled_data, resident_data;
+      CHECK(FuzzyEquals(spilled.WriteData(spilled_data),
+                        resident.WriteData(resident_data)));
+      CHECK(spilled_data.str() == resident_data.str());
+      std::stringstream ss;
+      spilled.WriteState(ss);
+      CHECK(StatsCollector::FromIStream(ss) == resident);
+      StatsCollector merged;
+      merged.Merge(spilled);
+      CHECK(merged == resident);
+    }
+
+    THEN("Copies spilling again do not affect each other.") {
+      StatsCollector copy{spilled};
+      spilled.Spill();
+      resident.CollectStats(batches.at(0));
+      copy.CollectStats(batches.at(0));
+      copy.Spill();
+      CHECK(spilled.NumSpilled() == 4l);
+      CHECK(copy.NumSpilled() == 5l);
+      CHECK(copy == resident);
+      resident.Spill();
+      CHECK(resident == copy);
+    }
+  }
+}
+
+SCENARIO("Test correctness of StatsCollector::CollectStats for batches"
+         " collected in parts.", "[StatsCollector][CollectStats][correctness]") {
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  std::vector<Alignment> alignments{
+      Alignment::FromStringFields(1, {"101", "125", "1101", "1125",
+                                   "24", "1", "0", "0",
+                                   "10000", "100000", "25"},
+                                  scoring_system, paste_parameters),
+      Alignment::FromStringFields(2, {"301", "320", "1301", "1320",
+                                   "17", "3", "0", "0",
+                                   "10000", "100000", "20"},
+                                  scoring_system, paste_parameters),
+      Alignment::FromStringFields(3, {"501", "550", "1501", "1550",
+                                   "45", "5", "0", "0",
+                                   "10000", "100000", "50"},
+                                  scoring_system, paste_parameters)};
+
+  GIVEN("A batch and the same batch split into two parts.") {
+    AlignmentBatch whole{"qseqid", "sseqid"}, first{"qseqid", "sseqid"},
+                   second{"qseqid", "sseqid"}, other{"other", "sseqid"};
+    whole.ResetAlignments(alignments, paste_parameters);
+    first.ResetAlignments({alignments.at(0)}, paste_parameters);
+    second.ResetAlignments({alignments.at(1), alignments.at(2)},
+                           paste_parameters);
+    other.ResetAlignments({alignments.at(0)}, paste_parameters);
+    for (AlignmentBatch* batch : {&whole, &first, &second, &other}) {
+      batch->PasteAlignments(scoring_system, paste_parameters);
+    }
+    StatsCollector expected, collector;
+    expected.CollectStats(whole);
+    expected.CollectStats(other);
+    collector.CollectStats(first);
+    collector.CollectStats(second, true);
+    collector.CollectStats(other);
+
+    THEN("Stats of the parts equal those of the whole batch.") {
+      CHECK(collector.BatchStats() == expected.BatchStats());
+      CHECK(collector.BatchStats().size() == 2);
+    }
+
+    THEN("Totals only differ in the strategy counted and the candidates"
+         " scanned for each part.") {
+      PasteTotals totals{collector.Totals()};
+      CHECK(totals.num_indexed_greedy_batches == 3l);
+      CHECK(totals.num_scanned_candidates
+            <= expected.Totals().num_scanned_candidates);
+      totals.num_indexed_greedy_batches -= 1l;
+      totals.num_scanned_candidates = expected.Totals().num_scanned_candidates;
+      CHECK(totals == expected.Totals());
+    }
+  }
+}
+
+SCENARIO("Test correctness of CombineStats.", "[CombineStats][correctness]") {
+
+  THEN("Combining no stats returns empty stats.") {
+    CHECK(FuzzyEquals(CombineStats({}), PasteStats()));
+  }
+
+  GIVEN("Stats of several disjoint sets of alignments.") {
+    PasteStats first, second, empty, expected;
+    first.qseqid = "qseqid1";
+    first.sseqid = "sseqid1";
+    first.num_alignments = 1l;
+    first.num_pastings = 2l;
+    first.average_length = 10.0f;
+    first.average_pident = 90.0f;
+    first.average_score = 20.0f;
+    first.average_bitscore = 30.0f;
+    first.average_evalue = 0.5;
+    first.average_nmatches = 1.0f;
+    second.qseqid = "qseqid2";
+    second.sseqid = "sseqid2";
+    second.num_alignments = 3l;
+    second.num_pastings = 1l;
+    second.average_length = 30.0f;
+    second.average_pident = 70.0f;
+    second.average_score = 40.0f;
+    second.average_bitscore = 50.0f;
+    second.average_evalue = 0.1;
+    second.average_nmatches = 5.0f;
+    expected.num_alignments = 4l;
+    expected.num_pastings = 3l;
+    expected.average_length = 25.0f;
+    expected.average_pident = 75.0f;
+    expected.average_score = 35.0f;
+    expected.average_bitscore = 45.0f;
+    expected.average_evalue = 0.2;
+    expected.average_nmatches = 4.0f;
+
+    THEN("Averages are weighted by the number of alignments.") {
+      CHECK(FuzzyEquals(CombineStats({first, empty, second}), expected));
+    }
+  }
+}
+
+SCENARIO("Test correctness of PasteTotals.", "[PasteTotals][correctness]") {
+  PasteParameters paste_parameters;
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  Alignment first{Alignment::FromStringFields(0, {"101", "125", "1101", "1125",
+                                               "24", "1", "0", "0",
+                                               "10000", "100000", "25",
+                                               "GCCCCAAAATTCCCCAAAATTCCCC",
+                                               "ACCCCAAAATTCCCCAAAATTCCCC"},
+                                              scoring_system,
+                                              paste_parameters)};
+  Alignment second{Alignment::FromStringFields(1, {"101", "120", "1131", "1150",
+                                                "20", "0", "0", "0",
+                                                "10000", "100000", "20",
+                                                "CCCCAAAATTCCCCAAAATT",
+                                                "CCCCAAAATTCCCCAAAATT"},
+                                               scoring_system,
+                                               paste_parameters)};
+
+  GIVEN("Totals of two alignments added separately and combined.") {
+    PasteTotals both, first_only, second_only;
+    both.Add(first);
+    both.Add(second);
+    both.num_seeds = 5l;
+    both.num_pruned_seeds = 3l;
+    both.num_removed_alignments = 4l;
+    both.num_window_overflows = 1l;
+    both.num_brute_force_batches = 2l;
+    both.num_indexed_greedy_batches = 1l;
+    both.num_cluster_parallel_batches = 3l;
+    both.num_scanned_candidates = 7l;
+    both.num_degraded_batches = 1l;
+    first_only.Add(first);
+    first_only.num_seeds = 2l;
+    first_only.num_pruned_seeds = 1l;
+    first_only.num_removed_alignments = 4l;
+    second_only.num_window_overflows = 1l;
+    first_only.num_brute_force_batches = 2l;
+    second_only.num_indexed_greedy_batches = 1l;
+    second_only.num_cluster_parallel_batches = 3l;
+    first_only.num_scanned_candidates = 4l;
+    second_only.num_scanned_candidates = 3l;
+    second_only.num_degraded_batches = 1l;
+    second_only.Add(second);
+    second_only.num_seeds = 3l;
+    second_only.num_pruned_seeds = 2l;
+    first_only += second_only;
+
+    THEN("Combined totals equal the totals of both alignments.") {
+      CHECK(first_only == both);
+    }
+
+    THEN("Averages are the averages over both alignments.") {
+      PasteStats expected;
+      expected.num_alignments = 2l;
+      expected.average_length = 22.5f;
+      expected.average_pident = (first.Pident() + second.Pident()) / 2.0f;
+      expected.average_score = (first.RawScore() + second.RawScore()) / 2.0f;
+      expected.average_bitscore = (first.Bitscore() + second.Bitscore())
+                                  / 2.0f;
+      expected.average_evalue = (first.Evalue() + second.Evalue()) / 2.0;
+      CHECK(FuzzyEquals(both.Averages(), expected));
+    }
+
+    THEN("The summary reports the seed pruning rate.") {
+      std::stringstream ss;
+      WriteSummary(both, ss);
+      CHECK(ss.str().find("\"seed_pruning_rate\": 0.6,\n")
+            != std::string::npos);
+      CHECK(ss.str().find("\"num_removed_alignments\": 4,\n")
+            != std::string::npos);
+      CHECK(ss.str().find("\"num_window_overflows\": 1,\n")
+            != std::string::npos);
+      CHECK(ss.str().find("\"num_brute_force_batches\": 2,\n")
+            != std::string::npos);
+      CHECK(ss.str().find("\"num_indexed_greedy_batches\": 1,\n")
+            != std::string::npos);
+      CHECK(ss.str().find("\"num_cluster_parallel_batches\": 3,\n")
+            != std::string::npos);
+      CHECK(ss.str().find("\"num_scanned_candidates\": 7,\n")
+            != std::string::npos);
+      CHECK(ss.str().find("\"num_degraded_batches\": 1\n")
+            != std::string::npos);
+    }
+
+    THEN("Totals are read back from a summary that includes them.") {
+      std::stringstream ss;
+      WriteSummary(both, ss, true);
+      CHECK(ReadSummaryTotals(ss) == both);
+    }
+
+    THEN("Summary without totals cannot be read back.") {
+      std::stringstream ss;
+      WriteSummary(both, ss);
+      CHECK_THROWS_AS(ReadSummaryTotals(ss), exceptions::ReadError);
+    }
   }
 }
 
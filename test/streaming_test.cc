@@ -0,0 +1,200 @@
+// Copyright (c) 2020 Jasper Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "streaming.h"
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_COLOUR_NONE
+#include "catch.h"
+
+#include "string_conversions.h" // include after catch.h
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "exceptions.h"
+
+// Streaming tests
+//
+// Test correctness for:
+// * PasteStreamedBatch
+//
+// Test exceptions for:
+// * PasteStreamedBatch
+
+namespace paste_alignments {
+
+namespace test {
+
+namespace {
+
+// Two pairs of pastable alignments far apart from each other, followed by
+// another batch.
+const std::string kSortedInput{
+    "q0\ts0\t101\t120\t1101\t1120\t20\t0\t0\t0\t10000\t100000\t20\n"
+    "q0\ts0\t126\t145\t1126\t1145\t20\t0\t0\t0\t10000\t100000\t20\n"
+    "q0\ts0\t5001\t5020\t6001\t6020\t20\t0\t0\t0\t10000\t100000\t20\n"
+    "q0\ts0\t5026\t5045\t6026\t6045\t20\t0\t0\t0\t10000\t100000\t20\n"
+    "q1\ts1\t101\t120\t1101\t1120\t20\t0\t0\t0\t10000\t100000\t20\n"};
+
+const std::string kUnsortedInput{
+    "q0\ts0\t5001\t5020\t6001\t6020\t20\t0\t0\t0\t10000\t100000\t20\n"
+    "q0\ts0\t101\t120\t1101\t1120\t20\t0\t0\t0\t10000\t100000\t20\n"};
+
+// Returns a reader of `input` in blind mode.
+//
+AlignmentReader BlindReader(const std::string& input) {
+  return AlignmentReader::FromIStream(
+      std::unique_ptr<std::istream>{new std::stringstream{input}}, 11);
+}
+
+// Returns the alignments of `batch` included in the output.
+//
+std::vector<Alignment> Included(const AlignmentBatch& batch) {
+  std::vector<Alignment> result;
+  for (const Alignment& a : batch.Alignments()) {
+    if (a.IncludeInOutput()) {
+      result.push_back(a);
+    }
+  }
+  return result;
+}
+
+SCENARIO("Test correctness of PasteStreamedBatch.",
+         "[PasteStreamedBatch][correctness]") {
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  AlignmentReader batch_reader{BlindReader(kSortedInput)};
+  AlignmentBatch whole{batch_reader.ReadBatch(scoring_system,
+                                              paste_parameters)};
+  whole.PasteAlignments(scoring_system, paste_parameters);
+  AlignmentReader reader{BlindReader(kSortedInput)};
+  std::vector<Alignment> streamed;
+  std::vector<int> part_sizes;
+  std::vector<bool> first_parts;
+  auto emit = [&](AlignmentBatch part, bool first_part) {
+    CHECK(part.Qseqid() == "q0");
+    CHECK(part.Sseqid() == "s0");
+    std::vector<Alignment> included{Included(part)};
+    streamed.insert(streamed.end(), included.begin(), included.end());
+    part_sizes.push_back(static_cast<int>(part.Size()));
+    first_parts.push_back(first_part);
+  };
+
+  GIVEN("A window holding the whole batch.") {
+    paste_parameters.stream_window = 100;
+    int num_overflows{PasteStreamedBatch(reader, scoring_system,
+                                         paste_parameters, emit)};
+
+    THEN("The batch is split between the pairs without overflows.") {
+      CHECK(num_overflows == 0);
+      CHECK(part_sizes == std::vector<int>{2, 2});
+      CHECK(first_parts == std::vector<bool>{true, false});
+    }
+
+    THEN("The pasted alignments equal those of the whole batch.") {
+      CHECK(streamed == Included(whole));
+      CHECK(streamed.size() == 2);
+    }
+
+    THEN("The reader continues with the next batch.") {
+      CHECK(reader.NextQseqid() == "q1");
+      CHECK(reader.NextAlignmentId() == 5l);
+    }
+  }
+
+  GIVEN("A window smaller than the pairs.") {
+    paste_parameters.stream_window = 1;
+    int num_overflows{PasteStreamedBatch(reader, scoring_system,
+                                         paste_parameters, emit)};
+
+    THEN("Each pair overflows the window.") {
+      CHECK(num_overflows == 2);
+      CHECK(part_sizes == std::vector<int>{2, 2});
+      CHECK(streamed == Included(whole));
+    }
+  }
+
+  GIVEN("A gap tolerance too small to paste the pairs.") {
+    paste_parameters.stream_window = 1;
+    paste_parameters.gap_tolerance = 0;
+    paste_parameters.intermediate_score_threshold = 100.0f;
+    int num_overflows{PasteStreamedBatch(reader, scoring_system,
+                                         paste_parameters, emit)};
+
+    THEN("Each alignment is a part of its own.") {
+      CHECK(num_overflows == 0);
+      CHECK(part_sizes == std::vector<int>{1, 1, 1, 1});
+      CHECK(streamed.size() == 4);
+    }
+  }
+}
+
+SCENARIO("Test exceptions thrown by PasteStreamedBatch.",
+         "[PasteStreamedBatch][exceptions]") {
+  ScoringSystem scoring_system{ScoringSystem::Create(100000l, 1, 2, 0, 0)};
+  PasteParameters paste_parameters;
+  paste_parameters.blind_mode = true;
+  auto emit = [](AlignmentBatch, bool) {};
+
+  GIVEN("A batch not sorted by query start.") {
+    paste_parameters.stream_window = 100;
+    AlignmentReader reader{BlindReader(kUnsortedInput)};
+
+    THEN("Streaming it causes exception.") {
+      CHECK_THROWS_AS(PasteStreamedBatch(reader, scoring_system,
+                                         paste_parameters, emit),
+                      exceptions::ReadError);
+    }
+  }
+
+  GIVEN("A window that is not positive.") {
+    AlignmentReader reader{BlindReader(kSortedInput)};
+
+    THEN("Streaming causes exception.") {
+      CHECK_THROWS_AS(PasteStreamedBatch(reader, scoring_system,
+                                         paste_parameters, emit),
+                      exceptions::OutOfRange);
+    }
+  }
+
+  GIVEN("A reader at the end of data.") {
+    paste_parameters.stream_window = 100;
+    AlignmentReader reader{BlindReader(kSortedInput)};
+    while (!reader.EndOfData()) {
+      reader.ReadBatch(scoring_system, paste_parameters);
+    }
+
+    THEN("Streaming causes exception.") {
+      CHECK_THROWS_AS(PasteStreamedBatch(reader, scoring_system,
+                                         paste_parameters, emit),
+                      exceptions::ReadError);
+    }
+  }
+}
+
+} // namespace
+
+} // namespace test
+
+} // namespace paste_alignments
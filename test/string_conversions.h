@@ -69,6 +69,69 @@ struct StringMaker<paste_alignments::StatsCollector> {
   }
 };
 
+template<>
+struct StringMaker<paste_alignments::ManifestEntry> {
+  static std::string convert(const paste_alignments::ManifestEntry& e) {
+    return e.DebugString();
+  }
+};
+
+template<>
+struct StringMaker<paste_alignments::SweepEntry> {
+  static std::string convert(const paste_alignments::SweepEntry& e) {
+    return e.DebugString();
+  }
+};
+
+template<>
+struct StringMaker<paste_alignments::Shard> {
+  static std::string convert(const paste_alignments::Shard& s) {
+    return s.DebugString();
+  }
+};
+
+template<>
+struct StringMaker<paste_alignments::InputRange> {
+  static std::string convert(const paste_alignments::InputRange& r) {
+    return r.DebugString();
+  }
+};
+
+template<>
+struct StringMaker<paste_alignments::PasteTotals> {
+  static std::string convert(const paste_alignments::PasteTotals& t) {
+    return t.DebugString();
+  }
+};
+
+template<>
+struct StringMaker<paste_alignments::Checkpoint> {
+  static std::string convert(const paste_alignments::Checkpoint& c) {
+    return c.DebugString();
+  }
+};
+
+template<>
+struct StringMaker<paste_alignments::RawBatch> {
+  static std::string convert(const paste_alignments::RawBatch& r) {
+    return r.DebugString();
+  }
+};
+
+template<>
+struct StringMaker<paste_alignments::CacheKey> {
+  static std::string convert(const paste_alignments::CacheKey& c) {
+    return c.DebugString();
+  }
+};
+
+template<>
+struct StringMaker<paste_alignments::OutputIndexEntry> {
+  static std::string convert(const paste_alignments::OutputIndexEntry& e) {
+    return e.DebugString();
+  }
+};
+
 } // namespace Catch
 
 #endif // PASTE_ALIGNMENTS_TEST_STRING_CONVERSIONS_H_
\ No newline at end of file